@@ -8,15 +8,26 @@ as specified in vscp.hpp. Handles all protocol methods with dummy responses.
 
 Protocol Methods:
 - INIT: Handshake and version compatibility check
-- UPDATE: Sensor data update requests
+- UPDATE: Sensor data update requests (single UID or batched 'id=S00,S01,S15')
 - CONFIG: Configuration changes from HMI to HW
 - RESET: Sensor reset operations
 - CONNECT: Connect sensor to specific pin
 - DISCONNECT: Disconnect sensor from pin
+- PINMAP: Apply pins of several sensors at once ('id=S00,S01&pins=1,2;'), all changes or none
+- SUBSCRIBE: Push sensor data every 'period' ms ('period=0' stops the stream)
+- PROBE: Echo 'data' back, verifies the line rate negotiated during INIT
+- BURST: Return up to 'n' samples buffered since the previous burst ('t=T1,T2,...&now=T&key=v1,v2,...')
+- STATS: Log counters reported by the display, answer with own counters ('rx', 'err', 'bad', 'proc', 'up')
 
 Protocol Format: URL-like with key-value pairs
 Request: ?type=METHOD&param1=value1&param2=value2
 Response: ?status=1/0&param1=value1&error=message
+Batched UPDATE response: ?id=S00&status=1&...|?id=S01&status=1&...
+Sequence ID: request '&seq=N' is echoed back at the end of the response
+Pushed frame (SUBSCRIBE): !?id=S00&status=1&... (same content as UPDATE response)
+Binary framing: INIT with 'framing=cobs' switches the link to COBS frames (see framing.py)
+Line rate: INIT with 'baud=R1,R2,...' switches to the highest offered rate up to max_baudrate, back to
+the base rate if no valid request arrives within BAUD_FALLBACK_DELAY or on damaged data
 
 Author: Generated for VSCP Protocol Testing
 """
@@ -29,11 +40,22 @@ import re
 from urllib.parse import parse_qs, unquote
 from typing import Dict, Any, Optional
 
+try:
+    from . import framing
+except ImportError:
+    import framing
+
 class VSCPEmulator:
     """Virtual Sensors Communication Protocol Emulator"""
     
-    def __init__(self, sensors:dict, port='COM3', baudrate=115200, timeout=0.1):
-        """Initialize the VSCP emulator"""
+    BAUD_FALLBACK_DELAY = 0.3  # Time (s) to receive a valid request at a new line rate (PROTOCOL_BAUD_FALLBACK_DELAY)
+    
+    def __init__(self, sensors:dict, port='COM3', baudrate=115200, timeout=0.1, max_baudrate=921600, unreliable_baudrate=None):
+        """Initialize the VSCP emulator
+
+        max_baudrate limits line rates accepted during INIT. Rates from unreliable_baudrate up are
+        simulated as broken (data are damaged both ways), e.g. to test the fallback on a pty.
+        """
         self.API_VERSION = "1.2"
         self.DB_VERSION = "1.0.0"
         self.APP_NAME = "VSCP Emulator"
@@ -43,13 +65,32 @@ class VSCPEmulator:
         self.initialized = False
         self.connected_sensors = {}  # uid -> pin mapping
         self.sensor_configs = {}     # uid -> config dict
+        self.subscriptions = {}      # uid -> [period_s, next_push_time]
+        self.revision = 0            # Last revision given to a changed value (shared by all sensors)
+        self.value_revisions = {}    # uid -> {key: (value, revision of the last change)}
+        self.revision_lock = threading.Lock()  # Requests and the push loop both give revisions
+        self.schema_ids = {}         # key -> negotiated schema key ID (sent as '#ID')
+        self.schema_keys = {}        # negotiated schema key ID -> key
+        self.burst_next = {}         # uid -> time (s) of the oldest sample not returned by BURST yet
+        self.start_time = time.time()
+        self.BURST_PERIOD = 0.01     # Sampling period of buffered samples (100 Hz)
+        self.BURST_BUFFER = 256      # Samples kept per sensor, older ones are dropped
+        self.stats = {'rx': 0, 'err': 0, 'bad': 0, 'proc': 0.0}  # Counters reported by STATS (proc = total s)
         
         # Serial connection
         self.port = port
         self.baudrate = baudrate
+        self.base_baudrate = baudrate
+        self.max_baudrate = max_baudrate
+        self.unreliable_baudrate = unreliable_baudrate
+        self.pending_baudrate = None     # Line rate to switch to after the INIT response
+        self.baud_deadline = None        # Time until a valid request has to arrive at the new rate
         self.timeout = timeout
         self.ser = None
         self.running = False
+        self.tx_lock = threading.Lock()  # Responses and pushed frames share the link
+        self.framing = 'text'            # Framing on the link: 'text' lines or 'cobs' frames
+        self.pending_framing = None      # Framing to switch to after the INIT response
         
         # Dummy sensor data
         self.sensor_data = sensors
@@ -91,7 +132,8 @@ class VSCPEmulator:
             for pair in pairs:
                 if '=' in pair:
                     key, value = pair.split('=', 1)
-                    params[key.strip()] = unquote(value.strip())
+                    key = key.strip()
+                    params[self.schema_keys.get(key, key)] = unquote(value.strip())
         
         return params
     
@@ -110,9 +152,39 @@ class VSCPEmulator:
         """Handle INIT method - handshake and version check"""
         print(f"🔄 INIT request: {params}")
         
+        # New session - streams of the previous one are stopped, INIT always comes at the base rate
+        self.subscriptions.clear()
+        self.fall_back_baudrate('INIT')
+        
+        # Accept the offered key schema, key N gets ID SCHEMA_KEY_BASE + N
+        self.schema_ids.clear()
+        self.schema_keys.clear()
+        offered = [key for key in params.get('keys', '').split(',') if key]
+        for index, key in enumerate(offered[:0x100 - framing.SCHEMA_KEY_BASE]):
+            key_id = f"{framing.SCHEMA_KEY_PREFIX}{framing.SCHEMA_KEY_BASE + index}"
+            self.schema_ids[key] = key_id
+            self.schema_keys[key_id] = key
+        
         # Dummy response for testing
         response_params = {'status': '1'}
         self.initialized = True
+        
+        # Confirm binary framing if offered, switch after the response is sent
+        if params.get('framing') == 'cobs':
+            response_params['framing'] = 'cobs'
+            self.pending_framing = 'cobs'
+        else:
+            self.pending_framing = 'text'
+        if offered:
+            response_params['keys'] = len(self.schema_ids)
+            print(f"🔑 Key schema: {len(self.schema_ids)} keys")
+        
+        # Accept the highest offered line rate, switch after the response is sent
+        rates = [int(rate) for rate in params.get('baud', '').split(',') if rate.strip().isdigit()]
+        accepted = max((rate for rate in rates if self.base_baudrate < rate <= self.max_baudrate), default=None)
+        if accepted:
+            response_params['baud'] = accepted
+            self.pending_baudrate = accepted
         return self.build_message(response_params)
         
         # Extract parameters
@@ -140,13 +212,28 @@ class VSCPEmulator:
         return self.build_message(response_params)
     
     def handle_update(self, params: Dict[str, str]) -> str:
-        """Handle UPDATE method - return sensor data"""
-        uid = params.get('id', '')
-        print(f"📊 UPDATE request for sensor: {uid}")
+        """Handle UPDATE method - return sensor data
+
+        Accepts a single UID or a comma separated list (batched update), e.g.
+        ?type=UPDATE&id=S00,S01,S15. Batched records are joined by '|'.
+        Optional since=REV (batched: since=REV1,REV2,...) returns only values changed
+        after the given revision.
+        """
+        uids = [uid.strip() for uid in params.get('id', '').split(',') if uid.strip()]
+        since = [int(rev) if rev.strip().isdigit() else 0 for rev in params.get('since', '').split(',')]
+        print(f"📊 UPDATE request for sensor(s): {', '.join(uids)}")
         
         if not self.initialized:
             return self.build_message({'status': '0', 'error': 'Protocol not initialized'})
         
+        if not uids:
+            return self.build_message({'status': '0', 'error': 'Missing sensor ID'})
+        
+        return '|'.join(self.build_message(self.build_update_record(uid, since[i] if i < len(since) else 0))
+                        for i, uid in enumerate(uids))
+    
+    def build_update_record(self, uid: str, since: int = 0) -> Dict[str, Any]:
+        """Build UPDATE response parameters for one sensor (only values changed after 'since' if given)"""
         if uid in self.sensor_data:
             # Get sensor data and add status
             sensor_info = self.sensor_data[uid].copy()
@@ -159,10 +246,24 @@ class VSCPEmulator:
                     else:
                         sensor_info[key] = round(value + random.uniform(-0.5, 0.5), 2)
             
-            response_params = {'id': uid, 'status': '1'}
-            response_params.update(sensor_info)
+            # Track revision of every value, it changes only with the value
+            with self.revision_lock:
+                revisions = self.value_revisions.setdefault(uid, {})
+                for key, value in sensor_info.items():
+                    if key not in revisions or revisions[key][0] != value:
+                        self.revision += 1
+                        revisions[key] = (value, self.revision)
+                sensor_revision = max((rev for _, rev in revisions.values()), default=0)
+                changed = {key: rev for key, (_, rev) in revisions.items()}
+            
+            # Unknown (or future - display restarted) revision gets all values
+            if 0 < since <= sensor_revision:
+                sensor_info = {key: value for key, value in sensor_info.items() if changed[key] > since}
             
-            print(f"✓ Sensor {uid} data: {sensor_info}")
+            response_params = {'id': uid, 'status': '1', 'rev': sensor_revision}
+            response_params.update({self.schema_ids.get(key, key): value for key, value in sensor_info.items()})
+            
+            print(f"✓ Sensor {uid} data (rev {sensor_revision}): {sensor_info if sensor_info else 'unchanged'}")
         else:
             response_params = {
                 'id': uid,
@@ -171,7 +272,7 @@ class VSCPEmulator:
             }
             print(f"✗ Sensor {uid} not found")
         
-        return self.build_message(response_params)
+        return response_params
     
     def handle_config(self, params: Dict[str, str]) -> str:
         """Handle CONFIG method - configure sensor"""
@@ -181,12 +282,12 @@ class VSCPEmulator:
         if not self.initialized:
             return self.build_message({'status': '0', 'error': 'Protocol not initialized'})
         
-        # Extract configuration parameters (exclude 'type' and 'id')
-        config_params = {k: v for k, v in params.items() if k not in ['type', 'id']}
+        # Extract configuration parameters (exclude 'type', 'id' and 'seq')
+        config_params = {k: v for k, v in params.items() if k not in ['type', 'id', 'seq']}
         
         if uid:
-            # Store configuration
-            self.sensor_configs[uid] = config_params
+            # Store configuration, only changed keys are sent - merge them
+            self.sensor_configs.setdefault(uid, {}).update(config_params)
             response_params = {
                 'id': uid,
                 'status': '1',
@@ -313,6 +414,218 @@ class VSCPEmulator:
         
         return self.build_message(response_params)
     
+    def handle_pinmap(self, params: Dict[str, str]) -> str:
+        """Handle PINMAP method - apply pin changes of several sensors as one transaction"""
+        uids = [uid.strip() for uid in params.get('id', '').split(',')]
+        entries = params.get('pins', '').split(';')
+        print(f"🔌 PINMAP request: sensors {uids} to pins {entries}")
+
+        if not self.initialized:
+            return self.build_message({'status': '0', 'error': 'Protocol not initialized'})
+
+        if not uids[0] or len(uids) != len(entries):
+            return self.build_message({'status': '0', 'error': 'Every sensor needs one pins entry'})
+
+        # Validate the resulting map first, nothing is applied if any change is refused
+        result = dict(self.connected_sensors)
+        for uid, entry in zip(uids, entries):
+            if uid not in self.sensor_data:
+                return self.build_message({'id': uid, 'status': '0', 'error': f'Sensor {uid} not found'})
+            try:
+                pins = [int(pin) for pin in entry.split(',')] if entry.strip() else []
+            except ValueError:
+                return self.build_message({'id': uid, 'status': '0', 'error': f'Invalid pin number: {entry}'})
+            if pins:
+                result[uid] = pins
+            else:
+                result.pop(uid, None)
+
+        used = {}
+        for uid, pins in result.items():
+            for pin in pins:
+                if pin in used:
+                    print(f"✗ Pin {pin} conflict: {uid} and {used[pin]}")
+                    return self.build_message({'id': uid, 'status': '0',
+                                               'error': f'Pin {pin} already used by sensor {used[pin]}'})
+                used[pin] = uid
+
+        self.connected_sensors = result
+        print(f"✓ Pin map applied: {result}")
+        return self.build_message({'status': '1'})
+
+    def handle_stats(self, params: Dict[str, str]) -> str:
+        """Handle STATS method - log display counters, return own counters"""
+        display = {key: params[key] for key in ('req', 'rsp', 'err', 'tmo', 'p50', 'p99') if key in params}
+        print(f"📊 STATS from display: {display}")
+
+        received = self.stats['rx'] + 1  # Including this request
+        return self.build_message({
+            'status': '1',
+            'rx': received,
+            'err': self.stats['err'],
+            'bad': self.stats['bad'],
+            'proc': int(self.stats['proc'] * 1e6 / received),
+            'up': int((time.time() - self.start_time) * 1000)
+        })
+
+    def handle_subscribe(self, params: Dict[str, str]) -> str:
+        """Handle SUBSCRIBE method - start/stop pushing sensor data"""
+        uid = params.get('id', '')
+        print(f"📡 SUBSCRIBE request for sensor: {uid}")
+        
+        if not self.initialized:
+            return self.build_message({'status': '0', 'error': 'Protocol not initialized'})
+        
+        try:
+            period = int(params.get('period', '0'))
+        except ValueError:
+            return self.build_message({'id': uid, 'status': '0', 'error': 'Invalid period'})
+        
+        if uid not in self.sensor_data:
+            print(f"✗ Sensor {uid} not found")
+            return self.build_message({'id': uid, 'status': '0', 'error': f'Sensor {uid} not found'})
+        
+        if period <= 0:
+            self.subscriptions.pop(uid, None)
+            print(f"✓ Sensor {uid} unsubscribed")
+        else:
+            self.subscriptions[uid] = [period / 1000.0, time.time()]
+            print(f"✓ Sensor {uid} subscribed every {period} ms")
+        
+        return self.build_message({'id': uid, 'status': '1'})
+    
+    def handle_burst(self, params: Dict[str, str]) -> str:
+        """Handle BURST method - return samples buffered since the previous burst
+
+        Samples are taken every BURST_PERIOD, at most BURST_BUFFER of them are kept.
+        Returns up to 'n' oldest samples: t=T1,T2,... (ms since start) and key=v1,v2,... per value,
+        'now' is the clock of the emulator when answering (ms since start).
+        """
+        uid = params.get('id', '')
+        print(f"📦 BURST request for sensor: {uid}")
+        
+        if not self.initialized:
+            return self.build_message({'status': '0', 'error': 'Protocol not initialized'})
+        
+        try:
+            limit = int(params.get('n', '0'))
+        except ValueError:
+            return self.build_message({'id': uid, 'status': '0', 'error': 'Invalid sample count'})
+        
+        if uid not in self.sensor_data:
+            print(f"✗ Sensor {uid} not found")
+            return self.build_message({'id': uid, 'status': '0', 'error': f'Sensor {uid} not found'})
+        
+        now = time.time()
+        oldest = self.burst_next.get(uid, self.start_time)
+        available = int((now - oldest) / self.BURST_PERIOD)
+        if available > self.BURST_BUFFER:
+            oldest += (available - self.BURST_BUFFER) * self.BURST_PERIOD  # Buffer overflow, oldest were dropped
+            available = self.BURST_BUFFER
+        count = max(0, min(limit, available))
+        self.burst_next[uid] = oldest + count * self.BURST_PERIOD
+        
+        times = [round((oldest + i * self.BURST_PERIOD - self.start_time) * 1000) for i in range(count)]
+        response_params = {'id': uid, 'status': '1', 'n': count, 't': ','.join(str(t) for t in times),
+                           'now': round((now - self.start_time) * 1000)}
+        for key, value in self.sensor_data[uid].items():
+            if key == 'type' or not isinstance(value, (int, float)):
+                continue
+            if isinstance(value, int):
+                samples = [value + random.randint(-2, 2) for _ in range(count)]
+            else:
+                samples = [round(value + random.uniform(-0.5, 0.5), 2) for _ in range(count)]
+            response_params[self.schema_ids.get(key, key)] = ','.join(str(sample) for sample in samples)
+        
+        print(f"✓ Sensor {uid} burst of {count} samples")
+        return self.build_message(response_params)
+    
+    def handle_probe(self, params: Dict[str, str]) -> str:
+        """Handle PROBE method - echo the data to verify the line rate"""
+        return self.build_message({'status': '1', 'data': params.get('data', '')})
+    
+    def link_broken(self) -> bool:
+        """Whether the current line rate is simulated as broken"""
+        return self.unreliable_baudrate is not None and self.baudrate >= self.unreliable_baudrate
+    
+    def set_baudrate(self, baudrate: int):
+        """Switch the line rate after the pending output is sent"""
+        with self.tx_lock:
+            if self.ser:
+                self.ser.flush()
+                self.ser.baudrate = baudrate
+            self.baudrate = baudrate
+        print(f"⚡ Line rate: {baudrate}")
+    
+    def fall_back_baudrate(self, reason: str):
+        """Return to the base line rate"""
+        self.pending_baudrate = None
+        self.baud_deadline = None
+        if self.baudrate != self.base_baudrate:
+            print(f"↩ Line rate fallback ({reason})")
+            self.set_baudrate(self.base_baudrate)
+    
+    def send_line(self, line: str):
+        """Send one message over the serial link (text line or binary frame)"""
+        with self.tx_lock:
+            if self.framing == 'cobs':
+                data = framing.encode_frame(line) + framing.FRAME_DELIMITER
+            else:
+                data = (line + '\n').encode('utf-8')
+            if self.link_broken():
+                data = bytes(byte ^ 0x5A for byte in data)
+            self.ser.write(data)
+    
+    def handle_line(self, line: str):
+        """Process one received request and send the response"""
+        if self.link_broken():
+            print(f"✗ Damaged data at {self.baudrate} baud")
+            self.stats['bad'] += 1
+            self.fall_back_baudrate('damaged data')
+            return
+        
+        self.baud_deadline = None  # Valid request, the line rate works
+        print(f"📨 Received: {line}")
+        started = time.perf_counter()
+        response = self.process_request(line)
+        self.stats['rx'] += 1
+        self.stats['proc'] += time.perf_counter() - started
+        if response and self.parse_message(response.split('|')[0]).get('status') == '0':
+            self.stats['err'] += 1
+        
+        # Send response
+        if response:
+            self.send_line(response)
+            print(f"📤 Sent: {response}")
+        
+        # Framing changes right after the INIT response
+        if self.pending_framing:
+            with self.tx_lock:
+                self.framing = self.pending_framing
+            self.pending_framing = None
+            print(f"🔀 Framing: {self.framing}")
+        
+        # Line rate changes after the framing
+        if self.pending_baudrate:
+            self.set_baudrate(self.pending_baudrate)
+            self.pending_baudrate = None
+            self.baud_deadline = time.time() + self.BAUD_FALLBACK_DELAY
+    
+    def push_loop(self):
+        """Push data of subscribed sensors"""
+        while self.running:
+            now = time.time()
+            for uid, subscription in list(self.subscriptions.items()):
+                period, next_push = subscription
+                if now < next_push:
+                    continue
+                subscription[1] = max(next_push + period, now)
+                try:
+                    self.send_line('!' + self.build_message(self.build_update_record(uid)))
+                except Exception as e:
+                    print(f"❌ Error in push loop: {e}")
+            time.sleep(0.005)
+    
     def process_request(self, message: str) -> str:
         """Process incoming protocol request"""
         params = self.parse_message(message)
@@ -325,33 +638,70 @@ class VSCPEmulator:
             'CONFIG': self.handle_config,
             'RESET': self.handle_reset,
             'CONNECT': self.handle_connect,
-            'DISCONNECT': self.handle_disconnect
+            'DISCONNECT': self.handle_disconnect,
+            'PINMAP': self.handle_pinmap,
+            'SUBSCRIBE': self.handle_subscribe,
+            'BURST': self.handle_burst,
+            'PROBE': self.handle_probe,
+            'STATS': self.handle_stats
         }
         
         if request_type in handlers:
-            return handlers[request_type](params)
+            response = handlers[request_type](params)
         else:
-            return self.build_message({
+            response = self.build_message({
                 'status': '0',
                 'error': f'Unknown request type: {request_type}'
             })
+        
+        # Echo sequence ID so the display can match pipelined responses
+        if 'seq' in params:
+            response += f"&seq={params['seq']}"
+        return response
     
     def listen_loop(self):
         """Main listening loop for incoming requests"""
         print("🎧 Listening for protocol requests...")
         buffer = ""
+        frame_buffer = b""
         
         while self.running:
             try:
+                if self.baud_deadline and time.time() > self.baud_deadline:
+                    self.fall_back_baudrate('no request at the new rate')
+                
                 if self.ser and self.ser.in_waiting > 0:
-                    data = self.ser.read(self.ser.in_waiting).decode('utf-8', errors='ignore')
+                    raw = self.ser.read(self.ser.in_waiting)
+                    
+                    if self.framing == 'cobs':
+                        frame_buffer += raw
+                        # Display restarted in text mode - text INIT line instead of frames
+                        if b'?type=INIT' in frame_buffer and b'\n' in frame_buffer:
+                            print("🔀 Text INIT received, framing: text")
+                            self.framing = 'text'
+                            raw, frame_buffer = frame_buffer[frame_buffer.index(b'?type=INIT'):], b""
+                        else:
+                            while framing.FRAME_DELIMITER in frame_buffer:
+                                frame, frame_buffer = frame_buffer.split(framing.FRAME_DELIMITER, 1)
+                                if not frame:
+                                    continue
+                                line = framing.decode_frame(frame)
+                                if line is None:
+                                    print("✗ Damaged frame dropped")
+                                    self.stats['bad'] += 1
+                                    self.fall_back_baudrate('damaged frame')
+                                    continue
+                                self.handle_line(line)
+                            raw = b""
+                    
+                    data = raw.decode('utf-8', errors='ignore')
                     buffer += data
                     
                     if data and '\n' in buffer:
                         print(f"DEBUG: {data}") 
                         #print(f"DEBUG BUFFER: {buffer}")
                     # Process complete messages (ending with newline or containing '?')
-                    while '\n' in buffer or '?' in buffer:
+                    while self.framing == 'text' and ('\n' in buffer or '?' in buffer):
                         if '\n' in buffer:
                             line, buffer = buffer.split('\n', 1)
                         else:
@@ -366,13 +716,9 @@ class VSCPEmulator:
                         if qmark_index != -1:
                             line = line[qmark_index:]
                         if line and line.startswith('?'):
-                            print(f"📨 Received: {line}")
-                            response = self.process_request(line)
-                            
-                            # Send response
-                            if response:
-                                self.ser.write((response + '\n').encode('utf-8'))
-                                print(f"📤 Sent: {response}")
+                            self.handle_line(line)
+                    if self.framing != 'text':
+                        buffer = ""
                 
                 time.sleep(0.01)  # Small delay to prevent busy waiting
                 
@@ -396,6 +742,10 @@ class VSCPEmulator:
         listen_thread = threading.Thread(target=self.listen_loop, daemon=True)
         listen_thread.start()
         
+        # Start push thread for SUBSCRIBE streams
+        push_thread = threading.Thread(target=self.push_loop, daemon=True)
+        push_thread.start()
+        
         try:
             print("\n💡 Emulator ready! Send protocol requests to test.")
             print("   Example: ?type=INIT&app=TestApp&version=1.0.0&dbversion=1.0.0&api=1.0")
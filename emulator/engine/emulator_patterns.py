@@ -8,7 +8,7 @@ as specified in vscp.hpp. Handles all protocol methods with dummy responses.
 
 Protocol Methods:
 - INIT: Handshake and version compatibility check
-- UPDATE: Sensor data update requests
+- UPDATE: Sensor data update requests (single UID or batched 'id=S00,S01,S15')
 - CONFIG: Configuration changes from HMI to HW
 - RESET: Sensor reset operations
 - CONNECT: Connect sensor to specific pin
@@ -17,6 +17,8 @@ Protocol Methods:
 Protocol Format: URL-like with key-value pairs
 Request: ?type=METHOD&param1=value1&param2=value2
 Response: ?status=1/0&param1=value1&error=message
+Batched UPDATE response: ?id=S00&status=1&...|?id=S01&status=1&...
+Sequence ID: request '&seq=N' is echoed back at the end of the response
 
 Author: Generated for VSCP Protocol Testing
 """
@@ -332,13 +334,24 @@ class VSCPEmulator:
         return final_value
 
     def handle_update(self, params: Dict[str, str]) -> str:
-        """Handle UPDATE method - return realistic sensor data"""
-        uid = params.get('id', '')
-        print(f"📊 UPDATE request for sensor: {uid}")
+        """Handle UPDATE method - return realistic sensor data
+
+        Accepts a single UID or a comma separated list (batched update), e.g.
+        ?type=UPDATE&id=S00,S01,S15. Batched records are joined by '|'.
+        """
+        uids = [uid.strip() for uid in params.get('id', '').split(',') if uid.strip()]
+        print(f"📊 UPDATE request for sensor(s): {', '.join(uids)}")
         
         if not self.initialized:
             return self.build_message({'status': '0', 'error': 'Protocol not initialized'})
         
+        if not uids:
+            return self.build_message({'status': '0', 'error': 'Missing sensor ID'})
+        
+        return '|'.join(self.build_message(self.build_update_record(uid)) for uid in uids)
+    
+    def build_update_record(self, uid: str) -> Dict[str, Any]:
+        """Build UPDATE response parameters for one sensor"""
         if uid in self.sensor_data:
             # Get sensor configuration
             sensor_config = self.sensor_data[uid]
@@ -373,7 +386,7 @@ class VSCPEmulator:
             }
             print(f"✗ Sensor {uid} not found")
         
-        return self.build_message(response_params)
+        return response_params
     
     def adjust_simulation_scenario(self):
         """Dynamically adjust simulation scenarios to create interesting patterns"""
@@ -571,12 +584,17 @@ class VSCPEmulator:
         }
         
         if request_type in handlers:
-            return handlers[request_type](params)
+            response = handlers[request_type](params)
         else:
-            return self.build_message({
+            response = self.build_message({
                 'status': '0',
                 'error': f'Unknown request type: {request_type}'
             })
+        
+        # Echo sequence ID so the display can match pipelined responses
+        if 'seq' in params:
+            response += f"&seq={params['seq']}"
+        return response
     
     def listen_loop(self):
         """Main listening loop for incoming requests"""
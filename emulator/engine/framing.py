@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+VSCP binary framing
+===================
+
+Python counterpart of libraries/vscp/src/io/framing.hpp. Converts text protocol
+messages to COBS encoded binary frames and back.
+
+frame   = COBS( flags | record... | crc16 ) 0x00
+flags   = u8, bit 0 set for pushed frames (text prefix '!')
+record  = pair... (records of a batched response are separated by a SEPARATOR pair)
+pair    = tag u8 | key | value
+tag     = value type (bits 0-6) | KEY_INDEX (bit 7)
+key     = key index u8 (well-known keys below SCHEMA_KEY_BASE, negotiated schema keys
+          '#ID' from SCHEMA_KEY_BASE) or key length u8 + characters
+value   = STRING: u8 length + bytes, STRING16: u16 length + bytes,
+          INT8/INT16/INT32: little-endian integer, FLOAT32: little-endian IEEE 754
+crc16   = CRC-16/CCITT-FALSE of flags and records, little-endian
+"""
+
+import struct
+from typing import Optional
+
+FRAME_DELIMITER = b'\x00'
+FLAG_PUSH = 0x01
+KEY_INDEX = 0x80
+PUSH_PREFIX = '!'
+SCHEMA_KEY_PREFIX = '#'
+SCHEMA_KEY_BASE = 32
+
+SEPARATOR, STRING, INT8, INT16, INT32, FLOAT32, STRING16 = range(7)
+
+# Well-known protocol keys sent as one byte index (order is part of the frame format)
+FRAME_KEYS = ["type", "id", "status", "error", "seq", "period", "pins", "app", "db", "api", "framing", "rev", "since", "n", "t"]
+
+
+def crc16(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_encode(data: bytes) -> bytes:
+    """COBS encode (without delimiter)"""
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte == 0:
+            out.append(len(block) + 1)
+            out += block
+            block = bytearray()
+        else:
+            block.append(byte)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block = bytearray()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def cobs_decode(data: bytes) -> Optional[bytes]:
+    """COBS decode (without delimiter), None if invalid"""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def schema_key_id(key: str) -> int:
+    """Negotiated schema key ID of a '#ID' key, 0 if the key is sent by name"""
+    if len(key) < 2 or key[0] != SCHEMA_KEY_PREFIX or not key[1:].isdigit():
+        return 0
+    key_id = int(key[1:])
+    return key_id if SCHEMA_KEY_BASE <= key_id <= 0xFF else 0
+
+
+def _encode_value(value: str):
+    """Smallest lossless type of the value"""
+    try:
+        number = int(value, 10)
+        if str(number) == value:
+            if -128 <= number <= 127:
+                return INT8, struct.pack('<b', number)
+            if -32768 <= number <= 32767:
+                return INT16, struct.pack('<h', number)
+            if -2**31 <= number < 2**31:
+                return INT32, struct.pack('<i', number)
+    except ValueError:
+        try:
+            real = struct.unpack('<f', struct.pack('<f', float(value)))[0]
+            if _format_float(real) == value:
+                return FLOAT32, struct.pack('<f', real)
+        except (ValueError, OverflowError):
+            pass
+    raw = value.encode('utf-8')
+    if len(raw) <= 0xFF:
+        return STRING, bytes([len(raw)]) + raw
+    return STRING16, struct.pack('<H', len(raw)) + raw
+
+
+def _format_float(real: float) -> str:
+    """Same text as C printf("%.7g")"""
+    return '%.7g' % real
+
+
+def encode_frame(message: str) -> bytes:
+    """Convert text message into COBS encoded frame (without delimiter)"""
+    flags = 0
+    if message.startswith(PUSH_PREFIX):
+        flags |= FLAG_PUSH
+        message = message[1:]
+
+    raw = bytearray([flags])
+    for index, record in enumerate(message.split('|')):
+        if index > 0:
+            raw.append(SEPARATOR)
+        record = record.strip()
+        if record.startswith('?'):
+            record = record[1:]
+        for pair in record.split('&'):
+            if '=' not in pair:
+                continue
+            key, value = pair.split('=', 1)
+            key, value = key.strip(), value.strip()
+            if not key:
+                continue
+            value_type, payload = _encode_value(value)
+            if schema_key_id(key):
+                raw += bytes([value_type | KEY_INDEX, schema_key_id(key)])
+            elif key in FRAME_KEYS:
+                raw += bytes([value_type | KEY_INDEX, FRAME_KEYS.index(key)])
+            else:
+                key_raw = key.encode('utf-8')
+                raw += bytes([value_type, len(key_raw)]) + key_raw
+            raw += payload
+
+    raw += struct.pack('<H', crc16(bytes(raw)))
+    return cobs_encode(bytes(raw))
+
+
+def decode_frame(frame: bytes) -> Optional[str]:
+    """Convert COBS encoded frame (without delimiter) into text message, None if damaged"""
+    raw = cobs_decode(frame)
+    if raw is None or len(raw) < 3:
+        return None
+    body, crc = raw[:-2], struct.unpack('<H', raw[-2:])[0]
+    if crc16(body) != crc:
+        return None
+
+    records = [[]]
+    i = 1
+    try:
+        while i < len(body):
+            tag = body[i]
+            i += 1
+            value_type = tag & ~KEY_INDEX
+            if value_type == SEPARATOR:
+                records.append([])
+                continue
+            if tag & KEY_INDEX:
+                index = body[i]
+                key = f"{SCHEMA_KEY_PREFIX}{index}" if index >= SCHEMA_KEY_BASE else FRAME_KEYS[index]
+                i += 1
+            else:
+                length = body[i]
+                key = body[i + 1:i + 1 + length].decode('utf-8')
+                i += 1 + length
+
+            if value_type in (STRING, STRING16):
+                size = 1 if value_type == STRING else 2
+                length = int.from_bytes(body[i:i + size], 'little')
+                value = body[i + size:i + size + length].decode('utf-8')
+                i += size + length
+            elif value_type == FLOAT32:
+                value = _format_float(struct.unpack('<f', body[i:i + 4])[0])
+                i += 4
+            else:
+                fmt, size = {INT8: ('<b', 1), INT16: ('<h', 2), INT32: ('<i', 4)}[value_type]
+                value = str(struct.unpack(fmt, body[i:i + size])[0])
+                i += size
+            records[-1].append(f"{key}={value}")
+    except (IndexError, KeyError, struct.error, UnicodeDecodeError):
+        return None
+
+    message = '|'.join('?' + '&'.join(pairs) for pairs in records)
+    return (PUSH_PREFIX + message) if body[0] & FLAG_PUSH else message
@@ -12,8 +12,8 @@
 #ifndef CONFIG_ENGINE_H
 #define CONFIG_ENGINE_H
 
-/// Uncomment to enable Arduino-based environments
-#ifndef ARDUINO_H
+/// Uncomment to enable Arduino-based environments (host builds define STDIO_H instead)
+#if !defined(ARDUINO_H) && !defined(STDIO_H)
 #define ARDUINO_H 
 #endif
 
@@ -21,11 +21,22 @@
 //#define STDIO_H 
 
 // Uncomment to enable LVGL support
-#ifndef USE_LVGL
+#if !defined(USE_LVGL) && defined(ARDUINO_H)
 #define USE_LVGL
 #endif
 
 // Uncomment to enable ESP32 platform
 //#define ESP_PLATFORM
 
+// Comment out to run the link (protocol polling and requests) in the GUI loop instead of its own task
+#ifndef LINK_WORKER
+#define LINK_WORKER
+#endif
+
+#define LINK_TASK_CORE 0         ///< Core of the link task, the Arduino loop (GUI) runs on core 1
+#define LINK_TASK_STACK 8192     ///< Stack size of the link task (bytes)
+#define LINK_TASK_PRIORITY 1     ///< Priority of the link task, same as the Arduino loop
+#define LINK_QUEUE_SIZE 64       ///< Capacity of the command and event queues (power of two)
+#define LINK_PERIOD_MS 1         ///< Sleep of the link task between passes, also the wait step of stop()
+
 #endif // CONFIG_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,340 @@
+/**
+ * @file diagnostics_gui.hpp
+ * @brief Header file for the DiagnosticsGui class
+ *
+ * This header file declares and defines the DiagnosticsGui class responsible for
+ * displaying link health: protocol counters, the response latency histogram,
+ * statistics reported by the peer and the render time of the display.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef DIAGNOSTICS_GUI_HPP
+#define DIAGNOSTICS_GUI_HPP
+
+#include <cstdio>
+#include "lvgl.h"
+#include "vscp.hpp"
+#include "gui_callbacks.hpp"
+#include "../managers/manager.hpp"
+
+/**
+ * @class DiagnosticsGui
+ * @brief Handles the creation, refresh, and destruction of the link diagnostics page.
+ *
+ * Counters are read lock-free from Protocol::getStats(), the peer counters are
+ * exchanged by a STATS request at most once per PEER_STATS_PERIOD_MS. The exchange
+ * runs on the link task, its result comes back with the sensor updates. Comparing the
+ * peer processing time, the link latency and the render time shows which part is slow.
+ */
+class DiagnosticsGui
+{
+private:
+    static const uint32_t PEER_STATS_PERIOD_MS = 1000; ///< Period of the STATS exchange
+
+    SensorManager &sensorManager;             ///< Reference to the sensor manager (owner of the link)
+    bool initialized = false;                 ///< Initialization state flag
+    bool peerStatsSupported = true;           ///< Whether the peer answers STATS requests
+    unsigned long lastPeerStats = 0;          ///< Time of the last STATS exchange (ms)
+    uint32_t renderMax = 0;                   ///< Longest render time since shown (us)
+    ResponseStatus peerStats;                 ///< Last counters reported by the peer
+    LinkStats linkStats;                      ///< Link state read with the last STATS exchange
+
+    lv_obj_t *ui_DiagnosticsScreen = nullptr; ///< Main screen/container widget
+    lv_obj_t *ui_LinkLabel = nullptr;         ///< Local protocol counters
+    lv_obj_t *ui_PeerLabel = nullptr;         ///< Counters reported by the peer and render time
+    lv_obj_t *ui_LatencyChart = nullptr;      ///< Latency histogram
+    lv_chart_series_t *ui_LatencySeries = nullptr; ///< Responses per latency bucket
+
+    static constexpr const char *txt_title = "Link Diagnostics";
+    static constexpr const char *txt_buckets =
+        "<0.5   1     2     5    10   20   50  100  200  500  1000 >1000 ms";
+
+    void create_corner_button()
+    {
+        lv_obj_t *ui_btnBackGroup = lv_obj_create(ui_DiagnosticsScreen);
+        lv_obj_remove_style_all(ui_btnBackGroup);
+        lv_obj_set_width(ui_btnBackGroup, 100);
+        lv_obj_set_height(ui_btnBackGroup, 40);
+        lv_obj_add_flag(ui_btnBackGroup, LV_OBJ_FLAG_FLOATING);
+        lv_obj_align(ui_btnBackGroup, LV_ALIGN_TOP_LEFT, -15, -15);
+        lv_obj_clear_flag(ui_btnBackGroup, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE); /// Flags
+
+        lv_obj_t *ui_btnBackCornerBottomLeft = lv_obj_create(ui_btnBackGroup);
+        lv_obj_remove_style_all(ui_btnBackCornerBottomLeft);
+        lv_obj_set_width(ui_btnBackCornerBottomLeft, 20);
+        lv_obj_set_height(ui_btnBackCornerBottomLeft, 20);
+        lv_obj_set_align(ui_btnBackCornerBottomLeft, LV_ALIGN_BOTTOM_LEFT);
+        lv_obj_clear_flag(ui_btnBackCornerBottomLeft, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE); /// Flags
+        lv_obj_set_style_bg_color(ui_btnBackCornerBottomLeft, lv_color_hex(0x009BFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(ui_btnBackCornerBottomLeft, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        lv_obj_t *ui_btnBackCornerTopRight = lv_obj_create(ui_btnBackGroup);
+        lv_obj_remove_style_all(ui_btnBackCornerTopRight);
+        lv_obj_set_width(ui_btnBackCornerTopRight, 20);
+        lv_obj_set_height(ui_btnBackCornerTopRight, 20);
+        lv_obj_set_align(ui_btnBackCornerTopRight, LV_ALIGN_TOP_RIGHT);
+        lv_obj_clear_flag(ui_btnBackCornerTopRight, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE); /// Flags
+        lv_obj_set_style_bg_color(ui_btnBackCornerTopRight, lv_color_hex(0x009BFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(ui_btnBackCornerTopRight, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        // Back button for returning to visualization
+        lv_obj_t *ui_btnBack = lv_btn_create(ui_btnBackGroup);
+        lv_obj_set_width(ui_btnBack, 100);
+        lv_obj_set_height(ui_btnBack, 40);
+        lv_obj_set_align(ui_btnBack, LV_ALIGN_CENTER);
+        lv_obj_add_event_cb(ui_btnBack, [](lv_event_t *e)
+                            {
+        auto self = static_cast<DiagnosticsGui*>(lv_event_get_user_data(e));
+        self->hideDiagnostics();
+        switchToVisualization(); }, LV_EVENT_CLICKED, this);
+
+        lv_obj_t *ui_btnBackLabel = lv_label_create(ui_btnBack);
+        lv_label_set_text(ui_btnBackLabel, "Back");
+        lv_obj_center(ui_btnBackLabel);
+        lv_obj_set_style_text_font(ui_btnBackLabel, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+
+    void create_reset_button()
+    {
+        lv_obj_t *ui_btnReset = lv_btn_create(ui_DiagnosticsScreen);
+        lv_obj_set_width(ui_btnReset, 100);
+        lv_obj_set_height(ui_btnReset, 30);
+        lv_obj_add_flag(ui_btnReset, LV_OBJ_FLAG_FLOATING);
+        lv_obj_align(ui_btnReset, LV_ALIGN_TOP_RIGHT, 0, 0);
+        lv_obj_set_style_radius(ui_btnReset, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_add_event_cb(ui_btnReset, [](lv_event_t *e)
+                            {
+        auto self = static_cast<DiagnosticsGui*>(lv_event_get_user_data(e));
+        self->sensorManager.getLink().post([]() { Protocol::resetStats(); });
+        self->renderMax = 0; }, LV_EVENT_CLICKED, this);
+
+        lv_obj_t *ui_btnResetLabel = lv_label_create(ui_btnReset);
+        lv_label_set_text(ui_btnResetLabel, "Reset");
+        lv_obj_center(ui_btnResetLabel);
+    }
+
+    /**
+     * @brief Exchange counters with the peer and read the link state
+     *
+     * The exchange is disabled for the session if the peer does not answer STATS.
+     */
+    void updatePeerStats()
+    {
+        if (!sensorManager.isInitialized())
+            return;
+
+        unsigned long now = getTimeMs();
+        if (lastPeerStats != 0 && now - lastPeerStats < PEER_STATS_PERIOD_MS)
+            return;
+        lastPeerStats = now;
+
+        LinkWorker &link = sensorManager.getLink();
+        bool exchange = peerStatsSupported;
+        link.post([this, &link, exchange]() {
+            ResponseStatus stats = exchange ? Protocol::exchangeStats() : ResponseStatus();
+            LinkStats state = Protocol::getLinkStats();
+            link.publish([this, stats, state]() { setPeerStats(stats, state); });
+        });
+    }
+
+    /**
+     * @brief Keep the result of a STATS exchange (GUI side)
+     */
+    void setPeerStats(const ResponseStatus &stats, const LinkStats &state)
+    {
+        if (!initialized)
+            return;
+
+        peerStats = stats;
+        linkStats = state;
+        if (peerStatsSupported && peerStats.status != ResponseStatusEnum::OK && peerStats.params.count("status"))
+        {
+            peerStatsSupported = false; // Answered, but does not know STATS
+        }
+    }
+
+    /**
+     * @brief Get a peer counter as text
+     */
+    const char *peerValue(const char *key) const
+    {
+        auto it = peerStats.params.find(key);
+        return it != peerStats.params.end() ? it->second.c_str() : "-";
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param manager Reference to the sensor manager
+     */
+    explicit DiagnosticsGui(SensorManager &manager) : sensorManager(manager) {}
+
+    /**
+     * @brief Destructor
+     */
+    ~DiagnosticsGui()
+    {
+        hideDiagnostics();
+    }
+
+    /**
+     * @brief Initialize the Diagnostics GUI
+     * Creates the screen layout, values are filled by refresh().
+     */
+    void init()
+    {
+        if (initialized)
+            return;
+
+        ui_DiagnosticsScreen = lv_obj_create(lv_scr_act());
+        lv_obj_remove_style_all(ui_DiagnosticsScreen);
+        lv_obj_set_width(ui_DiagnosticsScreen, 760);
+        lv_obj_set_height(ui_DiagnosticsScreen, 440);
+        lv_obj_set_align(ui_DiagnosticsScreen, LV_ALIGN_CENTER);
+        lv_obj_set_flex_flow(ui_DiagnosticsScreen, LV_FLEX_FLOW_COLUMN);
+        lv_obj_set_style_pad_all(ui_DiagnosticsScreen, 15, 0);
+        lv_obj_set_style_pad_row(ui_DiagnosticsScreen, 10, 0); // Gap between blocks
+        lv_obj_set_style_radius(ui_DiagnosticsScreen, 15, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_color(ui_DiagnosticsScreen, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(ui_DiagnosticsScreen, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_color(ui_DiagnosticsScreen, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_opa(ui_DiagnosticsScreen, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_width(ui_DiagnosticsScreen, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_clear_flag(ui_DiagnosticsScreen, LV_OBJ_FLAG_SCROLLABLE);
+
+        create_corner_button();
+        create_reset_button();
+
+        // Title
+        lv_obj_t *lbl_title = lv_label_create(ui_DiagnosticsScreen);
+        lv_label_set_text_static(lbl_title, txt_title);
+        lv_obj_set_style_pad_top(lbl_title, 30, 0);
+        lv_obj_set_style_text_font(lbl_title, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        ui_LinkLabel = lv_label_create(ui_DiagnosticsScreen);
+        lv_obj_set_width(ui_LinkLabel, lv_pct(100));
+        lv_label_set_text(ui_LinkLabel, "");
+
+        ui_PeerLabel = lv_label_create(ui_DiagnosticsScreen);
+        lv_obj_set_width(ui_PeerLabel, lv_pct(100));
+        lv_label_set_text(ui_PeerLabel, "");
+
+        // Latency histogram, one bar per bucket
+        ui_LatencyChart = lv_chart_create(ui_DiagnosticsScreen);
+        lv_obj_set_width(ui_LatencyChart, lv_pct(100));
+        lv_obj_set_flex_grow(ui_LatencyChart, 1);
+        lv_chart_set_type(ui_LatencyChart, LV_CHART_TYPE_BAR);
+        lv_chart_set_point_count(ui_LatencyChart, LATENCY_BUCKETS);
+        lv_chart_set_div_line_count(ui_LatencyChart, 5, 0);
+        lv_chart_set_range(ui_LatencyChart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+        ui_LatencySeries = lv_chart_add_series(ui_LatencyChart, lv_color_hex(0x009BFF), LV_CHART_AXIS_PRIMARY_Y);
+
+        lv_obj_t *lbl_buckets = lv_label_create(ui_DiagnosticsScreen);
+        lv_label_set_text_static(lbl_buckets, txt_buckets);
+        lv_obj_set_style_text_font(lbl_buckets, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        peerStatsSupported = true;
+        lastPeerStats = 0;
+        renderMax = 0;
+        peerStats = ResponseStatus();
+        linkStats = LinkStats();
+        initialized = true;
+    }
+
+    /**
+     * @brief Check if the Diagnostics GUI has been initialized
+     * @return True if initialized, false otherwise
+     */
+    bool isInitialized() const { return initialized; }
+
+    /**
+     * @brief Show the Diagnostics screen
+     */
+    void showDiagnostics()
+    {
+        init();
+    }
+
+    /**
+     * @brief Update all values
+     * @param renderTime Duration of the last LVGL render pass (us)
+     */
+    void refresh(uint32_t renderTime)
+    {
+        if (!initialized)
+            return;
+
+        if (renderTime > renderMax)
+            renderMax = renderTime;
+        updatePeerStats();
+
+        ProtocolStatsSnapshot stats = Protocol::getStats();
+        const LinkStats &link = linkStats;
+        char text[512];
+        snprintf(text, sizeof(text),
+                 "Requests: %lu   Responses: %lu   Errors: %lu   Timeouts: %lu   Late: %lu\n"
+                 "UID mismatches: %lu   Damaged frames: %lu   RX overflows: %lu   Pushed: %lu   Dropped updates: %lu\n"
+                 "Traffic: %lu B/s   Line rate: %lu baud   Timeout: %lu ms\n"
+                 "Latency mean: %.1f ms   p50: %.1f ms   p99: %.1f ms   max: %.1f ms",
+                 (unsigned long)stats.requests, (unsigned long)stats.responses, (unsigned long)stats.errors,
+                 (unsigned long)stats.timeouts, (unsigned long)stats.lateResponses,
+                 (unsigned long)stats.uidMismatches, (unsigned long)stats.framingErrors,
+                 (unsigned long)stats.rxOverflows, (unsigned long)stats.pushFrames,
+                 (unsigned long)sensorManager.getLink().getDroppedEvents(),
+                 (unsigned long)stats.bytesPerSecond(), (unsigned long)link.baudrate, (unsigned long)link.timeout,
+                 stats.meanLatency() / 1000.0, stats.percentile(50) / 1000.0,
+                 stats.percentile(99) / 1000.0, stats.latencyMax / 1000.0);
+        lv_label_set_text(ui_LinkLabel, text);
+
+        if (peerStatsSupported)
+        {
+            snprintf(text, sizeof(text),
+                     "Peer: requests %s   rejected %s   damaged %s   processing %s us   uptime %s ms\n"
+                     "Render: %.1f ms   max: %.1f ms",
+                     peerValue("rx"), peerValue("err"), peerValue("bad"), peerValue("proc"), peerValue("up"),
+                     renderTime / 1000.0, renderMax / 1000.0);
+        }
+        else
+        {
+            snprintf(text, sizeof(text), "Peer: statistics not supported\nRender: %.1f ms   max: %.1f ms",
+                     renderTime / 1000.0, renderMax / 1000.0);
+        }
+        lv_label_set_text(ui_PeerLabel, text);
+
+        // Bars in percent of all responses
+        uint32_t total = 0;
+        for (uint32_t count : stats.histogram)
+            total += count;
+        for (uint16_t i = 0; i < LATENCY_BUCKETS; i++)
+        {
+            lv_coord_t percent = total ? static_cast<lv_coord_t>(static_cast<uint64_t>(stats.histogram[i]) * 100 / total) : 0;
+            lv_chart_set_value_by_id(ui_LatencyChart, ui_LatencySeries, i, percent);
+        }
+        lv_chart_refresh(ui_LatencyChart);
+    }
+
+    /**
+     * @brief Hide the Diagnostics GUI and clean up resources
+     */
+    void hideDiagnostics()
+    {
+        if (!initialized)
+            return;
+
+        if (ui_DiagnosticsScreen)
+        {
+            lv_obj_del(ui_DiagnosticsScreen);
+            ui_DiagnosticsScreen = nullptr;
+        }
+        ui_LinkLabel = nullptr;
+        ui_PeerLabel = nullptr;
+        ui_LatencyChart = nullptr;
+        ui_LatencySeries = nullptr;
+
+        initialized = false;
+    }
+};
+
+#endif // DIAGNOSTICS_GUI_HPP
@@ -79,4 +79,12 @@ extern void switchToAppSelectionScreen();
  */
 extern void switchToCommunicationSelectionScreen();
 
+/**
+ * @brief Switch to link diagnostics screen
+ * 
+ * This function switches the GUI to the link diagnostics screen.
+ * Called from the settings section in visualization.
+ */
+extern void switchToDiagnosticsScreen();
+
 #endif // GUI_CALLBACKS_HPP
\ No newline at end of file
@@ -30,8 +30,10 @@ GuiManager::GuiManager(SensorManager &manager, DataBundleManager &dataBundleMana
       creditsGui(),
       appSelectionGui(),
       communicationSelectionGui(),
+      diagnosticsGui(manager),
       currentState(GuiState::NONE),
-      initialized(false) {
+      initialized(false),
+      renderTime(0) {
 }
 
 bool GuiManager::init(std::string configFile) {
@@ -43,6 +45,13 @@ bool GuiManager::init(std::string configFile) {
         // First initialize the crash GUI
         crashGui.init();
 
+        // SD card first, the sensor database is read from it
+        if(!dataBundleManager.init())
+        {
+            crashGui.showCrash("DataBundleManager initialization failed!");
+            return false;
+        }
+
         // Ensure SensorManager is initialized
         if(!sensorManager.init(configFile))
         {
@@ -50,12 +59,6 @@ bool GuiManager::init(std::string configFile) {
             return false;
         }             
 
-        if(!dataBundleManager.init())
-        {
-            crashGui.showCrash("DataBundleManager initialization failed!");
-            return false;
-        }
-
         // Initialize all GUI components
         menuGui.init();
         vizGui.init();
@@ -103,6 +106,7 @@ void GuiManager::hideAllComponents() {
     creditsGui.hideCredits();
     communicationSelectionGui.hideCommunicationSelection();
     appSelectionGui.hideAppSelection();
+    diagnosticsGui.hideDiagnostics();
 }
 
 void GuiManager::showMenu() {
@@ -211,6 +215,19 @@ void GuiManager::showCommunicationSelectionScreen() {
     // logMessage("Switched to COMMUNICATION_SELECTION state\n");
 }
 
+void GuiManager::showDiagnosticsScreen() {
+    if (!initialized) {
+        // logMessage("GuiManager not initialized\n");
+        return;
+    }
+
+    // Sensors keep running, the statistics show the link under load
+    hideAllComponents();
+    diagnosticsGui.showDiagnostics();
+    currentState = GuiState::DIAGNOSTICS;
+    // logMessage("Switched to DIAGNOSTICS state\n");
+}
+
 void GuiManager::switchContent(GuiState targetState) {
     if (!initialized) {
         // logMessage("GuiManager not initialized\n");
@@ -267,6 +284,10 @@ void GuiManager::switchContent(GuiState targetState) {
             showCommunicationSelectionScreen();
             break;
 
+        case GuiState::DIAGNOSTICS:
+            showDiagnosticsScreen();
+            break;
+
         default:
             // logMessage("Unknown target GUI state %d, switching to MENU\n", static_cast<int>(targetState));
             splashMessage("Unknown target GUI state %d, nothing to display...\n", static_cast<int>(targetState));
@@ -276,19 +297,35 @@ void GuiManager::switchContent(GuiState targetState) {
 }
 
 void GuiManager::redraw() {
+    unsigned long renderStart = getTimeUs();
     lv_timer_handler();
+    renderTime = static_cast<uint32_t>(getTimeUs() - renderStart);
     delay_ms(CYCLE_DRAW_MS);
 
     if (!initialized) {
         return;
     }
 
-    // Sync sensor data periodically
+    // Deliver sensor data received while rendering
+    sensorManager.poll();
+
+    // Sync sensors which are due, every sensor has its own period
+    sensorManager.resync();
+
+    // Periodic work of the screens
     if (LOOP_SYNC_COUNTER-- < 0) {
-        sensorManager.resync(); // Sync sensor data, if running
+        if (currentState == GuiState::VISUALIZATION && vizGui.isInitialized()) {
+            vizGui.recordBurst(); // Buffered samples of the recorded sensor
+        }
+        if (currentState == GuiState::DIAGNOSTICS) {
+            diagnosticsGui.refresh(renderTime);
+        }
         LOOP_SYNC_COUNTER = LOOP_SYNC_TH;   
         delay_ms(1);
     }
+
+    // Notify the screens of changed sensor data, they mark only the affected widgets to redraw
+    sensorManager.dispatchChanges();
     
     switch (currentState) {
         case GuiState::VISUALIZATION:
@@ -322,6 +359,10 @@ void GuiManager::redraw() {
         case GuiState::COMMUNICATION_SELECTION:
             // Communication selection doesn't need periodic redraw - it's event-driven
             break;
+
+        case GuiState::DIAGNOSTICS:
+            // Diagnostics are refreshed with the sensor sync above
+            break;
             
         default:
             break;
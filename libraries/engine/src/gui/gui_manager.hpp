@@ -21,6 +21,7 @@
 #include "sensor_wiki_gui.hpp"
 #include "crash_gui.hpp"
 #include "credits_gui.hpp"
+#include "diagnostics_gui.hpp"
 #include "app_selection_gui.hpp"
 #include "communication_selection_gui.hpp"
 
@@ -38,6 +39,7 @@ enum class GuiState
     CREDITS,                 ///< Credits screen
     APP_SELECTION,           ///< App selection screen
     COMMUNICATION_SELECTION, ///< Communication selection screen
+    DIAGNOSTICS,             ///< Link diagnostics screen
     NONE                     ///< Not ready / No active GUI
 };
 
@@ -60,9 +62,11 @@ private:
     CreditsGui creditsGui;                               ///< Credits screen component
     AppSelectionGui appSelectionGui;                     ///< App selection component
     CommunicationSelectionGui communicationSelectionGui; ///< Communication selection component
+    DiagnosticsGui diagnosticsGui;                       ///< Link diagnostics component
 
     GuiState currentState; ///< Current GUI state
     bool initialized;      ///< Initialization flag
+    uint32_t renderTime;   ///< Duration of the last LVGL render pass (us)
 
     /**
      * @brief Hide all GUI components
@@ -144,6 +148,11 @@ public:
      */
     void showCommunicationSelectionScreen();
 
+    /**
+     * @brief Switch to link diagnostics screen
+     */
+    void showDiagnosticsScreen();
+
     /**
      * @brief Switch content to specified GUI state
      *
@@ -157,6 +166,7 @@ public:
      * - DATA_BUNDLE_SELECTION: stops sensors (setRunning(false))
      * - CREDITS: stops sensors (setRunning(false))
      * - CRASH: stops sensors (setRunning(false))
+     * - DIAGNOSTICS: no sensor state change (the link is observed under load)
      *
      * @param targetState The GUI state to switch to
      */
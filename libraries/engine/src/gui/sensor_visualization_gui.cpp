@@ -13,6 +13,9 @@
 #include "../helpers.hpp"
 #include "./images/ui_images.h"
 
+/// Time windows of the chart (ms), 0 shows the last HISTORY_CAP samples
+static const uint32_t CHART_WINDOWS_MS[] = {0, 60000, 600000, 3600000};
+
 SensorVisualizationGui::SensorVisualizationGui(SensorManager &sensorManager, DataBundleManager &dataBundleManager) 
                                               : sensorManager(sensorManager), dataBundleManager(dataBundleManager)
 {
@@ -74,6 +77,8 @@ SensorVisualizationGui::SensorVisualizationGui(SensorManager &sensorManager, Dat
     ui_SettingsCreditsLabel = nullptr;
     ui_SettingsCreditsButton = nullptr;
     ui_SettingsCreditsButtonLabel = nullptr;
+    ui_SettingsDiagnosticsButton = nullptr;
+    ui_SettingsDiagnosticsButtonLabel = nullptr;
     ui_LogoGroup = nullptr;
     ui_LogoCornerBottomLeft = nullptr;
     ui_LogoCornerFillBottomLeft = nullptr;
@@ -296,8 +301,12 @@ void SensorVisualizationGui::constructVisualization()
     lv_obj_set_x(ui_Chart, 150);
     lv_obj_set_y(ui_Chart, 20);
     lv_obj_set_align(ui_Chart, LV_ALIGN_CENTER);
-    lv_obj_clear_flag(ui_Chart, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_PRESS_LOCK | LV_OBJ_FLAG_CLICK_FOCUSABLE |
+    lv_obj_clear_flag(ui_Chart, LV_OBJ_FLAG_PRESS_LOCK | LV_OBJ_FLAG_CLICK_FOCUSABLE |
                                     LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_SNAPPABLE);
+    lv_obj_add_event_cb(ui_Chart, [](lv_event_t *e)
+                        {
+        auto self = static_cast<SensorVisualizationGui*>(lv_event_get_user_data(e));
+        self->handleChartClick(); }, LV_EVENT_CLICKED, this);
     lv_chart_set_type(ui_Chart, LV_CHART_TYPE_LINE);
     lv_chart_set_div_line_count(ui_Chart, HISTORY_CAP - 1, HISTORY_CAP);
     lv_chart_set_axis_tick(ui_Chart, LV_CHART_AXIS_PRIMARY_X, HISTORY_CAP / 2, 0, HISTORY_CAP, 1, true, 50);
@@ -735,19 +744,88 @@ void SensorVisualizationGui::drawCurrentSensor()
         return;
     }
 
-    // // logMessage("Drawing sensor: %s\n", currentSensor->UID.c_str());
-    if (!currentSensor->getRedrawPending())
+    // Changes are kept while paused, the sync button draws them
+    if (paused || dirty == 0)
     {
         return;
     }
 
-    if (paused)
+    applyChanges();
+}
+
+void SensorVisualizationGui::watchCurrentSensor()
+{
+    ChangeBus &bus = getChangeBus();
+    for (auto &subscription : valueSubscriptions)
     {
+        bus.unsubscribe(subscription);
+        subscription = 0;
+    }
+    dirty = DIRTY_ALL; // Switched sensor is drawn whole once
+
+    if (!currentSensor)
         return;
+
+    // Only the two displayed values are watched, other parameters do not wake the screen
+    const SensorSnapshot &snapshot = currentSensor->getSnapshot();
+    for (size_t i = 0; i < snapshot.count && i < 2; i++)
+    {
+        const std::string &key = currentSensor->getValues().at(i).first; // Whole key, not the snapshot copy
+        uint8_t keyId = snapshot.values[i].keyId;
+        uint8_t flag = i == 0 ? DIRTY_VALUE_1 : DIRTY_VALUE_2;
+        valueSubscriptions[i] = bus.subscribe(currentSensor->getHandle(), keyId,
+                                              [this, key, keyId, flag](const SensorChange &change) {
+            if (keyId == CHANGE_ANY_KEY && *change.key != key)
+                return; // Other parameter of the sensor (sent by name)
+            dirty |= flag | DIRTY_CHART;
+        });
     }
+}
 
+void SensorVisualizationGui::applyChanges()
+{
     updateSensorDataDisplay();
-    updateChart();
+    if (dirty & DIRTY_CHART)
+    {
+        updateChart();
+    }
+    if (recording && !burstSupported)
+    {
+        recordSamples(); // Values received since the last draw
+    }
+    dirty = 0;
+}
+
+void SensorVisualizationGui::recordBurst()
+{
+    if (!currentSensor || !recording || paused || !burstSupported || burstPending)
+        return;
+
+    BaseSensor *sensor = currentSensor;
+    BurstDoneHandler onDone = [this, sensor](bool received) {
+        burstPending = false;
+        if (sensor != currentSensor || !recording)
+            return; // Recording ended meanwhile
+
+        if (received)
+        {
+            dirty |= DIRTY_CHART;
+            recordSamples(); // Samples are pushed to the value history
+        }
+        else
+        {
+            // logMessage("BURST refused, recording current values\n");
+            burstSupported = false;
+            sensor->setBurstHistory(false);
+            sensor->clearError();
+        }
+    };
+
+    burstPending = true;
+    if (!sensorManager.getLink().post([sensor, onDone]() { burstSensorAsync(sensor, MAX_BURST_SAMPLES, onDone); }))
+    {
+        burstPending = false; // Link busy, tried again next time
+    }
 }
 
 void SensorVisualizationGui::updateSensorDataDisplay()
@@ -756,34 +834,38 @@ void SensorVisualizationGui::updateSensorDataDisplay()
         return;
 
     // Update sensor name
-    if (ui_SensorLabel)
+    if ((dirty & DIRTY_LAYOUT) && ui_SensorLabel)
     {
         lv_obj_set_x(ui_SensorLabel, -(lv_obj_get_width(ui_SensorLabel) / 6)); // Center the label
         lv_label_set_text(ui_SensorLabel, currentSensor->getName().c_str());
     }
 
-    // Get all sensor values
-    auto values = currentSensor->getValues();
-    auto valueKeys = currentSensor->getValuesKeys();
+    // Values published by the sensor, read without copying them
+    const SensorSnapshot &snapshot = currentSensor->getSnapshot();
 
-    if (valueKeys.empty())
+    if (snapshot.count == 0)
     {
         // logMessage("No values available for sensor: %s\n", currentSensor->UID.c_str());
         return;
     }
 
     // Update Value 1 (primary value)
-    if (valueKeys.size() >= 1 && ui_LabelValueValue_1 && ui_LabelDescValue_1 && ui_LabelTypeValue_1)
+    if (snapshot.count >= 1 && ui_LabelValueValue_1 && ui_LabelDescValue_1 && ui_LabelTypeValue_1)
     {
-        const std::string &key1 = valueKeys[0];
+        const SnapshotValue &value1 = snapshot.values[0];
         try
         {
-            std::string value1 = currentSensor->getValue<std::string>(key1);
-            std::string units1 = currentSensor->getValueUnits(key1);
-
-            lv_label_set_text(ui_LabelValueValue_1, value1.c_str());
-            lv_label_set_text(ui_LabelDescValue_1, units1.empty() ? "" : ("[" + units1 + "]").c_str());
-            lv_label_set_text(ui_LabelTypeValue_1, key1.c_str());
+            if (dirty & DIRTY_VALUE_1)
+            {
+                // Long text was cut in the snapshot
+                lv_label_set_text(ui_LabelValueValue_1, value1.textCut ? currentSensor->getValues().at(0).second.Value.c_str() : value1.text);
+            }
+            if (dirty & DIRTY_LAYOUT)
+            {
+                const std::string units1 = value1.unit;
+                lv_label_set_text(ui_LabelDescValue_1, units1.empty() ? "" : ("[" + units1 + "]").c_str());
+                lv_label_set_text(ui_LabelTypeValue_1, value1.key);
+            }
         }
         catch (const std::exception &e)
         {
@@ -792,22 +874,27 @@ void SensorVisualizationGui::updateSensorDataDisplay()
     }
 
     // Update Value 2 (secondary value, if available)
-    if (valueKeys.size() >= 2 && ui_LabelValueValue_2 && ui_LabelDescValue_2 && ui_LabelTypeValue_2)
+    if (snapshot.count >= 2 && ui_LabelValueValue_2 && ui_LabelDescValue_2 && ui_LabelTypeValue_2)
     {
-        const std::string &key2 = valueKeys[1];
+        const SnapshotValue &value2 = snapshot.values[1];
         try
         {
-            std::string value2 = currentSensor->getValue<std::string>(key2);
-            std::string units2 = currentSensor->getValueUnits(key2);
-
-            lv_label_set_text(ui_LabelValueValue_2, value2.c_str());
-            lv_label_set_text(ui_LabelDescValue_2, units2.empty() ? "" : ("[" + units2 + "]").c_str());
-            lv_label_set_text(ui_LabelTypeValue_2, key2.c_str());
-
-            // Make second container visible
-            if (ui_ContainerForValue_2)
+            if (dirty & DIRTY_VALUE_2)
             {
-                lv_obj_clear_flag(ui_ContainerForValue_2, LV_OBJ_FLAG_HIDDEN);
+                // Long text was cut in the snapshot
+                lv_label_set_text(ui_LabelValueValue_2, value2.textCut ? currentSensor->getValues().at(1).second.Value.c_str() : value2.text);
+            }
+            if (dirty & DIRTY_LAYOUT)
+            {
+                const std::string units2 = value2.unit;
+                lv_label_set_text(ui_LabelDescValue_2, units2.empty() ? "" : ("[" + units2 + "]").c_str());
+                lv_label_set_text(ui_LabelTypeValue_2, value2.key);
+
+                // Make second container visible
+                if (ui_ContainerForValue_2)
+                {
+                    lv_obj_clear_flag(ui_ContainerForValue_2, LV_OBJ_FLAG_HIDDEN);
+                }
             }
         }
         catch (const std::exception &e)
@@ -815,7 +902,7 @@ void SensorVisualizationGui::updateSensorDataDisplay()
             // logMessage("Error updating value 2: %s\n", e.what());
         }
     }
-    else
+    else if (dirty & DIRTY_LAYOUT)
     {
         // Hide second value container if not needed
         if (ui_ContainerForValue_2)
@@ -827,163 +914,90 @@ void SensorVisualizationGui::updateSensorDataDisplay()
     // logMessage("Updated sensor data display for: %s\n", currentSensor->UID.c_str());
 }
 
+bool SensorVisualizationGui::buildSensorHistory(const std::string &key, lv_coord_t *history)
+{
+    const SampleHistory &samples = currentSensor->getSamples(key);
+    if (samples.size() == 0)
+        return false;
+
+    SampleBucket columns[HISTORY_CAP];
+    size_t count;
+    uint32_t window = CHART_WINDOWS_MS[chartWindow];
+    if (window == 0)
+    {
+        size_t last = samples.size() < HISTORY_CAP ? samples.size() : HISTORY_CAP;
+        count = samples.decimate(samples.size() - last, last, HISTORY_CAP, columns);
+    }
+    else
+    {
+        // Window ends with the newest sample, long windows are read from the pyramid
+        uint32_t end = samples.timeAt(samples.size() - 1) + 1;
+        count = samples.window(end > window ? end - window : 0, end, HISTORY_CAP, columns);
+    }
+    if (count == 0)
+        return false;
+
+    size_t pad = HISTORY_CAP - count;
+    for (size_t i = 0; i < HISTORY_CAP; i++)
+    {
+        history[i] = static_cast<lv_coord_t>(columns[i < pad ? 0 : i - pad].mean);
+    }
+    return true;
+}
+
+void SensorVisualizationGui::handleChartClick()
+{
+    chartWindow = (chartWindow + 1) % (sizeof(CHART_WINDOWS_MS) / sizeof(CHART_WINDOWS_MS[0]));
+    dirty |= DIRTY_CHART;
+    if (!paused)
+    {
+        applyChanges();
+    }
+}
+
 void SensorVisualizationGui::updateChart()
 {
     if (!currentSensor || !ui_Chart || !ui_Chart_series_V1)
         return;
 
-    if (sensorManager.isRedrawPending() == false)
-        return;
-
     // Get sensor value keys
-    auto valueKeys = currentSensor->getValuesKeys();
-    if (valueKeys.empty())
+    const SensorSnapshot &snapshot = currentSensor->getSnapshot();
+    if (snapshot.count == 0)
         return;
 
-    const std::string &primaryKey = valueKeys[0];
-
     try
     {
         lv_coord_t history[HISTORY_CAP];
-
-        auto values = currentSensor->getValues();
-        auto it = values.find(primaryKey);
-        if (it == values.end())
-            return;
-
-        SensorDataType dataType = it->second.DType;
-
-        switch (dataType)
-        {
-        case SensorDataType::INT:
-            buildSensorHistory<int>(currentSensor, primaryKey, history);
-            break;
-        case SensorDataType::FLOAT:
-            buildSensorHistory<float>(currentSensor, primaryKey, history);
-            break;
-        case SensorDataType::DOUBLE:
-            buildSensorHistory<double>(currentSensor, primaryKey, history);
-            break;
-        case SensorDataType::STRING:
-            try
-            {
-                buildSensorHistory<int>(currentSensor, primaryKey, history);
-            }
-            catch (...)
-            {
-                try
-                {
-                    buildSensorHistory<float>(currentSensor, primaryKey, history);
-                }
-                catch (...)
-                {
-                    return;
-                }
-            }
-            break;
-        default:
+        lv_coord_t history2[HISTORY_CAP];
+        if (!buildSensorHistory(currentSensor->getValues().at(0).first, history))
             return;
-        }
+        bool haveSecond = snapshot.count >= 2 && ui_Chart_series_V2 && buildSensorHistory(currentSensor->getValues().at(1).first, history2);
 
         // Dynamic Y range for Chart based on history data
-        if (HISTORY_CAP <= 0)
-            return;
-        lv_coord_t min1 = history[0];
-        lv_coord_t max1 = history[0];
-        for (int i = 1; i < HISTORY_CAP; ++i)
+        lv_coord_t global_min = history[0];
+        lv_coord_t global_max = history[0];
+        for (int i = 0; i < HISTORY_CAP; ++i)
         {
-            if (history[i] < min1)
-                min1 = history[i];
-            if (history[i] > max1)
-                max1 = history[i];
+            if (history[i] < global_min)
+                global_min = history[i];
+            if (history[i] > global_max)
+                global_max = history[i];
+            if (haveSecond && history2[i] < global_min)
+                global_min = history2[i];
+            if (haveSecond && history2[i] > global_max)
+                global_max = history2[i];
         }
 
-        if (min1 == max1)
+        if (global_min == global_max)
         {
-            min1 = min1 - 1;
-            max1 = max1 + 1;
+            global_min = global_min - 1;
+            global_max = global_max + 1;
         }
 
-        lv_coord_t span1 = max1 - min1;
-        lv_coord_t pad1 = (span1 / 10) > 1 ? (span1 / 10) : 1;
-        lv_coord_t range_min1 = min1 - pad1;
-        lv_coord_t range_max1 = max1 + pad1;
-
-        bool haveSecond = (valueKeys.size() >= 2 && ui_Chart_series_V2);
-        lv_coord_t range_min2 = range_min1;
-        lv_coord_t range_max2 = range_max1;
-        if (haveSecond)
-        {
-            const std::string &secondaryKey = valueKeys[1];
-            lv_coord_t history2[HISTORY_CAP];
-            auto it2 = values.find(secondaryKey);
-            if (it2 != values.end())
-            {
-                SensorDataType dataType2 = it2->second.DType;
-                try
-                {
-                    switch (dataType2)
-                    {
-                    case SensorDataType::INT:
-                        buildSensorHistory<int>(currentSensor, secondaryKey, history2);
-                        break;
-                    case SensorDataType::FLOAT:
-                        buildSensorHistory<float>(currentSensor, secondaryKey, history2);
-                        break;
-                    case SensorDataType::DOUBLE:
-                        buildSensorHistory<double>(currentSensor, secondaryKey, history2);
-                        break;
-                    case SensorDataType::STRING:
-                        try
-                        {
-                            buildSensorHistory<int>(currentSensor, secondaryKey, history2);
-                        }
-                        catch (...)
-                        {
-                            buildSensorHistory<float>(currentSensor, secondaryKey, history2);
-                        }
-                        break;
-                    default:
-                        haveSecond = false;
-                        break;
-                    }
-                }
-                catch (...)
-                {
-                    haveSecond = false;
-                }
-
-                if (haveSecond)
-                {
-                    lv_coord_t min2 = history2[0];
-                    lv_coord_t max2 = history2[0];
-                    for (int i = 1; i < HISTORY_CAP; ++i)
-                    {
-                        if (history2[i] < min2)
-                            min2 = history2[i];
-                        if (history2[i] > max2)
-                            max2 = history2[i];
-                    }
-                    if (min2 == max2)
-                    {
-                        min2 = min2 - 1;
-                        max2 = max2 + 1;
-                    }
-                    lv_coord_t span2 = max2 - min2;
-                    lv_coord_t pad2 = (span2 / 10) > 1 ? (span2 / 10) : 1;
-                    range_min2 = min2 - pad2;
-                    range_max2 = max2 + pad2;
-                }
-            }
-            else
-            {
-                haveSecond = false;
-            }
-        }
-        lv_coord_t global_min = (range_min1 < range_min2) ? range_min1 : range_min2;
-        lv_coord_t global_max = (range_max1 > range_max2) ? range_max1 : range_max2;
-        lv_chart_set_range(ui_Chart, LV_CHART_AXIS_PRIMARY_Y, global_min, global_max);
-        lv_chart_set_range(ui_Chart, LV_CHART_AXIS_SECONDARY_Y, global_min, global_max);
+        lv_coord_t span = global_max - global_min;
+        lv_coord_t pad = (span / 10) > 1 ? (span / 10) : 1;
+        lv_chart_set_range(ui_Chart, LV_CHART_AXIS_PRIMARY_Y, global_min - pad, global_max + pad);
+        lv_chart_set_range(ui_Chart, LV_CHART_AXIS_SECONDARY_Y, global_min - pad, global_max + pad);
 
         lv_chart_set_all_value(ui_Chart, ui_Chart_series_V1, LV_CHART_POINT_NONE);
         lv_chart_set_all_value(ui_Chart, ui_Chart_series_V2, LV_CHART_POINT_NONE);
@@ -995,40 +1009,9 @@ void SensorVisualizationGui::updateChart()
 
         if (haveSecond)
         {
-            const std::string &secondaryKey = valueKeys[1];
-            lv_coord_t history2[HISTORY_CAP];
-            auto it2 = values.find(secondaryKey);
-            if (it2 != values.end())
+            for (int i = 0; i < HISTORY_CAP; i++)
             {
-                SensorDataType dataType2 = it2->second.DType;
-                switch (dataType2)
-                {
-                case SensorDataType::INT:
-                    buildSensorHistory<int>(currentSensor, secondaryKey, history2);
-                    break;
-                case SensorDataType::FLOAT:
-                    buildSensorHistory<float>(currentSensor, secondaryKey, history2);
-                    break;
-                case SensorDataType::DOUBLE:
-                    buildSensorHistory<double>(currentSensor, secondaryKey, history2);
-                    break;
-                case SensorDataType::STRING:
-                    try
-                    {
-                        buildSensorHistory<int>(currentSensor, secondaryKey, history2);
-                    }
-                    catch (...)
-                    {
-                        buildSensorHistory<float>(currentSensor, secondaryKey, history2);
-                    }
-                    break;
-                default:
-                    break;
-                }
-                for (int i = 0; i < HISTORY_CAP; i++)
-                {
-                    lv_chart_set_next_value(ui_Chart, ui_Chart_series_V2, history2[i]);
-                }
+                lv_chart_set_next_value(ui_Chart, ui_Chart_series_V2, history2[i]);
             }
         }
 
@@ -1041,6 +1024,49 @@ void SensorVisualizationGui::updateChart()
     }
 }
 
+void SensorVisualizationGui::markRecordedSamples()
+{
+    recordedMarks.clear();
+    if (!currentSensor)
+        return;
+
+    for (const auto &v : currentSensor->getValues())
+    {
+        recordedMarks[v.first] = v.second.Samples.getTotal();
+    }
+}
+
+void SensorVisualizationGui::recordSamples()
+{
+    if (!currentSensor || !recording)
+        return;
+
+    char text[32];
+    for (const auto &v : currentSensor->getValues())
+    {
+        const std::string &key = v.first;
+        const SampleHistory &samples = v.second.Samples;
+        uint32_t &mark = recordedMarks[key];
+        for (size_t i = samples.size() - samples.newerThan(mark); i < samples.size(); i++)
+        {
+            switch (samples.getType())
+            {
+            case SensorDataType::INT:
+                snprintf(text, sizeof(text), "%ld", static_cast<long>(samples.at(i)));
+                break;
+            case SensorDataType::FLOAT:
+                snprintf(text, sizeof(text), "%.7g", samples.at(i));
+                break;
+            default:
+                snprintf(text, sizeof(text), "%.15g", samples.at(i));
+                break;
+            }
+            dataBundleManager.saveNewDataPoint(key, text, samples.timeAt(i));
+        }
+        mark = samples.getTotal();
+    }
+}
+
 void SensorVisualizationGui::handleBackButtonClick(){
     if(recording){
         handleStillRecording();
@@ -1087,6 +1113,7 @@ void SensorVisualizationGui::handleRecordButtonClick(const char *message)
 
     if (recording)
     {
+        currentSensor->setBurstHistory(false);
         dataBundleManager.saveRecording();
         lv_obj_set_style_bg_color(ui_btnRecord, lv_color_hex(0x009BFF), LV_PART_MAIN | LV_STATE_DEFAULT);
         lv_obj_set_style_bg_color(ui_btnPrev, lv_color_hex(0x009BFF), LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -1097,6 +1124,10 @@ void SensorVisualizationGui::handleRecordButtonClick(const char *message)
     else
     {
         dataBundleManager.startRecording(currentSensor->Type);
+        markRecordedSamples(); // Samples received before are not recorded
+        burstSupported = true; // Try samples buffered by the sensor first
+        burstPending = false;  // A lost result does not stop the next recording
+        currentSensor->setBurstHistory(true); // Updated values would interleave with the older samples
         lv_obj_set_style_bg_color(ui_btnRecord, lv_color_hex(0xE55858), LV_PART_MAIN | LV_STATE_DEFAULT);
         lv_obj_set_style_bg_color(ui_btnPrev, lv_color_hex(0x949494), LV_PART_MAIN | LV_STATE_DEFAULT);
         lv_obj_set_style_bg_color(ui_btnNext, lv_color_hex(0x949494), LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -1163,15 +1194,9 @@ void SensorVisualizationGui::handleClearConfirmButtonClick()
 {
     if (currentSensor)
     {
-        // Clear sensor internal history
+        // Clear sensor internal history (chart samples)
         currentSensor->clearHistory();
 
-        // Clear per-key buffers and set them to zero
-        for (auto &v : currentSensor->getValuesKeys())
-        {
-            clearSensorHistoryBuffer(v);
-        }
-
         if (ui_Chart && ui_Chart_series_V1)
             lv_chart_set_all_value(ui_Chart, ui_Chart_series_V1, 0);
         if (ui_Chart && ui_Chart_series_V2)
@@ -1239,7 +1264,7 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     ui_SettingsGroup = lv_obj_create(ui_SettingsOverlay);
     lv_obj_remove_style_all(ui_SettingsGroup);
     lv_obj_set_width(ui_SettingsGroup, 250);
-    lv_obj_set_height(ui_SettingsGroup, 225);
+    lv_obj_set_height(ui_SettingsGroup, 255);
     lv_obj_set_x(ui_SettingsGroup, -7);
     lv_obj_set_y(ui_SettingsGroup, 25);
     lv_obj_set_align(ui_SettingsGroup, LV_ALIGN_TOP_RIGHT);
@@ -1250,7 +1275,7 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     ui_SettingsOutlay = lv_obj_create(ui_SettingsGroup);
     lv_obj_remove_style_all(ui_SettingsOutlay);
     lv_obj_set_width(ui_SettingsOutlay, 250);
-    lv_obj_set_height(ui_SettingsOutlay, 200);
+    lv_obj_set_height(ui_SettingsOutlay, 230);
     lv_obj_set_align(ui_SettingsOutlay, LV_ALIGN_BOTTOM_MID);
     lv_obj_clear_flag(ui_SettingsOutlay, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_set_style_radius(ui_SettingsOutlay, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -1284,7 +1309,7 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     lv_obj_set_width(ui_SettingsDataBundleLabel, LV_SIZE_CONTENT);
     lv_obj_set_height(ui_SettingsDataBundleLabel, LV_SIZE_CONTENT);
     lv_obj_set_x(ui_SettingsDataBundleLabel, 10);
-    lv_obj_set_y(ui_SettingsDataBundleLabel, -40);
+    lv_obj_set_y(ui_SettingsDataBundleLabel, -55);
     lv_obj_set_align(ui_SettingsDataBundleLabel, LV_ALIGN_LEFT_MID);
     lv_label_set_text(ui_SettingsDataBundleLabel, "Data bundle:");
     lv_obj_set_style_text_color(ui_SettingsDataBundleLabel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -1293,7 +1318,7 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     lv_obj_set_width(ui_SettingsDataBundleShowButton, 200);
     lv_obj_set_height(ui_SettingsDataBundleShowButton, 20);
     lv_obj_set_x(ui_SettingsDataBundleShowButton, 17);
-    lv_obj_set_y(ui_SettingsDataBundleShowButton, -17);
+    lv_obj_set_y(ui_SettingsDataBundleShowButton, -32);
     lv_obj_set_align(ui_SettingsDataBundleShowButton, LV_ALIGN_LEFT_MID);
     lv_obj_add_flag(ui_SettingsDataBundleShowButton, LV_OBJ_FLAG_SCROLL_ON_FOCUS);
     lv_obj_clear_flag(ui_SettingsDataBundleShowButton, LV_OBJ_FLAG_SCROLLABLE);
@@ -1313,7 +1338,7 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     lv_obj_set_width(ui_SettingsDataBundleDeleteAllButton, 200);
     lv_obj_set_height(ui_SettingsDataBundleDeleteAllButton, 20);
     lv_obj_set_x(ui_SettingsDataBundleDeleteAllButton, 17);
-    lv_obj_set_y(ui_SettingsDataBundleDeleteAllButton, 10);
+    lv_obj_set_y(ui_SettingsDataBundleDeleteAllButton, -5);
     lv_obj_set_align(ui_SettingsDataBundleDeleteAllButton, LV_ALIGN_LEFT_MID);
     lv_obj_add_flag(ui_SettingsDataBundleDeleteAllButton, LV_OBJ_FLAG_SCROLL_ON_FOCUS);
     lv_obj_clear_flag(ui_SettingsDataBundleDeleteAllButton, LV_OBJ_FLAG_SCROLLABLE);
@@ -1335,7 +1360,7 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     lv_obj_set_width(ui_SettingsCreditsLabel, LV_SIZE_CONTENT);
     lv_obj_set_height(ui_SettingsCreditsLabel, LV_SIZE_CONTENT);
     lv_obj_set_x(ui_SettingsCreditsLabel, 10);
-    lv_obj_set_y(ui_SettingsCreditsLabel, 37);
+    lv_obj_set_y(ui_SettingsCreditsLabel, 22);
     lv_obj_set_align(ui_SettingsCreditsLabel, LV_ALIGN_LEFT_MID);
     lv_label_set_text(ui_SettingsCreditsLabel, "About Icons:");
 
@@ -1343,7 +1368,7 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     lv_obj_set_width(ui_SettingsCreditsButton, 200);
     lv_obj_set_height(ui_SettingsCreditsButton, 20);
     lv_obj_set_x(ui_SettingsCreditsButton, 17);
-    lv_obj_set_y(ui_SettingsCreditsButton, 60);
+    lv_obj_set_y(ui_SettingsCreditsButton, 45);
     lv_obj_set_align(ui_SettingsCreditsButton, LV_ALIGN_LEFT_MID);
     lv_obj_set_style_radius(ui_SettingsCreditsButton, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_add_event_cb(ui_SettingsCreditsButton, [](lv_event_t *e)
@@ -1356,6 +1381,24 @@ void SensorVisualizationGui::handleSettingsButtonClick(lv_obj_t *recordGroup, lv
     lv_obj_set_height(ui_SettingsCreditsButtonLabel, LV_SIZE_CONTENT);
     lv_obj_set_align(ui_SettingsCreditsButtonLabel, LV_ALIGN_CENTER);
     lv_label_set_text(ui_SettingsCreditsButtonLabel, "View About Icons");
+
+    ui_SettingsDiagnosticsButton = lv_btn_create(ui_SettingsGroup);
+    lv_obj_set_width(ui_SettingsDiagnosticsButton, 200);
+    lv_obj_set_height(ui_SettingsDiagnosticsButton, 20);
+    lv_obj_set_x(ui_SettingsDiagnosticsButton, 17);
+    lv_obj_set_y(ui_SettingsDiagnosticsButton, 72);
+    lv_obj_set_align(ui_SettingsDiagnosticsButton, LV_ALIGN_LEFT_MID);
+    lv_obj_set_style_radius(ui_SettingsDiagnosticsButton, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(ui_SettingsDiagnosticsButton, [](lv_event_t *e)
+                        {
+        auto * self = static_cast<SensorVisualizationGui*>(lv_event_get_user_data(e));
+        self->handleDiagnosticsButtonClick(); }, LV_EVENT_CLICKED, this);
+
+    ui_SettingsDiagnosticsButtonLabel = lv_label_create(ui_SettingsDiagnosticsButton);
+    lv_obj_set_width(ui_SettingsDiagnosticsButtonLabel, LV_SIZE_CONTENT);
+    lv_obj_set_height(ui_SettingsDiagnosticsButtonLabel, LV_SIZE_CONTENT);
+    lv_obj_set_align(ui_SettingsDiagnosticsButtonLabel, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_SettingsDiagnosticsButtonLabel, "View Link Diagnostics");
 }
 
 void SensorVisualizationGui::handleDataBundleShowButtonClick(){
@@ -1416,6 +1459,15 @@ void SensorVisualizationGui::handleCreditsButtonClick(){
     switchToCreditsScreen();
 }
 
+void SensorVisualizationGui::handleDiagnosticsButtonClick(){
+    if(recording){
+        handleStillRecording();
+        return;
+    }
+    hideSettingsPanel();
+    switchToDiagnosticsScreen();
+}
+
 void SensorVisualizationGui::handleStillRecording(){
     if(!recording) return;
 
@@ -1481,6 +1533,7 @@ void SensorVisualizationGui::goToPreviousSensor()
 
     sensorManager.setRunning(false); // Pause any ongoing sensor updates
     currentSensor = sensorManager.previousSensor();
+    watchCurrentSensor();
     delay_ms(10);                   // Small delay to ensure UI responsiveness
     sensorManager.setRunning(true); // Resume sensor updates
 }
@@ -1492,6 +1545,7 @@ void SensorVisualizationGui::goToNextSensor()
 
     sensorManager.setRunning(false); // Pause any ongoing sensor updates
     currentSensor = sensorManager.nextSensor();
+    watchCurrentSensor();
     delay_ms(10);                   // Small delay to ensure UI responsiveness
     sensorManager.setRunning(true); // Resume sensor updates
 }
@@ -1501,6 +1555,7 @@ void SensorVisualizationGui::goToFirstSensor()
     sensorManager.setRunning(false); // Pause any ongoing sensor updates
     sensorManager.resetCurrentIndex();
     currentSensor = sensorManager.getCurrentSensor();
+    watchCurrentSensor();
     delay_ms(10);                   // Small delay to ensure UI responsiveness
     sensorManager.setRunning(true); // Resume sensor updates
 }
@@ -1513,14 +1568,12 @@ bool SensorVisualizationGui::syncCurrentSensor()
         return false;
     }
 
-    // // logMessage("Drawing sensor: %s\n", currentSensor->UID.c_str());
-    if (!currentSensor->getRedrawPending())
+    if (dirty == 0)
     {
-        return false;
+        return false; // Nothing changed since the last draw
     }
 
-    updateSensorDataDisplay();
-    updateChart();
+    applyChanges();
     return true;
 }
 
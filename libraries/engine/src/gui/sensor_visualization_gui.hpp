@@ -13,7 +13,6 @@
 #define SENSOR_VISUALIZATION_GUI_HPP
 
 #include "lvgl.h"
-#include <array>
 #include <map>
 
 #include "gui_callbacks.hpp"
@@ -38,13 +37,31 @@ private:
     DataBundleManager &dataBundleManager;///< Reference to the databundle manager instance
     BaseSensor *currentSensor = nullptr; ///< Currently visualized sensor
 
-    /// Static buffers for chart data
-    std::map<std::string, std::array<lv_coord_t, HISTORY_CAP>> bufMap;
-    std::map<std::string, bool> initedMap;
+    /// Samples of each value recorded so far (SampleHistory::getTotal() when recorded last time)
+    std::map<std::string, uint32_t> recordedMarks;
 
     bool initialized = false; ///< Initialization state flag
     bool paused = false;      ///< Pause state flag
     bool recording = false;   ///< Recording state flag
+    bool burstSupported = true; ///< Samples are recorded by BURST, current values are recorded otherwise
+    bool burstPending = false;  ///< BURST request posted to the link, samples not delivered yet
+    uint8_t chartWindow = 0;    ///< Time window of the chart (index into CHART_WINDOWS_MS), changed by tapping the chart
+
+    /**
+     * @enum DirtyFlag
+     * @brief Widgets to redraw, set by the change notifications of the current sensor.
+     */
+    enum DirtyFlag : uint8_t
+    {
+        DIRTY_LAYOUT = 1,  ///< Sensor name, keys and units (sensor switched)
+        DIRTY_VALUE_1 = 2, ///< First value label
+        DIRTY_VALUE_2 = 4, ///< Second value label
+        DIRTY_CHART = 8,   ///< Chart
+        DIRTY_ALL = DIRTY_LAYOUT | DIRTY_VALUE_1 | DIRTY_VALUE_2 | DIRTY_CHART
+    };
+
+    uint8_t dirty = DIRTY_ALL;                         ///< Widgets to redraw (DirtyFlag)
+    ChangeSubscription valueSubscriptions[2] = {0, 0}; ///< Subscriptions to the displayed values
 
     // --- SENSOR VISUALIZATION MEMBERS ---
     lv_obj_t *ui_SensorWidget; ///< Widget for sensor visualisation
@@ -112,6 +129,8 @@ private:
     lv_obj_t *ui_SettingsCreditsLabel;                   ///< Credits label
     lv_obj_t *ui_SettingsCreditsButton;                  ///< Credits button
     lv_obj_t *ui_SettingsCreditsButtonLabel;             ///< Credits button label
+    lv_obj_t *ui_SettingsDiagnosticsButton;              ///< Link diagnostics button
+    lv_obj_t *ui_SettingsDiagnosticsButtonLabel;         ///< Link diagnostics button label
     lv_obj_t *ui_LogoGroup;                              ///< Logo panel widget
     lv_obj_t *ui_LogoCornerBottomLeft;                   ///< Decorative corner for logo panel
     lv_obj_t *ui_LogoCornerFillBottomLeft;               ///< Decorative fill for logo
@@ -147,86 +166,42 @@ private:
     void addLogoPanelToWidget(lv_obj_t *parentWidget);
 
     /**
-     * @brief Build sensor history data for chart display
-     * @param sensor Pointer to the sensor
+     * @brief Build sensor history data for chart display from the samples of a value
+     * The last HISTORY_CAP samples, or means of HISTORY_CAP columns of the chart time window
+     * (see SampleHistory::window()). Fewer columns than chart points are padded with the oldest one
      * @param key The key of the sensor parameter
-     * @param history The history array to store the history
+     * @param history The history array (HISTORY_CAP points) to store the history
+     * @return false if the value has no samples
      */
-    template <typename T>
-    void buildSensorHistory(BaseSensor *sensor, const std::string &key, lv_coord_t *history)
-    {
-        if (!history || !sensor)
-            return;
-
-        auto it = sensor->getValues().find(key);
-        if (it == sensor->getValues().end())
-            return;
-
-        // Static storage between calls
-        auto &buf = bufMap[key];
-        bool &inited = initedMap[key];
-
-        // Get current value as string and convert
-        lv_coord_t curr;
-        try
-        {
-            std::string s = sensor->getValue<std::string>(key);
-            curr = convertStringToType<T>(s);
-
-            if(recording){
-                dataBundleManager.saveNewDataPoint(key, s);
-            }   
-        }
-        catch (const std::exception &e)
-        {
-            throw InvalidDataTypeException("SensorVisualizationGui::buildSensorHistory", e.what());
-        }
-
-        if (!inited)
-        {
-            // First call: fill entire buffer with current value
-            for (int i = 0; i < HISTORY_CAP; ++i)
-            {
-                buf[i] = curr;
-            }
-            inited = true;
-        }
-        else
-        {
-            // Shift left by one position
-            for (int i = 0; i < HISTORY_CAP - 1; ++i)
-            {
-                buf[i] = buf[i + 1];
-            }
-            // Add current value at the end
-            buf[HISTORY_CAP - 1] = curr;
-        }
-
-        // Copy entire buffer to output array
-        for (int i = 0; i < HISTORY_CAP; ++i)
-        {
-            try
-            {
-                history[i] = buf[i];
-            }
-            catch (const std::exception &e)
-            {
-                throw InvalidDataTypeException("SensorVisualizationGui::buildSensorHistory", e.what());
-            }
-        }
-    }
-
-    void clearSensorHistoryBuffer(const std::string &key)
-    {
-        std::array<lv_coord_t, HISTORY_CAP> zeroBuf;
-        zeroBuf.fill(0);
+    bool buildSensorHistory(const std::string &key, lv_coord_t *history);
 
-        bufMap[key] = zeroBuf;
-        initedMap[key] = true;
-    }
+    /**
+     * @brief Switch the chart to the next time window
+     */
+    void handleChartClick();
 
     /**
-     * @brief Update sensor data display
+     * @brief Start recording at the samples received so far
+     */
+    void markRecordedSamples();
+
+    /**
+     * @brief Save samples of the current sensor received since the last call to the recording
+     */
+    void recordSamples();
+
+    /**
+     * @brief Subscribe to the displayed values of the current sensor, called when it is switched
+     */
+    void watchCurrentSensor();
+
+    /**
+     * @brief Redraw the widgets marked dirty and clear the marks
+     */
+    void applyChanges();
+
+    /**
+     * @brief Update sensor data display (dirty labels only)
      */
     void updateSensorDataDisplay();
 
@@ -273,6 +248,13 @@ public:
      */
     void drawCurrentSensor();
 
+    /**
+     * @brief Fetch samples buffered by the current sensor (BURST) into its history and the recording
+     * Called periodically while recording, falls back to recording current values if the peer refuses it.
+     * The request is posted to the link, the samples are recorded when poll() delivers them.
+     */
+    void recordBurst();
+
     /**
      * @brief Go to the previous sensor in the list
      */
@@ -341,6 +323,11 @@ public:
      */
     void handleCreditsButtonClick();
 
+    /**
+     * @brief Handle link diagnostics button click event
+     */
+    void handleDiagnosticsButtonClick();
+
     /**
      * @brief User should be stopped when recording is still ongoing and they want to click on any bundle related buttons
      */
@@ -367,20 +367,23 @@ void SensorWikiGui::handleStartButtonClick()
     //Disable button to prevent multiple clicks
     lv_obj_clear_flag(ui_StartButton, LV_OBJ_FLAG_CLICKABLE);
 
-    lv_timer_handler(); // Ensure UI updates
-    lv_refr_now(NULL);  // Force immediate screen refresh
-
-    if (!sensorManager.connect()) {
+    // The link connects the sensors, the result is delivered by the GUI loop
+    bool posted = sensorManager.connect([this](bool connected) {
         lv_label_set_text(ui_StartButtonLabel, "START VISUALISATION");
         lv_obj_add_flag(ui_StartButton, LV_OBJ_FLAG_CLICKABLE);
-        splashMessage("Error during sensor connection!\n");
-        return;
+        if (!connected) {
+            splashMessage("Error during sensor connection!\n");
+            return;
+        }
+        // Start sensor operations
+        // logMessage("Starting sensor operations with %zu sensors assigned\n", count);
+
+        // Switch to visualization screen
+        switchToVisualization();
+    });
+    if (!posted) {
+        lv_label_set_text(ui_StartButtonLabel, "START VISUALISATION");
+        lv_obj_add_flag(ui_StartButton, LV_OBJ_FLAG_CLICKABLE);
+        splashMessage("Link is busy, try again!\n");
     }
-    lv_label_set_text(ui_StartButtonLabel, "START VISUALISATION");
-    lv_obj_add_flag(ui_StartButton, LV_OBJ_FLAG_CLICKABLE);
-    // Start sensor operations
-    // logMessage("Starting sensor operations with %zu sensors assigned\n", count);
-    
-    // Switch to visualization screen
-    switchToVisualization();
 }
\ No newline at end of file
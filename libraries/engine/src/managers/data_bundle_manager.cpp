@@ -165,6 +165,17 @@ bool DataBundleManager::saveNewDataPoint(std::string partName, std::string value
     return true;
 }
 
+bool DataBundleManager::saveNewDataPoint(std::string partName, std::string value, uint32_t timeMs)
+{
+    char time[16];
+    snprintf(time, sizeof(time), "%02lu:%02lu:%02lu.%03lu",
+             (unsigned long)(timeMs / 3600000UL), (unsigned long)(timeMs / 60000UL % 60),
+             (unsigned long)(timeMs / 1000UL % 60), (unsigned long)(timeMs % 1000));
+    DataPoint temp = {partName, value, time};
+    currentBundleData.push_back(temp);
+    return true;
+}
+
 bool DataBundleManager::saveRecording()
 {
     File saved = SD.open(currentBundleMetaData.filePath.c_str(), FILE_WRITE);
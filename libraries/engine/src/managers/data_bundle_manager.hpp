@@ -12,6 +12,7 @@
 #define DATA_BUNDLE_MANAGER_H
 
 #include "data_bundle_types.hpp"
+#include <cstdint>
 #include "SD.h"
 
 class DataBundleManager {
@@ -83,6 +84,9 @@ public:
     // called when updated data comes
     bool saveNewDataPoint(std::string partName, std::string value);
 
+    // called for samples buffered by the sensor (BURST), time in ms of the sensor clock
+    bool saveNewDataPoint(std::string partName, std::string value, uint32_t timeMs);
+
     bool saveRecording();
 
     void scrapRecording();
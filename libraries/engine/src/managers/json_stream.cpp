@@ -0,0 +1,162 @@
+/**
+ * @file json_stream.cpp
+ * @brief Definition of the streaming JSON reader
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "json_stream.hpp"
+
+int JsonStream::peek() {
+    if (pos == len) {
+        if (eof) return -1;
+        offset += len;
+        pos = 0;
+        len = reader ? reader(buffer, sizeof(buffer)) : 0;
+        if (len == 0) {
+            eof = true;
+            return -1;
+        }
+    }
+    return buffer[pos];
+}
+
+int JsonStream::take() {
+    int c = peek();
+    if (c >= 0) pos++;
+    return c;
+}
+
+void JsonStream::skipSeparators() {
+    for (int c = peek(); c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ':'; c = peek()) {
+        pos++;
+    }
+}
+
+void JsonStream::fail(const char* message) const {
+    throw InvalidFileFormatException("JsonStream::next", std::string(message) + " at byte " + std::to_string(tell()));
+}
+
+void JsonStream::readString(bool keep) {
+    if (keep) Text.clear();
+    for (;;) {
+        int c = take();
+        if (c < 0) fail("Unterminated string");
+        if (c == '"') return;
+        if (c != '\\') {
+            if (keep) Text += static_cast<char>(c);
+            continue;
+        }
+
+        c = take();
+        switch (c) {
+            case '"': case '\\': case '/': break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u': {
+                uint32_t code = 0;
+                for (int i = 0; i < 4; i++) {
+                    int h = take();
+                    code <<= 4;
+                    if (h >= '0' && h <= '9') code |= h - '0';
+                    else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+                    else fail("Invalid \\u escape");
+                }
+                if (!keep) continue;
+                // UTF-8 (basic plane only, units and descriptions do not need more)
+                if (code < 0x80) {
+                    Text += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    Text += static_cast<char>(0xC0 | (code >> 6));
+                    Text += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    Text += static_cast<char>(0xE0 | (code >> 12));
+                    Text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    Text += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                continue;
+            }
+            default: fail("Invalid escape");
+        }
+        if (keep) Text += static_cast<char>(c);
+    }
+}
+
+void JsonStream::readBare(bool keep) {
+    if (keep) Text.clear();
+    for (int c = peek(); c >= 0; c = peek()) {
+        if (c == ',' || c == ':' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t') break;
+        if (keep) Text += static_cast<char>(c);
+        pos++;
+    }
+}
+
+void JsonStream::push(bool object) {
+    if (depth >= JSON_STREAM_DEPTH) fail("Nesting too deep");
+    if (object) objects |= 1u << depth;
+    else objects &= ~(1u << depth);
+    depth++;
+    expectKey = object;
+}
+
+void JsonStream::pop(bool object) {
+    if (depth == 0 || ((objects >> (depth - 1)) & 1u) != (object ? 1u : 0u)) fail("Unbalanced bracket");
+    depth--;
+    // The closed container was a value of its parent
+    expectKey = depth > 0 && ((objects >> (depth - 1)) & 1u);
+}
+
+JsonToken JsonStream::read(bool keep) {
+    skipSeparators();
+    int c = take();
+    switch (c) {
+        case -1:
+            if (depth != 0) fail("Unexpected end");
+            return JsonToken::END;
+        case '{':
+            push(true);
+            return JsonToken::OBJECT_BEGIN;
+        case '}':
+            pop(true);
+            return JsonToken::OBJECT_END;
+        case '[':
+            push(false);
+            return JsonToken::ARRAY_BEGIN;
+        case ']':
+            pop(false);
+            return JsonToken::ARRAY_END;
+        case '"': {
+            readString(keep);
+            bool key = expectKey;
+            expectKey = !key && depth > 0 && ((objects >> (depth - 1)) & 1u);
+            return key ? JsonToken::KEY : JsonToken::STRING;
+        }
+        default:
+            if (expectKey) fail("Expected key");
+            pos--; // First byte belongs to the scalar
+            readBare(keep);
+            expectKey = depth > 0 && ((objects >> (depth - 1)) & 1u);
+            if (c == '-' || (c >= '0' && c <= '9')) return JsonToken::NUMBER;
+            if (c == 't' || c == 'f' || c == 'n') return JsonToken::LITERAL;
+            fail("Unexpected character");
+            return JsonToken::END;
+    }
+}
+
+void JsonStream::skip(JsonToken first) {
+    if (first != JsonToken::OBJECT_BEGIN && first != JsonToken::ARRAY_BEGIN) return;
+
+    uint8_t target = depth - 1;
+    while (depth > target) {
+        if (read(false) == JsonToken::END) fail("Unexpected end");
+    }
+}
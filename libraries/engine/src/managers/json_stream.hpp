@@ -0,0 +1,147 @@
+/**
+ * @file json_stream.hpp
+ * @brief Declaration of the streaming JSON reader
+ *
+ * This header defines a pull tokenizer reading JSON in fixed-size chunks, so
+ * files larger than the free heap can be parsed. Scalars are passed in one
+ * reused string, skipped values are scanned without building anything.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+#ifndef JSON_STREAM_HPP
+#define JSON_STREAM_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "../exceptions/files_exceptions.hpp"
+
+#define JSON_STREAM_CHUNK 512 ///< Size of the read buffer (bytes)
+#define JSON_STREAM_DEPTH 32  ///< Maximal nesting of objects and arrays
+
+/**
+ * @enum JsonToken
+ * @brief Tokens returned by JsonStream::next().
+ */
+enum class JsonToken : uint8_t {
+    OBJECT_BEGIN, ///< {
+    OBJECT_END,   ///< }
+    ARRAY_BEGIN,  ///< [
+    ARRAY_END,    ///< ]
+    KEY,          ///< Key of an object member, text() holds it
+    STRING,       ///< String value, text() holds it unescaped
+    NUMBER,       ///< Number, text() holds it as written
+    LITERAL,      ///< true, false or null, text() holds it
+    END           ///< End of the input
+};
+
+/**
+ * @class JsonStream
+ * @brief Pull tokenizer of JSON read in chunks.
+ *
+ * Separators (',' and ':') are not validated, the reader is meant for trusted
+ * files written by tools. Malformed tokens throw InvalidFileFormatException.
+ */
+class JsonStream {
+public:
+    /**
+     * @brief Source of the input: fills the buffer, returns the number of bytes read (0 at the end)
+     */
+    typedef std::function<size_t(uint8_t* buffer, size_t size)> Reader;
+
+private:
+    Reader reader;                       ///< Source of the input
+    uint8_t buffer[JSON_STREAM_CHUNK];   ///< Current chunk
+    size_t pos = 0;                      ///< Read position in the chunk
+    size_t len = 0;                      ///< Bytes in the chunk
+    size_t offset = 0;                   ///< Input offset of the chunk (error messages)
+    bool eof = false;                    ///< Reader is exhausted
+    std::string Text;                    ///< Text of the last scalar or key (reused)
+    uint32_t objects = 0;                ///< Bit per nesting level, set for objects
+    uint8_t depth = 0;                   ///< Current nesting
+    bool expectKey = false;              ///< Next string is a key
+
+    /**
+     * @brief Next byte without consuming it, -1 at the end
+     */
+    int peek();
+
+    /**
+     * @brief Consume the next byte, -1 at the end
+     */
+    int take();
+
+    /**
+     * @brief Skip whitespace and separators
+     */
+    void skipSeparators();
+
+    /**
+     * @brief Read a string after its opening quote
+     * @param keep Unescape it into Text, skip only otherwise
+     */
+    void readString(bool keep);
+
+    /**
+     * @brief Read a number or literal starting with the given byte
+     * @param keep Store it into Text, skip only otherwise
+     */
+    void readBare(bool keep);
+
+    /**
+     * @brief Enter an object or an array
+     */
+    void push(bool object);
+
+    /**
+     * @brief Leave an object or an array
+     */
+    void pop(bool object);
+
+    /**
+     * @brief Read the next token
+     * @param keep Build the text of scalars and keys
+     */
+    JsonToken read(bool keep);
+
+    /**
+     * @brief Throw InvalidFileFormatException with the current input offset
+     */
+    void fail(const char* message) const;
+
+public:
+    /**
+     * @brief Constructor
+     * @param reader Source of the input
+     */
+    explicit JsonStream(const Reader& reader) : reader(reader) {}
+
+    JsonStream(const JsonStream&) = delete;
+    JsonStream& operator=(const JsonStream&) = delete;
+
+    /**
+     * @brief Read the next token
+     * @throws InvalidFileFormatException on malformed input
+     */
+    JsonToken next() { return read(true); }
+
+    /**
+     * @brief Skip the rest of a value
+     * @param first Token the value started with, nested objects and arrays are skipped whole
+     */
+    void skip(JsonToken first);
+
+    /**
+     * @brief Text of the last key or scalar
+     */
+    const std::string& text() const { return Text; }
+
+    /**
+     * @brief Number of bytes consumed
+     */
+    size_t tell() const { return offset + pos; }
+};
+
+#endif // JSON_STREAM_HPP
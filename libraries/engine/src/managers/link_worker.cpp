@@ -0,0 +1,147 @@
+/**
+ * @file link_worker.cpp
+ * @brief Definition of the link worker
+ *
+ * This source defines the link task and the job passing between it and the GUI.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <exception>
+#include "link_worker.hpp"
+
+#ifndef ARDUINO_H
+#include <chrono>
+#endif
+
+bool LinkWorker::start() {
+#ifdef LINK_WORKER
+    if (isRunning()) return true;
+
+    running.store(true, std::memory_order_release);
+    active.store(true, std::memory_order_release);
+#ifdef ARDUINO_H
+    if (xTaskCreatePinnedToCore(taskEntry, "vscp_link", LINK_TASK_STACK, this, LINK_TASK_PRIORITY, &task, LINK_TASK_CORE) != pdPASS) {
+        task = nullptr;
+        running.store(false, std::memory_order_release);
+        active.store(false, std::memory_order_release);
+        return false;
+    }
+#else
+    thread = std::thread(&LinkWorker::loop, this);
+#endif
+    return true;
+#else
+    return false; // Link runs in the GUI loop
+#endif
+}
+
+void LinkWorker::stop() {
+    running.store(false, std::memory_order_release);
+#ifdef ARDUINO_H
+    while (active.load(std::memory_order_acquire)) sleepPeriod(); // The task deletes itself
+    task = nullptr;
+#else
+    if (thread.joinable()) thread.join();
+#endif
+
+    // Nobody consumes the queues now
+    commands.clear();
+    events.clear();
+}
+
+#ifdef ARDUINO_H
+void LinkWorker::taskEntry(void* worker) {
+    static_cast<LinkWorker*>(worker)->loop();
+    vTaskDelete(nullptr);
+}
+#endif
+
+void LinkWorker::loop() {
+    while (running.load(std::memory_order_acquire)) {
+        LinkJob job;
+        while (commands.pop(job)) {
+            run(job);
+        }
+
+        if (Protocol::isInitialized()) {
+            Protocol::poll(); // Handlers publish received sensor data to the GUI
+        }
+
+        // Every pass yields, which keeps the idle task (and watchdog) of the core alive
+        sleepPeriod();
+    }
+    active.store(false, std::memory_order_release);
+}
+
+void LinkWorker::run(LinkJob& job) {
+    try {
+        job();
+    }
+    catch (const std::exception& e) {
+        logMessage("Link job failed: %s\n", e.what());
+    }
+    catch (...) {
+        logMessage("Link job failed!\n");
+    }
+}
+
+bool LinkWorker::isLinkTask() const {
+#ifdef ARDUINO_H
+    return task != nullptr && xTaskGetCurrentTaskHandle() == task;
+#else
+    return thread.get_id() == std::this_thread::get_id();
+#endif
+}
+
+void LinkWorker::sleepPeriod() {
+#ifdef ARDUINO_H
+    vTaskDelay(pdMS_TO_TICKS(LINK_PERIOD_MS) > 0 ? pdMS_TO_TICKS(LINK_PERIOD_MS) : 1);
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(LINK_PERIOD_MS));
+#endif
+}
+
+bool LinkWorker::post(LinkJob&& job) {
+    if (!isRunning() || isLinkTask()) {
+        job();
+        return true;
+    }
+    return commands.push(std::move(job));
+}
+
+bool LinkWorker::publish(LinkJob&& job) {
+    if (!isRunning()) {
+        job();
+        return true;
+    }
+    return events.push(std::move(job));
+}
+
+bool LinkWorker::complete(LinkJob&& job) {
+    if (!isRunning()) {
+        job();
+        return true;
+    }
+    // Only the GUI frees room, so once there is some the push cannot fail (nor count as dropped)
+    while (events.size() >= events.capacity()) {
+        if (!running.load(std::memory_order_acquire)) return false; // stop() waits for the task
+        sleepPeriod();
+    }
+    return events.push(std::move(job));
+}
+
+size_t LinkWorker::deliver() {
+    size_t delivered = 0;
+    LinkJob job;
+    while (events.pop(job)) {
+        run(job);
+        delivered++;
+    }
+    return delivered;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file link_worker.hpp
+ * @brief Declaration of the link worker
+ *
+ * The link worker runs the protocol (requests and polling of the link) in its own task,
+ * pinned to the core the GUI does not use (a thread on host builds). The GUI passes jobs
+ * to the link and the link passes sensor updates back, both through lock-free SPSC queues,
+ * so a slow or stalled link does not hold up rendering.
+ *
+ * Threading rule: the link task owns the Protocol, the GUI owns the sensors. A job posted
+ * to the link only talks to the peer, its result goes back by complete() (or by publish()
+ * if it may be dropped, e.g. streamed data) and is applied to the sensors by deliver() in
+ * the GUI loop. The GUI never waits for the link.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+#ifndef LINK_WORKER_HPP
+#define LINK_WORKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "../config.hpp"
+#include "vscp.hpp"
+#include "expt.hpp"
+
+#ifndef ARDUINO_H
+#include <thread>
+#endif
+
+/**
+ * @brief Job passed between the GUI and the link task.
+ */
+typedef std::function<void()> LinkJob;
+
+/**
+ * @class LinkWorker
+ * @brief Task running the protocol, connected to the GUI by a command and an event queue.
+ *
+ * The GUI is the producer of commands and the consumer of events, the link task the other
+ * way round. While the task is not running (not started, stopped, LINK_WORKER disabled)
+ * all jobs run in place, so callers work the same way with and without the task.
+ */
+class LinkWorker {
+private:
+    SpscQueue<LinkJob, LINK_QUEUE_SIZE> commands; ///< Jobs of the GUI run by the link task
+    SpscQueue<LinkJob, LINK_QUEUE_SIZE> events;   ///< Jobs of the link task run by the GUI (sensor updates)
+    std::atomic<bool> running{false};             ///< Cleared to stop the task
+    std::atomic<bool> active{false};              ///< Set while the task is alive
+
+#ifdef ARDUINO_H
+    TaskHandle_t task = nullptr;                  ///< The link task
+
+    /**
+     * @brief Entry point of the link task
+     * @param worker The LinkWorker
+     */
+    static void taskEntry(void* worker);
+#else
+    std::thread thread;                           ///< The link thread
+#endif
+
+    /**
+     * @brief Loop of the link task: run commands, poll the link, sleep
+     */
+    void loop();
+
+    /**
+     * @brief Check if the caller is the link task
+     */
+    bool isLinkTask() const;
+
+    /**
+     * @brief Sleep one period of the link (LINK_PERIOD_MS)
+     */
+    static void sleepPeriod();
+
+    /**
+     * @brief Run a job, a failure is logged and does not escape
+     * @param job The job
+     */
+    static void run(LinkJob& job);
+
+public:
+    LinkWorker() = default;
+    LinkWorker(const LinkWorker&) = delete;
+    LinkWorker& operator=(const LinkWorker&) = delete;
+
+    /**
+     * @brief Destructor, stops the task
+     */
+    ~LinkWorker() { stop(); }
+
+    /**
+     * @brief Start the link task
+     * @return true if the task runs
+     */
+    bool start();
+
+    /**
+     * @brief Stop the link task and drop all queued jobs
+     *
+     * Returns once the task has exited, so the caller owns the Protocol again.
+     */
+    void stop();
+
+    /**
+     * @brief Check if the link task runs
+     */
+    bool isRunning() const { return active.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Run a job on the link without waiting for it (GUI side)
+     * @param job The job, must not touch sensors
+     * @return false if the command queue is full and the job was dropped
+     */
+    bool post(LinkJob&& job);
+
+    /**
+     * @brief Pass a job (sensor update) to the GUI (link side), never blocks
+     * @param job The job
+     * @return false if the event queue is full and the job was dropped
+     */
+    bool publish(LinkJob&& job);
+
+    /**
+     * @brief Pass a result which must not be lost (completion of a posted job) to the GUI (link side)
+     *
+     * Waits for room in the event queue, the GUI frees it by the next deliver().
+     * @param job The job
+     * @return false only if the link was stopped meanwhile and the job was dropped
+     */
+    bool complete(LinkJob&& job);
+
+    /**
+     * @brief Run the jobs passed by the link (GUI side), never blocks
+     *
+     * A failing job is logged, the others still run.
+     * @return Number of run jobs
+     */
+    size_t deliver();
+
+    /**
+     * @brief Number of events dropped because the GUI did not keep up
+     */
+    uint32_t getDroppedEvents() const { return events.getOverflowCount(); }
+};
+
+#endif // LINK_WORKER_HPP
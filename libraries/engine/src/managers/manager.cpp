@@ -13,14 +13,22 @@
  *********************/
 
 #include <sstream>
+#include <algorithm>
+#include <memory>
 #include "manager.hpp"
 #include "../sensors/sensor_factory.hpp"
+#include "sensor_db.hpp"
 #include "helpers.hpp"
 
-SensorManager::SensorManager() : Sensors(), currentIndex(0) {
+SensorManager::SensorManager() : Sensors(), Index(Sensors), currentIndex(0) {
+    // Records of batched requests are matched by the index, applied in the GUI like the lookups
+    setSensorResolver([this](const MessageView& uid) { return Index.find(uid); });
 }
 
 SensorManager::~SensorManager() {
+    link.stop(); // Relayed updates refer to the sensors
+    setRecordRelay(RecordRelay());
+    setSensorResolver(SensorResolver());
     for (auto* s : Sensors) delete s;
 }
 
@@ -30,10 +38,17 @@ void SensorManager::loadConfigFile(std::string configFile) {
     {
         logMessage("Initializing manager via fixed sensors list...\n");
         createSensorList(Sensors);
+        indexSensors();
         return;
     }
 
-    throw Exception("SensorManager::init", "Initialization from config file not implemented yet", ErrorCode::NOT_DEFINED_ERROR);
+    logMessage("Initializing manager via sensor database %s...\n", configFile.c_str());
+    SensorDbInfo info;
+    SensorDb::load(configFile, Sensors, info);
+    if (!info.version.empty()) DB_VERSION = info.version;
+    if (!info.application.empty()) APP_NAME = info.application;
+    logMessage("\t(i)Loaded %d sensors\n", static_cast<int>(Sensors.size()));
+    indexSensors();
 }
 
 bool SensorManager::init(std::string configFile) {
@@ -41,6 +56,8 @@ bool SensorManager::init(std::string configFile) {
     {
         erase();
     }
+    link.stop(); // Protocol is used in place until the link task starts again
+    setRecordRelay(RecordRelay());
 
     initialized = false;
     Status = ManagerStatus::ERROR;
@@ -50,6 +67,7 @@ bool SensorManager::init(std::string configFile) {
         loadConfigFile(configFile);
 
         logMessage("\tinitializing of protocol...\n");
+        Protocol::setKeySchema(collectSchemaKeys()); // Offered with INIT
         ResponseStatus response;
         for (size_t i = 0; i < SensorManager::MAX_INIT_ATTEMPTS; i++)
         {
@@ -60,12 +78,15 @@ bool SensorManager::init(std::string configFile) {
                 break;
             }
             logMessage("\t\tProtocol initialization failed, retrying...\n");
-            delay_ms(500);
+            delay_ms(Protocol::getRetryDelay(static_cast<uint8_t>(i))); // Exponential backoff with jitter
         }
         if (response.status == ResponseStatusEnum::ERROR)
         {
             throw SensorInitializationFailException("SensorManager::init", response.error, ErrorCode::CRITICAL_ERROR_CODE);
         }
+        for (auto* sensor : Sensors) {
+            sensor->bindKeySchema(); // Values sent by key ID are applied by index
+        }
         logMessage("\tdone!\n");
     }
     catch(...)
@@ -75,34 +96,109 @@ bool SensorManager::init(std::string configFile) {
 
 
     Status = ManagerStatus::READY;
+    subscriptionsSupported = true;
+    pinMapSupported = true;
     resetPinMap();
+    AppliedPinMap.clear(); // The first connect of a new session sends the whole layout
+    syncInFlight = false;
+
+#ifdef LINK_WORKER
+    // Records received by the link task are applied by poll() in the GUI loop
+    setRecordRelay([this](std::function<void()>&& apply, bool keep) {
+        if (keep) {
+            link.complete(std::move(apply));
+        } else {
+            link.publish(std::move(apply));
+        }
+    });
+    if (!link.start()) {
+        setRecordRelay(RecordRelay());
+        logMessage("Link task not started, polling in the GUI loop\n");
+    }
+#endif
     logMessage("Initialization done!\n");
     return initialized = true;
 }
 
 
 
-BaseSensor* SensorManager::getSensor(std::string uid) {
+std::vector<std::string> SensorManager::collectSchemaKeys() const {
+    std::vector<std::string> keys;
     for (auto* sensor : Sensors) {
-        if (sensor->UID == uid) return sensor;
+        if (!sensor) continue;
+        for (const auto& key : sensor->getValuesKeys()) {
+            if (!isInVector(keys, key)) keys.push_back(key);
+        }
+        for (const auto& key : sensor->getConfigsKeys()) {
+            if (!isInVector(keys, key)) keys.push_back(key);
+        }
     }
-    return nullptr;
+    return keys;
+}
+
+void SensorManager::indexSensors() {
+    for (size_t i = 0; i < Sensors.size(); i++) {
+        Sensors[i]->setHandle(static_cast<SensorHandle>(i));
+    }
+    Index.rebuild();
+    SyncFlags.assign(Sensors.size(), 0);
 }
 
 void SensorManager::addSensor(BaseSensor* sensor) {
-    if (sensor) Sensors.push_back(sensor);
+    if (!sensor || Sensors.size() >= INVALID_SENSOR_HANDLE) return;
+
+    sensor->setHandle(static_cast<SensorHandle>(Sensors.size()));
+    Sensors.push_back(sensor);
+    SyncFlags.push_back(0);
+    if (!Index.insert(sensor->getHandle())) {
+        logMessage("Sensor UID %s is not unique, only the first one is found by UID\n", sensor->UID.c_str());
+    }
 }
 
-bool SensorManager::sync(std::string id) {
-    BaseSensor* sensor = getSensor(id);
-    if (sensor) return syncSensor(sensor);
+void SensorManager::setSyncFlag(const BaseSensor* sensor, uint8_t flag, bool value) {
+    uint8_t& flags = SyncFlags[sensor->getHandle()];
+    flags = value ? (flags | flag) : (flags & ~flag);
+}
+
+bool SensorManager::sync(SensorHandle handle) {
+    BaseSensor* sensor = getSensor(handle);
+    if (!sensor) return false;
+
+    // One sync request at a time, the sensor may be in the one in flight
+    unsigned long now = getTimeMs();
+    if (isSyncInFlight(now)) return false;
 
-    return false;
+    // Same as a polled sensor, a batch of one (configuration first)
+    std::shared_ptr<SyncBatch> batch = std::make_shared<SyncBatch>();
+    prepareSyncBatch(std::vector<BaseSensor*>(1, sensor), *batch);
+    return postSync(batch, now);
 }
 
-void SensorManager::print(std::string uid) {
-    BaseSensor* sensor = getSensor(uid);
-    printSensor(sensor);
+unsigned long SensorManager::syncDeadline(const SyncBatch& batch) {
+    return Protocol::maxRequestTimeout(MAX_RECEIVE_LINE_SIZE) +
+           batch.configs.size() * Protocol::maxRequestTimeout(PROTOCOL_RESPONSE_SIZE) + SYNC_STALL_MARGIN_MS;
+}
+
+bool SensorManager::isSyncInFlight(unsigned long now) {
+    if (syncInFlight && now - syncStarted >= syncStall) {
+        syncInFlight = false; // Completion lost (link stopped meanwhile), do not stop synchronizing
+    }
+    return syncInFlight;
+}
+
+bool SensorManager::postSync(const std::shared_ptr<SyncBatch>& batch, unsigned long now) {
+    // Sent by the link task (no I/O here), the completion comes also on timeout
+    syncInFlight = true;
+    syncStarted = now;
+    syncStall = syncDeadline(*batch);
+    if (!link.post([this, batch]() { sendSyncBatch(*batch, [this]() { syncInFlight = false; }); })) {
+        syncInFlight = false; // Link busy, the sensors are polled again next time
+    }
+    return syncInFlight;
+}
+
+void SensorManager::print(SensorHandle handle) {
+    printSensor(getSensor(handle));
 }
 
 void SensorManager::print() {
@@ -112,39 +208,330 @@ void SensorManager::print() {
 
 bool SensorManager::resync() 
 {
+    updateSubscriptions();
     if(!isRunning()) return false;
 
-    BaseSensor* currentSensor = getCurrentSensor();
-    return syncSensor(currentSensor);
+    unsigned long now = getTimeMs();
+    if (isSyncInFlight(now)) return true; // Previous cycle still in flight
+
+    // Configuration changed by the user is sent right away, whatever the schedule
+    PolledSensors.clear();
+    for (auto* sensor : SelectedSensors) {
+        if (PolledSensors.size() < SYNC_BUDGET && sensor->isConfigSyncDue()) {
+            PolledSensors.push_back(sensor);
+            setSyncFlag(sensor, SYNC_POLLED, true);
+        }
+    }
+
+    // Take all due sensors, the heap hands them out earliest first
+    DueSyncs.clear();
+    while (!SyncSchedule.empty() && static_cast<long>(now - SyncSchedule.front().due) >= 0) {
+        std::pop_heap(SyncSchedule.begin(), SyncSchedule.end(), laterDue);
+        DueSyncs.push_back(SyncSchedule.back());
+        SyncSchedule.pop_back();
+    }
+    std::stable_sort(DueSyncs.begin(), DueSyncs.end(), [this](const ScheduledSync& a, const ScheduledSync& b) {
+        return syncPriority(a.sensor) > syncPriority(b.sensor);
+    });
+
+    // Streamed sensors are pushed by the peer at their period, the others are polled within the budget
+    for (const auto& entry : DueSyncs) {
+        if (!hasSyncFlag(entry.sensor, SYNC_STREAMED | SYNC_POLLED)) {
+            if (PolledSensors.size() >= SYNC_BUDGET) {
+                // Over budget, stays due for the next call
+                SyncSchedule.push_back(entry);
+                std::push_heap(SyncSchedule.begin(), SyncSchedule.end(), laterDue);
+                continue;
+            }
+            PolledSensors.push_back(entry.sensor);
+            setSyncFlag(entry.sensor, SYNC_POLLED, true);
+        }
+        reschedule(entry, now);
+    }
+    for (auto* sensor : PolledSensors) setSyncFlag(sensor, SYNC_POLLED, false);
+    if (PolledSensors.empty()) return !SubscribedSensors.empty();
+
+    // Configuration is sent first by the same job, one request per sensor
+    std::shared_ptr<SyncBatch> batch = std::make_shared<SyncBatch>();
+    prepareSyncBatch(PolledSensors, *batch);
+    if (batch->sensors.empty()) return !SubscribedSensors.empty();
+
+    // One batched round trip for all polled sensors
+    return postSync(batch, now);
+}
+
+bool SensorManager::laterDue(const ScheduledSync& a, const ScheduledSync& b) {
+    return static_cast<long>(a.due - b.due) > 0;
+}
+
+void SensorManager::rebuildSchedule() {
+    SyncSchedule.clear();
+    unsigned long now = getTimeMs();
+    for (auto* sensor : SelectedSensors) {
+        SyncSchedule.push_back({now, sensor}); // All due now, same time keeps a valid heap
+    }
+}
+
+void SensorManager::reschedule(ScheduledSync entry, unsigned long now) {
+    // Keep the phase, but do not catch up on missed periods
+    entry.due += entry.sensor->getSyncPeriod();
+    if (static_cast<long>(now - entry.due) >= 0) {
+        entry.due = now + entry.sensor->getSyncPeriod();
+    }
+    SyncSchedule.push_back(entry);
+    std::push_heap(SyncSchedule.begin(), SyncSchedule.end(), laterDue);
+}
+
+unsigned int SensorManager::syncPriority(const BaseSensor* sensor) {
+    return sensor->getSyncPriority() + (sensor == getCurrentSensor() ? FOREGROUND_PRIORITY : 0);
 }
 
-bool SensorManager::connect() 
+bool SensorManager::setSyncPeriod(SensorHandle handle, unsigned int period, uint8_t priority) {
+    BaseSensor* sensor = getSensor(handle);
+    if (!sensor) return false;
+
+    sensor->setSyncPeriod(period);
+    sensor->setSyncPriority(priority);
+
+    // Stream has to be restarted at the new period
+    if (hasSyncFlag(sensor, SYNC_STREAMED)) postSubscribe(sensor);
+    return true;
+}
+
+bool SensorManager::postSubscribe(BaseSensor* sensor)
 {
-    //TODO:disconnect existing connections first
-    bool result = true;
-    for (auto virtualPin : PinMap) {
-        if(virtualPin.isAssigned()) {
-            //First disconnect if already connected
-            disconnectSensor(virtualPin.assignedSensor);
-            //Reassign pin
-            virtualPin.assignedSensor->assignPin(std::to_string(virtualPin.pinNumber));
+    unsigned int period = sensor->getSyncPeriod();
+    setSyncFlag(sensor, SYNC_SUBSCRIBING, true);
+    bool posted = link.post([this, sensor, period]() {
+        bool unsupported = false;
+        bool subscribed = subscribeSensor(sensor, period, &unsupported);
+        link.complete([this, sensor, subscribed, unsupported]() { onSubscribed(sensor, subscribed, unsupported); });
+    });
+    if (!posted) setSyncFlag(sensor, SYNC_SUBSCRIBING, false); // Tried again by the next resync
+    return posted;
+}
+
+void SensorManager::onSubscribed(BaseSensor* sensor, bool subscribed, bool unsupported)
+{
+    setSyncFlag(sensor, SYNC_SUBSCRIBING, false);
+    if (!subscribed) {
+        if (hasSyncFlag(sensor, SYNC_STREAMED)) {
+            // Restart at a new period failed, subscribed again by the next resync
+            SubscribedSensors.erase(std::find(SubscribedSensors.begin(), SubscribedSensors.end(), sensor));
+            setSyncFlag(sensor, SYNC_STREAMED, false);
+        } else if (unsupported) {
+            if (subscriptionsSupported) logMessage("Peer does not support SUBSCRIBE, falling back to polling...\n");
+            subscriptionsSupported = false; // Legacy peer, poll for the rest of the session
+        } else {
+            setSyncFlag(sensor, SYNC_REFUSED, true); // Only this one is polled
         }
+        return;
     }
 
-    for (auto virtualPin : PinMap) {
-        if(virtualPin.isAssigned()) {
-            result &= connectSensor(virtualPin.assignedSensor);
+    if (hasSyncFlag(sensor, SYNC_STREAMED)) return; // Stream restarted at a new period
+    if (!isRunning() || !hasSyncFlag(sensor, SYNC_SELECTED)) {
+        link.post([sensor]() { unsubscribeSensor(sensor); }); // Deselected meanwhile
+        return;
+    }
+    SubscribedSensors.push_back(sensor);
+    setSyncFlag(sensor, SYNC_STREAMED, true);
+}
+
+void SensorManager::updateSubscriptions()
+{
+    // Drop streams which are not needed anymore
+    for (auto it = SubscribedSensors.begin(); it != SubscribedSensors.end();) {
+        if (isRunning() && hasSyncFlag(*it, SYNC_SELECTED)) {
+            ++it;
+            continue;
+        }
+        BaseSensor* sensor = *it;
+        if (!link.post([sensor]() { unsubscribeSensor(sensor); })) {
+            ++it; // Link busy, dropped by the next call
+            continue;
+        }
+        setSyncFlag(sensor, SYNC_STREAMED, false);
+        it = SubscribedSensors.erase(it);
+    }
+
+    if (!isRunning() || !subscriptionsSupported) return;
+
+    // Polled until the result is delivered (right away while the link task does not run)
+    for (auto* sensor : SelectedSensors) {
+        if (!subscriptionsSupported) return;
+        if (hasSyncFlag(sensor, SYNC_STREAMED | SYNC_REFUSED | SYNC_SUBSCRIBING)) continue;
+        if (!postSubscribe(sensor)) return; // Link busy
+    }
+}
+
+size_t SensorManager::poll()
+{
+    if (link.isRunning()) return link.deliver();
+    if (!Protocol::isInitialized()) return 0;
+
+    return Protocol::poll();
+}
+
+bool SensorManager::connect(const ConnectHandler& onDone)
+{
+    // Pins of every assigned sensor in pin order
+    std::shared_ptr<PinMapJob> job = std::make_shared<PinMapJob>();
+    for (const auto& virtualPin : PinMap) {
+        if (!virtualPin.isAssigned()) continue;
+
+        std::string& pins = job->target[virtualPin.assignedSensor->getHandle()];
+        if (!pins.empty()) pins += ",";
+        pins += std::to_string(virtualPin.pinNumber);
+    }
+
+    // Delta against the pin map acknowledged by the peer, sensors left out are disconnected
+    PinChange change;
+    for (const auto& entry : job->target) {
+        auto applied = AppliedPinMap.find(entry.first);
+        if (applied == AppliedPinMap.end() || applied->second != entry.second) {
+            change.handle = entry.first;
+            change.pins = entry.second;
+            change.applied = applied != AppliedPinMap.end();
+            job->changes.push_back(change);
+        }
+    }
+    for (const auto& applied : AppliedPinMap) {
+        if (!job->target.count(applied.first)) {
+            change.handle = applied.first;
+            change.pins.clear();
+            change.applied = true;
+            job->changes.push_back(change);
+        }
+    }
+
+    if (job->changes.empty()) {
+        // Peer already runs this layout
+        if (onDone) onDone(true);
+        return true;
+    }
+
+    // UIDs only at the protocol boundary, the link does not touch the sensors
+    for (auto& pending : job->changes) {
+        pending.uid = Sensors[pending.handle]->UID;
+    }
+    job->transaction = pinMapSupported;
+    return link.post([this, job, onDone]() {
+        sendPinMap(*job);
+        link.complete([this, job, onDone]() {
+            bool connected = applyPinMap(*job);
+            if (onDone) onDone(connected);
+        });
+    });
+}
+
+void SensorManager::sendPinMap(PinMapJob& job)
+{
+    if (job.transaction) {
+        std::vector<std::pair<std::string, std::string>> request;
+        request.reserve(job.changes.size());
+        for (const auto& change : job.changes) {
+            request.emplace_back(change.uid, change.pins);
+        }
+
+        job.response = Protocol::pinMap(request);
+        // Answered without naming a sensor - legacy peer without PINMAP
+        job.legacy = job.response.status != ResponseStatusEnum::OK && !job.response.params.count("id") &&
+                     job.response.params.count("status");
+        if (!job.legacy) return;
+    }
+
+    // One sensor at a time, a sensor still holding the applied pins is disconnected from them first
+    for (auto& change : job.changes) {
+        change.released = true;
+        if (change.applied) {
+            ResponseStatus response = Protocol::disconnect(change.uid);
+            change.released = response.status == ResponseStatusEnum::OK;
+            change.error = response.error;
+        }
+        if (!change.released || change.pins.empty()) continue;
+
+        ResponseStatus response = Protocol::connect(change.uid, change.pins);
+        change.connected = response.status == ResponseStatusEnum::OK;
+        change.error = response.error;
+    }
+}
+
+bool SensorManager::applyPinMap(const PinMapJob& job)
+{
+    if (job.transaction && !job.legacy) {
+        const ResponseStatus& response = job.response;
+        if (response.status == ResponseStatusEnum::OK) {
+            for (const auto& change : job.changes) {
+                BaseSensor* sensor = getSensor(change.handle);
+                if (!sensor) continue;
+                sensor->clearError();
+                sensor->setPins(splitString(change.pins, ','));
+            }
+            AppliedPinMap = job.target;
+            return true;
         }
+
+        auto refused = response.params.find("id");
+        if (refused != response.params.end()) {
+            // Nothing was applied, the refused change is reported by its sensor
+            BaseSensor* sensor = getSensor(findSensor(refused->second));
+            if (sensor) sensor->setError(response.error);
+            logMessage("Pin map rejected: %s\n", response.error.c_str());
+            return false;
+        }
+
+        logMessage("Pin map failed: %s\n", response.error.c_str());
+        return false;
     }
 
+    if (job.legacy) {
+        logMessage("Pin map not supported by peer, connected sensors one by one\n");
+        pinMapSupported = false;
+    }
+
+    bool result = true;
+    for (const auto& change : job.changes) {
+        BaseSensor* sensor = getSensor(change.handle);
+        if (!sensor) continue;
+
+        sensor->clearError();
+        if (!change.released) {
+            sensor->setError(change.error);
+            result = false;
+            continue;
+        }
+        AppliedPinMap.erase(change.handle);
+        sensor->setPins(splitString(change.pins, ','));
+        if (change.pins.empty()) continue;
+
+        if (change.connected) {
+            AppliedPinMap[change.handle] = change.pins;
+        } else {
+            sensor->setError(change.error);
+            result = false;
+        }
+    }
     return result;
 }
 
 void SensorManager::erase() {
+    link.stop(); // Queued updates refer to the sensors, the Protocol is used in place from now on
+    setRecordRelay(RecordRelay());
+    for (auto* sensor : SubscribedSensors) unsubscribeSensor(sensor);
+    SubscribedSensors.clear();
+    PolledSensors.clear();
+    Protocol::cancelAll(); // Pending requests refer to the sensors
+    syncInFlight = false;
     resetPinMap();
+    AppliedPinMap.clear();
+    SelectedSensors.clear();
+    SyncSchedule.clear();
     currentIndex = 0;
+    getChangeBus().clear(); // Pending changes refer to the sensors
     for (auto* sensor : Sensors) delete sensor;
     Sensors.clear();
+    Index.clear();
+    SyncFlags.clear();
 }
 
 /////////////////////////
@@ -152,16 +539,19 @@ void SensorManager::erase() {
 /////////////////////////
 
 void SensorManager::selectSensorsFromPinMap() {
+    for (auto* sensor : SelectedSensors) setSyncFlag(sensor, SYNC_SELECTED | SYNC_REFUSED, false); // New layout, subscribe again
     SelectedSensors.clear();
     for (const auto& pin : PinMap) {
         if (pin.assignedSensor) {
-            if (!std::count(SelectedSensors.begin(), SelectedSensors.end(), pin.assignedSensor))
+            if (!hasSyncFlag(pin.assignedSensor, SYNC_SELECTED))
             {
                 SelectedSensors.push_back(pin.assignedSensor);
+                setSyncFlag(pin.assignedSensor, SYNC_SELECTED, true);
             }     
         }
     }
     resetCurrentIndex();
+    rebuildSchedule();
 }
 
 BaseSensor* SensorManager::getCurrentSensor()
@@ -16,10 +16,16 @@
 #include <cstddef>
 #include <string>
 #include <array>
+#include <map>
+#include <utility>
+#include <functional>
+#include <memory>
 #include "expt.hpp"
 
 #include "../sensors/base_sensor.hpp"
 #include "pin_structure.hpp"
+#include "link_worker.hpp"
+#include "sensor_index.hpp"
 
 /**
  * @enum ManagerStatus
@@ -38,6 +44,11 @@ enum class ManagerStatus
 };
 
 
+/**
+ * @brief Handler of a finished connect(), called with true if the peer runs the current pin map.
+ */
+typedef std::function<void(bool connected)> ConnectHandler;
+
 /**
  * @class SensorManager
  * @brief Class for managing sensors and their pin assignments.
@@ -47,12 +58,71 @@ enum class ManagerStatus
  */
 class SensorManager {
 private:
+    /**
+     * @struct ScheduledSync
+     * @brief Next synchronization of a selected sensor (entry of the scheduler min-heap).
+     */
+    struct ScheduledSync {
+        unsigned long due;  ///< Time (ms) the sensor is due
+        BaseSensor* sensor; ///< The sensor
+    };
+
+    /**
+     * @brief Synchronization state bits of a sensor (SyncFlags)
+     */
+    enum SyncFlag : uint8_t {
+        SYNC_SELECTED = 1, ///< Sensor is in SelectedSensors
+        SYNC_STREAMED = 2, ///< Sensor is in SubscribedSensors
+        SYNC_POLLED = 4,   ///< Sensor is in PolledSensors (current cycle only)
+        SYNC_REFUSED = 8,  ///< Peer refused to stream the sensor, it is polled (until selected again)
+        SYNC_SUBSCRIBING = 16 ///< SUBSCRIBE request posted to the link, its result not delivered yet
+    };
+
+    /**
+     * @struct PinChange
+     * @brief Pin change of one sensor sent by connect(), with its result.
+     */
+    struct PinChange {
+        SensorHandle handle;      ///< Sensor handle
+        std::string uid;          ///< UID of the sensor (used by the link)
+        std::string pins;         ///< New pins ("5" or "5,6,7"), empty to disconnect
+        bool applied = false;     ///< Sensor holds pins acknowledged by the peer, released first (one by one)
+        bool released = false;    ///< Result: the applied pins were released (one by one)
+        bool connected = false;   ///< Result: the new pins were acknowledged (one by one)
+        std::string error;        ///< Result: error reported by the peer (one by one)
+    };
+
+    /**
+     * @struct PinMapJob
+     * @brief Pin map difference prepared by the GUI, sent by the link and applied by the GUI again.
+     */
+    struct PinMapJob {
+        std::vector<PinChange> changes;             ///< Changes against the applied pin map
+        std::map<SensorHandle, std::string> target; ///< Pins of all assigned sensors
+        bool transaction = true;                    ///< Sent as one PINMAP transaction, one by one otherwise
+        bool legacy = false;                        ///< Result: peer does not support PINMAP (sent one by one)
+        ResponseStatus response;                    ///< Result: response to PINMAP
+    };
+
     std::array<VirtualPin, NUM_PINS> PinMap; ///< Mapping of pins to sensors
-    std::vector<BaseSensor*> Sensors;         ///< List of all managed sensors
+    std::vector<BaseSensor*> Sensors;         ///< List of all managed sensors, the index is the sensor handle
+    SensorIndex Index;                        ///< UID -> handle index of Sensors
+    std::vector<uint8_t> SyncFlags;           ///< SyncFlag bits per sensor handle
     std::vector<BaseSensor*> SelectedSensors; ///< List of fixed sensors (from config file)
+    std::vector<BaseSensor*> SubscribedSensors; ///< Sensors with data pushed by the peer
+    std::vector<BaseSensor*> PolledSensors;   ///< Sensors synchronized by UPDATE requests (reused each cycle)
+    std::vector<ScheduledSync> SyncSchedule;  ///< Min-heap of selected sensors by due time
+    std::vector<ScheduledSync> DueSyncs;      ///< Sensors due in the current cycle (reused each cycle)
 
     size_t currentIndex = 0;                      ///< Index of the current sensor
     BaseSensor* currentWikiSensor = nullptr;    ///< Pointer to the current chosen wiki sensor
+    LinkWorker link;                            ///< Task running the protocol
+    bool syncInFlight = false;                  ///< Asynchronous sync request in flight (cleared by its relayed completion)
+    unsigned long syncStarted = 0;              ///< Time (ms) the sync request was posted
+    unsigned long syncStall = 0;                ///< Time (ms) after which the sync request is given up (see syncDeadline())
+    bool subscriptionsSupported = true;         ///< Whether the peer supports SUBSCRIBE requests at all
+    bool pinMapSupported = true;                ///< Whether the peer accepts PINMAP transactions
+    std::map<SensorHandle, std::string> AppliedPinMap; ///< Pins of sensors acknowledged by the peer (handle -> pins)
 
     bool initialized = false;                 ///< Initialization state flag
     ManagerStatus Status = ManagerStatus::STOPPED; ///< Current status of the manager
@@ -61,8 +131,106 @@ private:
     std::string DB_VERSION = "";    ///< Database version
     std::string APP_NAME = ""; ///< Application name
 
+    /**
+     * @brief Collect value and config keys of all sensors for the key schema
+     * @return Unique keys, keys of one sensor are adjacent
+     */
+    std::vector<std::string> collectSchemaKeys() const;
+
+    /**
+     * @brief Send the pin map difference, runs on the link and touches no sensor (see connect())
+     *
+     * Peers without PINMAP get the changes one sensor at a time.
+     * @param job The changes, output - the results
+     */
+    static void sendPinMap(PinMapJob& job);
+
+    /**
+     * @brief Apply the results of sendPinMap() to the sensors (GUI side)
+     * @param job The changes with their results
+     * @return true if the peer runs the current pin map
+     */
+    bool applyPinMap(const PinMapJob& job);
+
+    /**
+     * @brief Post a SUBSCRIBE request of a sensor at its period, the result is applied by onSubscribed()
+     * @param sensor The sensor
+     * @return false if the link is busy (the sensor stays polled)
+     */
+    bool postSubscribe(BaseSensor* sensor);
+
+    /**
+     * @brief Apply the result of a SUBSCRIBE request (GUI side)
+     * @param sensor The sensor
+     * @param subscribed Whether the peer accepted the subscription
+     * @param unsupported Whether the peer does not support SUBSCRIBE at all
+     */
+    void onSubscribed(BaseSensor* sensor, bool subscribed, bool unsupported);
+
+    /**
+     * @brief Assign handles to all sensors and index their UIDs
+     */
+    void indexSensors();
+
+    /**
+     * @brief Check a synchronization state bit of a sensor
+     */
+    bool hasSyncFlag(const BaseSensor* sensor, uint8_t flag) const { return (SyncFlags[sensor->getHandle()] & flag) != 0; }
+
+    /**
+     * @brief Set or clear a synchronization state bit of a sensor
+     */
+    void setSyncFlag(const BaseSensor* sensor, uint8_t flag, bool value);
+
+    /**
+     * @brief Heap order of the schedule, the earliest due time on top (wrap-around safe)
+     */
+    static bool laterDue(const ScheduledSync& a, const ScheduledSync& b);
+
+    /**
+     * @brief Schedule all selected sensors to be synchronized now
+     */
+    void rebuildSchedule();
+
+    /**
+     * @brief Return the sensor to the schedule one period after its last due time
+     * @param entry Entry taken from the schedule
+     * @param now Current time (ms)
+     */
+    void reschedule(ScheduledSync entry, unsigned long now);
+
+    /**
+     * @brief Synchronization priority of the sensor, the displayed sensor goes first
+     */
+    unsigned int syncPriority(const BaseSensor* sensor);
+
+    /**
+     * @brief Longest time the link may take for a sync batch (ms)
+     *
+     * Each configuration request and the batched request at their longest timeout
+     * (Protocol::maxRequestTimeout()), the completion is relayed by then at the latest.
+     */
+    static unsigned long syncDeadline(const SyncBatch& batch);
+
+    /**
+     * @brief Check if a sync request is in flight, one stalled past its deadline is given up
+     * @param now Current time (ms)
+     */
+    bool isSyncInFlight(unsigned long now);
+
+    /**
+     * @brief Post a sync batch to the link, cleared from flight by its completion
+     * @param batch The batch
+     * @param now Current time (ms)
+     * @return true if the batch was posted
+     */
+    bool postSync(const std::shared_ptr<SyncBatch>& batch, unsigned long now);
+
 public:
     const static uint8_t MAX_INIT_ATTEMPTS = 5; ///< Maximum initialization attempts
+    const static uint8_t SYNC_BUDGET = 4;           ///< Maximum number of sensors polled by one batched request
+    const static uint16_t FOREGROUND_PRIORITY = 0x100; ///< Priority boost of the displayed sensor (above all sensor priorities)
+    const static uint16_t SYNC_STALL_MARGIN_MS = PROTOCOL_MAX_TIMEOUT; ///< Added to the sync deadline for jobs queued before the request (ms)
     /**
      * @brief Private constructor for singleton pattern
      */
@@ -75,6 +243,9 @@ public:
 
     /**
      * @brief Load configuration file
+     *
+     * Sensors are built from the sensor database (JSON on the SD card, see SensorDb),
+     * from the fixed list if the path is empty.
      * @param configFile Path to configuration file
      */
     void loadConfigFile(std::string configFile);
@@ -105,28 +276,35 @@ public:
     void setRunning(bool running) { Status = running ? ManagerStatus::RUNNING : ManagerStatus::STOPPED; }
 
     /**
-     * @brief Check if any sensor requires a redraw
-     * @return True if any sensor has redrawPending flag set, false otherwise
+     * @brief Deliver sensor changes to the GUI components subscribed to them (once per frame)
+     * @return Number of delivered changes
      */
-    bool isRedrawPending() const {
-        for (const auto* sensor : Sensors) {
-            if (sensor && sensor->getRedrawPending()) {
-                return true;
-            }
-        }
-        return false;
-    }
+    size_t dispatchChanges() { return getChangeBus().dispatch(); }
+
+    /**
+     * @brief Find the handle of a sensor (protocol boundary, does not allocate)
+     * @param uid Unique identifier
+     * @return The handle, INVALID_SENSOR_HANDLE if not found
+     */
+    SensorHandle findSensor(const MessageView& uid) const { return Index.find(uid); }
+
+    /**
+     * @brief Get a sensor by its handle
+     * @param handle Sensor handle
+     * @return Pointer to the sensor, or nullptr if the handle is invalid
+     */
+    BaseSensor* getSensor(SensorHandle handle) const { return handle < Sensors.size() ? Sensors[handle] : nullptr; }
 
     /**
      * @brief Get a sensor by its unique ID
      * @param uid Unique identifier string
      * @return Pointer to the sensor, or nullptr if not found
      */
-    BaseSensor* getSensor(std::string uid);
+    BaseSensor* getSensor(const std::string& uid) const { return getSensor(findSensor(uid)); }
 
     /**
      * @brief Add a sensor to the manager
-     * @param sensor Pointer to the sensor to add
+     * @param sensor Pointer to the sensor to add, its handle is assigned
      */
     void addSensor(BaseSensor* sensor);
 
@@ -136,16 +314,30 @@ public:
     void resetPinMap();
 
     /**
-     * @brief Synchronize a sensor by ID
+     * @brief Request synchronization of a sensor, the values are applied by poll()
+     * @param handle Sensor handle
+     * @return true if the request was posted to the link, false also while a sync request is in flight
+     */
+    bool sync(SensorHandle handle);
+
+    /**
+     * @brief Request synchronization of a sensor by ID, the values are applied by poll()
      * @param id Unique identifier string
+     * @return true if the request was posted to the link
+     */
+    bool sync(const std::string& id) { return sync(findSensor(id)); }
+
+    /**
+     * @brief Print information about a sensor
+     * @param handle Sensor handle
      */
-    bool sync(std::string id);
+    void print(SensorHandle handle);
 
     /**
      * @brief Print information about a sensor by UID
      * @param uid Unique identifier string
      */
-    void print(std::string uid);
+    void print(const std::string& uid) { print(findSensor(uid)); }
 
     /**
      * @brief Print information about all sensors
@@ -153,14 +345,79 @@ public:
     void print();
 
     /**
-     * @brief Resynchronize all sensors
+     * @brief Resynchronize selected sensors which are due
+     *
+     * Every selected sensor is scheduled with its own period (BaseSensor::getSyncPeriod) in
+     * a min-heap by due time, so resync() may be called every frame. While running, selected
+     * sensors are subscribed to data pushed by the peer at their period. Due sensors which can
+     * not be subscribed (refused by the peer or peer without SUBSCRIBE support) and sensors with configuration to be
+     * sent are fetched by a single asynchronous batched UPDATE request, which is completed by
+     * poll(). One request carries at most SYNC_BUDGET sensors, the displayed sensor and higher
+     * priorities go first and the rest stays due for the next call. A new request is not sent
+     * while the previous one is in flight. When stopped, all subscriptions are dropped.
+     *
+     * All requests (configuration changes first, subscriptions) are only posted to the link
+     * task, so resync() does no I/O and does not wait for the link.
+     *
+     * @return true if sensor data are streamed or a request is in flight
      */
     bool resync();
 
     /**
-     * @brief Connect sensors to pins (bulk operation)
+     * @brief Set the synchronization period and priority of a sensor
+     * @param handle Sensor handle
+     * @param period Period (ms), 0 for the default
+     * @param priority Priority when the link budget is short, higher first
+     * @return true if the sensor exists
+     */
+    bool setSyncPeriod(SensorHandle handle, unsigned int period, uint8_t priority = 0);
+
+    /**
+     * @brief Set the synchronization period and priority of a sensor by ID
+     * @param uid Unique identifier string
+     * @param period Period (ms), 0 for the default
+     * @param priority Priority when the link budget is short, higher first
+     * @return true if the sensor exists
+     */
+    bool setSyncPeriod(const std::string& uid, unsigned int period, uint8_t priority = 0) { return setSyncPeriod(findSensor(uid), period, priority); }
+
+    /**
+     * @brief Match subscriptions to selected sensors and running state
+     *
+     * SUBSCRIBE requests are posted to the link, a sensor is polled until its subscription
+     * is confirmed. A sensor refused by the peer is polled instead, all sensors are polled
+     * only if the peer does not support SUBSCRIBE.
+     */
+    void updateSubscriptions();
+
+    /**
+     * @brief Deliver received sensor data, never blocks
+     *
+     * With the link task running, the sensor updates it passed are applied,
+     * otherwise the link is polled in place.
+     *
+     * @return Number of completed requests or delivered updates
      */
-    bool connect();
+    size_t poll();
+
+    /**
+     * @brief Get the link worker, e.g. to post jobs which do not touch sensors
+     *
+     * Results go back by LinkWorker::complete() (or the record relay) and are run by poll().
+     */
+    LinkWorker& getLink() { return link; }
+
+    /**
+     * @brief Connect sensors to pins (bulk operation)
+     *
+     * Only the difference against the last applied pin map is sent, as one PINMAP
+     * transaction the peer acknowledges or rejects as a whole. Unchanged layout
+     * needs no request at all. The request is posted to the link, the result is
+     * applied and passed to @p onDone by poll() (right away if nothing changed).
+     * @param onDone Handler of the result (optional)
+     * @return false if the link is busy and nothing was sent
+     */
+    bool connect(const ConnectHandler& onDone = ConnectHandler());
 
     /**
      * @brief Erase all sensors and pin assignments
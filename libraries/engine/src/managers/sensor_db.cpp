@@ -0,0 +1,505 @@
+/**
+ * @file sensor_db.cpp
+ * @brief Definition of the sensor database loader
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <algorithm>
+#include "sensor_db.hpp"
+
+#ifdef ARDUINO_H
+#include "SD.h"
+#else
+#include <cstdio>
+#endif
+
+static const uint8_t IMAGE_MAGIC[4] = {'V', 'S', 'D', 'B'};
+
+/*********************
+ *  IMAGE ENCODING
+ *********************/
+
+static void putU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+static void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    putU16(out, static_cast<uint16_t>(value));
+    putU16(out, static_cast<uint16_t>(value >> 16));
+}
+
+static void putString(std::vector<uint8_t>& out, const std::string& value) {
+    size_t size = value.size() < 0xFFFF ? value.size() : 0xFFFF;
+    putU16(out, static_cast<uint16_t>(size));
+    out.insert(out.end(), value.begin(), value.begin() + size);
+}
+
+static bool getU8(const uint8_t*& data, const uint8_t* end, uint8_t& value) {
+    if (end - data < 1) return false;
+    value = *data++;
+    return true;
+}
+
+static bool getU16(const uint8_t*& data, const uint8_t* end, uint16_t& value) {
+    if (end - data < 2) return false;
+    value = static_cast<uint16_t>(data[0] | (data[1] << 8));
+    data += 2;
+    return true;
+}
+
+static bool getU32(const uint8_t*& data, const uint8_t* end, uint32_t& value) {
+    uint16_t low, high;
+    if (!getU16(data, end, low) || !getU16(data, end, high)) return false;
+    value = low | (static_cast<uint32_t>(high) << 16);
+    return true;
+}
+
+static bool getString(const uint8_t*& data, const uint8_t* end, std::string& value) {
+    uint16_t size;
+    if (!getU16(data, end, size) || end - data < size) return false;
+    value.assign(reinterpret_cast<const char*>(data), size);
+    data += size;
+    return true;
+}
+
+static uint32_t checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void putParam(std::vector<uint8_t>& out, const std::pair<std::string, SensorParam>& param) {
+    putString(out, param.first);
+    putString(out, param.second.Value);
+    putString(out, param.second.Unit);
+    out.push_back(static_cast<uint8_t>(param.second.DType));
+    putString(out, param.second.Restrictions.Min);
+    putString(out, param.second.Restrictions.Max);
+    putString(out, param.second.Restrictions.Step);
+    putString(out, param.second.Restrictions.Options);
+}
+
+static bool getParam(const uint8_t*& data, const uint8_t* end, std::pair<std::string, SensorParam>& param) {
+    uint8_t type;
+    param.second = SensorParam();
+    if (!getString(data, end, param.first) || !getString(data, end, param.second.Value) ||
+        !getString(data, end, param.second.Unit) || !getU8(data, end, type) ||
+        !getString(data, end, param.second.Restrictions.Min) || !getString(data, end, param.second.Restrictions.Max) ||
+        !getString(data, end, param.second.Restrictions.Step) || !getString(data, end, param.second.Restrictions.Options)) {
+        return false;
+    }
+    param.second.DType = type <= static_cast<uint8_t>(SensorDataType::STRING) ? static_cast<SensorDataType>(type) : SensorDataType::STRING;
+    return true;
+}
+
+static SensorDataType parseDataType(const std::string& type) {
+    if (type == "int") return SensorDataType::INT;
+    if (type == "float") return SensorDataType::FLOAT;
+    if (type == "double") return SensorDataType::DOUBLE;
+    return SensorDataType::STRING;
+}
+
+static bool isScalar(JsonToken token) {
+    return token == JsonToken::STRING || token == JsonToken::NUMBER || token == JsonToken::LITERAL;
+}
+
+/*********************
+ *  SENSOR SPEC
+ *********************/
+
+void SensorDb::SensorSpec::reset() {
+    uid.clear();
+    type.clear();
+    description.clear();
+    pins.clear();
+    valueCount = 0;
+    configCount = 0;
+}
+
+std::pair<std::string, SensorParam>& SensorDb::SensorSpec::add(std::vector<std::pair<std::string, SensorParam>>& list, size_t& count) {
+    if (count == list.size()) list.emplace_back();
+    auto& entry = list[count++];
+    entry.first.clear();
+    entry.second = SensorParam();
+    entry.second.DType = SensorDataType::STRING;
+    return entry;
+}
+
+/*********************
+ *  JSON
+ *********************/
+
+bool SensorDb::readScalar(JsonStream& json, JsonToken token, std::string& out) {
+    if (!isScalar(token)) {
+        json.skip(token);
+        return false;
+    }
+    if (token == JsonToken::LITERAL && json.text() == "null") out.clear();
+    else out = json.text();
+    return true;
+}
+
+void SensorDb::parseParams(JsonStream& json, std::vector<std::pair<std::string, SensorParam>>& list, size_t& count) {
+    std::string field;
+    for (JsonToken token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+        auto& entry = SensorSpec::add(list, count);
+        entry.first = json.text();
+
+        token = json.next();
+        if (token != JsonToken::OBJECT_BEGIN) {
+            readScalar(json, token, entry.second.Value); // "key": value
+            continue;
+        }
+
+        for (token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+            field = json.text();
+            token = json.next();
+            if (field == "value") readScalar(json, token, entry.second.Value);
+            else if (field == "unit") readScalar(json, token, entry.second.Unit);
+            else if (field == "dtype") {
+                std::string type;
+                if (readScalar(json, token, type)) entry.second.DType = parseDataType(type);
+            }
+            else if (field == "restrictions" && token == JsonToken::OBJECT_BEGIN) {
+                SensorRestrictions& restrictions = entry.second.Restrictions;
+                for (token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+                    field = json.text();
+                    token = json.next();
+                    if (field == "min") readScalar(json, token, restrictions.Min);
+                    else if (field == "max") readScalar(json, token, restrictions.Max);
+                    else if (field == "step") readScalar(json, token, restrictions.Step);
+                    else if (field == "options") readScalar(json, token, restrictions.Options);
+                    else json.skip(token);
+                }
+            }
+            else json.skip(token);
+        }
+    }
+}
+
+void SensorDb::parseDefaults(JsonStream& json, std::vector<std::pair<std::string, SensorParam>>& list, size_t count) {
+    std::string key;
+    for (JsonToken token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+        key = json.text();
+        token = json.next();
+
+        size_t i = 0;
+        while (i < count && list[i].first != key) i++;
+        if (i < count) readScalar(json, token, list[i].second.Value);
+        else json.skip(token); // Default of an undeclared parameter
+    }
+}
+
+void SensorDb::parseSensor(JsonStream& json, SensorSpec& spec) {
+    std::string field;
+    for (JsonToken token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+        field = json.text();
+        token = json.next();
+        if (field == "uid") readScalar(json, token, spec.uid);
+        else if (field == "type") readScalar(json, token, spec.type);
+        else if (field == "description") readScalar(json, token, spec.description);
+        else if (field == "values" && token == JsonToken::OBJECT_BEGIN) parseParams(json, spec.values, spec.valueCount);
+        else if (field == "configs" && token == JsonToken::OBJECT_BEGIN) parseParams(json, spec.configs, spec.configCount);
+        else if (field == "default" && token == JsonToken::OBJECT_BEGIN) {
+            // Defaults apply to the parameters declared before them
+            for (token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+                field = json.text();
+                token = json.next();
+                if (field == "values" && token == JsonToken::OBJECT_BEGIN) parseDefaults(json, spec.values, spec.valueCount);
+                else if (field == "configs" && token == JsonToken::OBJECT_BEGIN) parseDefaults(json, spec.configs, spec.configCount);
+                else if (field == "pins") readScalar(json, token, spec.pins);
+                else json.skip(token);
+            }
+        }
+        else json.skip(token);
+    }
+}
+
+void SensorDb::parseJson(JsonStream& json, std::vector<BaseSensor*>& sensors, SensorDbInfo& info, std::vector<uint8_t>* image) {
+    if (json.next() != JsonToken::OBJECT_BEGIN) {
+        throw InvalidFileFormatException("SensorDb::parseJson", "Sensor database is not an object");
+    }
+
+    SensorSpec spec;
+    std::vector<uint8_t> body;
+    uint16_t count = 0;
+    std::string field;
+    for (JsonToken token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+        field = json.text();
+        token = json.next();
+        if (field == "version") readScalar(json, token, info.version);
+        else if (field == "application") readScalar(json, token, info.application);
+        else if (field == "sensors" && token == JsonToken::OBJECT_BEGIN) {
+            for (token = json.next(); token != JsonToken::OBJECT_END; token = json.next()) {
+                spec.reset();
+                spec.uid = json.text(); // Key of the sensor, unless it has its own "uid"
+
+                token = json.next();
+                if (token != JsonToken::OBJECT_BEGIN) {
+                    json.skip(token);
+                    continue;
+                }
+                parseSensor(json, spec);
+                if (count == INVALID_SENSOR_HANDLE) {
+                    throw InvalidFileFormatException("SensorDb::parseJson", "Too many sensors");
+                }
+
+                sensors.push_back(buildSensor(spec));
+                if (image) writeSpec(body, spec);
+                count++;
+            }
+        }
+        else json.skip(token);
+    }
+
+    if (!image) return;
+
+    // Header is known only now, the version may follow the sensors
+    image->clear();
+    image->reserve(body.size() + 64);
+    image->insert(image->end(), IMAGE_MAGIC, IMAGE_MAGIC + sizeof(IMAGE_MAGIC));
+    image->push_back(SENSOR_DB_IMAGE_FORMAT);
+    putString(*image, info.version);
+    putString(*image, info.application);
+    putU32(*image, info.sourceSize);
+    putU32(*image, info.sourceTime);
+    putU16(*image, count);
+    image->insert(image->end(), body.begin(), body.end());
+    putU32(*image, checksum(image->data(), image->size()));
+}
+
+/*********************
+ *  IMAGE
+ *********************/
+
+void SensorDb::writeSpec(std::vector<uint8_t>& image, const SensorSpec& spec) {
+    putString(image, spec.uid);
+    putString(image, spec.type);
+    putString(image, spec.description);
+    putString(image, spec.pins);
+    image.push_back(static_cast<uint8_t>(spec.valueCount));
+    for (size_t i = 0; i < spec.valueCount && i < 0xFF; i++) putParam(image, spec.values[i]);
+    image.push_back(static_cast<uint8_t>(spec.configCount));
+    for (size_t i = 0; i < spec.configCount && i < 0xFF; i++) putParam(image, spec.configs[i]);
+}
+
+bool SensorDb::readSpec(const uint8_t*& data, const uint8_t* end, SensorSpec& spec) {
+    uint8_t values, configs;
+    spec.reset();
+    if (!getString(data, end, spec.uid) || !getString(data, end, spec.type) ||
+        !getString(data, end, spec.description) || !getString(data, end, spec.pins) ||
+        !getU8(data, end, values)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < values; i++) {
+        if (!getParam(data, end, SensorSpec::add(spec.values, spec.valueCount))) return false;
+    }
+    if (!getU8(data, end, configs)) return false;
+    for (uint8_t i = 0; i < configs; i++) {
+        if (!getParam(data, end, SensorSpec::add(spec.configs, spec.configCount))) return false;
+    }
+    return true;
+}
+
+const uint8_t* SensorDb::readHeader(const uint8_t* data, size_t size, SensorDbInfo& info, uint16_t& count) {
+    if (!data || size < sizeof(IMAGE_MAGIC) + 4) return nullptr;
+
+    const uint8_t* end = data + size - 4;
+    const uint8_t* tail = end;
+    uint32_t sum;
+    if (!getU32(tail, data + size, sum) || sum != checksum(data, size - 4)) return nullptr;
+    if (!std::equal(IMAGE_MAGIC, IMAGE_MAGIC + sizeof(IMAGE_MAGIC), data)) return nullptr;
+
+    data += sizeof(IMAGE_MAGIC);
+    uint8_t format;
+    if (!getU8(data, end, format) || format != SENSOR_DB_IMAGE_FORMAT) return nullptr;
+    if (!getString(data, end, info.version) || !getString(data, end, info.application) ||
+        !getU32(data, end, info.sourceSize) || !getU32(data, end, info.sourceTime) || !getU16(data, end, count)) {
+        return nullptr;
+    }
+    return data;
+}
+
+bool SensorDb::readImageInfo(const uint8_t* data, size_t size, SensorDbInfo& info) {
+    uint16_t count;
+    return readHeader(data, size, info, count) != nullptr;
+}
+
+bool SensorDb::readImage(const uint8_t* data, size_t size, std::vector<BaseSensor*>& sensors, SensorDbInfo& info) {
+    uint16_t count;
+    const uint8_t* next = readHeader(data, size, info, count);
+    if (!next) return false;
+
+    const uint8_t* end = data + size - 4;
+    SensorSpec spec;
+    std::vector<BaseSensor*> created;
+    created.reserve(count);
+    try {
+        for (uint16_t i = 0; i < count; i++) {
+            if (!readSpec(next, end, spec)) {
+                for (auto* sensor : created) delete sensor;
+                return false;
+            }
+            created.push_back(buildSensor(spec));
+        }
+    }
+    catch (...) {
+        for (auto* sensor : created) delete sensor;
+        throw;
+    }
+    sensors.insert(sensors.end(), created.begin(), created.end());
+    return true;
+}
+
+/*********************
+ *  SENSORS
+ *********************/
+
+BaseSensor* SensorDb::buildSensor(const SensorSpec& spec) {
+    BaseSensor* sensor = createSensorByType(spec.type, spec.uid);
+    if (!sensor) sensor = new GenericSensor(spec.uid, spec.type);
+
+    try {
+        if (!spec.description.empty()) sensor->Description = spec.description;
+        if (spec.valueCount > 0 || spec.configCount > 0) sensor->clearParameters(); // The database replaces the defaults of the type
+        for (size_t i = 0; i < spec.valueCount; i++) sensor->addValueParameter(spec.values[i].first, spec.values[i].second);
+        for (size_t i = 0; i < spec.configCount; i++) sensor->addConfigParameter(spec.configs[i].first, spec.configs[i].second);
+
+        size_t start = 0;
+        while (start < spec.pins.size()) {
+            size_t stop = spec.pins.find(',', start);
+            if (stop == std::string::npos) stop = spec.pins.size();
+            size_t first = spec.pins.find_first_not_of(' ', start);
+            size_t last = spec.pins.find_last_not_of(' ', stop - 1);
+            if (first < stop && last != std::string::npos && last >= first) {
+                sensor->assignPin(spec.pins.substr(first, last - first + 1));
+            }
+            start = stop + 1;
+        }
+    }
+    catch (...) {
+        delete sensor;
+        throw;
+    }
+    return sensor;
+}
+
+std::string SensorDb::imagePath(const std::string& jsonPath) {
+    size_t dot = jsonPath.find_last_of('.');
+    size_t slash = jsonPath.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return jsonPath + SENSOR_DB_IMAGE_EXT;
+    return jsonPath.substr(0, dot) + SENSOR_DB_IMAGE_EXT;
+}
+
+/*********************
+ *  STORAGE
+ *********************/
+
+#ifdef ARDUINO_H
+void SensorDb::load(const std::string& jsonPath, std::vector<BaseSensor*>& sensors, SensorDbInfo& info) {
+    unsigned long start = getTimeMs();
+    std::string image = imagePath(jsonPath);
+
+    bool hasJson = SD.exists(jsonPath.c_str());
+    uint32_t jsonSize = 0;
+    uint32_t jsonTime = 0;
+    if (hasJson) {
+        File file = SD.open(jsonPath.c_str(), FILE_READ);
+        if (file) {
+            jsonSize = static_cast<uint32_t>(file.size());
+            jsonTime = static_cast<uint32_t>(file.getLastWrite());
+        }
+        file.close();
+    }
+
+    std::vector<uint8_t> data;
+    SensorDbInfo cached;
+    bool hasImage = false;
+    if (SD.exists(image.c_str())) {
+        File file = SD.open(image.c_str(), FILE_READ);
+        if (file) {
+            data.resize(file.size());
+            data.resize(file.read(data.data(), data.size()));
+            file.close();
+        }
+        hasImage = readImageInfo(data.data(), data.size(), cached);
+    }
+
+    // Image of the same JSON: one bulk read, the JSON is not read at all
+    bool current = hasImage && (!hasJson || (cached.sourceSize == jsonSize && cached.sourceTime == jsonTime));
+    if (current && readImage(data.data(), data.size(), sensors, info)) {
+        logMessage("\tSensor database %s loaded from image in %lu ms\n", info.version.c_str(), getTimeMs() - start);
+        return;
+    }
+
+    if (!hasJson) {
+        throw FileNotFoundException("SensorDb::load", "Sensor database " + jsonPath + " not found");
+    }
+    if (hasImage) logMessage("\tSensor database image outdated, rebuilding...\n");
+
+    File file = SD.open(jsonPath.c_str(), FILE_READ);
+    JsonStream json([&file](uint8_t* buffer, size_t size) { return static_cast<size_t>(file.read(buffer, size)); });
+    std::vector<BaseSensor*> created;
+    std::vector<uint8_t> compiled;
+    info.sourceSize = jsonSize;
+    info.sourceTime = jsonTime;
+    try {
+        if (!file) {
+            throw FileReadException("SensorDb::load", "Sensor database " + jsonPath + " cannot be opened");
+        }
+        parseJson(json, created, info, &compiled);
+    }
+    catch (...) {
+        if (file) file.close();
+        for (auto* sensor : created) delete sensor;
+        created.clear();
+
+        // A broken JSON does not lose the last good database
+        info = SensorDbInfo();
+        if (!hasImage || !readImage(data.data(), data.size(), sensors, info)) throw;
+        logMessage("\tSensor database %s unreadable, image %s loaded instead\n", jsonPath.c_str(), info.version.c_str());
+        return;
+    }
+    file.close();
+    sensors.insert(sensors.end(), created.begin(), created.end());
+    logMessage("\tSensor database %s parsed in %lu ms\n", info.version.c_str(), getTimeMs() - start);
+
+    // A failed write only costs parsing on the next boot
+    SD.remove(image.c_str());
+    File out = SD.open(image.c_str(), FILE_WRITE);
+    if (!out || out.write(compiled.data(), compiled.size()) != compiled.size()) {
+        logMessage("\tSensor database image not saved\n");
+    }
+    if (out) out.close();
+}
+#else
+void SensorDb::load(const std::string& jsonPath, std::vector<BaseSensor*>& sensors, SensorDbInfo& info) {
+    // No image cache on the host, the JSON is parsed every time
+    FILE* file = fopen(jsonPath.c_str(), "rb");
+    if (!file) {
+        throw FileNotFoundException("SensorDb::load", "Sensor database " + jsonPath + " not found");
+    }
+    JsonStream json([file](uint8_t* buffer, size_t size) { return fread(buffer, 1, size, file); });
+    std::vector<BaseSensor*> created;
+    try {
+        parseJson(json, created, info, nullptr);
+    }
+    catch (...) {
+        fclose(file);
+        for (auto* sensor : created) delete sensor;
+        throw;
+    }
+    fclose(file);
+    sensors.insert(sensors.end(), created.begin(), created.end());
+}
+#endif
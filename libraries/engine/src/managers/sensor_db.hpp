@@ -0,0 +1,166 @@
+/**
+ * @file sensor_db.hpp
+ * @brief Declaration of the sensor database loader
+ *
+ * This header defines the loader building sensors from the JSON sensor database
+ * (see data/sensor_db.json). The first boot with a changed JSON streams it and
+ * compiles it into a binary image stored next to it, later boots read the image
+ * in one piece instead of parsing the JSON. The image is keyed on the size and
+ * modification time of the JSON, so checking it does not read the JSON.
+ *
+ * Image layout (little endian, strings are u16 length + bytes):
+ * "VSDB", u8 format, version, application, u32 JSON size, u32 JSON modification time, u16 sensor count,
+ * sensors (uid, type, description, pins, u8 value count, values, u8 config count, configs),
+ * u32 FNV-1a checksum of everything before it.
+ * Parameter: key, value, unit, u8 data type, min, max, step, options.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+#ifndef SENSOR_DB_HPP
+#define SENSOR_DB_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include "json_stream.hpp"
+#include "../sensors/sensor_factory.hpp"
+
+#define SENSOR_DB_IMAGE_EXT ".bin"  ///< Extension of the image, replaces the one of the JSON
+#define SENSOR_DB_IMAGE_FORMAT 2    ///< Format of the image, images of other formats are rebuilt
+
+/**
+ * @struct SensorDbInfo
+ * @brief Header of the sensor database.
+ */
+struct SensorDbInfo {
+    std::string version;     ///< Database version ("version")
+    std::string application; ///< Application ("application")
+    uint32_t sourceSize = 0; ///< Size of the JSON the image was compiled from, keys the image
+    uint32_t sourceTime = 0; ///< Modification time of the JSON the image was compiled from, keys the image
+};
+
+/**
+ * @class SensorDb
+ * @brief Sensor database loader (JSON and its binary image).
+ */
+class SensorDb {
+private:
+    /**
+     * @struct SensorSpec
+     * @brief Sensor read from the database, reused for every sensor so its buffers are allocated once.
+     */
+    struct SensorSpec {
+        std::string uid;                                          ///< Unique identifier
+        std::string type;                                         ///< Type
+        std::string description;                                  ///< Description
+        std::string pins;                                         ///< Default pins, separated by ","
+        std::vector<std::pair<std::string, SensorParam>> values;  ///< Value parameters
+        std::vector<std::pair<std::string, SensorParam>> configs; ///< Configuration parameters
+        size_t valueCount = 0;                                    ///< Used entries of values
+        size_t configCount = 0;                                   ///< Used entries of configs
+
+        /**
+         * @brief Forget the sensor, keep the buffers
+         */
+        void reset();
+
+        /**
+         * @brief Next free parameter entry of a list (reused or appended)
+         */
+        static std::pair<std::string, SensorParam>& add(std::vector<std::pair<std::string, SensorParam>>& list, size_t& count);
+    };
+
+    /**
+     * @brief Read one sensor object (after its OBJECT_BEGIN)
+     */
+    static void parseSensor(JsonStream& json, SensorSpec& spec);
+
+    /**
+     * @brief Read an object of parameters ("values" or "configs", after its OBJECT_BEGIN)
+     */
+    static void parseParams(JsonStream& json, std::vector<std::pair<std::string, SensorParam>>& list, size_t& count);
+
+    /**
+     * @brief Read an object of default values (after its OBJECT_BEGIN), overrides values of declared parameters
+     */
+    static void parseDefaults(JsonStream& json, std::vector<std::pair<std::string, SensorParam>>& list, size_t count);
+
+    /**
+     * @brief Read a scalar value (null is read as empty), other values are skipped
+     * @param json The JSON
+     * @param token First token of the value
+     * @param out Filled with the value
+     * @return false if the value was not a scalar
+     */
+    static bool readScalar(JsonStream& json, JsonToken token, std::string& out);
+
+    /**
+     * @brief Create the sensor described by a spec (registered type or GenericSensor)
+     */
+    static BaseSensor* buildSensor(const SensorSpec& spec);
+
+    /**
+     * @brief Append a sensor to the image
+     */
+    static void writeSpec(std::vector<uint8_t>& image, const SensorSpec& spec);
+
+    /**
+     * @brief Read a sensor from the image
+     * @return false if the image is truncated
+     */
+    static bool readSpec(const uint8_t*& data, const uint8_t* end, SensorSpec& spec);
+
+    /**
+     * @brief Read the header of the image, checks its magic, format and checksum
+     * @return Pointer to the first sensor, nullptr if the image is not valid
+     */
+    static const uint8_t* readHeader(const uint8_t* data, size_t size, SensorDbInfo& info, uint16_t& count);
+
+public:
+    /**
+     * @brief Load sensors from the database on the SD card (a file of the host on STDIO builds)
+     *
+     * The image is used if the size and modification time of the JSON match it (or if there
+     * is no JSON), otherwise the JSON is parsed and the image rebuilt. A valid image is also
+     * used if the JSON cannot be read or is malformed.
+     * @param jsonPath Path to the JSON database
+     * @param sensors Created sensors are appended
+     * @param info Filled with the database header
+     * @throws FileNotFoundException if neither the JSON nor a valid image exist
+     * @throws InvalidFileFormatException if the JSON is malformed and there is no valid image
+     */
+    static void load(const std::string& jsonPath, std::vector<BaseSensor*>& sensors, SensorDbInfo& info);
+
+    /**
+     * @brief Parse a JSON database
+     * @param json The JSON
+     * @param sensors Created sensors are appended
+     * @param info Filled with the database header, its sourceSize and sourceTime are stored in the image
+     * @param image Filled with the compiled image if not nullptr
+     * @throws InvalidFileFormatException if the JSON is malformed
+     */
+    static void parseJson(JsonStream& json, std::vector<BaseSensor*>& sensors, SensorDbInfo& info, std::vector<uint8_t>* image);
+
+    /**
+     * @brief Read the header of an image
+     * @return false if the image is not valid
+     */
+    static bool readImageInfo(const uint8_t* data, size_t size, SensorDbInfo& info);
+
+    /**
+     * @brief Create sensors from an image
+     * @param sensors Created sensors are appended
+     * @return false if the image is not valid (no sensor is created then)
+     */
+    static bool readImage(const uint8_t* data, size_t size, std::vector<BaseSensor*>& sensors, SensorDbInfo& info);
+
+    /**
+     * @brief Path of the image of a JSON database
+     */
+    static std::string imagePath(const std::string& jsonPath);
+};
+
+#endif // SENSOR_DB_HPP
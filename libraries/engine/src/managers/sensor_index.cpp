@@ -0,0 +1,77 @@
+/**
+ * @file sensor_index.cpp
+ * @brief Definition of the sensor index
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "sensor_index.hpp"
+
+uint32_t SensorIndex::hashUid(const MessageView& uid) {
+    uint32_t hash = 2166136261u;
+    for (char c : uid) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void SensorIndex::place(uint32_t hash, SensorHandle handle) {
+    size_t mask = Slots.size() - 1;
+    size_t i = hash & mask;
+    while (Slots[i].handle != INVALID_SENSOR_HANDLE) i = (i + 1) & mask;
+    Slots[i].hash = hash;
+    Slots[i].handle = handle;
+}
+
+void SensorIndex::grow(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(Slots);
+    Slots.resize(capacity);
+    for (const auto& slot : old) {
+        if (slot.handle != INVALID_SENSOR_HANDLE) place(slot.hash, slot.handle);
+    }
+}
+
+bool SensorIndex::insert(SensorHandle handle) {
+    if (handle >= Sensors.size() || !Sensors[handle]) return false;
+    if (find(Sensors[handle]->UID) != INVALID_SENSOR_HANDLE) return false;
+
+    // Keep at most half of the slots used, probe sequences stay short
+    if ((count + 1) * 2 > Slots.size()) {
+        grow(Slots.empty() ? 16 : Slots.size() * 2);
+    }
+    place(hashUid(Sensors[handle]->UID), handle);
+    count++;
+    return true;
+}
+
+void SensorIndex::rebuild() {
+    clear();
+    for (size_t i = 0; i < Sensors.size() && i < INVALID_SENSOR_HANDLE; i++) {
+        insert(static_cast<SensorHandle>(i));
+    }
+}
+
+void SensorIndex::clear() {
+    Slots.clear();
+    count = 0;
+}
+
+SensorHandle SensorIndex::find(const MessageView& uid) const {
+    if (Slots.empty()) return INVALID_SENSOR_HANDLE;
+
+    uint32_t hash = hashUid(uid);
+    size_t mask = Slots.size() - 1;
+    for (size_t i = hash & mask; Slots[i].handle != INVALID_SENSOR_HANDLE; i = (i + 1) & mask) {
+        if (Slots[i].hash == hash && MessageView(Sensors[Slots[i].handle]->UID) == uid) {
+            return Slots[i].handle;
+        }
+    }
+    return INVALID_SENSOR_HANDLE;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file sensor_index.hpp
+ * @brief Declaration of the sensor index
+ *
+ * This header defines the open-addressing hash index mapping sensor UIDs to
+ * sensor handles, used by the manager to resolve UIDs at the protocol boundary.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+#ifndef SENSOR_INDEX_HPP
+#define SENSOR_INDEX_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "../sensors/base_sensor.hpp"
+
+/**
+ * @class SensorIndex
+ * @brief UID to handle index with open addressing (linear probing).
+ *
+ * Slots keep the UID hash and the handle, UIDs themselves are compared in the
+ * sensor list the handles point to, so a lookup hashes once, compares one UID
+ * in the common case and never allocates. The table is kept at most half full.
+ */
+class SensorIndex {
+private:
+    /**
+     * @struct Slot
+     * @brief One slot of the table.
+     */
+    struct Slot {
+        uint32_t hash = 0;                           ///< Hash of the UID
+        SensorHandle handle = INVALID_SENSOR_HANDLE; ///< Handle, INVALID_SENSOR_HANDLE if the slot is free
+    };
+
+    const std::vector<BaseSensor*>& Sensors; ///< Sensor list the handles point to
+    std::vector<Slot> Slots;                 ///< Table, size is zero or a power of two
+    size_t count = 0;                        ///< Number of used slots
+
+    /**
+     * @brief Hash of a UID (FNV-1a)
+     */
+    static uint32_t hashUid(const MessageView& uid);
+
+    /**
+     * @brief Put a handle into a free slot, the table must have one
+     */
+    void place(uint32_t hash, SensorHandle handle);
+
+    /**
+     * @brief Resize the table and place all handles again
+     * @param capacity New number of slots (power of two)
+     */
+    void grow(size_t capacity);
+
+public:
+    /**
+     * @brief Constructor
+     * @param sensors Sensor list the handles point to (handle = index)
+     */
+    explicit SensorIndex(const std::vector<BaseSensor*>& sensors) : Sensors(sensors) {}
+
+    /**
+     * @brief Index the sensor with the given handle
+     * @param handle Handle (index) of the sensor in the list
+     * @return false if a sensor with the same UID is indexed already (the first one is kept)
+     */
+    bool insert(SensorHandle handle);
+
+    /**
+     * @brief Index all sensors of the list
+     */
+    void rebuild();
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear();
+
+    /**
+     * @brief Find the handle of a sensor
+     * @param uid Unique identifier
+     * @return The handle, INVALID_SENSOR_HANDLE if not found
+     */
+    SensorHandle find(const MessageView& uid) const;
+
+    /**
+     * @brief Number of indexed sensors
+     */
+    size_t size() const { return count; }
+};
+
+#endif // SENSOR_INDEX_HPP
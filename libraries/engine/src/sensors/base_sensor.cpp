@@ -143,6 +143,321 @@ bool syncSensor(BaseSensor *sensor) {
     }
 }
 
+void prepareSyncBatch(const std::vector<BaseSensor *> &sensors, SyncBatch &batch) {
+    batch.sensors.reserve(sensors.size());
+    batch.uids.reserve(sensors.size());
+    batch.revisions.reserve(sensors.size());
+
+    for (auto *sensor : sensors) {
+        if (sensor == nullptr) {
+            continue;
+        }
+
+        // Configuration is only collected, changes still within the coalescing window wait
+        if (sensor->isConfigSyncDue()) {
+            ConfigChange change = {sensor, sensor->UID, sensor->getConfigChanges()};
+            batch.configs.push_back(std::move(change));
+        }
+        sensor->clearError(); // Clear error if sync successful
+        sensor->invalidateValues(); // Until its record arrives
+        batch.sensors.push_back(sensor);
+        batch.uids.push_back(sensor->UID);
+        batch.revisions.push_back(sensor->getRevision()); // Only values changed since are sent back
+    }
+}
+
+static RecordRelay recordRelay; ///< Passes records to the task owning the sensors (empty - applied right away)
+
+void setRecordRelay(const RecordRelay &relay) {
+    recordRelay = relay;
+}
+
+static SensorResolver sensorResolver; ///< Finds sensors of records by UID (empty - UIDs compared in the batch)
+
+void setSensorResolver(const SensorResolver &resolver) {
+    sensorResolver = resolver;
+}
+
+/**
+ * @brief Wraps a record handler so it runs on the task which owns the sensors.
+ *
+ * Without a relay the handler runs right away, otherwise the record is copied (its views
+ * die with the Protocol call) and the handler runs when the relay delivers the copy.
+ *
+ * @param keep false if the relay may drop the record (pushed by a subscription).
+ */
+static ResponseRecordHandler relayed(const ResponseRecordHandler &handler, bool keep = true) {
+    return [handler, keep](const ResponseStatusView &record) {
+        if (!recordRelay) {
+            handler(record);
+            return;
+        }
+        ResponseRecordCopy copy(record);
+        recordRelay([handler, copy]() {
+            ResponseStatusView view;
+            copy.view(view);
+            handler(view);
+        }, keep);
+    };
+}
+
+/**
+ * @brief Applies the response of a CONFIG request to the sensor.
+ *
+ * @return false if the configuration was refused.
+ */
+static bool applyConfig(const ConfigChange &change, const ResponseStatus &response) {
+    try {
+        change.sensor->applyConfigResponse(change.values, response);
+        return true;
+    } catch (const Exception &ex) {
+        ex.print();
+        change.sensor->setError(ex.flush(0));
+        return false;
+    }
+    catch (const std::exception &e)
+    {
+        std::string msg = buildMessage("Standard exception during synchronization: %s\n", e.what());
+        logMessage("%s", msg.c_str());
+        change.sensor->setError(msg);
+        return false;
+    }
+    catch(...)
+    {
+        std::string msg = "Unknown exception during synchronization!\n";
+        logMessage("%s", msg.c_str());
+        change.sensor->setError(msg);
+        return false;
+    }
+}
+
+/**
+ * @brief Sends configuration of the batch, one CONFIG request per sensor.
+ *
+ * @param relay Whether the responses are applied where the record relay delivers them (link side).
+ * @return false if some configuration was refused (only known if applied right away).
+ */
+static bool sendConfigs(const SyncBatch &batch, bool relay) {
+    bool result = true;
+    for (const auto &change : batch.configs) {
+        ResponseStatus response;
+        response.status = ResponseStatusEnum::OK; // Nothing left to send, only confirmed
+        if (!change.values.empty()) {
+            response = Protocol::config(change.uid, change.values);
+        }
+
+        if (relay && recordRelay) {
+            recordRelay([change, response]() { applyConfig(change, response); }, true);
+        } else {
+            result &= applyConfig(change, response);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Applies an update record (response or pushed frame) to the sensor.
+ *
+ * @return false if the record failed to apply.
+ */
+static bool applyRecord(BaseSensor *sensor, const ResponseStatusView &record) {
+    try {
+        return sensor->ingest(record);
+    } catch (const Exception &ex) {
+        ex.print();
+        sensor->setError(ex.flush(0));
+        return false;
+    }
+    catch (const std::exception &e)
+    {
+        std::string msg = buildMessage("Standard exception during synchronization: %s\n", e.what());
+        logMessage("%s", msg.c_str());
+        sensor->setError(msg);
+        return false;
+    }
+    catch(...)
+    {
+        std::string msg = "Unknown exception during synchronization!\n";
+        logMessage("%s", msg.c_str());
+        sensor->setError(msg);
+        return false;
+    }
+}
+
+/**
+ * @brief Applies one record of a batched update to the matching sensor of the batch.
+ *
+ * @return false if the record failed to apply.
+ */
+static bool ingestRecord(const std::vector<BaseSensor *> &batch, const ResponseStatusView &record) {
+    // Resolved once, the sensors of the batch are matched by handle
+    MessageView id = record.params.get("id");
+    SensorHandle handle = sensorResolver ? sensorResolver(id) : INVALID_SENSOR_HANDLE;
+    for (auto *sensor : batch) {
+        bool match = handle != INVALID_SENSOR_HANDLE ? sensor->getHandle() == handle : id == MessageView(sensor->UID);
+        if (match) {
+            return applyRecord(sensor, record);
+        }
+    }
+    return true; // Not a record of this batch
+}
+
+/**
+ * @brief Reports a failed batched request on sensors which did not get their record.
+ */
+static void failBatch(const std::vector<BaseSensor *> &batch, const std::string &error) {
+    for (auto *sensor : batch) {
+        if (sensor->getError().empty() && sensor->isValuesSyncPending()) {
+            sensor->setError(error);
+        }
+    }
+}
+
+bool syncSensors(const std::vector<BaseSensor *> &sensors) {
+    SyncBatch batch;
+    prepareSyncBatch(sensors, batch);
+    bool result = sendConfigs(batch, false); // The caller owns the sensors
+
+    if (batch.sensors.empty()) {
+        return result;
+    }
+
+    ResponseStatus response = Protocol::updateBatch(batch.uids, [&batch, &result](const ResponseStatusView &record) {
+        result &= ingestRecord(batch.sensors, record);
+    }, batch.revisions);
+
+    if (response.status == ResponseStatusEnum::ERROR) {
+        failBatch(batch.sensors, response.error);
+        return false;
+    }
+
+    return result;
+}
+
+RequestId syncSensorsAsync(const std::vector<BaseSensor *> &sensors) {
+    SyncBatch batch;
+    prepareSyncBatch(sensors, batch);
+
+    if (batch.sensors.empty()) {
+        return 0;
+    }
+    return sendSyncBatch(batch);
+}
+
+RequestId sendSyncBatch(const SyncBatch &batch, const std::function<void()> &onComplete) {
+    sendConfigs(batch, true); // Configuration goes first, applied with the records
+
+    std::vector<BaseSensor *> sensors = batch.sensors;
+    ResponseRecordHandler handler = relayed([sensors, onComplete](const ResponseStatusView &record) {
+        if (!record.params.has("id")) {
+            // Overall result of the request
+            if (record.status == ResponseStatusEnum::ERROR) {
+                failBatch(sensors, record.error.str());
+            }
+            if (onComplete) {
+                onComplete();
+            }
+            return;
+        }
+        ingestRecord(sensors, record);
+    });
+
+    RequestId seq = Protocol::updateBatchAsync(batch.uids, handler, batch.revisions);
+    if (seq == 0) {
+        ResponseStatusView failed;
+        failed.error = MessageView("Request not sent");
+        handler(failed);
+    }
+    return seq;
+}
+
+bool subscribeSensor(BaseSensor *sensor, unsigned int period, bool *unsupported) {
+    if (unsupported) {
+        *unsupported = false;
+    }
+    if(sensor == nullptr) {
+        return false;
+    }
+
+    ResponseStatus response = Protocol::subscribe(sensor->UID, period, relayed([sensor](const ResponseStatusView &record) {
+        if (applyRecord(sensor, record)) {
+            sensor->clearError();
+        }
+    }, false));
+    if (response.status == ResponseStatusEnum::OK) {
+        return true;
+    }
+
+    // Answered without naming the sensor - legacy peer without SUBSCRIBE ("Unknown request type")
+    if (unsupported && response.params.count("status") && !response.params.count("id")) {
+        *unsupported = true;
+    }
+    logMessage("Subscribe of %s failed: %s\n", sensor->UID.c_str(), response.error.c_str());
+    return false;
+}
+
+bool unsubscribeSensor(BaseSensor *sensor) {
+    if(sensor == nullptr) {
+        return false;
+    }
+
+    ResponseStatus response = Protocol::unsubscribe(sensor->UID);
+    return response.status == ResponseStatusEnum::OK;
+}
+
+/**
+ * @brief Applies the response of a BURST request to the sensor.
+ *
+ * @return false if the burst was refused or failed to apply.
+ */
+static bool applyBurst(BaseSensor *sensor, const ResponseStatusView &response, const BurstSampleHandler &onSample) {
+    try {
+        sensor->ingestBurst(response, onSample);
+        return true;
+    } catch (const Exception &ex) {
+        ex.print();
+        sensor->setError(ex.flush(0));
+        return false;
+    }
+    catch (const std::exception &e)
+    {
+        std::string msg = buildMessage("Standard exception during synchronization: %s\n", e.what());
+        logMessage("%s", msg.c_str());
+        sensor->setError(msg);
+        return false;
+    }
+    catch(...)
+    {
+        std::string msg = "Unknown exception during synchronization!\n";
+        logMessage("%s", msg.c_str());
+        sensor->setError(msg);
+        return false;
+    }
+}
+
+bool burstSensor(BaseSensor *sensor, unsigned int samples, const BurstSampleHandler &onSample) {
+    if(sensor == nullptr) {
+        return false;
+    }
+
+    return applyBurst(sensor, Protocol::burstView(sensor->UID, samples), onSample);
+}
+
+void burstSensorAsync(BaseSensor *sensor, unsigned int samples, const BurstDoneHandler &onDone, const BurstSampleHandler &onSample) {
+    if(sensor == nullptr) {
+        return;
+    }
+
+    // Only the request is sent here, the sensor is touched where the relay delivers the response
+    ResponseRecordHandler apply = relayed([sensor, onDone, onSample](const ResponseStatusView &response) {
+        bool received = applyBurst(sensor, response, onSample);
+        if (onDone) {
+            onDone(received);
+        }
+    });
+    apply(Protocol::burstView(sensor->UID, samples));
+}
+
 bool initSensor(BaseSensor *sensor) {
     if(sensor == nullptr) {
         return false;
@@ -21,15 +21,27 @@
 #include "vscp.hpp"
 #include "../exceptions/sensors_exceptions.hpp" ///< Sensor related exceptions.
 #include "../helpers.hpp"    ///< Helper functions.
+#include "change_bus.hpp"    ///< Change notifications (sensor handles).
+#include "sensor_arena.hpp"  ///< Memory of sensor objects.
+#include "sample_history.hpp" ///< Sample history of values (and data types).
+#include "sensor_snapshot.hpp" ///< Snapshots of values for readers.
+#include "param_table.hpp"   ///< Parameter schemas and tables.
 
 #include <string>
 #include <unordered_map>
 #include <map>
 #include <array>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 
 #define HISTORY_CAP 10 ///< History capacity.
-
+#define SENSOR_NUMBER_TEXT_MAX 32  ///< Longest numeric text decoded (bytes), longer text is cut.
+#define CONFIG_COALESCE_MS 150     ///< Changed configs are sent once no other change came for this time (ms).
+#define CONFIG_COALESCE_MAX_MS 500 ///< Changed configs are sent at the latest after this time (ms), even while changing.
+#define SYNC_PERIOD_MS 100         ///< Default period (ms) of value synchronization, sensor types may override it.
+#define UNBOUND_VALUE 0xFF         ///< Entry of BaseSensor::ValuesById without a value.
 /**
  * @enum SensorStatus
  * @brief Enumeration representing possible sensor statuses.
@@ -64,23 +76,6 @@ enum class SensorsCommandsEnum
     DISCONNECT
 };
 
-/**
- * @enum enum class SensorDataType
- * @brief Enumeration representing possible parametrs data types.
- *
- * - INT: int.
- * - DOUBLE: double.
- *  - FLOAT: float.
- * - STRING: string.
- */
-enum class SensorDataType
-{
-    INT,
-    DOUBLE,
-    FLOAT,
-    STRING
-};
-
 
 /**
  * @struct SensorRestrictions
@@ -95,6 +90,16 @@ struct SensorRestrictions
     std::string Max;
     std::string Step;
     std::string Options; ///< Comma separated list of options (for enum types).
+
+    /**
+     * @brief Check if there is no restriction to apply.
+     *
+     * @return true if all restrictions are empty.
+     */
+    bool empty() const
+    {
+        return Min.empty() && Max.empty() && Options.empty();
+    }
 };
 
 /**
@@ -102,6 +107,9 @@ struct SensorRestrictions
  * @brief Structure for sensor parameters.
  *
  * This structure can be used to store sensor parameters for configuration and updating.
+ * Numeric parameters are decoded once when their value is set (Number), so reading them
+ * does not parse the text again. Received values are kept with timestamps in Samples,
+ * text history is kept only for STRING parameters.
  */
 struct SensorParam
 {
@@ -109,10 +117,22 @@ struct SensorParam
     std::string Unit;                 ///< Parameter unit.
     SensorDataType DType;                   ///< Parameter data type.
     int lastHistoryIndex;             ///< Last history index.
-    std::string History[HISTORY_CAP]; ///< Parameter history.
+    std::string History[HISTORY_CAP]; ///< Last values as text (STRING parameters).
     SensorRestrictions Restrictions;  ///< Parameter restrictions.
+    uint8_t KeyId;                    ///< Negotiated schema key ID (0 if sent by name), set by bindKeySchema().
+    SensorNumber Number;              ///< Decoded value (numeric parameters), valid if NumberValid.
+    SampleHistory Samples;            ///< Received values with timestamps (numeric and numeric STRING values).
+    bool NumberValid;                 ///< Whether Value was decoded into Number.
 };
 
+/**
+ * @brief Handler called for every sample of a BURST response (see BaseSensor::ingestBurst()).
+ *
+ * Called with the key of the value parameter, the sample (valid only during the call)
+ * and its timestamp (ms, getTimeMs() clock).
+ */
+typedef std::function<void(const std::string &key, const MessageView &value, uint32_t time)> BurstSampleHandler;
+
 /**
  * @class BaseSensor
  * @brief Abstract base class for sensors.
@@ -124,15 +144,30 @@ struct SensorParam
 class BaseSensor
 {
 protected:
-    bool redrawPending = true;  ///< Flag to indicate if sensor needs to be redrawn.
     bool isConfigsSync = false; ///< Flag to indicate if sensor congig is synchronized with real sensor.
     bool isValuesSync = false;  ///< Flag to indicate if sensor values is synchronized with real sensor.
-
-    std::unordered_map<std::string, SensorParam> Values;            ///< Sensor values.
-    std::unordered_map<std::string, SensorParam> Configs;          ///< Sensor configurations.
+    uint32_t Revision = 0;      ///< Revision of the values received last time (0 = unknown, full update).
+    unsigned int SyncPeriod = SYNC_PERIOD_MS; ///< Period (ms) of value synchronization (poll or push).
+    uint8_t SyncPriority = 0;   ///< Priority of the synchronization when the link budget is short (higher first).
+    SensorHandle Handle = INVALID_SENSOR_HANDLE; ///< Handle assigned by the SensorManager.
+    bool BurstHistory = false;       ///< Value history is fed by BURST samples only (see setBurstHistory()).
+    bool BurstClockKnown = false;    ///< Whether BurstClockOffset was measured.
+    uint32_t BurstClockOffset = 0;   ///< Local minus peer clock (ms), the smallest one seen (least delayed response).
+    std::vector<std::string> DirtyConfigs; ///< Keys of configurations changed since they were sent last time.
+    unsigned long configDirtySince = 0;    ///< Time (ms) of the first change not sent yet.
+    unsigned long configChangedAt = 0;     ///< Time (ms) of the last change not sent yet.
+
+    ParamTable<SensorParam> Values;                                ///< Sensor values (the first one is the primary value).
+    ParamTable<SensorParam> Configs;                               ///< Sensor configurations.
     std::vector<std::string> Pins;                                 ///< Sensor pins.
     std::string AllowedPins;                                       ///< Allowed sensor pins, enter as list of values separated by ",".
 
+    SnapshotBuffer Snapshots; ///< Published values, see getSnapshot().
+
+    std::vector<uint8_t> ValuesById;      ///< Index into Values by schema key ID - ValuesByIdBase, UNBOUND_VALUE if none (see bindKeySchema).
+    uint8_t ValuesByIdBase = 0;           ///< Schema key ID of the first entry of ValuesById.
+    bool ValuesByIdComplete = false;      ///< Whether all values have a schema key ID (no lookup by name needed).
+
     /**
      * @brief Set sensor status.
      *
@@ -174,30 +209,47 @@ protected:
     }
 
 
+    /**
+     * @brief Mark configuration as changed, it is sent with the next configuration sync.
+     *
+     * Rapid successive changes are coalesced, see isConfigSyncDue().
+     *
+     * @param key The key of the configuration parameter.
+     */
+    void markConfigDirty(const std::string &key)
+    {
+        unsigned long now = getTimeMs();
+        if (DirtyConfigs.empty())
+        {
+            configDirtySince = now;
+        }
+        if (!isInVector(DirtyConfigs, key))
+        {
+            DirtyConfigs.push_back(key);
+        }
+        configChangedAt = now;
+        isConfigsSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+    }
+
     /**
      * @brief Synchronize sensor configurations with real sensor.
      *
-     * This function sends a request to the real sensor to synchronize the configurations.
+     * This function sends a request to the real sensor with configurations changed since the last sync.
      */
     void syncConfigs()
     {
         isConfigsSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
-        redrawPending = false; // Reset redraw flag.
 
-        //Convert Configs to unordered_map<std::string, std::string>
-        std::unordered_map<std::string, std::string> configMap;
-        for (const auto &pair : Configs)
-        {
-            configMap[pair.first] = pair.second.Value;
-        }
-        auto response = Protocol::config(UID, configMap);
-        if (response.status == ResponseStatusEnum::ERROR)
+        // Only changed configurations are sent
+        std::unordered_map<std::string, std::string> configMap = getConfigChanges();
+        if (configMap.empty())
         {
-            throw SensorSynchronizationFailException("BaseSensor::syncConfigs", response.error);
+            DirtyConfigs.clear();
+            isConfigsSync = true;
+            return;
         }
 
-        isConfigsSync = response.status == ResponseStatusEnum::OK; // Set flag to indicate sensor is synchronized with real sensor.
-        redrawPending = isConfigsSync; // Set flag to redraw sensor - values updated.
+        applyConfigResponse(configMap, Protocol::config(UID, configMap));
     }
 
     /**
@@ -210,26 +262,337 @@ protected:
         try
         {
             isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
-            redrawPending = false; // Reset redraw flag.
 
-            auto response = Protocol::update(UID);
-            if (response.status == ResponseStatusEnum::ERROR)
+            ingest(Protocol::updateView(UID, Revision));
+        }
+        catch (...)
+        {
+            throw;
+        }
+    }
+
+
+
+    /**
+     * @brief Apply a received value to the value parameter and push it to its history.
+     *
+     * @param key The key of the value parameter (for error messages).
+     * @param param The value parameter.
+     * @param value The received value.
+     * @param time Timestamp of the value (ms, getTimeMs() clock).
+     * @throws InvalidValueException if the value does not meet restrictions.
+     */
+    void applyValue(const std::string &key, SensorParam &param, const MessageView &value, uint32_t time)
+    {
+        SensorNumber number;
+        bool decoded = decodeNumber(param.DType, value, number);
+        if (!param.Restrictions.empty() && !checkRestrictions(value, param, decoded ? &number : nullptr))
+        {
+            throw InvalidValueException("BaseSensor::update", "Value " + value.str() + " for key " + key + " does not meet restrictions.");
+        }
+        param.Value.assign(value.data(), value.size());
+        param.Number = number;
+        param.NumberValid = decoded;
+        pushHistory(param, time);
+
+        notifyChange(key, param);
+    }
+
+    /**
+     * @brief Build a parameter from a schema row.
+     *
+     * @param row The schema row.
+     * @return The parameter with the default value (not decoded yet).
+     */
+    static SensorParam schemaParam(const ParamSchema &row)
+    {
+        SensorParam param = SensorParam();
+        param.Value = row.Value ? row.Value : "";
+        param.Unit = row.Unit ? row.Unit : "";
+        param.DType = row.DType;
+        param.Restrictions.Min = row.Min ? row.Min : "";
+        param.Restrictions.Max = row.Max ? row.Max : "";
+        param.Restrictions.Step = row.Step ? row.Step : "";
+        param.Restrictions.Options = row.Options ? row.Options : "";
+        return param;
+    }
+
+    /**
+     * @brief Decode the value of a numeric parameter, called whenever its text is set.
+     *
+     * @param param The parameter.
+     */
+    static void decodeValue(SensorParam &param)
+    {
+        param.NumberValid = decodeNumber(param.DType, MessageView(param.Value), param.Number);
+    }
+
+    /**
+     * @brief Push the current value of a parameter to its history.
+     *
+     * STRING values are pushed to the samples too if they are numbers.
+     *
+     * @param param The parameter.
+     * @param time Timestamp of the value (ms, getTimeMs() clock).
+     */
+    void pushHistory(SensorParam &param, uint32_t time)
+    {
+        if (BurstHistory)
+        {
+            return; // Filled by BURST samples in order
+        }
+        if (param.NumberValid)
+        {
+            param.Samples.push(param.DType, param.Number, time);
+            return;
+        }
+        if (param.DType != SensorDataType::STRING)
+        {
+            return; // Not a number, nothing to draw
+        }
+
+        param.History[param.lastHistoryIndex] = param.Value;
+        if (++param.lastHistoryIndex >= HISTORY_CAP)
+        {
+            param.lastHistoryIndex = 0;
+        }
+
+        SensorNumber number;
+        if (decodeNumber(SensorDataType::DOUBLE, MessageView(param.Value), number))
+        {
+            param.Samples.push(SensorDataType::STRING, number, time);
+        }
+    }
+
+    /**
+     * @brief Read the value of a parameter as the requested type.
+     *
+     * Numeric parameters are read from their decoded value, text is parsed only for
+     * STRING parameters (or numeric text that could not be decoded).
+     *
+     * @param param The parameter.
+     * @return The value.
+     */
+    template <typename T>
+    static T readParam(const SensorParam &param, T *)
+    {
+        if (param.NumberValid)
+        {
+            switch (param.DType)
             {
-                throw SensorSynchronizationFailException("BaseSensor::syncValues", response.error);
+            case SensorDataType::INT:
+                return static_cast<T>(param.Number.Int);
+            case SensorDataType::FLOAT:
+                return static_cast<T>(param.Number.Float);
+            case SensorDataType::DOUBLE:
+                return static_cast<T>(param.Number.Double);
+            default:
+                break;
             }
+        }
+        return convertStringToType<T>(param.Value);
+    }
+
+    /**
+     * @brief Read the value of a parameter as text.
+     *
+     * @param param The parameter.
+     * @return The value.
+     */
+    static std::string readParam(const SensorParam &param, std::string *)
+    {
+        return param.Value;
+    }
+
+    /**
+     * @brief Copy a value parameter into a snapshot value.
+     *
+     * @param value The snapshot value.
+     * @param key The key of the parameter.
+     * @param param The parameter.
+     */
+    static void fillSnapshotValue(SnapshotValue &value, const std::string &key, const SensorParam &param)
+    {
+        copySnapshotString(value.key, SENSOR_SNAPSHOT_KEY, key.data(), key.size());
+        copySnapshotString(value.unit, SENSOR_SNAPSHOT_UNIT, param.Unit.data(), param.Unit.size());
+        value.type = param.DType;
+        value.keyId = param.KeyId;
+        value.numberValid = param.NumberValid;
+        value.number = param.Number;
+        setSnapshotText(value, param.Value.data(), param.Value.size());
+    }
 
-            update(response.params); // Update sensor values from response parameters
+    /**
+     * @brief Publish the current values as a new snapshot, called after values were applied.
+     */
+    void publishSnapshot()
+    {
+        SensorSnapshot &snapshot = Snapshots.back();
+        snapshot.count = 0;
+        for (const auto &v : Values)
+        {
+            if (snapshot.count >= SENSOR_SNAPSHOT_VALUES)
+            {
+                break;
+            }
+            fillSnapshotValue(snapshot.values[snapshot.count++], v.first, v.second);
+        }
+        Snapshots.publish();
+    }
 
-            isValuesSync = response.status == ResponseStatusEnum::OK; // Set flag to indicate sensor is synchronized with real sensor.
-            redrawPending = isValuesSync; // Set flag to redraw sensor - values updated.
+    /**
+     * @brief Publish a change of one value parameter, the other values are taken from the published snapshot.
+     *
+     * @param index Index of the parameter in Values.
+     */
+    void publishSnapshotValue(size_t index)
+    {
+        if (index >= SENSOR_SNAPSHOT_VALUES)
+        {
+            return; // Not in the snapshot, read from the sensor
         }
-        catch (...)
+
+        const SensorSnapshot &published = Snapshots.current();
+        if (index >= published.count)
         {
-            throw;
+            publishSnapshot(); // Parameters changed since the last publication
+            return;
         }
+        SensorSnapshot &snapshot = Snapshots.back();
+        snapshot.count = published.count;
+        memcpy(snapshot.values, published.values, published.count * sizeof(SnapshotValue));
+        const auto &v = Values.at(index);
+        fillSnapshotValue(snapshot.values[index], v.first, v.second);
+        Snapshots.publish();
     }
 
+    /**
+     * @brief Publish a change of a parameter to the change bus (only if the sensor is managed).
+     *
+     * @param key The key of the parameter.
+     * @param param The changed parameter.
+     */
+    void notifyChange(const std::string &key, const SensorParam &param) const
+    {
+        if (Handle != INVALID_SENSOR_HANDLE)
+        {
+            getChangeBus().publish(Handle, param.KeyId, &key, &param.Value);
+        }
+    }
+
+    /**
+     * @brief Measure the offset of the peer clock from a BURST response.
+     *
+     * The peer time is its clock when answering ("now"), or the last sample time of peers
+     * without it. Local minus peer time only grows by delays, so the smallest one is kept.
+     *
+     * @param response The burst response.
+     * @param received Local time (ms) the response was received.
+     */
+    void measureBurstClock(const ResponseStatusView &response, uint32_t received)
+    {
+        MessageView peerTime = response.params.get("now");
+        if (peerTime.empty())
+        {
+            size_t pos = 0;
+            MessageView time;
+            const MessageView times = response.params.get("t");
+            while (nextListItem(times, pos, time))
+            {
+                peerTime = time;
+            }
+        }
+        if (peerTime.empty())
+        {
+            return;
+        }
+
+        uint32_t offset = received - parseTimestamp(peerTime);
+        if (!BurstClockKnown || static_cast<int32_t>(offset - BurstClockOffset) < 0)
+        {
+            BurstClockOffset = offset;
+            BurstClockKnown = true;
+        }
+    }
+
+    /**
+     * @brief Apply samples of one value parameter received by BURST, oldest first.
+     *
+     * Samples are older than the current value, so they only go to the value history, at
+     * peer timestamps moved to the local clock (see measureBurstClock()). Samples not newer
+     * than the last stored one are dropped, history timestamps only grow.
+     *
+     * @param key The key of the value parameter.
+     * @param param The value parameter.
+     * @param samples Comma separated samples.
+     * @param times Comma separated timestamps of the samples.
+     * @param received Local time (ms) the response was received, the time of samples without a timestamp.
+     * @param onSample Handler called for every applied sample (optional).
+     * @return Number of applied samples.
+     * @throws InvalidValueException if a sample does not meet restrictions.
+     */
+    size_t applySamples(const std::string &key, SensorParam &param, const MessageView &samples, const MessageView &times,
+                        uint32_t received, const BurstSampleHandler &onSample)
+    {
+        size_t count = 0;
+        size_t samplePos = 0;
+        size_t timePos = 0;
+        MessageView sample;
+        MessageView time;
+        SensorDataType type = param.DType == SensorDataType::STRING ? SensorDataType::DOUBLE : param.DType;
+
+        while (nextListItem(samples, samplePos, sample))
+        {
+            if (!nextListItem(times, timePos, time))
+            {
+                time = MessageView();
+            }
+            if (sample.empty())
+            {
+                continue;
+            }
+
+            SensorNumber number;
+            bool decoded = decodeNumber(type, sample, number);
+            if (!param.Restrictions.empty() && !checkRestrictions(sample, param, decoded ? &number : nullptr))
+            {
+                throw InvalidValueException("BaseSensor::ingestBurst", "Value " + sample.str() + " for key " + key + " does not meet restrictions.");
+            }
+
+            uint32_t local = time.empty() ? received : parseTimestamp(time) + BurstClockOffset;
+            const SampleHistory &history = param.Samples;
+            if (!decoded || (history.size() > 0 && static_cast<int32_t>(local - history.timeAt(history.size() - 1)) <= 0))
+            {
+                continue;
+            }
+
+            param.Samples.push(param.DType, number, local);
+            count++;
+            if (onSample)
+            {
+                onSample(key, sample, local);
+            }
+        }
+        return count;
+    }
 
+    /**
+     * @brief Parse a timestamp of a BURST sample.
+     *
+     * @param time The timestamp (ms, digits).
+     * @return The timestamp, 0 if it is empty.
+     */
+    static uint32_t parseTimestamp(const MessageView &time)
+    {
+        uint32_t timestamp = 0;
+        for (char c : time)
+        {
+            if (c < '0' || c > '9')
+                break;
+            timestamp = timestamp * 10 + static_cast<uint32_t>(c - '0');
+        }
+        return timestamp;
+    }
 
     /**
      * @brief Check if the given value meets the restrictions defined in the sensor parameter.
@@ -238,16 +601,55 @@ protected:
      * @param param The sensor parameter containing the restrictions.
      * @return true if the value meets the restrictions, false otherwise.
      */
-    bool checkRestrictions(std::string value, const SensorParam &param)
+    bool checkRestrictions(const std::string &value, const SensorParam &param)
     {
-        SensorRestrictions restrictions = param.Restrictions;
-        try
+        SensorNumber number;
+        bool decoded = decodeNumber(param.DType, MessageView(value), number);
+        return checkRestrictions(MessageView(value), param, decoded ? &number : nullptr);
+    }
+
+    /**
+     * @brief Check if the given value meets the restrictions defined in the sensor parameter.
+     *
+     * Allocation-free variant used by the sync path.
+     *
+     * @param value The value to check.
+     * @param param The sensor parameter containing the restrictions.
+     * @param number The value decoded by the data type of the parameter, nullptr if not decoded.
+     * @return true if the value meets the restrictions, false otherwise.
+     * @throws InvalidDataTypeException if the value or a limit is not a number.
+     */
+    bool checkRestrictions(const MessageView &value, const SensorParam &param, const SensorNumber *number)
+    {
+        const SensorRestrictions &restrictions = param.Restrictions;
+        if (!restrictions.Min.empty() || !restrictions.Max.empty())
         {
+            SensorNumber val;
+            if (number && param.DType == SensorDataType::INT)
+            {
+                val.Double = number->Int;
+            }
+            else if (number && param.DType == SensorDataType::FLOAT)
+            {
+                val.Double = number->Float;
+            }
+            else if (number && param.DType == SensorDataType::DOUBLE)
+            {
+                val.Double = number->Double;
+            }
+            else if (!decodeNumber(SensorDataType::DOUBLE, value, val))
+            {
+                throw InvalidDataTypeException("BaseSensor::checkRestrictions", value.str() + " is non-double format string!");
+            }
+
+            SensorNumber limit;
             if (!restrictions.Min.empty())
             {
-                double min = convertStringToType<double>(restrictions.Min);
-                double val = convertStringToType<double>(value);
-                if (val < min)
+                if (!decodeNumber(SensorDataType::DOUBLE, MessageView(restrictions.Min), limit))
+                {
+                    throw InvalidDataTypeException("BaseSensor::checkRestrictions", restrictions.Min + " is non-double format string!");
+                }
+                if (val.Double < limit.Double)
                 {
                     return false;
                 }
@@ -255,26 +657,31 @@ protected:
 
             if (!restrictions.Max.empty())
             {
-                double max = convertStringToType<double>(restrictions.Max);
-                double val = convertStringToType<double>(value);
-                if (val > max)
+                if (!decodeNumber(SensorDataType::DOUBLE, MessageView(restrictions.Max), limit))
+                {
+                    throw InvalidDataTypeException("BaseSensor::checkRestrictions", restrictions.Max + " is non-double format string!");
+                }
+                if (val.Double > limit.Double)
                 {
                     return false;
                 }
             }
+        }
 
-            if (!restrictions.Options.empty())
+        if (!restrictions.Options.empty())
+        {
+            // Options are compared in place, without splitting them
+            MessageView options(restrictions.Options);
+            size_t pos = 0;
+            MessageView option;
+            while (nextListItem(options, pos, option))
             {
-                std::vector<std::string> options = splitString(restrictions.Options, ',');
-                if (std::find(options.begin(), options.end(), value) == options.end())
+                if (option == value)
                 {
-                    return false;
+                    return true;
                 }
             }
-        }
-        catch (const std::exception &e)
-        {
-            throw InvalidDataTypeException("BaseSensor::checkRestrictions", e.what());
+            return false;
         }
 
         return true;
@@ -339,20 +746,93 @@ public:
     {
     }
 
-    std::unordered_map<std::string, SensorParam> getValues() const { return Values; }
+    /**
+     * @brief Place sensor objects into the sensor arena.
+     *
+     * @param size Size of the sensor object.
+     */
+    static void *operator new(size_t size) { return SensorArena::allocate(size); }
+
+    /**
+     * @brief Release a sensor object placed by operator new.
+     *
+     * @param memory Memory of the sensor object.
+     */
+    static void operator delete(void *memory) { SensorArena::release(memory); }
+
+    /**
+     * @brief Decode numeric text by a parameter data type.
+     *
+     * Leading number is decoded as std::stoi/stof/stod would do ("12.5" is 12 as INT).
+     *
+     * @param type The data type.
+     * @param text The text.
+     * @param number Output - the decoded number.
+     * @return false for STRING parameters or text not starting with a number.
+     */
+    static bool decodeNumber(SensorDataType type, const MessageView &text, SensorNumber &number)
+    {
+        number.Double = 0;
+        if (type == SensorDataType::STRING || text.empty())
+        {
+            return false;
+        }
+
+        // Values are not null terminated in the received message
+        char buffer[SENSOR_NUMBER_TEXT_MAX];
+        size_t length = text.size() < sizeof(buffer) - 1 ? text.size() : sizeof(buffer) - 1;
+        memcpy(buffer, text.data(), length);
+        buffer[length] = '\0';
+
+        char *end = buffer;
+        switch (type)
+        {
+        case SensorDataType::INT:
+            number.Int = static_cast<int32_t>(strtol(buffer, &end, 10));
+            break;
+        case SensorDataType::FLOAT:
+            number.Float = strtof(buffer, &end);
+            break;
+        case SensorDataType::DOUBLE:
+            number.Double = strtod(buffer, &end);
+            break;
+        default:
+            break;
+        }
+        return end != buffer;
+    }
+
+    const ParamTable<SensorParam> &getValues() const { return Values; }
+
+    /**
+     * @brief Get the values published after the last applied update.
+     *
+     * Values are kept in the order of getValuesKeys(), with copies of their keys and units.
+     * Readers on other tasks read getSnapshots().current(epoch) and check isCurrent() after reading.
+     *
+     * @return The snapshot, valid until the next but one publication.
+     */
+    const SensorSnapshot &getSnapshot() const { return Snapshots.current(); }
+
+    /**
+     * @brief Get the snapshot buffer (epoch and consistency check of readers).
+     */
+    const SnapshotBuffer &getSnapshots() const { return Snapshots; }
     std::vector<std::string> getValuesKeys() const
     {
         std::vector<std::string> keys;
+        keys.reserve(Values.size());
         for (const auto &pair : Values)
         {
             keys.push_back(pair.first);
         }
         return keys;
     }
-    std::unordered_map<std::string, SensorParam> getConfigs() const { return Configs; }
+    const ParamTable<SensorParam> &getConfigs() const { return Configs; }
     std::vector<std::string> getConfigsKeys() const
     {
         std::vector<std::string> keys;
+        keys.reserve(Configs.size());
         for (const auto &pair : Configs)
         {
             keys.push_back(pair.first);
@@ -361,25 +841,25 @@ public:
     }
 
     /**
-     * @brief Get the redraw pending status.
+     * @brief Get the sensor unique identifier.
      *
-     * @return true if redraw is pending, false otherwise.
+     * @return The sensor UID.
      */
-    bool getRedrawPending() const { return redrawPending; }
+    std::string getId() const { return UID; }
 
     /**
-     * @brief Set the redraw pending status.
+     * @brief Get the handle assigned by the SensorManager.
      *
-     * @param pending The new redraw pending status.
+     * @return The handle, INVALID_SENSOR_HANDLE if the sensor is not managed.
      */
-    void setRedrawPending(bool pending) { redrawPending = pending; }
+    SensorHandle getHandle() const { return Handle; }
 
     /**
-     * @brief Get the sensor unique identifier.
+     * @brief Set the handle (SensorManager only).
      *
-     * @return The sensor UID.
+     * @param handle The handle.
      */
-    std::string getId() const { return UID; }
+    void setHandle(SensorHandle handle) { Handle = handle; }
 
     /**
      * @brief Get the sensor name (same as UID for compatibility).
@@ -410,14 +890,61 @@ public:
     SensorStatus getStatus() const { return Status; }
 
     /**
-     * @brief Assign a pin to the sensor.
-     * 
-     * @param pin The pin to assign.
+     * @brief Get the period of value synchronization.
+     *
+     * @return The period (ms).
      */
-    void assignPin(std::string pin) 
-    {
-        if (isInVector(Pins, pin)) {
-            return; // Pin already assigned
+    unsigned int getSyncPeriod() const { return SyncPeriod; }
+
+    /**
+     * @brief Set the period of value synchronization.
+     *
+     * @param period The period (ms), 0 for SYNC_PERIOD_MS.
+     */
+    void setSyncPeriod(unsigned int period) { SyncPeriod = period ? period : SYNC_PERIOD_MS; }
+
+    /**
+     * @brief Get the priority of value synchronization.
+     *
+     * @return The priority, higher is synchronized first.
+     */
+    uint8_t getSyncPriority() const { return SyncPriority; }
+
+    /**
+     * @brief Feed the value history by BURST samples only, e.g. while they are recorded.
+     *
+     * Updated and pushed values still become the current values, but their samples would
+     * interleave with the (older) BURST samples. Enabling it measures the peer clock again.
+     *
+     * @param enabled Whether the history is fed by BURST only.
+     */
+    void setBurstHistory(bool enabled)
+    {
+        BurstHistory = enabled;
+        BurstClockKnown = BurstClockKnown && !enabled;
+    }
+
+    /**
+     * @brief Check if the value history is fed by BURST samples only.
+     */
+    bool isBurstHistory() const { return BurstHistory; }
+
+    /**
+     * @brief Set the priority of value synchronization.
+     *
+     * @param priority The priority, higher is synchronized first.
+     */
+    void setSyncPriority(uint8_t priority) { SyncPriority = priority; }
+
+    /**
+     * @brief Assign a pin to the sensor.
+     * 
+     * @param pin The pin to assign.
+     */
+    void assignPin(std::string pin) 
+    {
+        if (isInVector(Pins, pin)) {
+            return; // Pin already assigned
         }
         Pins.push_back(pin);
     }
@@ -435,6 +962,16 @@ public:
         }
     }
 
+    /**
+     * @brief Replace all assigned pins (e.g. after a pin map transaction).
+     * 
+     * @param pins The new pins, empty to unassign all.
+     */
+    void setPins(const std::vector<std::string> &pins) 
+    {
+        Pins = pins;
+    }
+
     /**
      * @brief Get the Pins object
      * 
@@ -504,19 +1041,15 @@ public:
     template <typename T>
     T getConfig(const std::string &key)
     {
-        std::string value;
-        if (Configs.find(key) != Configs.end())
-        {
-            value = Configs[key].Value;
-        }
-        if (value.empty())
+        auto it = Configs.find(key);
+        if (it == Configs.end() || it->second.Value.empty())
         {
             throw ConfigurationNotFoundException("BaseSensor::getConfig", "Configuration not found for key: " + key);
         }
 
         try
         {
-            return convertStringToType<T>(value);
+            return readParam(it->second, static_cast<T *>(nullptr));
         }
         catch (const std::exception &e)
         {
@@ -534,16 +1067,20 @@ public:
      */
     void setConfig(const std::string &key, const std::string &value)
     {
-        if (Configs.find(key) != Configs.end())
+        auto it = Configs.find(key);
+        if (it == Configs.end())
         {
-            Configs[key].Value = value;
+            throw ConfigurationNotFoundException("BaseSensor::setConfig", "Configuration not found for key: " + key);
         }
-        else
+        if (it->second.Value == value)
         {
-            throw ConfigurationNotFoundException("BaseSensor::setConfig", "Configuration not found for key: " + key);
+            return; // Nothing to send
         }
 
-        isConfigsSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+        it->second.Value = value;
+        decodeValue(it->second);
+        markConfigDirty(key);
+        notifyChange(it->first, it->second);
     }
 
     /**
@@ -557,19 +1094,15 @@ public:
     template <typename T>
     T getValue(const std::string &key)
     {
-        std::string value;
-        if (Values.find(key) != Values.end())
-        {
-            value = Values[key].Value;
-        }
-        if (value.empty())
+        auto it = Values.find(key);
+        if (it == Values.end() || it->second.Value.empty())
         {
             throw ValueNotFoundException("BaseSensor::getValue", "Value not found for key: " + key);
         }
 
         try
         {
-            return convertStringToType<T>(value);
+            return readParam(it->second, static_cast<T *>(nullptr));
         }
         catch (const std::exception &e)
         {
@@ -587,9 +1120,14 @@ public:
      */
     void setValue(const std::string &key, const std::string &value)
     {
-        if (Values.find(key) != Values.end())
+        size_t index = Values.indexOf(key);
+        if (index != ParamTable<SensorParam>::npos)
         {
-            Values[key].Value = value;
+            auto &v = Values.at(index);
+            v.second.Value = value;
+            decodeValue(v.second);
+            publishSnapshotValue(index);
+            notifyChange(v.first, v.second);
         }
         else
         {
@@ -597,6 +1135,29 @@ public:
         }
     }
 
+    /**
+     * @brief Check if the sensor has a value parameter.
+     *
+     * @param key The key of the value parameter.
+     * @return true if the parameter exists.
+     */
+    bool hasValue(const std::string &key) const
+    {
+        return Values.find(key) != Values.end();
+    }
+
+    /**
+     * @brief Get the schema key ID of a value parameter, used to subscribe to its changes.
+     *
+     * @param key The key of the value parameter.
+     * @return The key ID, CHANGE_ANY_KEY if the parameter is sent by name or does not exist.
+     */
+    uint8_t getValueKeyId(const std::string &key) const
+    {
+        auto it = Values.find(key);
+        return it != Values.end() ? it->second.KeyId : CHANGE_ANY_KEY;
+    }
+
     /**
      * @brief Get units of sensor value parameter.
      *
@@ -607,11 +1168,8 @@ public:
      */
     std::string getValueUnits(const std::string &key)
     {
-        if (Values.find(key) != Values.end())
-        {
-            return Values[key].Unit;
-        }
-        return "";
+        auto it = Values.find(key);
+        return it != Values.end() ? it->second.Unit : "";
     }
 
     /**
@@ -624,11 +1182,8 @@ public:
      */
     std::string getConfigUnits(const std::string &key)
     {
-        if (Configs.find(key) != Configs.end())
-        {
-            return Configs[key].Unit;
-        }
-        return "";
+        auto it = Configs.find(key);
+        return it != Configs.end() ? it->second.Unit : "";
     }
 
     /**
@@ -668,6 +1223,7 @@ public:
      * @brief Get history of sensor value parameter.
      *
      * This function retrieves the history of a sensor value parameter by key.
+     * Only STRING parameters keep text history, see getNumberHistory() for numeric ones.
      *
      * @param key The key of the value sensor parameter.
      * @return The history array of the value sensor parameter.
@@ -675,15 +1231,45 @@ public:
     std::string* getHistory(const std::string &key)
     {
         //Find key in Values and return history array
-        if (Values.find(key) != Values.end())
+        auto it = Values.find(key);
+        if (it != Values.end())
         {
             // Return the history array
-            return Values[key].History;
+            return it->second.History;
         }
 
         throw ValueNotFoundException("BaseSensor::getHistory", "Value not found for key: " + key);
     }
 
+    /**
+     * @brief Get received samples of sensor value parameter.
+     *
+     * @param key The key of the value sensor parameter.
+     * @return The samples with timestamps.
+     */
+    const SampleHistory &getSamples(const std::string &key) const
+    {
+        auto it = Values.find(key);
+        if (it == Values.end())
+        {
+            throw ValueNotFoundException("BaseSensor::getSamples", "Value not found for key: " + key);
+        }
+        return it->second.Samples;
+    }
+
+    /**
+     * @brief Set the number of samples kept for every value parameter, stored samples are dropped.
+     *
+     * @param samples Number of samples, 0 for SAMPLE_HISTORY_DEPTH.
+     */
+    void setHistoryDepth(size_t samples)
+    {
+        for (auto &v : Values)
+        {
+            v.second.Samples.setDepth(samples);
+        }
+    }
+
     /**
      * @brief Clear history of all sensor value parameters.
      */
@@ -696,7 +1282,204 @@ public:
                 //logMessage("Clearing history value %s for key %s\n", v.second.History[i], v.first.c_str());
             }
             v.second.lastHistoryIndex = 0;
+            v.second.Samples.clear();
+        }
+    }
+
+    /**
+     * @brief Check if sensor configuration has to be sent before values can be synchronized.
+     *
+     * @return true if configuration is not synchronized with real sensor.
+     */
+    bool isConfigSyncPending() const { return !isConfigsSync; }
+
+    /**
+     * @brief Check if the changed configuration should be sent now.
+     *
+     * Changes are held until no other change came for CONFIG_COALESCE_MS (e.g. a dragged slider),
+     * but at most CONFIG_COALESCE_MAX_MS since the first of them, so they go in one CONFIG request.
+     *
+     * @return true if configuration is not synchronized and the coalescing window is over.
+     */
+    bool isConfigSyncDue() const
+    {
+        if (isConfigsSync)
+        {
+            return false;
+        }
+        unsigned long now = getTimeMs();
+        return DirtyConfigs.empty() || now - configChangedAt >= CONFIG_COALESCE_MS || now - configDirtySince >= CONFIG_COALESCE_MAX_MS;
+    }
+
+    /**
+     * @brief Get configurations changed since they were sent last time, without sending them.
+     *
+     * @return Keys and values for a CONFIG request.
+     */
+    std::unordered_map<std::string, std::string> getConfigChanges() const
+    {
+        std::unordered_map<std::string, std::string> configMap;
+        for (const auto &key : DirtyConfigs)
+        {
+            auto it = Configs.find(key);
+            if (it != Configs.end())
+            {
+                configMap[key] = it->second.Value;
+            }
+        }
+        return configMap;
+    }
+
+    /**
+     * @brief Apply the response of a CONFIG request sent with configurations from getConfigChanges().
+     *
+     * Configurations changed again since they were collected stay to be sent.
+     *
+     * @param sent The sent configurations.
+     * @param response The response of the peer.
+     * @throws SensorSynchronizationFailException if the peer refused the configuration.
+     */
+    void applyConfigResponse(const std::unordered_map<std::string, std::string> &sent, const ResponseStatus &response)
+    {
+        if (response.status == ResponseStatusEnum::ERROR)
+        {
+            throw SensorSynchronizationFailException("BaseSensor::syncConfigs", response.error);
+        }
+        if (response.status != ResponseStatusEnum::OK)
+        {
+            return;
+        }
+
+        for (auto it = DirtyConfigs.begin(); it != DirtyConfigs.end();)
+        {
+            auto value = sent.find(*it);
+            auto config = Configs.find(*it);
+            if (config == Configs.end() || (value != sent.end() && value->second == config->second.Value))
+            {
+                it = DirtyConfigs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        isConfigsSync = DirtyConfigs.empty(); // Set flag to indicate sensor is synchronized with real sensor.
+    }
+
+    /**
+     * @brief Check if the requested values were not received yet.
+     *
+     * @return true if values are not synchronized with real sensor.
+     */
+    bool isValuesSyncPending() const { return !isValuesSync; }
+
+    /**
+     * @brief Mark values as not synchronized, a new update is requested.
+     */
+    void invalidateValues() { isValuesSync = false; }
+
+    /**
+     * @brief Get revision of the values received last time.
+     *
+     * Sent with update requests, so the real sensor returns only values changed since then.
+     *
+     * @return The revision (0 = unknown).
+     */
+    uint32_t getRevision() const { return Revision; }
+
+    /**
+     * @brief Forget the revision, the next update requests all values (e.g. after reconnect).
+     */
+    void resetRevision() { Revision = 0; }
+
+    /**
+     * @brief Apply an UPDATE response (single or one record of a batched one) to the sensor.
+     *
+     * Only values present in the response are updated (delta update). If the response revision
+     * matches the known one, nothing changed - history and change notifications are skipped.
+     *
+     * @param response The update response.
+     * @return true if sensor values are synchronized with real sensor.
+     * @throws SensorSynchronizationFailException if the response reports an error.
+     */
+    bool ingest(const ResponseStatusView &response)
+    {
+        isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+
+        if (response.status == ResponseStatusEnum::ERROR)
+        {
+            throw SensorSynchronizationFailException("BaseSensor::ingest", response.error.str());
         }
+
+        isValuesSync = response.status == ResponseStatusEnum::OK; // Set flag to indicate sensor is synchronized with real sensor.
+        uint32_t revision = response.getRevision();
+        if (isValuesSync && revision != 0 && revision == Revision)
+        {
+            return isValuesSync; // Unchanged since the last update
+        }
+
+        update(response.params); // Update sensor values from response parameters, publishes the changed ones
+
+        Revision = revision;
+        return isValuesSync;
+    }
+
+    /**
+     * @brief Apply a BURST response to the sensor.
+     *
+     * Samples are pushed to the value history in order (see applySamples()), the current
+     * values and the revision are left to UPDATE and SUBSCRIBE.
+     *
+     * @param response The burst response.
+     * @param onSample Handler called for every sample, e.g. to record it (optional).
+     * @return Number of stored samples (of the value with the most samples).
+     * @throws SensorSynchronizationFailException if the response reports an error.
+     */
+    size_t ingestBurst(const ResponseStatusView &response, const BurstSampleHandler &onSample = BurstSampleHandler())
+    {
+        if (response.status == ResponseStatusEnum::ERROR)
+        {
+            throw SensorSynchronizationFailException("BaseSensor::ingestBurst", response.error.str());
+        }
+        if (response.status != ResponseStatusEnum::OK)
+        {
+            return 0;
+        }
+
+        const MessageView times = response.params.get("t");
+        uint32_t received = static_cast<uint32_t>(getTimeMs());
+        measureBurstClock(response, received);
+        size_t samples = 0;
+        size_t applied = 0;
+        for (const auto &p : response.params)
+        {
+            size_t slot = static_cast<size_t>(p.keyId - ValuesByIdBase);
+            if (p.keyId == 0 || p.keyId < ValuesByIdBase || slot >= ValuesById.size() || ValuesById[slot] == UNBOUND_VALUE)
+            {
+                continue;
+            }
+
+            auto &bound = Values.at(ValuesById[slot]);
+            applied = applySamples(bound.first, bound.second, p.value, times, received, onSample);
+            samples = applied > samples ? applied : samples;
+        }
+
+        if (!ValuesByIdComplete)
+        {
+            for (auto &c : Values)
+            {
+                const MessageView *value = response.params.find(c.first);
+                if (!value)
+                {
+                    continue;
+                }
+
+                applied = applySamples(c.first, c.second, *value, times, received, onSample);
+                samples = applied > samples ? applied : samples;
+            }
+        }
+
+        return samples;
     }
 
     /**
@@ -707,7 +1490,7 @@ public:
     virtual bool synchronize()
     {
         isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
-        if (!isConfigsSync)
+        if (isConfigSyncDue())
         {
             try
             {
@@ -734,6 +1517,20 @@ public:
         return isValuesSync && isConfigsSync;
     }
 
+    /**
+     * @brief Remove all value and configuration parameters, e.g. to replace the defaults of the type.
+     */
+    void clearParameters()
+    {
+        Values.clear();
+        Configs.clear();
+        DirtyConfigs.clear();
+        ValuesById.clear(); // Has to be bound again
+        ValuesByIdComplete = false;
+        isValuesSync = false;
+        publishSnapshot(); // Keys of the previous snapshot are gone
+    }
+
     /**
      * @brief Add configuration parameter to the sensor.
      *
@@ -744,14 +1541,15 @@ public:
     {
         try
         {
-            Configs[key] = param;
+            SensorParam &added = Configs.set(key, param);
+            decodeValue(added);
         }
         catch (const std::exception &e)
         {
             throw InvalidConfigurationException("BaseSensor::addConfigParameter", e.what());
         }
 
-        isConfigsSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+        markConfigDirty(key);
     }
 
     /**
@@ -779,15 +1577,14 @@ public:
                     {
                         throw InvalidValueException("BaseSensor::config", "Value " + value + " for key " + c.first + " does not meet restrictions.");
                     }
-                    c.second.Value = value;
-
-                    c.second.History[c.second.lastHistoryIndex++] = value;
-                    if (c.second.lastHistoryIndex >= HISTORY_CAP)
+                    if (c.second.Value != value)
                     {
-                        c.second.lastHistoryIndex = 0;
+                        c.second.Value = value;
+                        decodeValue(c.second);
+                        markConfigDirty(c.first);
                     }
 
-                    redrawPending = true; // Set flag to redraw sensor - values updated.
+                    notifyChange(c.first, c.second);
                 }
             }
         }
@@ -808,14 +1605,75 @@ public:
     {
         try
         {
-            Values[key] = param;
+            SensorParam &added = Values.set(key, param);
+            decodeValue(added);
         }
         catch (const std::exception &e)
         {
             throw InvalidValueException("BaseSensor::addValueParameter", new Exception(e));
         }
 
+        ValuesById.clear(); // Has to be bound again
+        ValuesByIdComplete = false;
+
         isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+        publishSnapshot();
+    }
+
+    /**
+     * @brief Lay out value parameters from the schema table of the sensor class.
+     *
+     * Values are stored in the order of the table (the first row is the primary value),
+     * keys already present (e.g. from a previous init()) are reset to their defaults in place.
+     *
+     * @param values The value schema.
+     * @throws Exception if adding a value parameter fails.
+     */
+    template <size_t V>
+    void applySchema(const ParamSchema (&values)[V])
+    {
+        if (Values.empty())
+        {
+            Values.reserve(V);
+        }
+        try
+        {
+            for (size_t i = 0; i < V; i++)
+            {
+                decodeValue(Values.set(values[i].Key, schemaParam(values[i])));
+            }
+        }
+        catch (const std::exception &e)
+        {
+            throw InvalidValueException("BaseSensor::applySchema", new Exception(e));
+        }
+
+        ValuesById.clear(); // Has to be bound again
+        ValuesByIdComplete = false;
+
+        isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+        publishSnapshot();
+    }
+
+    /**
+     * @brief Lay out value and configuration parameters from the schema tables of the sensor class.
+     *
+     * @param values The value schema.
+     * @param configs The configuration schema.
+     * @throws Exception if adding a parameter fails.
+     */
+    template <size_t V, size_t C>
+    void applySchema(const ParamSchema (&values)[V], const ParamSchema (&configs)[C])
+    {
+        if (Configs.empty())
+        {
+            Configs.reserve(C);
+        }
+        for (size_t i = 0; i < C; i++)
+        {
+            addConfigParameter(configs[i].Key, schemaParam(configs[i]));
+        }
+        applySchema(values);
     }
 
     /**
@@ -845,16 +1703,15 @@ public:
                         throw InvalidValueException("BaseSensor::update", "Value " + value + " for key " + c.first + " does not meet restrictions.");
                     }
                     c.second.Value = value;
-                    c.second.History[c.second.lastHistoryIndex++] = value;
-                    if (c.second.lastHistoryIndex >= HISTORY_CAP)
-                    {
-                        c.second.lastHistoryIndex = 0;
-                    }
+                    decodeValue(c.second);
+                    pushHistory(c.second, static_cast<uint32_t>(getTimeMs()));
 
-                    redrawPending = true; // Set flag to redraw sensor - values updated.
+                    notifyChange(c.first, c.second);
                 }
             }
 
+            publishSnapshot();
+
             std::string status = upd.find("status") != upd.end() ? upd.at("status") : "-1";
         }
         catch(...)
@@ -863,6 +1720,115 @@ public:
         }
     }
 
+    /**
+     * @brief Index value parameters by the negotiated schema key IDs.
+     *
+     * Called after the protocol initialization. Values sent as "#ID" are then applied
+     * directly by index, without looking up their keys. The key IDs of all parameters
+     * are kept, changes are published to the change bus with them.
+     */
+    void bindKeySchema()
+    {
+        ValuesById.clear();
+        ValuesByIdBase = 0;
+        ValuesByIdComplete = true;
+
+        for (auto &c : Configs)
+        {
+            c.second.KeyId = Protocol::getKeyId(c.first);
+        }
+
+        uint8_t first = 0xFF;
+        uint8_t last = 0;
+        for (auto &v : Values)
+        {
+            uint8_t id = Protocol::getKeyId(v.first);
+            v.second.KeyId = id;
+            if (id == 0)
+            {
+                ValuesByIdComplete = false; // Sent by name
+                continue;
+            }
+            first = id < first ? id : first;
+            last = id > last ? id : last;
+        }
+        if (first > last)
+        {
+            ValuesByIdComplete = false;
+            publishSnapshot();
+            return;
+        }
+
+        // Keys of one sensor are adjacent in the schema, so the table is small
+        ValuesByIdBase = first;
+        ValuesById.assign(last - first + 1, UNBOUND_VALUE);
+        for (size_t i = 0; i < Values.size(); i++)
+        {
+            uint8_t id = Values.at(i).second.KeyId;
+            if (id == 0)
+            {
+                continue;
+            }
+            if (i >= UNBOUND_VALUE)
+            {
+                ValuesByIdComplete = false; // Not indexable, looked up by key
+                continue;
+            }
+            ValuesById[id - first] = static_cast<uint8_t>(i);
+        }
+        publishSnapshot(); // Key IDs of the snapshot values
+    }
+
+    /**
+     * @brief Updates the sensor with new data parsed in place from a protocol response.
+     *
+     * Allocation-free variant of update() used by the sync path: values are copied into
+     * the already allocated parameter strings. Values sent by schema key ID are applied
+     * by index, the others are looked up by key.
+     *
+     * @param upd The parsed response parameters.
+     * @throws Exception if update fails.
+     */
+    virtual void update(const MessageParams &upd)
+    {
+        if(upd.empty())
+        {
+            return;
+        }
+
+        uint32_t now = static_cast<uint32_t>(getTimeMs());
+        for (const auto &p : upd)
+        {
+            size_t slot = static_cast<size_t>(p.keyId - ValuesByIdBase);
+            if (p.keyId == 0 || p.keyId < ValuesByIdBase || slot >= ValuesById.size() || p.value.empty())
+            {
+                continue;
+            }
+
+            if (ValuesById[slot] != UNBOUND_VALUE)
+            {
+                auto &bound = Values.at(ValuesById[slot]);
+                applyValue(bound.first, bound.second, p.value, now);
+            }
+        }
+
+        if (!ValuesByIdComplete) // Otherwise all values are sent by schema key ID
+        {
+            for (auto &c : Values)
+            {
+                const MessageView *value = upd.find(c.first);
+                if (!value || value->empty())
+                {
+                    continue;
+                }
+
+                applyValue(c.first, c.second, *value, now);
+            }
+        }
+
+        publishSnapshot();
+    }
+
     /**
      * @brief Prints sensor information.
      */
@@ -894,9 +1860,10 @@ public:
      */
     virtual void init()
     {
-        redrawPending = true; // Set flag to redraw sensor - values updated.
         isConfigsSync = true; // Set flag to indicate sensor is synchronized by default with real sensor.
+        DirtyConfigs.clear();
         isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor
+        Revision = 0;         // Request all values with the next update
 
         clearError();
     };
@@ -988,6 +1955,167 @@ void printSensor(BaseSensor *sensor);
  */
 bool syncSensor(BaseSensor *sensor);
 
+/**
+ * @brief Synchronizes several sensors with the real sensors in a single round trip.
+ *
+ * Configuration due to be sent (see BaseSensor::isConfigSyncDue()) goes first by one CONFIG request
+ * per sensor, then values of all sensors are fetched by one batched UPDATE request.
+ *
+ * @param sensors Sensors to be synchronized.
+ * @return true if all sensors were synchronized.
+ * @throws Exceptions should be internally resolved to prevent program from crash.
+ */
+bool syncSensors(const std::vector<BaseSensor *> &sensors);
+
+/**
+ * @brief Starts synchronization of several sensors without waiting for the response.
+ *
+ * Same as syncSensors(), but values are fetched by an asynchronous batched UPDATE request and
+ * applied to the sensors when Protocol::poll() delivers the response. Sensors must stay alive
+ * until the request completes or is cancelled.
+ *
+ * @param sensors Sensors to be synchronized.
+ * @return Sequence ID of the request, 0 if no request was sent.
+ * @throws Exceptions should be internally resolved to prevent program from crash.
+ */
+RequestId syncSensorsAsync(const std::vector<BaseSensor *> &sensors);
+
+/**
+ * @struct ConfigChange
+ * @brief Configuration of one sensor to be sent by a CONFIG request, see BaseSensor::getConfigChanges().
+ */
+struct ConfigChange
+{
+    BaseSensor *sensor;                                  ///< The sensor.
+    std::string uid;                                     ///< UID of the sensor.
+    std::unordered_map<std::string, std::string> values; ///< Changed configurations.
+};
+
+/**
+ * @struct SyncBatch
+ * @brief Sensors of one asynchronous batched UPDATE request, see prepareSyncBatch().
+ */
+struct SyncBatch
+{
+    std::vector<BaseSensor *> sensors; ///< Sensors waiting for their record.
+    std::vector<std::string> uids;     ///< UIDs of the sensors.
+    std::vector<uint32_t> revisions;   ///< Last known revisions of the sensors.
+    std::vector<ConfigChange> configs; ///< Configuration sent before the UPDATE request.
+};
+
+/**
+ * @brief Sensor side of syncSensorsAsync(), collects the batch without sending it.
+ *
+ * Does no I/O, so it may run on the task owning the sensors while the link task owns the
+ * Protocol. Configuration due to be sent is collected as well, it is sent by sendSyncBatch().
+ *
+ * @param sensors Sensors to be synchronized.
+ * @param batch Output - the batch for sendSyncBatch().
+ */
+void prepareSyncBatch(const std::vector<BaseSensor *> &sensors, SyncBatch &batch);
+
+/**
+ * @brief Link side of syncSensorsAsync(), sends the batch prepared by prepareSyncBatch().
+ *
+ * Configuration goes first, one blocking CONFIG request per sensor, then the asynchronous
+ * UPDATE request. Responses and records are applied where the record relay delivers them
+ * (see setRecordRelay()), the sensors are not touched here. The batch is not touched after
+ * the call, the sensors must stay alive until the request completes.
+ *
+ * @param batch The batch.
+ * @param onComplete Called after the last record, also if the request failed or was not sent (optional).
+ * @return Sequence ID of the request, 0 if it was not sent.
+ */
+RequestId sendSyncBatch(const SyncBatch &batch, const std::function<void()> &onComplete = std::function<void()>());
+
+/**
+ * @brief Passes a job applying received records to the task which owns the sensors.
+ *
+ * @p keep is false only for records pushed by a subscription, which the relay may drop
+ * when the owner does not keep up. Responses of requests (and their completions) are kept.
+ */
+typedef std::function<void(std::function<void()> &&apply, bool keep)> RecordRelay;
+
+/**
+ * @brief Set the relay of records received by asynchronous requests and subscriptions.
+ *
+ * Without a relay (default) records are applied right away by Protocol::poll(). Set only
+ * while no request is in flight, e.g. before the link task starts.
+ *
+ * @param relay The relay, empty to apply records right away.
+ */
+void setRecordRelay(const RecordRelay &relay);
+
+/**
+ * @brief Finds the handle of a sensor by its UID, INVALID_SENSOR_HANDLE if it is not known.
+ */
+typedef std::function<SensorHandle(const MessageView &uid)> SensorResolver;
+
+/**
+ * @brief Set the lookup matching records of batched requests to the sensors of the batch.
+ *
+ * Called where the records are applied (see setRecordRelay()). Without a resolver (default)
+ * or for a UID it does not know, the UIDs of the batch are compared.
+ *
+ * @param resolver The lookup, empty to compare UIDs.
+ */
+void setSensorResolver(const SensorResolver &resolver);
+
+/**
+ * @brief Subscribes to values pushed by the real sensor.
+ *
+ * Pushed values are applied to the sensor when Protocol::poll() delivers them.
+ * Sensor must stay alive until it is unsubscribed.
+ *
+ * A refusal naming the sensor (e.g. unknown UID) or a lost response concern this sensor only,
+ * a refusal without the sensor UID comes from a peer which does not support SUBSCRIBE.
+ *
+ * @param sensor Pointer to the sensor.
+ * @param period Push period in milliseconds.
+ * @param unsupported Set if the peer does not support SUBSCRIBE (optional).
+ * @return true if the peer accepted the subscription.
+ */
+bool subscribeSensor(BaseSensor *sensor, unsigned int period, bool *unsupported = nullptr);
+
+/**
+ * @brief Stops values pushed by the real sensor.
+ *
+ * @param sensor Pointer to the sensor.
+ * @return true if the peer confirmed it.
+ */
+bool unsubscribeSensor(BaseSensor *sensor);
+
+/**
+ * @brief Fetches samples buffered by the real sensor in one BURST request.
+ *
+ * Samples are pushed to the value history and passed to @p onSample.
+ *
+ * @param sensor Pointer to the sensor.
+ * @param samples Maximum number of samples.
+ * @param onSample Handler called for every sample, e.g. to record it (optional).
+ * @return true if the burst was received (it may carry no samples).
+ */
+bool burstSensor(BaseSensor *sensor, unsigned int samples, const BurstSampleHandler &onSample = BurstSampleHandler());
+
+/**
+ * @brief Handler of a finished burst, called with true if the burst was received.
+ */
+typedef std::function<void(bool received)> BurstDoneHandler;
+
+/**
+ * @brief Link side of burstSensor(), sends the BURST request without touching the sensor.
+ *
+ * The samples are applied and @p onDone is called where the record relay delivers the
+ * response (see setRecordRelay()). Sensor must stay alive until then.
+ *
+ * @param sensor Pointer to the sensor.
+ * @param samples Maximum number of samples.
+ * @param onDone Handler called after the samples were applied (optional).
+ * @param onSample Handler called for every sample (optional).
+ */
+void burstSensorAsync(BaseSensor *sensor, unsigned int samples, const BurstDoneHandler &onDone,
+                      const BurstSampleHandler &onSample = BurstSampleHandler());
+
 /**
  * @brief Initializes the sensor.
  *
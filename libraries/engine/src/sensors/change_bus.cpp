@@ -0,0 +1,84 @@
+/**
+ * @file change_bus.cpp
+ * @brief Definition of the sensor change-notification bus.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "change_bus.hpp"
+
+ChangeSubscription ChangeBus::subscribe(SensorHandle handle, uint8_t keyId, const ChangeHandler &handler)
+{
+    if (handle == INVALID_SENSOR_HANDLE || !handler)
+    {
+        return 0;
+    }
+
+    if (++lastId == 0)
+    {
+        lastId = 1; // 0 is never issued
+    }
+    if (handle >= Watched.size())
+    {
+        Watched.resize(handle + 1, 0);
+    }
+    Watched[handle]++;
+    Subscribers.push_back({lastId, handle, keyId, handler});
+    return lastId;
+}
+
+void ChangeBus::unsubscribe(ChangeSubscription id)
+{
+    if (id == 0)
+    {
+        return;
+    }
+
+    for (auto it = Subscribers.begin(); it != Subscribers.end(); ++it)
+    {
+        if (it->id == id)
+        {
+            Watched[it->handle]--;
+            Subscribers.erase(it);
+            return;
+        }
+    }
+}
+
+size_t ChangeBus::dispatch()
+{
+    if (Pending.empty())
+    {
+        return 0;
+    }
+
+    // Changes published by handlers are delivered with the next dispatch
+    Delivered.swap(Pending);
+    for (const auto &pending : Delivered)
+    {
+        SensorChange change = {pending.handle, pending.keyId, pending.key, MessageView(*pending.value)};
+        for (const auto &subscriber : Subscribers)
+        {
+            if (subscriber.handle == change.handle &&
+                (subscriber.keyId == CHANGE_ANY_KEY || subscriber.keyId == change.keyId))
+            {
+                subscriber.handler(change);
+            }
+        }
+    }
+
+    size_t delivered = Delivered.size();
+    Delivered.clear();
+    return delivered;
+}
+
+ChangeBus &getChangeBus()
+{
+    static ChangeBus bus;
+    return bus;
+}
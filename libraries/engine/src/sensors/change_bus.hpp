@@ -0,0 +1,160 @@
+/**
+ * @file change_bus.hpp
+ * @brief Declaration of the sensor change-notification bus.
+ *
+ * Sensors publish every applied value or configuration as (handle, key ID, new value).
+ * GUI components subscribe to the sensors and keys they display and redraw only the
+ * widgets whose data changed. Changes are coalesced and dispatched once per frame,
+ * changes of sensors nobody watches are dropped on publishing.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef CHANGE_BUS_HPP
+#define CHANGE_BUS_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "vscp.hpp"
+
+#define INVALID_SENSOR_HANDLE 0xFFFF ///< Handle of a sensor not managed by the SensorManager.
+#define CHANGE_ANY_KEY 0             ///< Key ID of a subscription to all keys of a sensor (also keys without schema key ID).
+
+/**
+ * @brief Dense integer handle of a managed sensor (its index in the SensorManager).
+ */
+typedef uint16_t SensorHandle;
+
+/**
+ * @brief Identifier of a change subscription, 0 is never used.
+ */
+typedef uint16_t ChangeSubscription;
+
+/**
+ * @struct SensorChange
+ * @brief One coalesced change of a sensor parameter.
+ */
+struct SensorChange
+{
+    SensorHandle handle; ///< Changed sensor.
+    uint8_t keyId;       ///< Negotiated schema key ID of the parameter, CHANGE_ANY_KEY if it has none.
+    const std::string *key; ///< Key of the parameter.
+    MessageView value;   ///< Current value, valid only during the handler call.
+};
+
+/**
+ * @brief Handler of sensor changes.
+ */
+typedef std::function<void(const SensorChange &change)> ChangeHandler;
+
+/**
+ * @class ChangeBus
+ * @brief Typed change notifications from sensors to GUI components.
+ *
+ * Publishing is O(1) for unwatched sensors. A parameter changed several times
+ * before dispatch() is delivered once, with its latest value.
+ */
+class ChangeBus
+{
+private:
+    /**
+     * @struct Subscriber
+     * @brief One subscription.
+     */
+    struct Subscriber
+    {
+        ChangeSubscription id; ///< Identifier returned by subscribe().
+        SensorHandle handle;   ///< Watched sensor.
+        uint8_t keyId;         ///< Watched key, CHANGE_ANY_KEY for all keys.
+        ChangeHandler handler; ///< Handler.
+    };
+
+    /**
+     * @struct PendingChange
+     * @brief Change waiting for dispatch().
+     */
+    struct PendingChange
+    {
+        SensorHandle handle;      ///< Changed sensor.
+        uint8_t keyId;            ///< Key ID of the parameter.
+        const std::string *key;   ///< Key of the parameter (owned by the sensor).
+        const std::string *value; ///< Value of the parameter (owned by the sensor).
+    };
+
+    std::vector<Subscriber> Subscribers;  ///< All subscriptions (a few per displayed sensor).
+    std::vector<uint8_t> Watched;         ///< Number of subscriptions per sensor handle.
+    std::vector<PendingChange> Pending;   ///< Coalesced changes.
+    std::vector<PendingChange> Delivered; ///< Changes being dispatched (reused).
+    ChangeSubscription lastId = 0;        ///< Last issued subscription identifier.
+
+public:
+    /**
+     * @brief Subscribe to changes of a sensor.
+     *
+     * @param handle Watched sensor.
+     * @param keyId Schema key ID of the watched parameter, CHANGE_ANY_KEY for all parameters.
+     * @param handler Handler, called by dispatch().
+     * @return Subscription identifier, 0 if the handle is invalid.
+     */
+    ChangeSubscription subscribe(SensorHandle handle, uint8_t keyId, const ChangeHandler &handler);
+
+    /**
+     * @brief Cancel a subscription, unknown identifiers are ignored.
+     */
+    void unsubscribe(ChangeSubscription id);
+
+    /**
+     * @brief Publish a change of a sensor parameter (sensor side).
+     *
+     * @param handle Changed sensor.
+     * @param keyId Schema key ID of the parameter, CHANGE_ANY_KEY if it has none.
+     * @param key The parameter key, must live until dispatch() (the sensor's own string).
+     * @param value The parameter value, must live until dispatch() (the sensor's own string).
+     */
+    void publish(SensorHandle handle, uint8_t keyId, const std::string *key, const std::string *value)
+    {
+        if (handle >= Watched.size() || Watched[handle] == 0)
+        {
+            return; // Nobody displays this sensor
+        }
+        for (const auto &change : Pending)
+        {
+            if (change.value == value)
+            {
+                return; // Delivered once, with the value current at dispatch()
+            }
+        }
+        Pending.push_back({handle, keyId, key, value});
+    }
+
+    /**
+     * @brief Deliver the coalesced changes to their subscribers.
+     *
+     * Called by the GUI once per frame. Handlers must not subscribe or unsubscribe.
+     *
+     * @return Number of delivered changes.
+     */
+    size_t dispatch();
+
+    /**
+     * @brief Drop pending changes, before the sensors owning their values are deleted.
+     */
+    void clear() { Pending.clear(); }
+
+    /**
+     * @brief Check if a sensor has any subscriber.
+     */
+    bool isWatched(SensorHandle handle) const { return handle < Watched.size() && Watched[handle] != 0; }
+};
+
+/**
+ * @brief The bus used by all sensors.
+ */
+ChangeBus &getChangeBus();
+
+#endif // CHANGE_BUS_HPP
@@ -0,0 +1,148 @@
+/**
+ * @file param_table.hpp
+ * @brief Declaration of parameter schemas and the flat parameter table of sensors.
+ *
+ * Sensor classes describe their values and configurations by constexpr tables of
+ * ParamSchema rows (kept in flash). BaseSensor lays its parameters out from them into
+ * a ParamTable: one contiguous array in the order of the schema, addressed by index.
+ * A sensor has a few parameters, so a key is found by a linear scan faster than by
+ * hashing, and the first value of the schema is always the primary one.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef PARAM_TABLE_HPP
+#define PARAM_TABLE_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+#include "sample_history.hpp"
+
+/**
+ * @struct ParamSchema
+ * @brief Description of one sensor parameter (a row of a constexpr schema table).
+ *
+ * Rows spell out all fields (gnu++11 warns about missing initializers), nullptr = not restricted.
+ */
+struct ParamSchema
+{
+    const char *Key;      ///< Parameter key.
+    const char *Value;    ///< Default value.
+    const char *Unit;     ///< Parameter unit.
+    SensorDataType DType; ///< Parameter data type.
+    const char *Min;      ///< Minimum (nullptr = none).
+    const char *Max;      ///< Maximum (nullptr = none).
+    const char *Step;     ///< Step (nullptr = none).
+    const char *Options;  ///< Comma separated list of options (nullptr = none).
+};
+
+/**
+ * @class ParamTable
+ * @brief Parameters of a sensor in one array, in the order they were added.
+ *
+ * Keeps the interface of a map (find(), operator[], iteration over key/parameter
+ * pairs), indexes stay valid until clear(). References and iterators stay valid
+ * while no parameter is added.
+ */
+template <typename T>
+class ParamTable
+{
+public:
+    typedef std::pair<std::string, T> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    static const size_t npos = static_cast<size_t>(-1); ///< Index of a missing key.
+
+private:
+    std::vector<value_type> entries; ///< The parameters.
+
+public:
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    void clear() { entries.clear(); }
+
+    /**
+     * @brief Reserve space for parameters, e.g. the rows of a schema.
+     */
+    void reserve(size_t count) { entries.reserve(count); }
+
+    /**
+     * @brief Get the index of a key.
+     *
+     * @return The index, npos if the key is not in the table.
+     */
+    size_t indexOf(const std::string &key) const
+    {
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (entries[i].first == key)
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    /**
+     * @brief Get a key/parameter pair by index.
+     */
+    value_type &at(size_t index) { return entries[index]; }
+    const value_type &at(size_t index) const { return entries[index]; }
+
+    iterator find(const std::string &key)
+    {
+        size_t index = indexOf(key);
+        return index == npos ? entries.end() : entries.begin() + index;
+    }
+
+    const_iterator find(const std::string &key) const
+    {
+        size_t index = indexOf(key);
+        return index == npos ? entries.end() : entries.begin() + index;
+    }
+
+    /**
+     * @brief Set a parameter, a new key is appended at the end.
+     *
+     * @return The stored parameter.
+     */
+    T &set(const std::string &key, const T &param)
+    {
+        size_t index = indexOf(key);
+        if (index != npos)
+        {
+            return entries[index].second = param;
+        }
+        entries.push_back(value_type(key, param));
+        return entries.back().second;
+    }
+
+    /**
+     * @brief Get a parameter, a default one is appended if the key is not in the table.
+     */
+    T &operator[](const std::string &key)
+    {
+        size_t index = indexOf(key);
+        if (index != npos)
+        {
+            return entries[index].second;
+        }
+        entries.push_back(value_type(key, T()));
+        return entries.back().second;
+    }
+};
+
+template <typename T>
+const size_t ParamTable<T>::npos;
+
+#endif // PARAM_TABLE_HPP
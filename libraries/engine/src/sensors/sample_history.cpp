@@ -0,0 +1,411 @@
+/**
+ * @file sample_history.cpp
+ * @brief Definition of the sample history of sensor value channels.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <cstdlib>
+#include <utility>
+#include "../config.hpp"
+#include "sample_history.hpp"
+
+#ifdef ARDUINO_H
+#include <Arduino.h>
+#endif
+
+/**
+ * @brief Allocate memory of samples, PSRAM if available.
+ */
+static void *allocateSamples(size_t size)
+{
+    void *memory = nullptr;
+#ifdef ARDUINO_H
+    memory = ps_malloc(size); // Internal RAM is kept for the link and LVGL
+#endif
+    if (!memory)
+    {
+        memory = malloc(size);
+    }
+    return memory;
+}
+
+size_t SampleHistory::sampleSize(SensorDataType type)
+{
+    switch (type)
+    {
+    case SensorDataType::INT:
+        return sizeof(int32_t);
+    case SensorDataType::FLOAT:
+        return sizeof(float);
+    default:
+        return sizeof(double);
+    }
+}
+
+bool SampleHistory::reserve(SensorDataType sampleType)
+{
+    if (values && sampleType == type)
+    {
+        return true;
+    }
+
+    release();
+    values = static_cast<uint8_t *>(allocateSamples(depth * sampleSize(sampleType)));
+    times = static_cast<uint32_t *>(allocateSamples(depth * sizeof(uint32_t)));
+    if (!values || !times)
+    {
+        release();
+        return false;
+    }
+    type = sampleType;
+
+    // Pyramid: levels and their buckets in one block, about depth buckets in total
+    uint8_t needed = 0;
+    size_t buckets = 0;
+    while ((depth >> (needed + 1)) >= SAMPLE_PYRAMID_MIN_BUCKETS)
+    {
+        buckets += depth >> (needed + 1);
+        needed++;
+    }
+    if (needed == 0)
+    {
+        return true;
+    }
+
+    levels = static_cast<PyramidLevel *>(allocateSamples(needed * sizeof(PyramidLevel) + buckets * sizeof(SampleBucket)));
+    if (!levels)
+    {
+        return true; // Decimated from raw samples then
+    }
+    levelCount = needed;
+    SampleBucket *next = reinterpret_cast<SampleBucket *>(levels + needed);
+    for (uint8_t k = 0; k < levelCount; k++)
+    {
+        levels[k].buckets = next;
+        levels[k].capacity = depth >> (k + 1);
+        next += levels[k].capacity;
+    }
+    clear();
+    return true;
+}
+
+void SampleHistory::release()
+{
+    free(values);
+    free(times);
+    free(levels);
+    values = nullptr;
+    times = nullptr;
+    levels = nullptr;
+    levelCount = 0;
+    clear();
+}
+
+void SampleHistory::clear()
+{
+    head = 0;
+    count = 0;
+    total = 0;
+    for (uint8_t k = 0; k < levelCount; k++)
+    {
+        levels[k].head = 0;
+        levels[k].count = 0;
+        levels[k].samples = 0;
+    }
+}
+
+SampleHistory &SampleHistory::operator=(const SampleHistory &other)
+{
+    if (this != &other)
+    {
+        release(); // Samples are not copied
+        depth = other.depth;
+    }
+    return *this;
+}
+
+SampleHistory::SampleHistory(SampleHistory &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+SampleHistory &SampleHistory::operator=(SampleHistory &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        values = other.values;
+        times = other.times;
+        depth = other.depth;
+        head = other.head;
+        count = other.count;
+        total = other.total;
+        type = other.type;
+        levels = other.levels;
+        levelCount = other.levelCount;
+
+        other.values = nullptr; // Buffers are owned by this history now
+        other.times = nullptr;
+        other.levels = nullptr;
+        other.levelCount = 0;
+        other.clear();
+    }
+    return *this;
+}
+
+void SampleHistory::setDepth(size_t samples)
+{
+    release();
+    depth = samples ? samples : SAMPLE_HISTORY_DEPTH;
+}
+
+void SampleHistory::push(SensorDataType sampleType, const SensorNumber &number, uint32_t time)
+{
+    if (sampleType == SensorDataType::STRING)
+    {
+        sampleType = SensorDataType::DOUBLE;
+    }
+    if (!reserve(sampleType))
+    {
+        return;
+    }
+
+    double value;
+    switch (type)
+    {
+    case SensorDataType::INT:
+        reinterpret_cast<int32_t *>(values)[head] = number.Int;
+        value = number.Int;
+        break;
+    case SensorDataType::FLOAT:
+        reinterpret_cast<float *>(values)[head] = number.Float;
+        value = number.Float;
+        break;
+    default:
+        reinterpret_cast<double *>(values)[head] = number.Double;
+        value = number.Double;
+        break;
+    }
+    times[head] = time;
+    pushPyramid(value, time);
+
+    head = head + 1 < depth ? head + 1 : 0;
+    if (count < depth)
+    {
+        count++;
+    }
+    total++;
+}
+
+double SampleHistory::at(size_t index) const
+{
+    size_t i = slot(index);
+    switch (type)
+    {
+    case SensorDataType::INT:
+        return reinterpret_cast<const int32_t *>(values)[i];
+    case SensorDataType::FLOAT:
+        return reinterpret_cast<const float *>(values)[i];
+    default:
+        return reinterpret_cast<const double *>(values)[i];
+    }
+}
+
+void SampleHistory::pushPyramid(double value, uint32_t time)
+{
+    SampleBucket bucket = {static_cast<float>(value), static_cast<float>(value), 0, time};
+    double sum = value;
+    uint32_t samples = 1;
+
+    for (uint8_t k = 0; k < levelCount; k++)
+    {
+        PyramidLevel &level = levels[k];
+        if (level.samples == 0)
+        {
+            level.pending = bucket;
+            level.sum = sum;
+        }
+        else
+        {
+            level.pending.min = bucket.min < level.pending.min ? bucket.min : level.pending.min;
+            level.pending.max = bucket.max > level.pending.max ? bucket.max : level.pending.max;
+            level.sum += sum;
+        }
+        level.samples += samples;
+        if (level.samples < (2u << k))
+        {
+            return; // Upper levels get the bucket once it is complete
+        }
+
+        level.pending.mean = static_cast<float>(level.sum / level.samples);
+        level.buckets[level.head] = level.pending;
+        level.head = level.head + 1 < level.capacity ? level.head + 1 : 0;
+        if (level.count < level.capacity)
+        {
+            level.count++;
+        }
+
+        bucket = level.pending;
+        sum = level.sum;
+        samples = level.samples;
+        level.samples = 0;
+    }
+}
+
+uint32_t SampleHistory::bucketAt(uint8_t level, uint32_t bucket, SampleBucket &out) const
+{
+    const PyramidLevel &l = levels[level];
+    uint32_t completed = total >> (level + 1);
+    if (bucket == completed)
+    {
+        // Samples not passed up yet are pending in the lower levels, the oldest in the highest one
+        uint32_t samples = 0;
+        double sum = 0;
+        for (int k = level; k >= 0; k--)
+        {
+            const PyramidLevel &lower = levels[k];
+            if (lower.samples == 0)
+            {
+                continue;
+            }
+            if (samples == 0)
+            {
+                out = lower.pending;
+            }
+            out.min = lower.pending.min < out.min ? lower.pending.min : out.min;
+            out.max = lower.pending.max > out.max ? lower.pending.max : out.max;
+            sum += lower.sum;
+            samples += lower.samples;
+        }
+        if (samples == 0)
+        {
+            return 0;
+        }
+        out.mean = static_cast<float>(sum / samples);
+        return samples;
+    }
+    if (bucket > completed || completed - bucket > l.count)
+    {
+        return 0; // Not stored (anymore)
+    }
+
+    out = l.buckets[(l.head + l.capacity - (completed - bucket)) % l.capacity];
+    return 2u << level;
+}
+
+size_t SampleHistory::findTime(uint32_t time) const
+{
+    size_t low = 0;
+    size_t high = count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (timeAt(middle) < time)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+size_t SampleHistory::decimate(size_t first, size_t samples, size_t columns, SampleBucket *out) const
+{
+    if (first >= count || columns == 0)
+    {
+        return 0;
+    }
+    samples = samples < count - first ? samples : count - first;
+
+    if (samples <= columns)
+    {
+        for (size_t i = 0; i < samples; i++)
+        {
+            float value = static_cast<float>(at(first + i));
+            out[i].min = value;
+            out[i].max = value;
+            out[i].mean = value;
+            out[i].time = timeAt(first + i);
+        }
+        return samples;
+    }
+
+    // Highest level with at least one bucket per column, -1 for raw samples
+    int level = -1;
+    while (level + 1 < levelCount && (samples >> (level + 2)) >= columns)
+    {
+        level++;
+    }
+
+    uint32_t base = total - count + first; // Number of the first sample since clear()
+    for (size_t c = 0; c < columns; c++)
+    {
+        uint32_t from = base + static_cast<uint32_t>(static_cast<uint64_t>(samples) * c / columns);
+        uint32_t to = base + static_cast<uint32_t>(static_cast<uint64_t>(samples) * (c + 1) / columns);
+        SampleBucket &column = out[c];
+        double sum = 0;
+        uint32_t weight = 0;
+
+        if (level < 0)
+        {
+            for (uint32_t n = from; n < to; n++)
+            {
+                size_t i = n - (total - count);
+                float value = static_cast<float>(at(i));
+                if (weight == 0)
+                {
+                    column.min = value;
+                    column.max = value;
+                    column.time = timeAt(i);
+                }
+                column.min = value < column.min ? value : column.min;
+                column.max = value > column.max ? value : column.max;
+                sum += value;
+                weight++;
+            }
+        }
+        else
+        {
+            // Buckets overlapping the column, edge buckets may reach into neighbours
+            SampleBucket bucket;
+            for (uint32_t b = from >> (level + 1); b <= (to - 1) >> (level + 1); b++)
+            {
+                uint32_t n = bucketAt(static_cast<uint8_t>(level), b, bucket);
+                if (n == 0)
+                {
+                    continue;
+                }
+                if (weight == 0)
+                {
+                    column = bucket;
+                }
+                column.min = bucket.min < column.min ? bucket.min : column.min;
+                column.max = bucket.max > column.max ? bucket.max : column.max;
+                sum += static_cast<double>(bucket.mean) * n;
+                weight += n;
+            }
+        }
+
+        if (weight == 0)
+        {
+            // Bucket already overwritten, fall back to the first sample of the column
+            float value = static_cast<float>(at(from - (total - count)));
+            column.min = value;
+            column.max = value;
+            sum = value;
+            weight = 1;
+            column.time = timeAt(from - (total - count));
+        }
+        column.mean = static_cast<float>(sum / weight);
+    }
+    return columns;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file sample_history.hpp
+ * @brief Declaration of the sample history of sensor value channels.
+ *
+ * Every numeric value parameter keeps its received samples with timestamps in a typed
+ * ring buffer (int32, float or double by its data type). The buffers are allocated with
+ * the first sample (PSRAM if available), appending is O(1) and readers get the stored
+ * samples as at most two contiguous segments, oldest first. The chart, its range
+ * statistics and recording read the samples from here.
+ *
+ * Samples are decimated into a pyramid on append as well: level k keeps min/max/mean of
+ * buckets of 2^(k+1) samples (the same time span as the raw samples). A window of any
+ * length is reduced to N columns from the level with about N buckets in it, so drawing
+ * a long capture costs O(N) instead of O(samples).
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef SAMPLE_HISTORY_HPP
+#define SAMPLE_HISTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef SAMPLE_HISTORY_DEPTH
+#define SAMPLE_HISTORY_DEPTH 4096 ///< Default number of samples kept per value channel.
+#endif
+
+#ifndef SAMPLE_PYRAMID_MIN_BUCKETS
+#define SAMPLE_PYRAMID_MIN_BUCKETS 16 ///< Pyramid levels with fewer buckets are not kept.
+#endif
+
+/**
+ * @enum enum class SensorDataType
+ * @brief Enumeration representing possible parametrs data types.
+ *
+ * - INT: int.
+ * - DOUBLE: double.
+ *  - FLOAT: float.
+ * - STRING: string.
+ */
+enum class SensorDataType
+{
+    INT,
+    DOUBLE,
+    FLOAT,
+    STRING
+};
+
+/**
+ * @union SensorNumber
+ * @brief Numeric value of a parameter, the member is selected by its SensorDataType.
+ */
+union SensorNumber
+{
+    int32_t Int;   ///< SensorDataType::INT.
+    float Float;   ///< SensorDataType::FLOAT.
+    double Double; ///< SensorDataType::DOUBLE.
+};
+
+/**
+ * @struct SampleSegment
+ * @brief Contiguous run of stored samples, valid until the next push().
+ */
+template <typename T>
+struct SampleSegment
+{
+    const T *values = nullptr;        ///< Samples.
+    const uint32_t *times = nullptr;  ///< Timestamps of the samples (ms, getTimeMs() clock).
+    size_t count = 0;                 ///< Number of samples.
+};
+
+/**
+ * @struct SampleBucket
+ * @brief Samples reduced to one column (pyramid bucket or decimate() output).
+ */
+struct SampleBucket
+{
+    float min;     ///< Lowest sample.
+    float max;     ///< Highest sample.
+    float mean;    ///< Mean of the samples.
+    uint32_t time; ///< Timestamp of the first sample.
+};
+
+/**
+ * @brief Data type stored for a sample type (INT for int32_t, FLOAT for float, DOUBLE for double).
+ */
+template <typename T>
+struct SampleTypeOf;
+template <>
+struct SampleTypeOf<int32_t> { static const SensorDataType value = SensorDataType::INT; };
+template <>
+struct SampleTypeOf<float> { static const SensorDataType value = SensorDataType::FLOAT; };
+template <>
+struct SampleTypeOf<double> { static const SensorDataType value = SensorDataType::DOUBLE; };
+
+/**
+ * @class SampleHistory
+ * @brief Ring buffer of timestamped samples of one value channel.
+ *
+ * Copies do not take the samples over (a parameter copied into a sensor starts with an
+ * empty history), moves do (parameter tables growing keep the samples). Used by the GUI
+ * task only.
+ */
+class SampleHistory
+{
+private:
+    uint8_t *values = nullptr;  ///< Samples, element size by type.
+    uint32_t *times = nullptr;  ///< Timestamps of the samples.
+    size_t depth = SAMPLE_HISTORY_DEPTH; ///< Capacity (samples).
+    size_t head = 0;            ///< Slot of the next sample.
+    size_t count = 0;           ///< Stored samples.
+    uint32_t total = 0;         ///< Samples pushed since the last clear().
+    SensorDataType type = SensorDataType::DOUBLE; ///< Type of the stored samples.
+
+    /**
+     * @struct PyramidLevel
+     * @brief Buckets of one decimation level, level k reduces 2^(k+1) samples into one bucket.
+     */
+    struct PyramidLevel
+    {
+        SampleBucket *buckets; ///< Completed buckets (ring).
+        size_t capacity;       ///< Capacity of the ring.
+        size_t head;           ///< Slot of the next bucket.
+        size_t count;          ///< Stored buckets.
+        SampleBucket pending;  ///< Bucket being filled (mean is not valid).
+        double sum;            ///< Sum of the samples of the pending bucket.
+        uint32_t samples;      ///< Samples in the pending bucket.
+    };
+
+    PyramidLevel *levels = nullptr; ///< Levels, allocated with the samples (one block with their buckets).
+    uint8_t levelCount = 0;         ///< Number of levels.
+
+    /**
+     * @brief Size of one sample of a type.
+     */
+    static size_t sampleSize(SensorDataType type);
+
+    /**
+     * @brief Allocate the buffers for samples of a type (drops stored samples of another type).
+     *
+     * @return false if there is no memory, the sample is dropped then.
+     */
+    bool reserve(SensorDataType sampleType);
+
+    /**
+     * @brief Free the buffers.
+     */
+    void release();
+
+    /**
+     * @brief Add a sample to the pending buckets, completed buckets move up the pyramid.
+     */
+    void pushPyramid(double value, uint32_t time);
+
+    /**
+     * @brief Get a bucket of a level.
+     *
+     * @param level The level.
+     * @param bucket Number of the bucket since clear() (pending one included).
+     * @param out Output - the bucket.
+     * @return Number of samples in the bucket, 0 if it is not stored.
+     */
+    uint32_t bucketAt(uint8_t level, uint32_t bucket, SampleBucket &out) const;
+
+    /**
+     * @brief Slot of a sample (0 = oldest stored).
+     */
+    size_t slot(size_t index) const
+    {
+        size_t first = head + depth - count;
+        return (first + index) % depth;
+    }
+
+public:
+    SampleHistory() {}
+    SampleHistory(const SampleHistory &other) : depth(other.depth) {}
+    SampleHistory(SampleHistory &&other) noexcept;
+    SampleHistory &operator=(const SampleHistory &other);
+    SampleHistory &operator=(SampleHistory &&other) noexcept;
+    ~SampleHistory() { release(); }
+
+    /**
+     * @brief Set the capacity, stored samples are dropped.
+     *
+     * @param samples Number of samples kept, 0 for SAMPLE_HISTORY_DEPTH.
+     */
+    void setDepth(size_t samples);
+
+    /**
+     * @brief Append a sample, the oldest one is overwritten if the history is full.
+     *
+     * @param sampleType Data type of the sample (STRING is stored as DOUBLE).
+     * @param number The sample.
+     * @param time Timestamp of the sample (ms, getTimeMs() clock).
+     */
+    void push(SensorDataType sampleType, const SensorNumber &number, uint32_t time);
+
+    /**
+     * @brief Drop all samples, the buffers are kept.
+     */
+    void clear();
+
+    /**
+     * @brief Number of stored samples.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Capacity (samples).
+     */
+    size_t capacity() const { return depth; }
+
+    /**
+     * @brief Samples pushed since the last clear(), readers keep it to find new samples (see newerThan()).
+     */
+    uint32_t getTotal() const { return total; }
+
+    /**
+     * @brief Number of stored samples pushed after a total returned by getTotal().
+     *
+     * @param mark The earlier total.
+     * @return The number of samples, they are the last ones (samples overwritten meanwhile are not counted).
+     */
+    size_t newerThan(uint32_t mark) const
+    {
+        if (mark > total)
+        {
+            return count; // Cleared since
+        }
+        size_t pushed = total - mark;
+        return pushed < count ? pushed : count;
+    }
+
+    /**
+     * @brief Type of the stored samples.
+     */
+    SensorDataType getType() const { return type; }
+
+    /**
+     * @brief Get the last samples as contiguous segments, oldest first.
+     *
+     * @tparam T int32_t, float or double, has to match getType().
+     * @param last Number of the last samples (limited by size()).
+     * @param out Output - the segments.
+     * @return Number of segments (0 if T does not match the type, up to 2).
+     */
+    template <typename T>
+    size_t segments(size_t last, SampleSegment<T> out[2]) const
+    {
+        if (SampleTypeOf<T>::value != type || !values || count == 0 || last == 0)
+        {
+            return 0;
+        }
+
+        last = last < count ? last : count;
+        size_t start = slot(count - last);
+        const T *typed = reinterpret_cast<const T *>(values);
+        size_t first = depth - start < last ? depth - start : last;
+
+        out[0].values = typed + start;
+        out[0].times = times + start;
+        out[0].count = first;
+        if (first == last)
+        {
+            return 1;
+        }
+
+        out[1].values = typed;
+        out[1].times = times;
+        out[1].count = last - first;
+        return 2;
+    }
+
+    /**
+     * @brief Get a sample converted to double.
+     *
+     * @param index Index of the sample (0 = oldest stored).
+     */
+    double at(size_t index) const;
+
+    /**
+     * @brief Get a timestamp of a sample.
+     *
+     * @param index Index of the sample (0 = oldest stored).
+     */
+    uint32_t timeAt(size_t index) const { return times[slot(index)]; }
+
+    /**
+     * @brief Find the first sample not older than a time (binary search, timestamps grow).
+     *
+     * @param time The time (ms, getTimeMs() clock).
+     * @return Index of the sample, size() if all samples are older.
+     */
+    size_t findTime(uint32_t time) const;
+
+    /**
+     * @brief Reduce a range of samples into columns, min/max/mean per column.
+     *
+     * Columns are built from the pyramid level with at least as many buckets in the range
+     * as columns, so the cost depends on the number of columns only. Ranges not longer
+     * than the columns are returned sample by sample.
+     *
+     * @param first Index of the first sample (0 = oldest stored).
+     * @param samples Number of samples.
+     * @param columns Number of columns.
+     * @param out Output - the columns (at least @p columns entries).
+     * @return Number of filled columns.
+     */
+    size_t decimate(size_t first, size_t samples, size_t columns, SampleBucket *out) const;
+
+    /**
+     * @brief Reduce samples of a time window into columns, see decimate().
+     *
+     * @param from Start of the window (ms, getTimeMs() clock).
+     * @param to End of the window (exclusive).
+     * @param columns Number of columns.
+     * @param out Output - the columns (at least @p columns entries).
+     * @return Number of filled columns.
+     */
+    size_t window(uint32_t from, uint32_t to, size_t columns, SampleBucket *out) const
+    {
+        size_t first = findTime(from);
+        size_t last = findTime(to);
+        return decimate(first, last - first, columns, out);
+    }
+};
+
+#endif // SAMPLE_HISTORY_HPP
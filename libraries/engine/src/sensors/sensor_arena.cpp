@@ -0,0 +1,68 @@
+/**
+ * @file sensor_arena.cpp
+ * @brief Definition of the sensor arena.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <new>
+#include <cstdlib>
+#include "../config.hpp"
+#include "sensor_arena.hpp"
+
+#ifdef ARDUINO_H
+#include <Arduino.h>
+#endif
+
+uint8_t *SensorArena::base = nullptr;
+size_t SensorArena::used = 0;
+size_t SensorArena::live = 0;
+
+void *SensorArena::allocate(size_t size)
+{
+    if (!base)
+    {
+#ifdef ARDUINO_H
+        base = static_cast<uint8_t *>(ps_malloc(SENSOR_ARENA_SIZE)); // Internal RAM is kept for the link and LVGL
+#endif
+        if (!base)
+        {
+            base = static_cast<uint8_t *>(malloc(SENSOR_ARENA_SIZE));
+        }
+    }
+
+    const size_t align = alignof(std::max_align_t);
+    size_t start = (used + align - 1) & ~(align - 1);
+    if (base && start + size <= SENSOR_ARENA_SIZE)
+    {
+        used = start + size;
+        live++;
+        return base + start;
+    }
+
+    return ::operator new(size); // Arena full
+}
+
+void SensorArena::release(void *memory)
+{
+    if (!memory)
+    {
+        return;
+    }
+    if (!owns(memory))
+    {
+        ::operator delete(memory);
+        return;
+    }
+
+    // Sensors are deleted together, the block is reused once all of them are gone
+    if (live > 0 && --live == 0)
+    {
+        used = 0;
+    }
+}
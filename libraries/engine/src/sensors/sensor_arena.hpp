@@ -0,0 +1,71 @@
+/**
+ * @file sensor_arena.hpp
+ * @brief Declaration of the sensor arena.
+ *
+ * Sensors are created together (sensor list, database, upstream announcement) and
+ * deleted together (SensorManager::erase()), so their objects are placed one after
+ * another into one preallocated block (PSRAM if available) instead of separate heap
+ * blocks. BaseSensor allocates from the arena by its class operator new, so sensors
+ * are still created by new and deleted by delete everywhere.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef SENSOR_ARENA_HPP
+#define SENSOR_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef SENSOR_ARENA_SIZE
+#define SENSOR_ARENA_SIZE 32768 ///< Size of the arena (bytes), sensors not fitting are allocated from the heap.
+#endif
+
+/**
+ * @class SensorArena
+ * @brief Bump allocator of sensor objects, reset when the last sensor placed in it is deleted.
+ *
+ * Used by the GUI task only (sensors are created and deleted there).
+ */
+class SensorArena
+{
+private:
+    static uint8_t *base;     ///< The block, allocated with the first sensor.
+    static size_t used;       ///< Bytes used from the start of the block.
+    static size_t live;       ///< Sensors placed in the block and not deleted yet.
+
+public:
+    /**
+     * @brief Allocate memory of a sensor object.
+     *
+     * @param size Size of the object.
+     * @return Memory in the arena, from the heap if the arena is full.
+     * @throws std::bad_alloc if the heap is exhausted as well.
+     */
+    static void *allocate(size_t size);
+
+    /**
+     * @brief Release memory of a deleted sensor object (arena or heap).
+     *
+     * @param memory The memory returned by allocate().
+     */
+    static void release(void *memory);
+
+    /**
+     * @brief Check if the memory lies in the arena.
+     */
+    static bool owns(const void *memory) { return base && memory >= base && memory < base + SENSOR_ARENA_SIZE; }
+
+    /**
+     * @brief Bytes used by sensors.
+     */
+    static size_t getUsed() { return used; }
+
+    /**
+     * @brief Number of sensors in the arena.
+     */
+    static size_t getLive() { return live; }
+};
+
+#endif // SENSOR_ARENA_HPP
@@ -8,8 +8,72 @@
  * 
  */
 
+#include <cstring>
 #include "sensor_factory.hpp"
 
+/**
+ * @struct SensorType
+ * @brief Entry of the sensor type registry.
+ */
+struct SensorType
+{
+    const char *name;                              ///< Type name used upstream (class name).
+    BaseSensor *(*create)(const std::string &uid); ///< Constructor of the type.
+};
+
+/**
+ * @brief Construct a sensor of type T (placed into the sensor arena, see BaseSensor::operator new).
+ */
+template <typename T>
+static BaseSensor *constructSensor(const std::string &uid)
+{
+    return new T(uid);
+}
+
+/**
+ * @brief Registry of sensor types, sorted by name for binary search.
+ */
+static constexpr SensorType SENSOR_TYPES[] = {
+    {"ADC", &constructSensor<ADC>},
+    {"AnalogTemperature", &constructSensor<AnalogTemperature>},
+    {"CameraSensor", &constructSensor<CameraSensor>},
+    {"CpuTempSensor", &constructSensor<CpuTempSensor>},
+    {"DHT11", &constructSensor<DHT11>},
+    {"DigitalHall", &constructSensor<DigitalHall>},
+    {"DigitalTemperature", &constructSensor<DigitalTemperature>},
+    {"GAT", &constructSensor<GAT>},
+    {"Joystick", &constructSensor<Joystick>},
+    {"LinearHall", &constructSensor<LinearHall>},
+    {"LinearHallAndDigital", &constructSensor<LinearHallAndDigital>},
+    {"MicrophoneSensor", &constructSensor<MicrophoneSensor>},
+    {"PhotoInterrupter", &constructSensor<PhotoInterrupter>},
+    {"PhotoResistor", &constructSensor<PhotoResistor>},
+    {"TH", &constructSensor<TH>},
+    {"TOF", &constructSensor<TOF>},
+    {"TP", &constructSensor<TP>},
+};
+
+static constexpr size_t SENSOR_TYPE_COUNT = sizeof(SENSOR_TYPES) / sizeof(SENSOR_TYPES[0]);
+
+/**
+ * @brief Compare two names like strcmp(), usable at compile time.
+ */
+static constexpr int compareNames(const char *a, const char *b)
+{
+    return *a != *b ? (static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b) ? -1 : 1)
+                    : (*a == '\0' ? 0 : compareNames(a + 1, b + 1));
+}
+
+/**
+ * @brief Check that the registry is sorted and has no duplicates.
+ */
+static constexpr bool isSorted(const SensorType *types, size_t count)
+{
+    return count < 2 || (compareNames(types[0].name, types[1].name) < 0 && isSorted(types + 1, count - 1));
+}
+
+static_assert(isSorted(SENSOR_TYPES, SENSOR_TYPE_COUNT), "SENSOR_TYPES must be sorted by name");
+
 void createSensorList(std::vector<BaseSensor*> &memory)
 {
     memory.clear();
@@ -26,13 +90,18 @@ void createSensorList(std::vector<BaseSensor*> &memory, std::string stringSource
 {
     memory.clear();
     //Expected format: ?0:ADC&1:ADC&2:TH
+    if (!stringSource.empty() && stringSource[0] == '?')
+    {
+        stringSource.erase(0, 1);
+    }
     std::vector<std::string> sensorList = splitString(stringSource, '&');
     logMessage("\t(i)Found %d sensors...\n", sensorList.size());
+    memory.reserve(sensorList.size());
     std::string id;
     std::string type;
     BaseSensor* sensor;
 
-    for (std::string sensorStr: sensorList)
+    for (const std::string &sensorStr: sensorList)
     {
         logMessage("\tProcessing sensor request: %s\n", sensorStr.c_str());
         if (sensorStr.empty())
@@ -52,5 +121,25 @@ void createSensorList(std::vector<BaseSensor*> &memory, std::string stringSource
 
 BaseSensor* createSensorByType(std::string type, std::string uid)
 {
+    // Binary search, one name comparison per halving
+    size_t low = 0;
+    size_t high = SENSOR_TYPE_COUNT;
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        int order = strcmp(SENSOR_TYPES[middle].name, type.c_str());
+        if (order == 0)
+        {
+            return SENSOR_TYPES[middle].create(uid);
+        }
+        if (order < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
     return nullptr;
 }
\ No newline at end of file
@@ -17,10 +17,12 @@
  * @brief Create a sensor by type.
  * 
  * This function creates a sensor object based on the given type and unique identifier.
+ * Types are looked up by binary search in a registry sorted at compile time, the sensor
+ * is placed into the sensor arena (see SensorArena).
  * 
- * @param type The sensor type.
+ * @param type The sensor type (class name, e.g. "ADC" or "TH").
  * @param uid The unique sensor identifier.
- * @return The sensor object.
+ * @return The sensor object, nullptr if the type is not registered.
  */
 BaseSensor* createSensorByType(std::string type, std::string uid);
 
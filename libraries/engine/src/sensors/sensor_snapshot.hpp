@@ -0,0 +1,191 @@
+/**
+ * @file sensor_snapshot.hpp
+ * @brief Declaration of sensor value snapshots.
+ *
+ * A sensor publishes its values into one of two fixed buffers after every applied
+ * update, readers get the other (published) one as a const view: no copy of the
+ * parameter maps, no allocation and no lock. Every publication increments the epoch,
+ * so readers find out whether anything changed by comparing one number. A snapshot
+ * owns all its data, it does not point into the parameters of the sensor.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef SENSOR_SNAPSHOT_HPP
+#define SENSOR_SNAPSHOT_HPP
+
+#include <string>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "sample_history.hpp"
+
+#ifndef SENSOR_SNAPSHOT_VALUES
+#define SENSOR_SNAPSHOT_VALUES 6 ///< Values kept in a snapshot, further values are read from the sensor.
+#endif
+#define SENSOR_SNAPSHOT_TEXT 24  ///< Size of the value text in a snapshot, longer text is cut (see SnapshotValue::textCut).
+#define SENSOR_SNAPSHOT_KEY 32   ///< Size of the key in a snapshot, longer keys are cut.
+#define SENSOR_SNAPSHOT_UNIT 16  ///< Size of the unit in a snapshot, longer units are cut.
+
+/**
+ * @struct SnapshotValue
+ * @brief Value parameter in a snapshot.
+ */
+struct SnapshotValue
+{
+    char key[SENSOR_SNAPSHOT_KEY];   ///< Key (null terminated, find() does not match cut keys).
+    char unit[SENSOR_SNAPSHOT_UNIT]; ///< Unit (null terminated).
+    SensorDataType type;     ///< Data type.
+    uint8_t keyId;           ///< Negotiated schema key ID (CHANGE_ANY_KEY if sent by name).
+    bool numberValid;        ///< Whether number holds the decoded value.
+    SensorNumber number;     ///< Decoded value (numeric parameters).
+    char text[SENSOR_SNAPSHOT_TEXT]; ///< Value as text (null terminated).
+    bool textCut;            ///< Whether text is cut, the whole value is read from the sensor.
+};
+
+/**
+ * @struct SensorSnapshot
+ * @brief Values of a sensor at one publication, in the order of BaseSensor::getValuesKeys().
+ */
+struct SensorSnapshot
+{
+    std::atomic<uint32_t> epoch{0}; ///< Publication number (0 = nothing published yet or being refilled).
+    uint8_t count = 0;  ///< Values in the snapshot.
+    SnapshotValue values[SENSOR_SNAPSHOT_VALUES]; ///< The values.
+
+    /**
+     * @brief Find a value by key.
+     *
+     * @param key The key.
+     * @return The value, nullptr if the snapshot does not have it.
+     */
+    const SnapshotValue *find(const std::string &key) const
+    {
+        if (key.size() >= SENSOR_SNAPSHOT_KEY)
+        {
+            return nullptr;
+        }
+        // Bounded, a reader on another task may see a buffer being refilled (rejected by isCurrent())
+        for (uint8_t i = 0; i < count && i < SENSOR_SNAPSHOT_VALUES; i++)
+        {
+            if (strncmp(values[i].key, key.c_str(), SENSOR_SNAPSHOT_KEY) == 0)
+            {
+                return &values[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @class SnapshotBuffer
+ * @brief Double-buffered snapshots of one writer.
+ *
+ * The writer fills back() and publishes it with publish(). The buffer a reader got by
+ * current() is refilled only after the next publication. A reader on another task works
+ * like with a seqlock: it takes the epoch together with the view by current(epoch),
+ * checks isCurrent() after reading and reads again if it is false. Readers on the
+ * writer's task (the GUI) do not need to check.
+ */
+class SnapshotBuffer
+{
+private:
+    SensorSnapshot buffers[2];          ///< Published and back buffer.
+    std::atomic<uint8_t> front{0};      ///< Index of the published buffer.
+    std::atomic<uint32_t> epoch{0};     ///< Epoch of the published buffer.
+
+public:
+    /**
+     * @brief Buffer to fill by the writer.
+     *
+     * The epoch of the buffer is cleared first, so a reader still holding it fails isCurrent().
+     */
+    SensorSnapshot &back()
+    {
+        SensorSnapshot &buffer = buffers[front.load(std::memory_order_relaxed) ^ 1];
+        buffer.epoch.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return buffer;
+    }
+
+    /**
+     * @brief Publish the back buffer.
+     */
+    void publish()
+    {
+        uint8_t next = front.load(std::memory_order_relaxed) ^ 1;
+        uint32_t published = epoch.load(std::memory_order_relaxed) + 1;
+        buffers[next].epoch.store(published, std::memory_order_release);
+        front.store(next, std::memory_order_release);
+        epoch.store(published, std::memory_order_release);
+    }
+
+    /**
+     * @brief The published snapshot (readers on the writer's task).
+     */
+    const SensorSnapshot &current() const { return buffers[front.load(std::memory_order_acquire)]; }
+
+    /**
+     * @brief The published snapshot and its epoch (readers on other tasks).
+     *
+     * @param snapshotEpoch Output - epoch of the snapshot when the read starts, passed to isCurrent().
+     */
+    const SensorSnapshot &current(uint32_t &snapshotEpoch) const
+    {
+        const SensorSnapshot &snapshot = buffers[front.load(std::memory_order_acquire)];
+        snapshotEpoch = snapshot.epoch.load(std::memory_order_acquire);
+        return snapshot;
+    }
+
+    /**
+     * @brief Epoch of the published snapshot.
+     */
+    uint32_t getEpoch() const { return epoch.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Check that a snapshot was not refilled while it was read.
+     *
+     * Epochs of a buffer only grow, so a buffer refilled and published again meanwhile fails too.
+     *
+     * @param snapshot The snapshot returned by current(epoch).
+     * @param snapshotEpoch The epoch returned with it.
+     */
+    bool isCurrent(const SensorSnapshot &snapshot, uint32_t snapshotEpoch) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return snapshotEpoch != 0 && snapshot.epoch.load(std::memory_order_relaxed) == snapshotEpoch;
+    }
+};
+
+/**
+ * @brief Copy a string into a fixed snapshot field, longer strings are cut.
+ *
+ * @param field The field.
+ * @param capacity Size of the field, including the terminator.
+ * @param text The string.
+ * @param size Length of the string.
+ */
+inline void copySnapshotString(char *field, size_t capacity, const char *text, size_t size)
+{
+    size = size < capacity - 1 ? size : capacity - 1;
+    memcpy(field, text, size);
+    field[size] = '\0';
+}
+
+/**
+ * @brief Copy value text into a snapshot value.
+ *
+ * @param value The snapshot value.
+ * @param text The text.
+ * @param size Length of the text.
+ */
+inline void setSnapshotText(SnapshotValue &value, const char *text, size_t size)
+{
+    copySnapshotString(value.text, SENSOR_SNAPSHOT_TEXT, text, size);
+    value.textCut = size >= SENSOR_SNAPSHOT_TEXT;
+}
+
+#endif // SENSOR_SNAPSHOT_HPP
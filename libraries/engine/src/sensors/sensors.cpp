@@ -9,4 +9,39 @@
  * 
  */
 
-#include "sensors.hpp"
\ No newline at end of file
+#include "sensors.hpp"
+
+/*********************
+ *  PARAMETER SCHEMAS
+ *********************/
+
+// Definitions of the constexpr schema tables (odr-used by BaseSensor::applySchema())
+constexpr ParamSchema MicrophoneSensor::VALUES[];
+constexpr ParamSchema CameraSensor::VALUES[];
+constexpr ParamSchema CpuTempSensor::VALUES[];
+constexpr ParamSchema ADC::VALUES[];
+constexpr ParamSchema ADC::CONFIGS[];
+constexpr ParamSchema Joystick::VALUES[];
+constexpr ParamSchema DHT11::VALUES[];
+constexpr ParamSchema DHT11::CONFIGS[];
+constexpr ParamSchema LinearHallAndDigital::VALUES[];
+constexpr ParamSchema LinearHallAndDigital::CONFIGS[];
+constexpr ParamSchema PhotoResistor::VALUES[];
+constexpr ParamSchema PhotoResistor::CONFIGS[];
+constexpr ParamSchema LinearHall::VALUES[];
+constexpr ParamSchema LinearHall::CONFIGS[];
+constexpr ParamSchema DigitalTemperature::VALUES[];
+constexpr ParamSchema DigitalTemperature::CONFIGS[];
+constexpr ParamSchema AnalogTemperature::VALUES[];
+constexpr ParamSchema AnalogTemperature::CONFIGS[];
+constexpr ParamSchema TH::VALUES[];
+constexpr ParamSchema TH::CONFIGS[];
+constexpr ParamSchema DigitalHall::VALUES[];
+constexpr ParamSchema DigitalHall::CONFIGS[];
+constexpr ParamSchema PhotoInterrupter::VALUES[];
+constexpr ParamSchema TP::VALUES[];
+constexpr ParamSchema TP::CONFIGS[];
+constexpr ParamSchema GAT::VALUES[];
+constexpr ParamSchema GAT::CONFIGS[];
+constexpr ParamSchema TOF::VALUES[];
+constexpr ParamSchema TOF::CONFIGS[];
@@ -24,6 +24,11 @@ Emulated microphone sensor returning dBFS and peak values.
 */
 class MicrophoneSensor : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"dBFS", "0.0", "dBm", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"peak", "0.0", "dBm", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new object.
@@ -56,9 +61,7 @@ public:
 
         try
         {
-            // Default values
-            addValueParameter("dBFS", {"0.0", "dBm", SensorDataType::FLOAT});
-            addValueParameter("peak", {"0.0", "dBm", SensorDataType::FLOAT});
+            applySchema(VALUES);
         }
         catch (const std::exception &e)
         {
@@ -73,6 +76,10 @@ Emulated camera sensor returning estimated lux value.
 */
 class CameraSensor : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"lux_est", "0.0", "lux", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new object.
@@ -105,8 +112,7 @@ public:
 
         try
         {
-            // Default values
-            addValueParameter("lux_est", {"0.0", "lux", SensorDataType::FLOAT});
+            applySchema(VALUES);
         }
         catch (const std::exception &e)
         {
@@ -120,6 +126,10 @@ Emulated CPU temperature sensor returning real temperature value.
 */
 class CpuTempSensor : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"temp", "0.0", "C", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new object.
@@ -148,12 +158,12 @@ public:
         // Additional initialization for sensor can be added here.
         Type = "CPU Temp";
         Description = "Emulated cpu real temperature sensor";
+        SyncPeriod = 1000; // Slowly changing value
         
 
         try
         {
-            // Default values
-            addValueParameter("temp", {"0.0", "C", SensorDataType::FLOAT});
+            applySchema(VALUES);
         }
         catch (const std::exception &e)
         {
@@ -175,6 +185,13 @@ public:
  */
 class ADC : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"value", "0", "", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"resolution", "12", "bits", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new ADC object.
@@ -207,10 +224,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("resolution", {"12", "bits", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("value", {"0", "", SensorDataType::INT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -232,6 +246,12 @@ public:
  */
 class Joystick : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"XCoordination", "50", "%", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+        {"YCoordination", "50", "%", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+        {"Button", "0", "ON/OFF", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     Joystick(std::string uid) : BaseSensor(uid) { init(); }
     virtual ~Joystick() {}
@@ -239,12 +259,11 @@ public:
     {
         Type = "Joystick";
         Description = "Joystick peripheral";
+        SyncPeriod = 20; // 50 Hz, follows the hand without lag
         
         try
         {
-            addValueParameter("XCoordination", {"50", "%", SensorDataType::INT, 0});
-            addValueParameter("YCoordination", {"50", "%", SensorDataType::INT, 0});
-            addValueParameter("Button", {"0", "ON/OFF", SensorDataType::INT, 0});
+            applySchema(VALUES);
         }
         catch (const std::exception &e)
         {
@@ -264,6 +283,14 @@ public:
  */
 class DHT11 : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"temp", "0", "°C", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+        {"humi", "0", "%", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"Unit", "", "", SensorDataType::STRING, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     DHT11(std::string uid) : BaseSensor(uid) { init(); }
     virtual ~DHT11() {}
@@ -272,11 +299,10 @@ public:
     {
         Type = "DHT11";
         Description = "DHT11 Temperature & Humidity sensor";
+        SyncPeriod = 1000; // Sensor itself measures at most once per second
         
 
-        addConfigParameter("Unit", {"", "", SensorDataType::STRING, 0});
-        addValueParameter("temp", {"0", "°C", SensorDataType::INT, 0});
-        addValueParameter("humi", {"0", "%", SensorDataType::INT, 0});
+        applySchema(VALUES, CONFIGS);
     }
 };
 
@@ -291,6 +317,14 @@ public:
  */
 class LinearHallAndDigital : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"milliTesla Meter", "0", "milliTesla", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"Magnet Detector", "0", "", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"precision", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new LinearHallAndDigital object.
@@ -324,11 +358,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("precision", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("milliTesla Meter", {"0", "milliTesla", SensorDataType::FLOAT, 0});
-            addValueParameter("Magnet Detector", {"0", "", SensorDataType::INT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -348,6 +378,13 @@ public:
  */
 class PhotoResistor : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"intensity", "0", "Lux", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"Res", "5", "digits", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new PhotoResistor object.
@@ -381,10 +418,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("Res", {"5", "digits", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("intensity", {"0", "Lux", SensorDataType::INT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -404,6 +438,13 @@ public:
  */
 class LinearHall : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"milliTesla", "0", "milliTesla", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"precision", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new LinearHall object.
@@ -438,10 +479,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("precision", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("milliTesla", {"0", "milliTesla", SensorDataType::FLOAT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -461,6 +499,14 @@ public:
  */
 class DigitalTemperature : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"temp", "0", "°C", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"alarm", "0", "", SensorDataType::STRING, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"Res", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new DigitalTemperature object.
@@ -490,15 +536,12 @@ public:
         // Additional initialization for sensor can be added here.
         Type = "DS18B20";
         Description = "Returns temperature in °C and if the temperature goes past a hardware-configured value";
+        SyncPeriod = 1000; // Conversion takes up to 750 ms
         
 
         try
         {
-            // Default configs
-            addConfigParameter("Res", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("temp", {"0", "°C", SensorDataType::FLOAT, 0});
-            addValueParameter("alarm", {"0", "", SensorDataType::STRING, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -518,6 +561,13 @@ public:
  */
 class AnalogTemperature : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"Temperature", "0", "°C", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"precision", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new AnalogTemperature object.
@@ -551,10 +601,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("precision", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("Temperature", {"0", "°C", SensorDataType::FLOAT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -574,6 +621,14 @@ public:
  */
 class TH : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"temperature", "0", "Celsia", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"humidity", "0", "%", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"precision", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new TH object.
@@ -604,15 +659,12 @@ public:
         // Additional initialization for sensor can be added here.
         Type = "TH";
         Description = "Temperature & Humidity Sensor";
+        SyncPeriod = 1000; // Slowly changing values
         
 
         try
         {
-            // Default configs
-            addConfigParameter("precision", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("temperature", {"0", "Celsia", SensorDataType::FLOAT, 0});
-            addValueParameter("humidity", {"0", "%", SensorDataType::INT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -634,6 +686,13 @@ public:
  */
 class DigitalHall : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"Magnet Detector", "0", "", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"resolution", "1", "bits", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new DigitalHall object.
@@ -668,10 +727,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("resolution", {"1", "bits", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("Magnet Detector", {"0", "", SensorDataType::INT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -691,6 +747,10 @@ public:
  */
 class PhotoInterrupter : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"Motion Detector", "0", "", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new PhotoInterrupter object.
@@ -725,8 +785,7 @@ public:
 
         try
         {
-            // Default values
-            addValueParameter("Motion Detector", {"0", "", SensorDataType::INT, 0});
+            applySchema(VALUES);
         }
         catch (const std::exception &e)
         {
@@ -748,6 +807,14 @@ public:
 
 class TP : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"Temperature", "0", "°C", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"Pressure", "0", "hPa", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"Precision", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new TP object.
@@ -781,11 +848,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("Precision", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("Temperature", {"0", "°C", SensorDataType::FLOAT, 0});
-            addValueParameter("Pressure", {"0", "hPa", SensorDataType::FLOAT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -805,6 +868,19 @@ public:
 
 class GAT : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"Temperature", "0", "°C", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"acm_x", "0", "g", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"acm_y", "0", "g", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"acm_z", "0", "g", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"gyr_x", "0", "°/s", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"gyr_y", "0", "°/s", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+        {"gyr_z", "0", "°/s", SensorDataType::FLOAT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"Precision", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new GAT object.
@@ -839,16 +915,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("Precision", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("Temperature", {"0", "°C", SensorDataType::FLOAT, 0});
-            addValueParameter("acm_x", {"0", "g", SensorDataType::FLOAT, 0});
-            addValueParameter("acm_y", {"0", "g", SensorDataType::FLOAT, 0});
-            addValueParameter("acm_z", {"0", "g", SensorDataType::FLOAT, 0});
-            addValueParameter("gyr_x", {"0", "°/s", SensorDataType::FLOAT, 0});
-            addValueParameter("gyr_y", {"0", "°/s", SensorDataType::FLOAT, 0});
-            addValueParameter("gyr_z", {"0", "°/s", SensorDataType::FLOAT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -868,6 +935,13 @@ public:
 
 class TOF : public BaseSensor
 {
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"dist", "0", "mm", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"Precision", "2", "decimals", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+
 public:
     /**
      * @brief Constructs a new GAT object.
@@ -902,10 +976,7 @@ public:
 
         try
         {
-            // Default configs
-            addConfigParameter("Precision", {"2", "decimals", SensorDataType::INT, 0});
-            // Default values
-            addValueParameter("dist", {"0", "mm", SensorDataType::INT, 0});
+            applySchema(VALUES, CONFIGS);
         }
         catch (const std::exception &e)
         {
@@ -913,4 +984,32 @@ public:
         }
     }
 };
+
+/**************************************************************************/
+/**
+ * @class GenericSensor
+ * @brief Sensor without its own class, described by the sensor database.
+ *
+ * Type, description, values and configurations are filled in by the database loader.
+ */
+
+class GenericSensor : public BaseSensor
+{
+public:
+    /**
+     * @brief Constructs a new GenericSensor object.
+     *
+     * @param uid The unique sensor identifier.
+     * @param type The sensor type as text.
+     */
+    GenericSensor(std::string uid, std::string type) : BaseSensor(uid)
+    {
+        Type = type;
+    }
+
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~GenericSensor() {}
+};
 #endif // SENSORS_HPP
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+ * @file test_burst.cpp
+ * @brief Host test of BURST samples interleaved with updated values.
+ *
+ * The peer returns its oldest buffered samples, so they are older than values updated
+ * meanwhile. The value history must keep growing timestamps and hold every sample once.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+static const uint32_t PEER_OFFSET = 50000; ///< Local minus peer clock (ms).
+
+/**
+ * @brief Parse a response, the views point into @p text.
+ */
+static ResponseStatusView parse(const std::string &text)
+{
+    ResponseStatusView response;
+    parseMessageParams(MessageView(text), response.params);
+    response.status = ResponseStatusEnum::OK;
+    return response;
+}
+
+static uint32_t peerTime(uint32_t local)
+{
+    return local - PEER_OFFSET;
+}
+
+static bool near(uint32_t actual, uint32_t expected)
+{
+    return std::abs(static_cast<int32_t>(actual - expected)) <= 2;
+}
+
+static bool timesGrow(const SampleHistory &history)
+{
+    for (size_t i = 1; i < history.size(); i++)
+    {
+        if (static_cast<int32_t>(history.timeAt(i) - history.timeAt(i - 1)) < 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void poll(DHT11 &sensor, int temp)
+{
+    std::string text = "?id=D&status=1&temp=" + std::to_string(temp) + "&humi=40";
+    sensor.ingest(parse(text));
+}
+
+static void testInterleaving()
+{
+    DHT11 sensor("D");
+    const SampleHistory &history = sensor.getValues().at(0).second.Samples;
+    for (int i = 0; i < 3; i++)
+    {
+        poll(sensor, 20 + i);
+        waitMs(2);
+    }
+    CHECK_EQ(history.size(), 3);
+    uint32_t polled = history.timeAt(2);
+
+    // Recording by BURST, updated values no longer go to the history
+    sensor.setBurstHistory(true);
+    uint32_t mark = history.getTotal();
+    waitMs(10);
+    uint32_t now = static_cast<uint32_t>(getTimeMs());
+    std::string text = "?id=D&status=1&n=4&t=" + std::to_string(peerTime(polled - 20)) + "," +
+                       std::to_string(peerTime(polled - 10)) + "," + std::to_string(peerTime(polled + 3)) + "," +
+                       std::to_string(peerTime(polled + 6)) + "&now=" + std::to_string(peerTime(now)) +
+                       "&temp=1,2,3,4&humi=5,6,7,8";
+    CHECK_EQ(sensor.ingestBurst(parse(text)), 2); // Older than the stored samples, dropped
+    CHECK_EQ(history.size(), 5);
+    CHECK(near(history.timeAt(3), polled + 3));
+    CHECK(near(history.timeAt(4), polled + 6));
+    CHECK(sensor.getValue<int>("temp") == 22); // Samples are older than the current value
+
+    poll(sensor, 30);
+    CHECK_EQ(history.size(), 5);
+    CHECK(sensor.getValue<int>("temp") == 30);
+
+    // Delayed response does not move the clock, the least delayed one is kept
+    waitMs(10);
+    now = static_cast<uint32_t>(getTimeMs());
+    text = "?id=D&status=1&n=2&t=" + std::to_string(peerTime(now - 4)) + "," + std::to_string(peerTime(now - 2)) +
+           "&now=" + std::to_string(peerTime(now) - 30) + "&temp=9,10&humi=11,12";
+    CHECK_EQ(sensor.ingestBurst(parse(text)), 2);
+    CHECK(near(history.timeAt(5), now - 4));
+    CHECK(near(history.timeAt(6), now - 2));
+
+    // Recorded samples are the burst samples, once and in order
+    CHECK_EQ(history.newerThan(mark), 4);
+    CHECK(history.at(3) == 3 && history.at(4) == 4 && history.at(5) == 9 && history.at(6) == 10);
+    CHECK(timesGrow(history));
+    CHECK_EQ(history.findTime(polled + 1), 3);
+
+    // Updates feed the history again
+    sensor.setBurstHistory(false);
+    waitMs(2);
+    poll(sensor, 31);
+    CHECK_EQ(history.size(), 8);
+    CHECK(timesGrow(history));
+}
+
+static void testPeerWithoutClock()
+{
+    // Older peer, the last sample is taken as sent right before the response
+    DHT11 sensor("D");
+    const SampleHistory &history = sensor.getValues().at(0).second.Samples;
+    sensor.setBurstHistory(true);
+    uint32_t now = static_cast<uint32_t>(getTimeMs());
+    std::string text = "?id=D&status=1&n=3&t=1000,1010,1020&temp=1,2,3&humi=4,5,6";
+    CHECK_EQ(sensor.ingestBurst(parse(text)), 3);
+    CHECK(near(history.timeAt(2), now));
+    CHECK(near(history.timeAt(0), now - 20));
+
+    // Later burst answered longer after its last sample keeps the smaller offset
+    waitMs(25);
+    text = "?id=D&status=1&n=2&t=1030,1040&temp=7,8&humi=9,10";
+    CHECK_EQ(sensor.ingestBurst(parse(text)), 2);
+    CHECK(near(history.timeAt(4), now + 20));
+    CHECK(timesGrow(history));
+}
+
+int main()
+{
+    testInterleaving();
+    testPeerWithoutClock();
+    return TEST_RESULT();
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_change_bus.cpp
+ * @brief Host test of the sensor change-notification bus.
+ *
+ * Changes of a parameter published several times before dispatch() arrive once with
+ * the latest value, subscriptions get the keys they watch and unwatched sensors are
+ * dropped on publishing.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+#include <vector>
+
+#include "sensors/change_bus.hpp"
+#include "test.hpp"
+
+/**
+ * @brief Received changes as "handle:key=value".
+ */
+static ChangeHandler recorder(std::vector<std::string> &received)
+{
+    return [&received](const SensorChange &change) {
+        received.push_back(std::to_string(change.handle) + ":" + *change.key + "=" + change.value.str());
+    };
+}
+
+static void testCoalescing()
+{
+    ChangeBus bus;
+    std::string temp = "temp";
+    std::string humi = "humi";
+    std::string tempValue = "20";
+    std::string humiValue = "40";
+    std::vector<std::string> received;
+    CHECK(bus.subscribe(1, CHANGE_ANY_KEY, recorder(received)) != 0);
+
+    // Latest value, once per parameter, in the order of the first change
+    bus.publish(1, 3, &temp, &tempValue);
+    bus.publish(1, 4, &humi, &humiValue);
+    tempValue = "21";
+    bus.publish(1, 3, &temp, &tempValue);
+    tempValue = "22";
+    CHECK_EQ(bus.dispatch(), 2);
+    CHECK_EQ(received.size(), 2);
+    CHECK(received.size() == 2 && received[0] == "1:temp=22" && received[1] == "1:humi=40");
+
+    received.clear();
+    CHECK_EQ(bus.dispatch(), 0);
+    CHECK(received.empty());
+
+    // Dropped before the sensors owning the values are deleted
+    bus.publish(1, 3, &temp, &tempValue);
+    bus.clear();
+    CHECK_EQ(bus.dispatch(), 0);
+    CHECK(received.empty());
+}
+
+static void testKeyMatching()
+{
+    ChangeBus bus;
+    std::string temp = "temp";
+    std::string note = "note";
+    std::string value = "1";
+    std::string text = "x";
+    std::vector<std::string> all;
+    std::vector<std::string> tempOnly;
+    std::vector<std::string> other;
+    bus.subscribe(2, CHANGE_ANY_KEY, recorder(all));
+    bus.subscribe(2, 3, recorder(tempOnly));
+    bus.subscribe(5, CHANGE_ANY_KEY, recorder(other));
+
+    // A key without a schema key ID reaches only the subscriptions to all keys
+    bus.publish(2, 3, &temp, &value);
+    bus.publish(2, CHANGE_ANY_KEY, &note, &text);
+    CHECK_EQ(bus.dispatch(), 2);
+    CHECK_EQ(all.size(), 2);
+    CHECK(tempOnly.size() == 1 && tempOnly[0] == "2:temp=1");
+    CHECK(other.empty());
+}
+
+static void testUnsubscribe()
+{
+    ChangeBus bus;
+    std::string temp = "temp";
+    std::string value = "1";
+    std::vector<std::string> received;
+    CHECK(!bus.isWatched(7));
+    CHECK_EQ(bus.subscribe(INVALID_SENSOR_HANDLE, CHANGE_ANY_KEY, recorder(received)), 0);
+    CHECK_EQ(bus.subscribe(7, CHANGE_ANY_KEY, ChangeHandler()), 0);
+
+    // The sensor is watched until its last subscription is cancelled
+    ChangeSubscription first = bus.subscribe(7, CHANGE_ANY_KEY, recorder(received));
+    ChangeSubscription second = bus.subscribe(7, 3, recorder(received));
+    CHECK(first != 0 && second != 0 && first != second);
+    CHECK(bus.isWatched(7));
+    CHECK(!bus.isWatched(6));
+
+    bus.unsubscribe(first);
+    bus.unsubscribe(first); // Cancelled already, not counted again
+    bus.unsubscribe(0);
+    bus.unsubscribe(999);
+    CHECK(bus.isWatched(7));
+
+    bus.publish(7, 3, &temp, &value);
+    CHECK_EQ(bus.dispatch(), 1);
+    CHECK_EQ(received.size(), 1);
+
+    bus.unsubscribe(second);
+    CHECK(!bus.isWatched(7));
+    bus.publish(7, 3, &temp, &value); // Nobody watches, dropped
+    CHECK_EQ(bus.dispatch(), 0);
+    CHECK_EQ(received.size(), 1);
+
+    // Watched again by a new subscription
+    ChangeSubscription third = bus.subscribe(7, 3, recorder(received));
+    CHECK(third != first && third != second);
+    bus.publish(7, 3, &temp, &value);
+    CHECK_EQ(bus.dispatch(), 1);
+    CHECK_EQ(received.size(), 2);
+}
+
+static void testPublishInHandler()
+{
+    // Changes published by a handler wait for the next dispatch
+    ChangeBus bus;
+    std::string temp = "temp";
+    std::string humi = "humi";
+    std::string value = "1";
+    unsigned calls = 0;
+    bus.subscribe(0, CHANGE_ANY_KEY, [&](const SensorChange &change) {
+        calls++;
+        if (*change.key == "temp")
+        {
+            bus.publish(0, 4, &humi, &value);
+        }
+    });
+    bus.publish(0, 3, &temp, &value);
+    CHECK_EQ(bus.dispatch(), 1);
+    CHECK_EQ(calls, 1);
+    CHECK_EQ(bus.dispatch(), 1);
+    CHECK_EQ(calls, 2);
+}
+
+int main()
+{
+    testCoalescing();
+    testKeyMatching();
+    testUnsubscribe();
+    testPublishInHandler();
+    return TEST_RESULT();
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_config_sync.cpp
+ * @brief Host test of the dirty-key configuration sync.
+ *
+ * Only configurations changed since the last confirmed CONFIG are collected, values
+ * changed again while a request was on the link stay to be sent, and rapid changes are
+ * held back until the coalescing window closes.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+typedef std::unordered_map<std::string, std::string> ConfigMap;
+
+static void sleepMs(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static ResponseStatus response(ResponseStatusEnum status)
+{
+    ResponseStatus result;
+    result.status = status;
+    return result;
+}
+
+/**
+ * @brief Sensor with INT configurations a, b and c, all of them confirmed.
+ */
+static void addConfigs(GenericSensor &sensor)
+{
+    const char *keys[] = {"a", "b", "c"};
+    for (const char *key : keys)
+    {
+        SensorParam param = SensorParam();
+        param.Value = "1";
+        param.DType = SensorDataType::INT;
+        sensor.addConfigParameter(key, param);
+    }
+    ConfigMap added = sensor.getConfigChanges();
+    CHECK_EQ(added.size(), 3);
+    sensor.applyConfigResponse(added, response(ResponseStatusEnum::OK));
+    CHECK(!sensor.isConfigSyncPending());
+    CHECK(!sensor.isConfigSyncDue());
+}
+
+static void testDirtyKeys()
+{
+    GenericSensor sensor("S", "T");
+    addConfigs(sensor);
+
+    // Same value is not sent again
+    sensor.setConfig("a", "1");
+    CHECK(!sensor.isConfigSyncPending());
+    CHECK(sensor.getConfigChanges().empty());
+
+    sensor.setConfig("b", "5");
+    ConfigMap config;
+    config["c"] = "7";
+    config["a"] = "1";
+    sensor.config(config);
+    ConfigMap changes = sensor.getConfigChanges();
+    CHECK_EQ(changes.size(), 2);
+    CHECK(changes["b"] == "5" && changes["c"] == "7");
+
+    // Changed again while on the link, stays to be sent with the new value
+    sensor.setConfig("b", "6");
+    sensor.applyConfigResponse(changes, response(ResponseStatusEnum::OK));
+    CHECK(sensor.isConfigSyncPending());
+    changes = sensor.getConfigChanges();
+    CHECK(changes.size() == 1 && changes["b"] == "6");
+
+    // Refused by the peer, nothing is confirmed
+    bool thrown = false;
+    try
+    {
+        sensor.applyConfigResponse(changes, response(ResponseStatusEnum::ERROR));
+    }
+    catch (const SensorSynchronizationFailException &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK_EQ(sensor.getConfigChanges().size(), 1);
+
+    sensor.applyConfigResponse(changes, response(ResponseStatusEnum::OK));
+    CHECK(!sensor.isConfigSyncPending());
+    CHECK(sensor.getConfigChanges().empty());
+}
+
+static void testCoalescing()
+{
+    GenericSensor sensor("S", "T");
+    addConfigs(sensor);
+
+    // Quiet window after the last change
+    sensor.setConfig("a", "2");
+    CHECK(sensor.isConfigSyncPending());
+    CHECK(!sensor.isConfigSyncDue());
+    sleepMs(CONFIG_COALESCE_MS + 20);
+    CHECK(sensor.isConfigSyncDue());
+    sensor.applyConfigResponse(sensor.getConfigChanges(), response(ResponseStatusEnum::OK));
+    CHECK(!sensor.isConfigSyncDue());
+
+    // Changing all the time (dragged slider), sent after the longest window
+    unsigned long start = getTimeMs();
+    int value = 10;
+    bool due = false;
+    while (!due && getTimeMs() - start < 2 * CONFIG_COALESCE_MAX_MS)
+    {
+        sensor.setConfig("b", std::to_string(value++));
+        sleepMs(CONFIG_COALESCE_MS / 3);
+        due = sensor.isConfigSyncDue();
+    }
+    unsigned long elapsed = getTimeMs() - start;
+    CHECK(due);
+    CHECK(elapsed >= CONFIG_COALESCE_MAX_MS);
+    CHECK(elapsed < CONFIG_COALESCE_MAX_MS + CONFIG_COALESCE_MS);
+    ConfigMap changes = sensor.getConfigChanges();
+    CHECK(changes.size() == 1 && changes["b"] == std::to_string(value - 1));
+}
+
+int main()
+{
+    testDirtyKeys();
+    testCoalescing();
+    return TEST_RESULT();
+}
@@ -0,0 +1,160 @@
+/**
+ * @file test_key_schema.cpp
+ * @brief Host test of the key schema negotiated in INIT.
+ *
+ * Keys accepted by the peer travel as "#ID" in both directions, the others by name.
+ * Sensors apply values sent by ID by index and the owning copies of responses are keyed
+ * by names again. A peer which does not confirm the schema keeps getting names.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pty_peer.hpp"
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+static std::mutex peerLock;
+static std::string offered;  ///< Keys offered in the last INIT.
+static std::string accepted; ///< Answer to the keys, empty for a legacy peer.
+static std::string update;   ///< Values of the UPDATE response.
+static std::string config;   ///< Last CONFIG request.
+
+static PeerReply answer(const std::string &request, const MessageParams &params)
+{
+    std::lock_guard<std::mutex> guard(peerLock);
+    PeerReply reply;
+    MessageView type = params.get("type");
+    if (type == MessageView("INIT"))
+    {
+        offered = params.get("keys").str();
+        reply.line = "?status=1" + (accepted.empty() ? std::string() : "&keys=" + accepted);
+    }
+    else if (type == MessageView("UPDATE"))
+    {
+        reply.line = echoSeq(params, "id=D&status=1&" + update);
+    }
+    else if (type == MessageView("CONFIG"))
+    {
+        config = request;
+        reply.line = echoSeq(params, "id=D&status=1");
+    }
+    return reply;
+}
+
+static void init(const std::string &keys)
+{
+    std::lock_guard<std::mutex> guard(peerLock);
+    accepted = keys;
+}
+
+static void answerUpdate(const std::string &values)
+{
+    std::lock_guard<std::mutex> guard(peerLock);
+    update = values;
+}
+
+static std::string lastConfig()
+{
+    std::lock_guard<std::mutex> guard(peerLock);
+    return config;
+}
+
+/**
+ * @brief Send a CONFIG of the "Unit" key.
+ */
+static void sendUnit(const std::string &unit)
+{
+    std::unordered_map<std::string, std::string> values;
+    values["Unit"] = unit;
+    CHECK(Protocol::config("D", values).status == ResponseStatusEnum::OK);
+}
+
+static void testAccepted(DHT11 &sensor)
+{
+    // Schema of all keys, in the order of the sensors
+    init("3");
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+    CHECK(offered == "temp,humi,Unit");
+    CHECK_EQ(Protocol::getKeyId("temp"), SCHEMA_KEY_BASE);
+    CHECK_EQ(Protocol::getKeyId("Unit"), SCHEMA_KEY_BASE + 2);
+    CHECK(Protocol::getKeyName(SCHEMA_KEY_BASE + 1) && *Protocol::getKeyName(SCHEMA_KEY_BASE + 1) == "humi");
+    CHECK(Protocol::getKeyName(SCHEMA_KEY_BASE + 3) == nullptr);
+    sensor.bindKeySchema();
+
+    // Values by ID are applied by index, an unknown ID is ignored
+    answerUpdate("#32=21&#33=45&#40=9");
+    CHECK(sensor.ingest(Protocol::updateView("D")));
+    CHECK(sensor.getValue<int>("temp") == 21);
+    CHECK(sensor.getValue<int>("humi") == 45);
+
+    // Owning copy is keyed by names
+    ResponseStatus response = Protocol::update("D");
+    CHECK(response.params["temp"] == "21");
+    CHECK(response.params.count("#32") == 0);
+
+    sendUnit("C");
+    CHECK(lastConfig().find("&#34=C") != std::string::npos);
+}
+
+static void testPartial(DHT11 &sensor)
+{
+    // Only the first key is accepted, the others are sent by name
+    init("1");
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+    CHECK_EQ(Protocol::getKeyId("temp"), SCHEMA_KEY_BASE);
+    CHECK_EQ(Protocol::getKeyId("humi"), 0);
+    sensor.bindKeySchema();
+
+    answerUpdate("#32=22&humi=50");
+    CHECK(sensor.ingest(Protocol::updateView("D")));
+    CHECK(sensor.getValue<int>("temp") == 22);
+    CHECK(sensor.getValue<int>("humi") == 50);
+
+    sendUnit("F");
+    CHECK(lastConfig().find("&Unit=F") != std::string::npos);
+}
+
+static void testLegacyPeer(DHT11 &sensor)
+{
+    // Schema not confirmed, names only
+    init("");
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+    CHECK(!offered.empty());
+    CHECK_EQ(Protocol::getKeyId("temp"), 0);
+    sensor.bindKeySchema();
+
+    answerUpdate("temp=23&humi=51");
+    CHECK(sensor.ingest(Protocol::updateView("D")));
+    CHECK(sensor.getValue<int>("temp") == 23);
+    CHECK(sensor.getValue<int>("humi") == 51);
+
+    sendUnit("K");
+    CHECK(lastConfig().find("&Unit=K") != std::string::npos);
+}
+
+int main()
+{
+    PtyPeer peer;
+    CHECK(peer.ok());
+    peer.setHandler(answer);
+    peer.start();
+
+    DHT11 sensor("D");
+    std::vector<std::string> keys = sensor.getValuesKeys();
+    std::vector<std::string> configs = sensor.getConfigsKeys();
+    keys.insert(keys.end(), configs.begin(), configs.end());
+    Protocol::setKeySchema(keys);
+
+    testAccepted(sensor);
+    testPartial(sensor);
+    testLegacyPeer(sensor);
+
+    peer.stop();
+    return TEST_RESULT();
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_link_worker.cpp
+ * @brief Host test of the job hand-off between the GUI and the link task.
+ *
+ * The link task runs on a std::thread off-target. Jobs posted by the GUI run on the link,
+ * their results come back by publish() and run on the GUI by deliver(). The GUI never waits
+ * for the link, also not while a request to the peer (pty) is in flight.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "managers/link_worker.hpp"
+#include "pty_peer.hpp"
+#include "test.hpp"
+
+static const unsigned LATENCY_MS = 50; ///< Injected latency of UPDATE responses.
+
+/**
+ * @brief Deliver events until @p done or the timeout (GUI loop).
+ */
+template <typename Done>
+static bool deliverUntil(LinkWorker &link, Done done, unsigned long timeout = 2000)
+{
+    unsigned long start = getTimeMs();
+    while (!done() && getTimeMs() - start < timeout)
+    {
+        link.deliver();
+        std::this_thread::yield();
+    }
+    return done();
+}
+
+static void testInPlace()
+{
+    // Without the task jobs and events run right away on the caller
+    LinkWorker link;
+    std::thread::id ran;
+    std::thread::id published;
+    CHECK(link.post([&]() {
+        ran = std::this_thread::get_id();
+        link.publish([&]() { published = std::this_thread::get_id(); });
+    }));
+    CHECK(ran == std::this_thread::get_id());
+    CHECK(published == std::this_thread::get_id());
+    CHECK_EQ(link.deliver(), 0);
+}
+
+static void testHandOff()
+{
+    LinkWorker link;
+    CHECK(link.start());
+    CHECK(link.isRunning());
+
+    // Jobs run on the link in order, their results on the GUI in order
+    const int total = 200;
+    std::thread::id gui = std::this_thread::get_id();
+    std::vector<int> results; // GUI side state, touched by delivered events only
+    unsigned onLink = 0;
+    unsigned onGui = 0;
+    for (int i = 0; i < total; i++)
+    {
+        // At most a queue of jobs in flight, or their results would not fit the event queue
+        while (i - results.size() >= LINK_QUEUE_SIZE)
+        {
+            link.deliver();
+            std::this_thread::yield();
+        }
+        CHECK(link.post([&link, &results, &onLink, &onGui, gui, i]() {
+            onLink += std::this_thread::get_id() != gui;
+            link.publish([&results, &onGui, gui, i]() {
+                onGui += std::this_thread::get_id() == gui;
+                results.push_back(i);
+            });
+        }));
+    }
+
+    CHECK(deliverUntil(link, [&]() { return results.size() == static_cast<size_t>(total); }));
+    CHECK_EQ(onLink, total);
+    CHECK_EQ(onGui, total);
+    int unordered = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        unordered += results[i] != static_cast<int>(i);
+    }
+    CHECK_EQ(unordered, 0);
+    CHECK_EQ(link.getDroppedEvents(), 0);
+
+    // Failed job does not stop the link
+    CHECK(link.post([]() { throw std::runtime_error("job failed"); }));
+    bool alive = false;
+    CHECK(link.post([&link, &alive]() { link.publish([&alive]() { alive = true; }); }));
+    CHECK(deliverUntil(link, [&]() { return alive; }));
+
+    // Stopped link drops what was not delivered, jobs run in place again
+    CHECK(link.post([&link]() { link.publish([]() {}); }));
+    link.stop();
+    CHECK(!link.isRunning());
+    CHECK_EQ(link.deliver(), 0);
+    bool inPlace = false;
+    CHECK(link.post([&inPlace]() { inPlace = true; }));
+    CHECK(inPlace);
+}
+
+static void testCompletionNotDropped()
+{
+    LinkWorker link;
+    CHECK(link.start());
+
+    // The GUI does not deliver until the event queue is full of data
+    std::atomic<bool> filled(false);
+    CHECK(link.post([&link, &filled]() {
+        while (link.publish([]() {}))
+        {
+        }
+        filled.store(true);
+    }));
+    while (!filled.load())
+    {
+        std::this_thread::yield();
+    }
+    uint32_t dropped = link.getDroppedEvents();
+
+    // The completion waits for room instead of being lost with the data
+    bool completed = false;
+    CHECK(link.post([&link, &completed]() { link.complete([&completed]() { completed = true; }); }));
+    waitMs(20);
+    CHECK(!completed);
+    CHECK(deliverUntil(link, [&]() { return completed; }));
+    CHECK_EQ(link.getDroppedEvents(), dropped);
+
+    // Failing delivered job is logged, the next one still runs
+    bool next = false;
+    CHECK(link.post([&link, &next]() {
+        link.complete([]() { throw std::runtime_error("event failed"); });
+        link.complete([&next]() { next = true; });
+    }));
+    CHECK(deliverUntil(link, [&]() { return next; }));
+
+    // Stopped link does not wait for the GUI
+    CHECK(link.post([&link]() {
+        while (link.publish([]() {}))
+        {
+        }
+        link.complete([]() {});
+    }));
+    waitMs(20);
+    link.stop();
+    CHECK(!link.isRunning());
+}
+
+static PeerReply answer(const std::string &, const MessageParams &params)
+{
+    PeerReply reply;
+    MessageView type = params.get("type");
+    if (type == MessageView("INIT"))
+    {
+        reply.line = "?status=1";
+        reply.delay = LATENCY_MS; // The first round trip sets the timeout
+    }
+    else if (type == MessageView("UPDATE"))
+    {
+        reply.line = echoSeq(params, "status=1&value=42");
+        reply.delay = LATENCY_MS;
+    }
+    return reply;
+}
+
+static void testRequestOnLink()
+{
+    PtyPeer peer;
+    CHECK(peer.ok());
+    peer.setHandler(answer);
+    peer.start();
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK); // In place, before the task starts
+
+    LinkWorker link;
+    CHECK(link.start());
+
+    // Blocking request on the link, the GUI only posts it and keeps running
+    std::string value;
+    bool done = false;
+    unsigned long posted = getTimeMs();
+    CHECK(link.post([&link, &value, &done]() {
+        ResponseStatus response = Protocol::update("S");
+        std::string received = response.status == ResponseStatusEnum::OK ? response.params["value"] : "";
+        link.publish([&value, &done, received]() {
+            value = received;
+            done = true;
+        });
+    }));
+    CHECK(getTimeMs() - posted < LATENCY_MS / 2);
+
+    unsigned frames = 0;
+    unsigned long start = getTimeMs();
+    while (!done && getTimeMs() - start < 2000)
+    {
+        link.deliver();
+        frames++;
+        waitMs(1); // One GUI frame
+    }
+    CHECK(done);
+    CHECK(value == "42");
+    CHECK(frames > LATENCY_MS / 5); // The GUI loop ran while the request was in flight
+
+    link.stop();
+    peer.stop();
+}
+
+int main()
+{
+    testInPlace();
+    testHandOff();
+    testCompletionNotDropped();
+    testRequestOnLink();
+    return TEST_RESULT();
+}
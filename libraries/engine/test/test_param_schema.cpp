@@ -0,0 +1,137 @@
+/**
+ * @file test_param_schema.cpp
+ * @brief Host test of the constexpr parameter schemas and the parameter table.
+ *
+ * Parameters are laid out in the order of the schema with its defaults, units, data
+ * types and restrictions, init() again resets them in place and samples survive the
+ * table growing.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+#include <unordered_map>
+
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+/**
+ * @class SchemaSensor
+ * @brief Sensor with restricted parameters in its schema.
+ */
+class SchemaSensor : public BaseSensor
+{
+    static constexpr ParamSchema VALUES[] = { ///< Value schema.
+        {"level", "1.5", "m", SensorDataType::FLOAT, "0", "10", nullptr, nullptr},
+        {"mode", "auto", "", SensorDataType::STRING, nullptr, nullptr, nullptr, "auto,manual"},
+        {"count", "7", "", SensorDataType::INT, nullptr, nullptr, nullptr, nullptr},
+    };
+    static constexpr ParamSchema CONFIGS[] = { ///< Configuration schema.
+        {"rate", "100", "ms", SensorDataType::INT, "10", "1000", "10", nullptr},
+    };
+
+public:
+    SchemaSensor(std::string uid) : BaseSensor(uid) { init(); }
+
+    virtual void init() override
+    {
+        Type = "SchemaSensor";
+        applySchema(VALUES, CONFIGS);
+    }
+};
+
+constexpr ParamSchema SchemaSensor::VALUES[];
+constexpr ParamSchema SchemaSensor::CONFIGS[];
+
+static void testLayout()
+{
+    SchemaSensor sensor("S");
+    const ParamTable<SensorParam> &values = sensor.getValues();
+    CHECK_EQ(values.size(), 3);
+    if (values.size() != 3)
+    {
+        return;
+    }
+
+    // Order of the schema, the first row is the primary value
+    CHECK(values.at(0).first == "level" && values.at(1).first == "mode" && values.at(2).first == "count");
+    const SensorParam &level = values.at(0).second;
+    CHECK(level.Value == "1.5" && level.Unit == "m" && level.DType == SensorDataType::FLOAT);
+    CHECK(level.Restrictions.Min == "0" && level.Restrictions.Max == "10" && level.Restrictions.Options.empty());
+    CHECK(level.NumberValid && level.Number.Float == 1.5f); // Defaults are decoded
+    CHECK(values.at(1).second.Restrictions.Options == "auto,manual");
+    CHECK(!values.at(1).second.NumberValid);
+    CHECK(values.at(2).second.Restrictions.empty());
+
+    CHECK_EQ(sensor.getConfigs().size(), 1);
+    const SensorParam &rate = sensor.getConfigs().at(0).second;
+    CHECK(sensor.getConfigs().at(0).first == "rate");
+    CHECK(rate.Value == "100" && rate.Unit == "ms" && rate.Restrictions.Step == "10");
+
+    // Restrictions of the schema apply to received values
+    bool thrown = false;
+    try
+    {
+        std::unordered_map<std::string, std::string> update;
+        update["mode"] = "off";
+        sensor.update(update);
+    }
+    catch (const InvalidValueException &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // Reset to the defaults in place
+    sensor.setValue("count", "9");
+    sensor.init();
+    CHECK_EQ(values.size(), 3);
+    CHECK(sensor.getValue<int>("count") == 7);
+    CHECK_EQ(sensor.getConfigs().size(), 1);
+
+    // Classes of the sensor list keep their key order
+    DHT11 dht("D");
+    CHECK(dht.getValuesKeys().size() == 2 && dht.getValuesKeys()[0] == "temp" && dht.getValuesKeys()[1] == "humi");
+}
+
+static void testTable()
+{
+    ParamTable<SensorParam> table;
+    CHECK(table.indexOf("a") == ParamTable<SensorParam>::npos);
+    CHECK(table.find("a") == table.end());
+
+    SensorParam param = SensorParam();
+    param.DType = SensorDataType::INT;
+    SensorNumber number;
+    number.Int = 5;
+    table.set("a", param).Samples.push(SensorDataType::INT, number, 1);
+
+    // Growing moves the parameters, samples stay with them
+    for (int i = 0; i < 64; i++)
+    {
+        table.set("k" + std::to_string(i), param);
+    }
+    CHECK_EQ(table.size(), 65);
+    CHECK_EQ(table.indexOf("a"), 0);
+    CHECK_EQ(table.indexOf("k63"), 64);
+    CHECK(table.at(0).second.Samples.size() == 1 && table.at(0).second.Samples.at(0) == 5);
+
+    // Existing key is replaced in place, a copied parameter starts without samples
+    param.Unit = "u";
+    table.set("a", param);
+    CHECK_EQ(table.size(), 65);
+    CHECK(table.at(0).second.Unit == "u");
+    CHECK_EQ(table.at(0).second.Samples.size(), 0);
+
+    table["new"].Value = "1";
+    CHECK_EQ(table.indexOf("new"), 65);
+    CHECK(table.find("new")->second.Value == "1");
+}
+
+int main()
+{
+    testLayout();
+    testTable();
+    return TEST_RESULT();
+}
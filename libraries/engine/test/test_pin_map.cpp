@@ -0,0 +1,199 @@
+/**
+ * @file test_pin_map.cpp
+ * @brief Host test of the pin map transaction of the sensor manager.
+ *
+ * Only sensors whose pins differ from the layout acknowledged by the peer are sent, in
+ * one PINMAP request. A refused transaction changes nothing and is sent again, a peer
+ * without PINMAP gets DISCONNECT/CONNECT per sensor for the rest of the session.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "managers/manager.hpp"
+#include "pty_peer.hpp"
+#include "test.hpp"
+
+enum class PeerMode
+{
+    ACCEPT, ///< Pin maps are applied.
+    REFUSE, ///< Pin maps are refused naming the sensor S15.
+    LEGACY, ///< PINMAP is an unknown request type.
+};
+
+static std::mutex peerLock;
+static PeerMode mode = PeerMode::ACCEPT;
+static std::vector<std::string> requests; ///< Connection requests as "TYPE id pins".
+
+static std::string seqOnly(const MessageParams &params)
+{
+    return params.has("seq") ? "?seq=" + params.get("seq").str() + "&" : std::string("?");
+}
+
+static PeerReply answer(const std::string &, const MessageParams &params)
+{
+    std::lock_guard<std::mutex> guard(peerLock);
+    PeerReply reply;
+    MessageView type = params.get("type");
+    if (type == MessageView("INIT"))
+    {
+        reply.line = "?status=1";
+    }
+    else if (type == MessageView("PINMAP"))
+    {
+        requests.push_back("PINMAP " + params.get("id").str() + " " + params.get("pins").str());
+        if (mode == PeerMode::ACCEPT)
+        {
+            reply.line = seqOnly(params) + "status=1";
+        }
+        else if (mode == PeerMode::REFUSE)
+        {
+            reply.line = seqOnly(params) + "status=0&id=S15&error=Pin conflict";
+        }
+        else
+        {
+            reply.line = seqOnly(params) + "status=0&error=Unknown type";
+        }
+    }
+    else if (type == MessageView("CONNECT") || type == MessageView("DISCONNECT"))
+    {
+        requests.push_back(type.str() + " " + params.get("id").str() + " " + params.get("pins").str());
+        reply.line = echoSeq(params, "status=1");
+    }
+    return reply;
+}
+
+static void setMode(PeerMode value)
+{
+    std::lock_guard<std::mutex> guard(peerLock);
+    mode = value;
+    requests.clear();
+}
+
+static std::vector<std::string> sent()
+{
+    std::lock_guard<std::mutex> guard(peerLock);
+    return requests;
+}
+
+/**
+ * @brief Apply the pin map and wait for its result.
+ *
+ * @return 1 if connected, 0 if not and -1 if no result came.
+ */
+static int connect(SensorManager &manager)
+{
+    int result = -1;
+    CHECK(manager.connect([&result](bool connected) { result = connected ? 1 : 0; }));
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (result < 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(2))
+    {
+        manager.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return result;
+}
+
+static void testTransaction(SensorManager &manager)
+{
+    BaseSensor *temp = manager.getSensor("S00");
+    BaseSensor *dht = manager.getSensor("S01");
+    BaseSensor *photo = manager.getSensor("S15");
+    CHECK(temp && dht && photo);
+    if (!temp || !dht || !photo)
+    {
+        return;
+    }
+
+    // Whole layout in one request
+    setMode(PeerMode::ACCEPT);
+    manager.assignSensorToPin(temp, 0);
+    manager.assignSensorToPin(dht, 1);
+    manager.assignSensorToPin(dht, 2);
+    CHECK_EQ(connect(manager), 1);
+    std::vector<std::string> requests = sent();
+    CHECK(requests.size() == 1 && requests[0] == "PINMAP S00,S01 0;1,2");
+    CHECK(temp->getPins() == "0" && dht->getPins() == "1,2");
+
+    // Same layout, nothing to send
+    setMode(PeerMode::ACCEPT);
+    CHECK_EQ(connect(manager), 1);
+    CHECK(sent().empty());
+
+    // Changed and added sensors, a removed one gets an empty entry
+    manager.unassignSensorFromPin(0);
+    manager.unassignSensorFromPin(2);
+    manager.assignSensorToPin(photo, 3);
+    CHECK_EQ(connect(manager), 1);
+    requests = sent();
+    CHECK(requests.size() == 1 && requests[0] == "PINMAP S01,S15,S00 1;3;");
+    CHECK(temp->getPins().empty() && dht->getPins() == "1" && photo->getPins() == "3");
+
+    // Refused, nothing applied and the refused sensor reports the error
+    setMode(PeerMode::REFUSE);
+    manager.unassignSensorFromPin(3);
+    manager.assignSensorToPin(photo, 4);
+    CHECK_EQ(connect(manager), 0);
+    CHECK(photo->getError() == "Pin conflict");
+    CHECK(dht->getError().empty());
+
+    // Sent again once accepted
+    setMode(PeerMode::ACCEPT);
+    CHECK_EQ(connect(manager), 1);
+    requests = sent();
+    CHECK(requests.size() == 1 && requests[0] == "PINMAP S15 4");
+    CHECK(photo->getError().empty() && photo->getPins() == "4");
+}
+
+static void testLegacyPeer(SensorManager &manager)
+{
+    BaseSensor *dht = manager.getSensor("S01");
+    BaseSensor *photo = manager.getSensor("S15");
+    if (!dht || !photo)
+    {
+        return;
+    }
+
+    // Rejected without a sensor, applied one by one
+    setMode(PeerMode::LEGACY);
+    manager.unassignSensorFromPin(1);
+    manager.unassignSensorFromPin(4);
+    manager.assignSensorToPin(dht, 5);
+    CHECK_EQ(connect(manager), 1);
+    std::vector<std::string> requests = sent();
+    CHECK_EQ(requests.size(), 4);
+    CHECK(requests.size() == 4 && requests[0] == "PINMAP S01,S15 5;" && requests[1] == "DISCONNECT S01 " &&
+          requests[2] == "CONNECT S01 5" && requests[3] == "DISCONNECT S15 ");
+    CHECK(dht->getPins() == "5" && photo->getPins().empty());
+
+    // No more PINMAP in this session
+    setMode(PeerMode::LEGACY);
+    manager.assignSensorToPin(photo, 6);
+    CHECK_EQ(connect(manager), 1);
+    requests = sent();
+    CHECK(requests.size() == 1 && requests[0] == "CONNECT S15 6");
+}
+
+int main()
+{
+    PtyPeer peer;
+    CHECK(peer.ok());
+    peer.setHandler(answer);
+    peer.start();
+
+    {
+        SensorManager manager;
+        CHECK(manager.init());
+        testTransaction(manager);
+        testLegacyPeer(manager);
+    }
+
+    peer.stop();
+    return TEST_RESULT();
+}
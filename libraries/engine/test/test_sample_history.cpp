@@ -0,0 +1,218 @@
+/**
+ * @file test_sample_history.cpp
+ * @brief Host test of the sample history and its decimation pyramid.
+ *
+ * Columns built from the pyramid levels are compared with the raw samples they cover,
+ * also after the ring wrapped and for windows cut at their edges.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <vector>
+
+#include "sensors/sample_history.hpp"
+#include "test.hpp"
+
+static void pushInt(SampleHistory &history, int32_t value, uint32_t time)
+{
+    SensorNumber number;
+    number.Int = value;
+    history.push(SensorDataType::INT, number, time);
+}
+
+/**
+ * @brief History with samples 0..n-1, the value of a sample is its index and its time.
+ */
+static void fill(SampleHistory &history, size_t depth, int32_t n)
+{
+    history.setDepth(depth);
+    for (int32_t i = 0; i < n; i++)
+    {
+        pushInt(history, i, static_cast<uint32_t>(i));
+    }
+}
+
+static void testRingWrap()
+{
+    SampleHistory history;
+    history.setDepth(10);
+    for (int32_t i = 0; i < 25; i++)
+    {
+        pushInt(history, i, static_cast<uint32_t>(100 * i));
+    }
+    CHECK_EQ(history.size(), 10);
+    CHECK_EQ(history.getTotal(), 25);
+    CHECK(history.at(0) == 15 && history.at(9) == 24);
+    CHECK_EQ(history.timeAt(0), 1500);
+
+    // Oldest first, split where the ring wraps
+    SampleSegment<int32_t> segments[2];
+    CHECK_EQ(history.segments(10, segments), 2);
+    CHECK_EQ(segments[0].count + segments[1].count, 10);
+    CHECK_EQ(segments[0].values[0], 15);
+    CHECK_EQ(segments[1].values[segments[1].count - 1], 24);
+    CHECK_EQ(history.segments(3, segments), 1);
+    CHECK_EQ(segments[0].values[0], 22);
+    SampleSegment<float> wrongType[2];
+    CHECK_EQ(history.segments(10, wrongType), 0);
+
+    // Overwritten samples are not counted as new
+    CHECK_EQ(history.newerThan(20), 5);
+    CHECK_EQ(history.newerThan(5), 10);
+
+    uint32_t mark = history.getTotal();
+    history.clear();
+    CHECK_EQ(history.size(), 0);
+    pushInt(history, 1, 0);
+    CHECK_EQ(history.newerThan(mark), 1);
+
+    // Samples of another type replace the stored ones, strings are kept as doubles
+    SensorNumber number;
+    number.Double = 2.5;
+    history.push(SensorDataType::STRING, number, 1);
+    CHECK(history.getType() == SensorDataType::DOUBLE);
+    CHECK_EQ(history.size(), 1);
+    CHECK(history.at(0) == 2.5);
+}
+
+static void testFindTime()
+{
+    SampleHistory history;
+    history.setDepth(8);
+    uint32_t times[] = {10, 20, 20, 20, 30, 40, 50, 60, 70, 80};
+    for (int32_t i = 0; i < 10; i++)
+    {
+        pushInt(history, i, times[i]);
+    }
+    // Stored: 20, 20, 30, ..., 80
+    CHECK_EQ(history.findTime(0), 0);
+    CHECK_EQ(history.findTime(20), 0);
+    CHECK_EQ(history.findTime(21), 2);
+    CHECK_EQ(history.findTime(80), 7);
+    CHECK_EQ(history.findTime(81), 8);
+}
+
+/**
+ * @brief Check columns against the samples they cover (the value of a sample is its number).
+ *
+ * Edge buckets of a level may reach one bucket into the neighbour columns.
+ */
+static void checkColumns(const SampleHistory &history, size_t first, size_t samples, size_t columns)
+{
+    std::vector<SampleBucket> out(columns);
+    size_t filled = history.decimate(first, samples, columns, out.data());
+    CHECK_EQ(filled, samples < columns ? samples : columns);
+
+    double start = history.at(first);
+    for (size_t c = 0; c < filled; c++)
+    {
+        double from = start + static_cast<double>(samples) * c / filled;
+        double to = start + static_cast<double>(samples) * (c + 1) / filled - 1;
+        double reach = static_cast<double>(samples) / columns;
+        const SampleBucket &column = out[c];
+        if (column.min > from + 1 || column.max < to - 1 || column.min < from - reach || column.max > to + reach ||
+            column.mean < column.min || column.mean > column.max || column.time != static_cast<uint32_t>(column.min))
+        {
+            CHECK(false);
+            return;
+        }
+    }
+}
+
+static void testPyramid()
+{
+    SampleHistory history;
+    fill(history, 4096, 4096);
+
+    // Aligned columns get whole buckets, exact min/max/mean
+    SampleBucket out[16];
+    CHECK_EQ(history.decimate(0, 4096, 16, out), 16);
+    for (int c = 0; c < 16; c++)
+    {
+        if (out[c].min != 256 * c || out[c].max != 256 * c + 255 || out[c].mean != 256 * c + 127.5f ||
+            out[c].time != static_cast<uint32_t>(256 * c))
+        {
+            CHECK(false);
+            break;
+        }
+    }
+
+    // Every level, columns not aligned to buckets
+    size_t columnCounts[] = {1, 3, 7, 16, 100, 333, 2048};
+    for (size_t columns : columnCounts)
+    {
+        checkColumns(history, 0, 4096, columns);
+        checkColumns(history, 1000, 2500, columns);
+    }
+
+    // Pending buckets of the last samples are counted, the oldest sample is overwritten
+    pushInt(history, 4096, 4096);
+    CHECK_EQ(history.decimate(3999, 97, 1, out), 1);
+    CHECK(out[0].max == 4096);
+    CHECK(out[0].min <= 4000 && out[0].min >= 4000 - 64); // Edge bucket of the level
+
+    // Short ranges are returned sample by sample
+    CHECK_EQ(history.decimate(10, 3, 8, out), 3);
+    CHECK(out[0].min == 11 && out[2].max == 13 && out[1].mean == 12);
+    CHECK_EQ(history.decimate(4096, 3, 8, out), 0);
+    CHECK_EQ(history.decimate(0, 10, 0, out), 0);
+}
+
+static void testPyramidWrapped()
+{
+    // Samples and buckets of the older part are overwritten
+    SampleHistory history;
+    fill(history, 256, 1000);
+    CHECK(history.at(0) == 744);
+
+    size_t columnCounts[] = {1, 4, 5, 16, 64, 128};
+    for (size_t columns : columnCounts)
+    {
+        checkColumns(history, 0, 256, columns);
+        checkColumns(history, 100, 150, columns);
+    }
+
+    SampleBucket out[4];
+    CHECK_EQ(history.decimate(0, 256, 4, out), 4);
+    CHECK(out[3].max == 999);
+    CHECK(out[0].min <= 744);
+}
+
+static void testWindow()
+{
+    SampleHistory history;
+    history.setDepth(64);
+    for (int32_t i = 0; i < 100; i++)
+    {
+        pushInt(history, i, static_cast<uint32_t>(10 * i));
+    }
+    // Stored: 36..99 at 360..990
+    SampleBucket out[8];
+    CHECK_EQ(history.window(250, 260, 8, out), 0); // Overwritten
+    CHECK_EQ(history.window(500, 510, 8, out), 1); // End is exclusive
+    CHECK(out[0].min == 50 && out[0].time == 500);
+    CHECK_EQ(history.window(505, 511, 8, out), 1);
+    CHECK(out[0].min == 51);
+    CHECK_EQ(history.window(0, 380, 8, out), 2);
+    CHECK(out[0].min == 36 && out[1].min == 37);
+    CHECK_EQ(history.window(985, 5000, 8, out), 1);
+    CHECK(out[0].min == 99);
+    CHECK_EQ(history.window(995, 5000, 8, out), 0);
+    CHECK_EQ(history.window(600, 600, 8, out), 0);
+
+    // Longer windows are decimated over their samples only
+    CHECK_EQ(history.window(400, 720, 4, out), 4);
+    CHECK(out[0].min >= 38 && out[0].min <= 40);
+    CHECK(out[3].max >= 71 && out[3].max <= 73);
+}
+
+int main()
+{
+    testRingWrap();
+    testFindTime();
+    testPyramid();
+    testPyramidWrapped();
+    testWindow();
+    return TEST_RESULT();
+}
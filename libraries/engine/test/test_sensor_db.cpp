@@ -0,0 +1,273 @@
+/**
+ * @file test_sensor_db.cpp
+ * @brief Host test of the sensor database loader.
+ *
+ * JSON tokens across read chunks, compiling the JSON into the binary image and reading
+ * it back, rejecting an image which is damaged or truncated, and loading the JSON file.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "managers/sensor_db.hpp"
+#include "test.hpp"
+
+static const char *DATABASE = "{\"sensors\": {"
+                              "\"DHT11_0\": {\"type\": \"DHT11\", \"description\": \"Room \\u00b0C\","
+                              " \"values\": {"
+                              "  \"temperature\": {\"value\": 0.0, \"unit\": \"C\", \"dtype\": \"float\","
+                              "   \"restrictions\": {\"min\": -40.0, \"max\": 80.0}},"
+                              "  \"humidity\": {\"value\": 0.0, \"unit\": \"%\", \"dtype\": \"float\", \"extra\": [1, {\"a\": 2}]}},"
+                              " \"configs\": {\"resolution\": {\"value\": 0, \"dtype\": \"int\","
+                              "   \"restrictions\": {\"options\": \"8, 10, 12\"}}},"
+                              " \"default\": {\"configs\": {\"resolution\": 10, \"unknown\": 1}, \"pins\": \"4, 5\"}},"
+                              "\"X1\": {\"uid\": \"custom\", \"type\": \"NoSuchType\", \"values\": {\"v\": null}},"
+                              "\"skipped\": 3},"
+                              "\"version\": \"2.1\", \"application\": \"board\"}";
+
+/**
+ * @brief Reader of a string, at most @p chunk bytes per read.
+ */
+static JsonStream::Reader reader(const std::string &text, size_t &pos, size_t chunk)
+{
+    return [&text, &pos, chunk](uint8_t *buffer, size_t size) {
+        size_t count = std::min(std::min(size, chunk), text.size() - pos);
+        memcpy(buffer, text.data() + pos, count);
+        pos += count;
+        return count;
+    };
+}
+
+static bool fails(const std::string &text)
+{
+    size_t pos = 0;
+    JsonStream json(reader(text, pos, JSON_STREAM_CHUNK));
+    try
+    {
+        while (json.next() != JsonToken::END)
+        {
+        }
+    }
+    catch (const InvalidFileFormatException &)
+    {
+        return true;
+    }
+    return false;
+}
+
+static void deleteAll(std::vector<BaseSensor *> &sensors)
+{
+    for (auto *sensor : sensors)
+    {
+        delete sensor;
+    }
+    sensors.clear();
+}
+
+static void testTokens()
+{
+    // Long string crosses the chunks, short reads split the tokens
+    std::string longText(JSON_STREAM_CHUNK + 100, 'x');
+    std::string text = "{\"a\": [1, -2.5e3, true, null], \"b\": \"q\\\"\\n\\u0041\", \"c\": \"" + longText + "\"}";
+    size_t pos = 0;
+    JsonStream json(reader(text, pos, 7));
+    CHECK(json.next() == JsonToken::OBJECT_BEGIN);
+    CHECK(json.next() == JsonToken::KEY && json.text() == "a");
+    CHECK(json.next() == JsonToken::ARRAY_BEGIN);
+    CHECK(json.next() == JsonToken::NUMBER && json.text() == "1");
+    CHECK(json.next() == JsonToken::NUMBER && json.text() == "-2.5e3");
+    CHECK(json.next() == JsonToken::LITERAL && json.text() == "true");
+    CHECK(json.next() == JsonToken::LITERAL && json.text() == "null");
+    CHECK(json.next() == JsonToken::ARRAY_END);
+    CHECK(json.next() == JsonToken::KEY && json.text() == "b");
+    CHECK(json.next() == JsonToken::STRING && json.text() == "q\"\nA");
+    CHECK(json.next() == JsonToken::KEY && json.text() == "c");
+    CHECK(json.next() == JsonToken::STRING && json.text() == longText);
+    CHECK(json.next() == JsonToken::OBJECT_END);
+    CHECK(json.next() == JsonToken::END);
+    CHECK_EQ(json.tell(), text.size());
+
+    // Nested values are skipped whole
+    text = "{\"skip\": {\"x\": [1, {\"y\": []}]}, \"keep\": 5}";
+    pos = 0;
+    JsonStream skipped(reader(text, pos, 3));
+    CHECK(skipped.next() == JsonToken::OBJECT_BEGIN);
+    CHECK(skipped.next() == JsonToken::KEY);
+    skipped.skip(skipped.next());
+    CHECK(skipped.next() == JsonToken::KEY && skipped.text() == "keep");
+    CHECK(skipped.next() == JsonToken::NUMBER && skipped.text() == "5");
+
+    CHECK(fails("{\"a\": 1"));
+    CHECK(fails("{\"a\": [1}"));
+    CHECK(fails("{\"a\": \"open"));
+    CHECK(fails("{\"a\": \"\\x\"}"));
+    CHECK(fails("{1: 2}"));
+    CHECK(fails("{\"a\": @}"));
+    CHECK(fails(std::string(JSON_STREAM_DEPTH + 1, '[')));
+    CHECK(!fails(std::string(JSON_STREAM_DEPTH, '[') + std::string(JSON_STREAM_DEPTH, ']')));
+}
+
+static void checkSensors(const std::vector<BaseSensor *> &sensors)
+{
+    CHECK_EQ(sensors.size(), 2);
+    if (sensors.size() != 2)
+    {
+        return;
+    }
+
+    const BaseSensor &dht = *sensors[0];
+    CHECK(dht.UID == "DHT11_0");
+    CHECK(dht.getTypeName() == "DHT11");
+    CHECK(dht.Description == "Room \xc2\xb0" "C");
+    CHECK(dht.getPins() == "4,5");
+    CHECK_EQ(dht.getValues().size(), 2);
+    const SensorParam &temperature = dht.getValues().at(0).second;
+    CHECK(dht.getValues().at(0).first == "temperature");
+    CHECK(temperature.Unit == "C");
+    CHECK(temperature.DType == SensorDataType::FLOAT);
+    CHECK(temperature.Restrictions.Min == "-40.0" && temperature.Restrictions.Max == "80.0");
+    CHECK(dht.getValues().at(1).first == "humidity");
+    CHECK_EQ(dht.getConfigs().size(), 1);
+    const SensorParam &resolution = dht.getConfigs().at(0).second;
+    CHECK(resolution.Value == "10"); // Default
+    CHECK(resolution.DType == SensorDataType::INT);
+    CHECK(resolution.Restrictions.Options == "8, 10, 12");
+
+    const BaseSensor &generic = *sensors[1];
+    CHECK(generic.UID == "custom");
+    CHECK(generic.getTypeName() == "NoSuchType");
+    CHECK_EQ(generic.getValues().size(), 1);
+    CHECK(generic.getValues().at(0).second.Value.empty());
+}
+
+static void compile(std::vector<uint8_t> &image)
+{
+    std::string text = DATABASE;
+    size_t pos = 0;
+    JsonStream json(reader(text, pos, 16));
+    std::vector<BaseSensor *> sensors;
+    SensorDbInfo info;
+    info.sourceSize = static_cast<uint32_t>(text.size());
+    info.sourceTime = 1700000000;
+    SensorDb::parseJson(json, sensors, info, &image);
+    CHECK(info.version == "2.1"); // Follows the sensors
+    CHECK(info.application == "board");
+    checkSensors(sensors);
+    deleteAll(sensors);
+}
+
+static void testImageRoundTrip()
+{
+    std::vector<uint8_t> image;
+    compile(image);
+    CHECK(image.size() > 8);
+
+    SensorDbInfo info;
+    CHECK(SensorDb::readImageInfo(image.data(), image.size(), info));
+    CHECK(info.version == "2.1");
+    CHECK_EQ(info.sourceSize, strlen(DATABASE));
+    CHECK_EQ(info.sourceTime, 1700000000);
+
+    std::vector<BaseSensor *> sensors;
+    SensorDbInfo read;
+    CHECK(SensorDb::readImage(image.data(), image.size(), sensors, read));
+    CHECK(read.application == "board");
+    checkSensors(sensors);
+    deleteAll(sensors);
+
+    CHECK(SensorDb::imagePath("/db/sensor_db.json") == "/db/sensor_db.bin");
+    CHECK(SensorDb::imagePath("/db.d/sensors") == "/db.d/sensors.bin");
+}
+
+static void testImageRejected()
+{
+    std::vector<uint8_t> image;
+    compile(image);
+    SensorDbInfo info;
+    std::vector<BaseSensor *> sensors;
+
+    // Every flipped byte is caught, no sensor is created
+    for (size_t i = 0; i < image.size(); i++)
+    {
+        std::vector<uint8_t> damaged = image;
+        damaged[i] ^= 0x10;
+        if (SensorDb::readImage(damaged.data(), damaged.size(), sensors, info))
+        {
+            CHECK(false);
+            break;
+        }
+    }
+    CHECK(sensors.empty());
+
+    CHECK(!SensorDb::readImage(image.data(), image.size() - 1, sensors, info));
+    CHECK(!SensorDb::readImage(image.data(), 4, sensors, info));
+    CHECK(!SensorDb::readImage(nullptr, 0, sensors, info));
+    CHECK(sensors.empty());
+
+    // Image of another format, with a valid checksum
+    std::vector<uint8_t> other(image.begin(), image.end() - 4);
+    other[4] = SENSOR_DB_IMAGE_FORMAT + 1;
+    uint32_t hash = 2166136261u;
+    for (uint8_t byte : other)
+    {
+        hash = (hash ^ byte) * 16777619u;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        other.push_back(static_cast<uint8_t>(hash >> (8 * i)));
+    }
+    CHECK(!SensorDb::readImageInfo(other.data(), other.size(), info));
+    other[4] = SENSOR_DB_IMAGE_FORMAT;
+    CHECK(!SensorDb::readImageInfo(other.data(), other.size(), info));
+}
+
+static void testLoadFile()
+{
+    // Host build reads the JSON file itself
+    char path[] = "/tmp/sensor_db_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    FILE *file = fdopen(fd, "wb");
+    fputs(DATABASE, file);
+    fclose(file);
+
+    std::vector<BaseSensor *> sensors;
+    SensorDbInfo info;
+    SensorDb::load(path, sensors, info);
+    CHECK(info.version == "2.1");
+    checkSensors(sensors);
+    deleteAll(sensors);
+    remove(path);
+
+    bool thrown = false;
+    try
+    {
+        SensorDb::load(path, sensors, info);
+    }
+    catch (const FileNotFoundException &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(sensors.empty());
+}
+
+int main()
+{
+    testTokens();
+    testImageRoundTrip();
+    testImageRejected();
+    testLoadFile();
+    return TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+/**
+ * @file test_sensor_factory.cpp
+ * @brief Host test of the sensor type registry and the sensor arena.
+ *
+ * Every registered type is found by its name, and sensors are placed one after another
+ * into the arena until it is full, the block is reused once all of them are deleted.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+#include <vector>
+
+#include "sensors/sensor_arena.hpp"
+#include "sensors/sensor_factory.hpp"
+#include "test.hpp"
+
+static const char *TYPES[] = { ///< Registered types.
+    "ADC", "AnalogTemperature", "CameraSensor", "CpuTempSensor", "DHT11", "DigitalHall",
+    "DigitalTemperature", "GAT", "Joystick", "LinearHall", "LinearHallAndDigital",
+    "MicrophoneSensor", "PhotoInterrupter", "PhotoResistor", "TH", "TOF", "TP",
+};
+
+static void deleteAll(std::vector<BaseSensor *> &sensors)
+{
+    for (auto *sensor : sensors)
+    {
+        delete sensor;
+    }
+    sensors.clear();
+}
+
+static void testRegistry()
+{
+    std::vector<BaseSensor *> sensors;
+    for (const char *type : TYPES)
+    {
+        BaseSensor *sensor = createSensorByType(type, std::string("U") + type);
+        CHECK(sensor != nullptr);
+        if (!sensor)
+        {
+            continue;
+        }
+        sensors.push_back(sensor);
+        CHECK(sensor->UID == std::string("U") + type);
+        CHECK(!sensor->getValues().empty());
+    }
+    deleteAll(sensors);
+
+    // Names around and between the registered ones
+    CHECK(createSensorByType("", "X") == nullptr);
+    CHECK(createSensorByType("AAA", "X") == nullptr);
+    CHECK(createSensorByType("DHT1", "X") == nullptr);
+    CHECK(createSensorByType("DHT111", "X") == nullptr);
+    CHECK(createSensorByType("dht11", "X") == nullptr);
+    CHECK(createSensorByType("ZZZ", "X") == nullptr);
+
+    // Announced list, unknown types are skipped
+    createSensorList(sensors, "?0:ADC&1:TH&&2:NoSuchType&3:DHT11");
+    CHECK_EQ(sensors.size(), 3);
+    CHECK(sensors.size() == 3 && sensors[0]->UID == "0" && sensors[1]->UID == "1" && sensors[2]->UID == "3");
+    deleteAll(sensors);
+}
+
+static void testArena()
+{
+    CHECK_EQ(SensorArena::getLive(), 0);
+
+    // Placed one after another
+    std::vector<BaseSensor *> sensors;
+    sensors.push_back(new DHT11("A"));
+    sensors.push_back(new DHT11("B"));
+    CHECK(SensorArena::owns(sensors[0]) && SensorArena::owns(sensors[1]));
+    CHECK_EQ(SensorArena::getLive(), 2);
+    CHECK(reinterpret_cast<uint8_t *>(sensors[1]) > reinterpret_cast<uint8_t *>(sensors[0]));
+    CHECK(SensorArena::getUsed() >= 2 * sizeof(DHT11));
+    BaseSensor *first = sensors[0];
+
+    // Full arena falls back to the heap
+    size_t placed = 2;
+    while (sensors.size() < 10000 && SensorArena::owns(sensors.back()))
+    {
+        sensors.push_back(new DHT11("S" + std::to_string(sensors.size())));
+        placed += SensorArena::owns(sensors.back());
+    }
+    CHECK(!SensorArena::owns(sensors.back()));
+    CHECK_EQ(SensorArena::getLive(), placed);
+    CHECK(SensorArena::getUsed() <= SENSOR_ARENA_SIZE);
+
+    // Deleting the heap sensor leaves the arena as it is
+    delete sensors.back();
+    sensors.pop_back();
+    CHECK_EQ(SensorArena::getLive(), placed);
+
+    // Reused from the start once all sensors are deleted
+    deleteAll(sensors);
+    CHECK_EQ(SensorArena::getLive(), 0);
+    CHECK_EQ(SensorArena::getUsed(), 0);
+    BaseSensor *again = new DHT11("A");
+    CHECK(again == first);
+    delete again;
+}
+
+int main()
+{
+    testArena(); // Starts with an empty arena
+    testRegistry();
+    return TEST_RESULT();
+}
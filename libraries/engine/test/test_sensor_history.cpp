@@ -0,0 +1,120 @@
+/**
+ * @file test_sensor_history.cpp
+ * @brief Host test of the per-channel sample history fed by received values.
+ *
+ * Every value channel keeps its samples in its own data type with the time they were
+ * received, numeric text of STRING values is kept as doubles and other text only in
+ * the text history.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+/**
+ * @brief Parse a response, the views point into @p text.
+ */
+static ResponseStatusView parse(const std::string &text)
+{
+    ResponseStatusView response;
+    parseMessageParams(MessageView(text), response.params);
+    response.status = ResponseStatusEnum::OK;
+    return response;
+}
+
+static void addValue(GenericSensor &sensor, const std::string &key, SensorDataType type)
+{
+    SensorParam param = SensorParam();
+    param.DType = type;
+    sensor.addValueParameter(key, param);
+}
+
+static void testTypedChannels()
+{
+    GenericSensor sensor("S", "T");
+    addValue(sensor, "count", SensorDataType::INT);
+    addValue(sensor, "level", SensorDataType::FLOAT);
+    addValue(sensor, "state", SensorDataType::STRING);
+    sensor.setHistoryDepth(8);
+
+    uint32_t start = static_cast<uint32_t>(getTimeMs());
+    for (int i = 0; i < 20; i++)
+    {
+        std::string text = "?id=S&status=1&count=" + std::to_string(i) + "&level=" + std::to_string(i) + ".5&state=" +
+                           (i % 2 ? "on" : std::to_string(i) + ".25");
+        CHECK(sensor.ingest(parse(text)));
+    }
+    uint32_t end = static_cast<uint32_t>(getTimeMs());
+
+    // Ring of the last samples, in the type of the channel
+    const SampleHistory &count = sensor.getSamples("count");
+    CHECK(count.getType() == SensorDataType::INT);
+    CHECK_EQ(count.size(), 8);
+    CHECK_EQ(count.getTotal(), 20);
+    CHECK(count.at(0) == 12 && count.at(7) == 19);
+    CHECK(count.timeAt(0) >= start && count.timeAt(7) <= end);
+    SampleSegment<int32_t> segments[2];
+    CHECK(count.segments(8, segments) > 0);
+
+    const SampleHistory &level = sensor.getSamples("level");
+    CHECK(level.getType() == SensorDataType::FLOAT);
+    CHECK(level.at(7) == 19.5);
+
+    // Numeric text only, as doubles, the text goes to the text history
+    const SampleHistory &state = sensor.getSamples("state");
+    CHECK(state.getType() == SensorDataType::DOUBLE);
+    CHECK_EQ(state.getTotal(), 10);
+    CHECK(state.at(state.size() - 1) == 18.25);
+    std::string *history = sensor.getHistory("state");
+    CHECK(history[(20 - 1) % HISTORY_CAP] == "on");
+
+    // Not a number in a numeric channel is not drawn
+    CHECK(sensor.ingest(parse("?id=S&status=1&count=n/a")));
+    CHECK_EQ(count.getTotal(), 20);
+
+    sensor.clearHistory();
+    CHECK(count.size() == 0 && level.size() == 0 && state.size() == 0);
+
+    sensor.setHistoryDepth(0); // Default depth
+    for (int i = 0; i < 10; i++)
+    {
+        sensor.ingest(parse("?id=S&status=1&count=" + std::to_string(i)));
+    }
+    CHECK_EQ(count.size(), 10);
+    sensor.setHistoryDepth(4); // Stored samples are dropped
+    CHECK_EQ(count.size(), 0);
+}
+
+static void testSensorChannels()
+{
+    // Channels of a sensor class get its schema types
+    DHT11 sensor("D");
+    sensor.ingest(parse("?id=D&status=1&temp=21&humi=45"));
+    sensor.ingest(parse("?id=D&status=1&temp=22"));
+    CHECK(sensor.getSamples("temp").getType() == SensorDataType::INT);
+    CHECK_EQ(sensor.getSamples("temp").size(), 2);
+    CHECK_EQ(sensor.getSamples("humi").size(), 1);
+    CHECK(sensor.getSamples("humi").at(0) == 45);
+
+    bool thrown = false;
+    try
+    {
+        sensor.getSamples("none");
+    }
+    catch (const ValueNotFoundException &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+int main()
+{
+    testTypedChannels();
+    testSensorChannels();
+    return TEST_RESULT();
+}
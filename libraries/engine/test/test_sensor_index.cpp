@@ -0,0 +1,100 @@
+/**
+ * @file test_sensor_index.cpp
+ * @brief Host test of the UID to handle index of the sensor manager.
+ *
+ * Many sensors share slots and probe sequences, the table grows while sensors are added
+ * and a repeated UID keeps the handle of its first sensor.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+#include <vector>
+
+#include "managers/sensor_index.hpp"
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+static const size_t SENSORS = 1000; ///< Sensors of the large list.
+
+static void deleteAll(std::vector<BaseSensor *> &sensors)
+{
+    for (auto *sensor : sensors)
+    {
+        delete sensor;
+    }
+    sensors.clear();
+}
+
+static void testGrowth()
+{
+    std::vector<BaseSensor *> sensors;
+    SensorIndex index(sensors);
+    CHECK(index.find("S0") == INVALID_SENSOR_HANDLE); // Empty table
+
+    // Added one by one, every growth places the indexed ones again
+    for (size_t i = 0; i < SENSORS; i++)
+    {
+        sensors.push_back(new GenericSensor("S" + std::to_string(i), "T"));
+        CHECK(index.insert(static_cast<SensorHandle>(i)));
+    }
+    CHECK_EQ(index.size(), SENSORS);
+
+    unsigned wrong = 0;
+    for (size_t i = 0; i < SENSORS; i++)
+    {
+        wrong += index.find("S" + std::to_string(i)) != i;
+    }
+    CHECK_EQ(wrong, 0);
+
+    // Misses walk the probe sequence to a free slot
+    CHECK(index.find("S") == INVALID_SENSOR_HANDLE);
+    CHECK(index.find("S1000") == INVALID_SENSOR_HANDLE);
+    CHECK(index.find("") == INVALID_SENSOR_HANDLE);
+
+    // Views into a longer message
+    std::string message = "S42&S7";
+    CHECK_EQ(index.find(MessageView(message.data(), 3)), 42);
+    CHECK_EQ(index.find(MessageView(message.data() + 4, 2)), 7);
+
+    index.clear();
+    CHECK_EQ(index.size(), 0);
+    CHECK(index.find("S1") == INVALID_SENSOR_HANDLE);
+    index.rebuild();
+    CHECK_EQ(index.size(), SENSORS);
+    CHECK_EQ(index.find("S999"), 999);
+    deleteAll(sensors);
+}
+
+static void testDuplicates()
+{
+    std::vector<BaseSensor *> sensors;
+    SensorIndex index(sensors);
+    sensors.push_back(new GenericSensor("A", "T"));
+    sensors.push_back(new GenericSensor("B", "T"));
+    sensors.push_back(new GenericSensor("A", "T"));
+    sensors.push_back(nullptr);
+
+    CHECK(index.insert(0));
+    CHECK(index.insert(1));
+    CHECK(!index.insert(2)); // Same UID, the first one is kept
+    CHECK(!index.insert(0));
+    CHECK(!index.insert(3)); // No sensor
+    CHECK(!index.insert(4)); // Past the list
+    CHECK_EQ(index.size(), 2);
+    CHECK_EQ(index.find("A"), 0);
+
+    index.rebuild();
+    CHECK_EQ(index.size(), 2);
+    CHECK_EQ(index.find("A"), 0);
+    CHECK_EQ(index.find("B"), 1);
+    deleteAll(sensors);
+}
+
+int main()
+{
+    testGrowth();
+    testDuplicates();
+    return TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+/**
+ * @file test_sensor_values.cpp
+ * @brief Host test of the decoded numeric values of sensor parameters.
+ *
+ * Numeric parameters are decoded once when their text is set, reads of any type use
+ * the decoded number and restrictions compare it without parsing the text again.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+#include <unordered_map>
+
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+static void addValue(GenericSensor &sensor, const std::string &key, SensorDataType type, const std::string &min = "",
+                     const std::string &max = "")
+{
+    SensorParam param = SensorParam();
+    param.DType = type;
+    param.Restrictions.Min = min;
+    param.Restrictions.Max = max;
+    sensor.addValueParameter(key, param);
+}
+
+static void testDecode()
+{
+    SensorNumber number;
+    CHECK(BaseSensor::decodeNumber(SensorDataType::INT, MessageView("12.5"), number) && number.Int == 12);
+    CHECK(BaseSensor::decodeNumber(SensorDataType::INT, MessageView("-7"), number) && number.Int == -7);
+    CHECK(BaseSensor::decodeNumber(SensorDataType::FLOAT, MessageView("2.5"), number) && number.Float == 2.5f);
+    CHECK(BaseSensor::decodeNumber(SensorDataType::DOUBLE, MessageView("-1e3x"), number) && number.Double == -1000);
+    CHECK(!BaseSensor::decodeNumber(SensorDataType::INT, MessageView("abc"), number));
+    CHECK(!BaseSensor::decodeNumber(SensorDataType::INT, MessageView(""), number));
+    CHECK(!BaseSensor::decodeNumber(SensorDataType::STRING, MessageView("1"), number));
+
+    // View into a message, not null terminated
+    std::string message = "temp=21&humi=45";
+    CHECK(BaseSensor::decodeNumber(SensorDataType::INT, MessageView(message.data() + 5, 2), number) && number.Int == 21);
+}
+
+static void testTypedReads()
+{
+    GenericSensor sensor("S", "T");
+    addValue(sensor, "int", SensorDataType::INT);
+    addValue(sensor, "float", SensorDataType::FLOAT);
+    addValue(sensor, "text", SensorDataType::STRING);
+
+    sensor.setValue("int", "42");
+    sensor.setValue("float", "2.75");
+    sensor.setValue("text", "17");
+    CHECK(sensor.getValue<int>("int") == 42);
+    CHECK(sensor.getValue<double>("int") == 42.0);
+    CHECK(sensor.getValue<std::string>("int") == "42");
+    CHECK(sensor.getValue<float>("float") == 2.75f);
+    CHECK(sensor.getValue<int>("float") == 2);
+    CHECK(sensor.getValue<int>("text") == 17); // Parsed from the text
+
+    const SensorParam &param = sensor.getValues().at(0).second;
+    CHECK(param.NumberValid && param.Number.Int == 42);
+
+    // Not a number, read as text only
+    sensor.setValue("int", "n/a");
+    CHECK(!sensor.getValues().at(0).second.NumberValid);
+    CHECK(sensor.getValue<std::string>("int") == "n/a");
+    bool thrown = false;
+    try
+    {
+        sensor.getValue<int>("int");
+    }
+    catch (const InvalidDataTypeException &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+static void testRestrictions()
+{
+    GenericSensor sensor("S", "T");
+    addValue(sensor, "level", SensorDataType::FLOAT, "0", "10");
+
+    std::unordered_map<std::string, std::string> update;
+    update["level"] = "9.5";
+    sensor.update(update);
+    CHECK(sensor.getValue<float>("level") == 9.5f);
+
+    // Out of range, the last value stays
+    update["level"] = "10.5";
+    bool thrown = false;
+    try
+    {
+        sensor.update(update);
+    }
+    catch (const InvalidValueException &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(sensor.getValue<float>("level") == 9.5f);
+
+    // Decoded value is published with the snapshot
+    const SensorSnapshot &snapshot = sensor.getSnapshot();
+    CHECK_EQ(snapshot.count, 1);
+    CHECK(snapshot.values[0].numberValid && snapshot.values[0].number.Float == 9.5f);
+    CHECK(snapshot.values[0].type == SensorDataType::FLOAT);
+}
+
+int main()
+{
+    testDecode();
+    testTypedReads();
+    testRestrictions();
+    return TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+/**
+ * @file test_snapshot.cpp
+ * @brief Host test of the double-buffered sensor snapshots.
+ *
+ * A reader on another task takes the epoch with the view and checks it after reading
+ * (seqlock), a refilled buffer must never pass, also not one published again meanwhile.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "sensors/sensors.hpp"
+#include "test.hpp"
+
+/**
+ * @brief Fill all values of the back buffer with @p n and publish it.
+ */
+static void publishNumber(SnapshotBuffer &buffer, int32_t n)
+{
+    SensorSnapshot &snapshot = buffer.back();
+    snapshot.count = SENSOR_SNAPSHOT_VALUES;
+    std::string text = std::to_string(n);
+    for (int i = 0; i < SENSOR_SNAPSHOT_VALUES; i++)
+    {
+        snapshot.values[i].number.Int = n;
+        setSnapshotText(snapshot.values[i], text.data(), text.size());
+    }
+    buffer.publish();
+}
+
+static void testRefilledBuffer()
+{
+    SnapshotBuffer buffer;
+    publishNumber(buffer, 1);
+
+    uint32_t epoch = 0;
+    const SensorSnapshot &read = buffer.current(epoch);
+    CHECK(epoch != 0);
+    CHECK(buffer.isCurrent(read, epoch));
+
+    // Being refilled while read
+    publishNumber(buffer, 2);
+    buffer.back();
+    CHECK(!buffer.isCurrent(read, epoch));
+
+    // Refilled and published again (ABA), same buffer and the global epoch is its epoch
+    publishNumber(buffer, 3);
+    CHECK(&buffer.current() == &read);
+    CHECK(!buffer.isCurrent(read, epoch));
+
+    // Nothing published yet
+    SnapshotBuffer empty;
+    const SensorSnapshot &none = empty.current(epoch);
+    CHECK(!empty.isCurrent(none, epoch));
+}
+
+static void testConcurrentReader()
+{
+    // Every published snapshot holds one number, a consistent read never mixes two
+    static SnapshotBuffer buffer;
+    publishNumber(buffer, 0);
+    std::atomic<bool> done(false);
+    const int total = 100000;
+    std::thread writer([&done]() {
+        for (int n = 1; n <= total; n++)
+        {
+            publishNumber(buffer, n);
+        }
+        done.store(true);
+    });
+
+    unsigned consistent = 0;
+    unsigned torn = 0;
+    while (!done.load())
+    {
+        uint32_t epoch;
+        const SensorSnapshot &snapshot = buffer.current(epoch);
+        int32_t first = snapshot.values[0].number.Int;
+        bool same = true;
+        for (int i = 1; i < SENSOR_SNAPSHOT_VALUES; i++)
+        {
+            same = same && snapshot.values[i].number.Int == first;
+        }
+        if (!buffer.isCurrent(snapshot, epoch))
+        {
+            continue; // Read again
+        }
+        consistent++;
+        torn += !same;
+    }
+    writer.join();
+    CHECK(consistent > 0);
+    CHECK_EQ(torn, 0);
+}
+
+static void testSetValue()
+{
+    GAT sensor("G");
+    const SnapshotBuffer &snapshots = sensor.getSnapshots();
+    uint32_t epoch = snapshots.getEpoch();
+
+    // One value is refreshed, the others are kept
+    sensor.setValue("acm_x", "1.5");
+    sensor.setValue("acm_y", "-2");
+    const SensorSnapshot &snapshot = sensor.getSnapshot();
+    CHECK_EQ(snapshots.getEpoch(), epoch + 2);
+    CHECK_EQ(snapshot.count, SENSOR_SNAPSHOT_VALUES);
+    CHECK(std::string(snapshot.find("acm_x")->text) == "1.5");
+    CHECK(std::string(snapshot.find("acm_y")->text) == "-2");
+    CHECK(std::string(snapshot.find("Temperature")->unit) == "°C");
+
+    // Value past the snapshot is read from the sensor, nothing is published
+    sensor.setValue("gyr_z", "3");
+    CHECK_EQ(snapshots.getEpoch(), epoch + 2);
+    CHECK(snapshot.find("gyr_z") == nullptr);
+
+    // Long text is cut and marked, the sensor keeps the whole value
+    std::string longText(SENSOR_SNAPSHOT_TEXT + 8, '7');
+    sensor.setValue("Temperature", longText);
+    const SnapshotValue *value = sensor.getSnapshot().find("Temperature");
+    CHECK(value && value->textCut);
+    CHECK(value && std::string(value->text).size() == SENSOR_SNAPSHOT_TEXT - 1);
+    CHECK(sensor.getValues().at(0).second.Value == longText);
+    CHECK(!sensor.getSnapshot().find("acm_x")->textCut);
+}
+
+int main()
+{
+    testRefilledBuffer();
+    testConcurrentReader();
+    testSetValue();
+    return TEST_RESULT();
+}
@@ -12,18 +12,20 @@
 #ifndef CONFIG_EXPT_H
 #define CONFIG_EXPT_H
 
-/// Uncomment to enable Arduino-based environments
+/// Uncomment to enable Arduino-based environments (host builds define STDIO_H instead)
+#ifndef STDIO_H
 #define ARDUINO_H 
-#ifdef ARDUINO_H 
+#endif
 #define UART0_BAUDRATE 115200
 #define UART0_TIMEOUT 100 // only for receive
-#endif
 
 /// Uncomment to enable standard console applications (PC/Linux)
 //#define STDIO_H 
 
 // Uncomment to enable LVGL support
+#ifdef ARDUINO_H
 #define USE_LVGL
+#endif
 #define SPLASHER_TIMEOUT_MS 5000  // Default splash timeout in milliseconds
 
 // Uncomment to enable ESP32 platform
@@ -17,6 +17,7 @@
     #include <Arduino.h>  ///< Include Arduino Serial functions
 #elif defined(STDIO_H)
     #include <stdio.h>    ///< Include standard I/O functions
+    #include <unistd.h>   ///< Include usleep()
 #endif
 
 #ifdef USE_LVGL
@@ -3,7 +3,7 @@
  * @brief Configuration file for platform-specific settings.
  * 
  * This file defines macros to select the execution environment (Arduino or standard console).
- * Uncomment the desired macro to enable the respective environment.
+ * The environment is selected automatically, define ARDUINO_H or STDIO_H to force it.
  * 
  * @copyright 2025 MTA
  * @author Ing. Jiri Konecny
@@ -13,22 +13,65 @@
 #define CONFIG_H
 
 #define MAX_PROTOCOL_REQUEST_SIZE 1024 ///< Maximum size of a protocol request message
+#define MAX_MESSAGE_PARAMS 32 ///< Maximum number of key/value pairs kept from one message
+
+/// Arduino-based environments are detected by the Arduino toolchain,
+/// standard console applications (PC/Linux) use a POSIX pty as the serial link
+#if !defined(ARDUINO_H) && !defined(STDIO_H)
+#ifdef ARDUINO
+#define ARDUINO_H
+#else
+#define STDIO_H
+#endif
+#endif
 
-/// Uncomment to enable Arduino-based environments
-#define ARDUINO_H 
-#ifdef ARDUINO_H
 #define UART1_PORT 0
-#define UART1_BAUDRATE 115200
+#define UART1_BAUDRATE 115200 ///< Base line rate, used until a higher one is negotiated during INIT
 #define UART1_RX -1
 #define UART1_TX -1
-#define UART1_TIMEOUT 100
-#endif
+#define UART1_TIMEOUT 100 ///< Receive timeout, also the request timeout until the round trip time is measured
+#define UART_RX_RING_SIZE 4096 ///< Size of the receive ring buffer filled from the UART event (power of two)
+#define MAX_RECEIVE_LINE_SIZE 2048 ///< Maximum size of a received line/frame, longer ones are dropped
+/// Environment variable with serial device used by console applications (a new pty if not set)
+#define STDIO_PORT_ENV "VSCP_PORT"
 /// Set protocol verbosity level (0 = silent, 1 = errors, 2 = all)
 #define PROTOCOL_VERBOSE 1
 #define PROTOCOL_INIT_TIMEOUT 500
-
-/// Uncomment to enable standard console applications (PC/Linux)
-//#define STDIO_H 
+/// Bounds of the adaptive request timeout (ms) computed from measured round trip times
+#define PROTOCOL_MIN_TIMEOUT 10
+#define PROTOCOL_MAX_TIMEOUT 1000
+/// Response size (bytes) assumed by timeouts of single-sensor requests, the transfer time at the
+/// current line rate is added to the timeout (BURST and batched requests assume MAX_RECEIVE_LINE_SIZE)
+#define PROTOCOL_RESPONSE_SIZE 256
+/// Retry delays (ms) of failed requests grow exponentially from the base up to the maximum (with jitter)
+#define PROTOCOL_RETRY_DELAY 50
+#define PROTOCOL_RETRY_DELAY_MAX 2000
+/// Comment out to stay at UART1_BAUDRATE, otherwise the line rates below are offered during INIT
+#define PROTOCOL_BAUD_NEGOTIATION
+/// Line rates offered during INIT, highest first (see Protocol::init)
+#define PROTOCOL_BAUDRATES 2000000, 921600, 460800
+/// Number of probe exchanges verifying a negotiated line rate, all of them have to pass
+#define PROTOCOL_PROBE_COUNT 3
+/// Time (ms) after which the peer returns to UART1_BAUDRATE if no valid request arrives at the new rate
+#define PROTOCOL_BAUD_FALLBACK_DELAY 300
+/// Requests without response in a row after which a negotiated line rate is given up
+#define PROTOCOL_BAUD_FALLBACK_TIMEOUTS 3
+/// Maximum number of asynchronous requests in flight at once
+#define MAX_PIPELINE_DEPTH 4
+/// Comment out to keep text framing, otherwise binary framing is offered during INIT
+#define PROTOCOL_BINARY_FRAMING
+/// Maximum number of active SUBSCRIBE streams
+#define MAX_SUBSCRIPTIONS 8
+/// First character of frames pushed by the peer without request (SUBSCRIBE streams)
+#define PUSH_FRAME_PREFIX '!'
+/// Maximum number of samples of one BURST request (the response has to fit MAX_RECEIVE_LINE_SIZE)
+#define MAX_BURST_SAMPLES 32
+/// First character of keys sent by their negotiated schema ID ("#ID=value", see Protocol::setKeySchema)
+#define SCHEMA_KEY_PREFIX '#'
+/// First negotiated schema key ID (lower IDs are the well-known keys of binary frames)
+#define SCHEMA_KEY_BASE 32
+/// Maximum number of negotiated schema keys (IDs SCHEMA_KEY_BASE..255)
+#define MAX_SCHEMA_KEYS 224
 
 ///Set whatever the application should be a case sensitive
 #define CASE_SENSITIVE true
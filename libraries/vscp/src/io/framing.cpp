@@ -0,0 +1,373 @@
+/**
+ * @file framing.cpp
+ * @brief Implementation of the compact binary framing of protocol messages.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include "framing.hpp"
+#include "../message.hpp"
+
+#include <cstdio>  // For snprintf
+#include <cstdlib> // For strtol, strtof
+#include <cstring> // For memcpy
+
+static std::string rawBuffer; ///< Reused buffer of the frame before COBS encoding / after decoding
+
+/**
+ * @brief Well-known protocol keys sent as one byte index (order is part of the frame format).
+ */
+static const char *const FRAME_KEYS[] = {
+    "type", "id", "status", "error", "seq", "period", "pins", "app", "db", "api", "framing", "rev", "since", "n", "t",
+};
+static const size_t FRAME_KEYS_COUNT = sizeof(FRAME_KEYS) / sizeof(FRAME_KEYS[0]);
+static_assert(sizeof(FRAME_KEYS) / sizeof(FRAME_KEYS[0]) <= SCHEMA_KEY_BASE, "Well-known keys overlap schema key IDs");
+
+uint16_t crc16(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void cobsEncode(const uint8_t *data, size_t length, std::string &out)
+{
+    size_t codePos = out.size();
+    out.push_back(0); // Placeholder of the first code byte
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (data[i] != 0)
+        {
+            out.push_back(static_cast<char>(data[i]));
+            code++;
+        }
+        if (data[i] == 0 || code == 0xFF)
+        {
+            out[codePos] = static_cast<char>(code);
+            codePos = out.size();
+            out.push_back(0);
+            code = 1;
+        }
+    }
+    out[codePos] = static_cast<char>(code);
+}
+
+bool cobsDecode(const char *data, size_t length, std::string &out)
+{
+    out.clear();
+    size_t i = 0;
+    while (i < length)
+    {
+        uint8_t code = static_cast<uint8_t>(data[i++]);
+        if (code == 0 || i + code - 1 > length)
+        {
+            return false;
+        }
+        out.append(data + i, code - 1);
+        i += code - 1;
+        if (code != 0xFF && i < length)
+        {
+            out.push_back(0);
+        }
+    }
+    return true;
+}
+
+/*Typed values*/
+
+static void appendLE(std::string &out, uint32_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+    {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static uint32_t readLE(const uint8_t *data, size_t bytes)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Checks if the text converts back from the number to exactly the same text.
+ */
+static bool isCanonical(const MessageView &text, const char *formatted)
+{
+    return text == MessageView(formatted);
+}
+
+/**
+ * @brief Appends value with the smallest lossless type.
+ */
+static void appendValue(std::string &out, const MessageView &key, const MessageView &value)
+{
+    char text[32];
+    char formatted[32];
+    FrameValueType type = value.size() <= 0xFF ? FrameValueType::STRING : FrameValueType::STRING16;
+    uint32_t raw = 0;
+
+    if (!value.empty() && value.size() < sizeof(text))
+    {
+        memcpy(text, value.data(), value.size());
+        text[value.size()] = '\0';
+
+        char *end = nullptr;
+        long number = strtol(text, &end, 10);
+        if (*end == '\0' && number >= INT32_MIN && number <= INT32_MAX)
+        {
+            snprintf(formatted, sizeof(formatted), "%ld", number);
+            if (isCanonical(value, formatted))
+            {
+                type = (number >= INT8_MIN && number <= INT8_MAX)     ? FrameValueType::INT8
+                       : (number >= INT16_MIN && number <= INT16_MAX) ? FrameValueType::INT16
+                                                                      : FrameValueType::INT32;
+                raw = static_cast<uint32_t>(static_cast<int32_t>(number));
+            }
+        }
+        else
+        {
+            float real = strtof(text, &end);
+            snprintf(formatted, sizeof(formatted), "%.7g", static_cast<double>(real));
+            if (*end == '\0' && isCanonical(value, formatted))
+            {
+                type = FrameValueType::FLOAT32;
+                memcpy(&raw, &real, sizeof(raw));
+            }
+        }
+    }
+
+    size_t index = parseSchemaKeyId(key);
+    if (index == 0)
+    {
+        while (index < FRAME_KEYS_COUNT && key != MessageView(FRAME_KEYS[index]))
+            index++;
+    }
+
+    if (index < FRAME_KEYS_COUNT || index >= SCHEMA_KEY_BASE)
+    {
+        out.push_back(static_cast<char>(static_cast<uint8_t>(type) | FRAME_TAG_KEY_INDEX));
+        out.push_back(static_cast<char>(index));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(type));
+        out.push_back(static_cast<char>(key.size()));
+        out.append(key.data(), key.size());
+    }
+
+    switch (type)
+    {
+    case FrameValueType::INT8:
+        appendLE(out, raw, 1);
+        break;
+    case FrameValueType::INT16:
+        appendLE(out, raw, 2);
+        break;
+    case FrameValueType::INT32:
+    case FrameValueType::FLOAT32:
+        appendLE(out, raw, 4);
+        break;
+    case FrameValueType::STRING16:
+        appendLE(out, static_cast<uint32_t>(value.size()), 2);
+        out.append(value.data(), value.size());
+        break;
+    default:
+        out.push_back(static_cast<char>(value.size()));
+        out.append(value.data(), value.size());
+        break;
+    }
+}
+
+bool encodeFrame(const std::string &message, std::string &frame)
+{
+    MessageView rest(message);
+    uint8_t flags = 0;
+    if (!rest.empty() && rest[0] == PUSH_FRAME_PREFIX)
+    {
+        flags |= FRAME_FLAG_PUSH;
+        rest = rest.substr(1);
+    }
+
+    rawBuffer.clear();
+    rawBuffer.push_back(static_cast<char>(flags));
+
+    // Every record of a batched response is framed on its own
+    MessageParams params;
+    size_t pos = 0;
+    while (pos <= rest.size())
+    {
+        size_t sep = rest.find('|', pos);
+        if (sep == MessageView::npos)
+            sep = rest.size();
+
+        if (pos > 0)
+        {
+            rawBuffer.push_back(static_cast<char>(FrameValueType::SEPARATOR));
+        }
+
+        parseMessageParams(rest.substr(pos, sep - pos), params, true);
+        if (params.isTruncated())
+        {
+            return false; // Pairs over MAX_MESSAGE_PARAMS would be lost, the CRC would not tell
+        }
+        for (const auto &param : params)
+        {
+            if (param.key.size() > 0xFF || param.value.size() > 0xFFFF)
+            {
+                return false;
+            }
+            appendValue(rawBuffer, param.key, param.value);
+        }
+        pos = sep + 1;
+    }
+
+    uint16_t crc = crc16(reinterpret_cast<const uint8_t *>(rawBuffer.data()), rawBuffer.size());
+    appendLE(rawBuffer, crc, 2);
+
+    frame.clear();
+    cobsEncode(reinterpret_cast<const uint8_t *>(rawBuffer.data()), rawBuffer.size(), frame);
+    return true;
+}
+
+bool decodeFrame(const char *data, size_t length, std::string &message)
+{
+    if (!cobsDecode(data, length, rawBuffer) || rawBuffer.size() < 3)
+    {
+        return false;
+    }
+
+    const uint8_t *raw = reinterpret_cast<const uint8_t *>(rawBuffer.data());
+    size_t size = rawBuffer.size() - 2;
+    if (crc16(raw, size) != readLE(raw + size, 2))
+    {
+        return false;
+    }
+
+    message.clear();
+    if (raw[0] & FRAME_FLAG_PUSH)
+    {
+        message.push_back(PUSH_FRAME_PREFIX);
+    }
+    message.push_back('?');
+
+    bool first = true;
+    size_t i = 1;
+    while (i < size)
+    {
+        uint8_t tag = raw[i++];
+        FrameValueType type = static_cast<FrameValueType>(tag & ~FRAME_TAG_KEY_INDEX);
+        if (type == FrameValueType::SEPARATOR)
+        {
+            message.append("|?");
+            first = true;
+            continue;
+        }
+
+        if (i >= size)
+        {
+            return false;
+        }
+        if (!first)
+        {
+            message.push_back('&');
+        }
+        first = false;
+
+        if (tag & FRAME_TAG_KEY_INDEX)
+        {
+            size_t index = raw[i++];
+            if (index >= SCHEMA_KEY_BASE)
+            {
+                char id[8];
+                snprintf(id, sizeof(id), "%c%u", SCHEMA_KEY_PREFIX, static_cast<unsigned>(index));
+                message.append(id);
+            }
+            else if (index < FRAME_KEYS_COUNT)
+            {
+                message.append(FRAME_KEYS[index]);
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else
+        {
+            size_t keyLength = raw[i++];
+            if (i + keyLength > size)
+                return false;
+            message.append(reinterpret_cast<const char *>(raw + i), keyLength);
+            i += keyLength;
+        }
+        message.push_back('=');
+
+        char formatted[32];
+        size_t valueLength = 0;
+        switch (type)
+        {
+        case FrameValueType::STRING:
+        case FrameValueType::STRING16:
+        {
+            size_t lengthBytes = type == FrameValueType::STRING ? 1 : 2;
+            if (i + lengthBytes > size)
+                return false;
+            valueLength = readLE(raw + i, lengthBytes);
+            i += lengthBytes;
+            if (i + valueLength > size)
+                return false;
+            message.append(reinterpret_cast<const char *>(raw + i), valueLength);
+            i += valueLength;
+            continue;
+        }
+        case FrameValueType::INT8:
+            valueLength = 1;
+            break;
+        case FrameValueType::INT16:
+            valueLength = 2;
+            break;
+        case FrameValueType::INT32:
+        case FrameValueType::FLOAT32:
+            valueLength = 4;
+            break;
+        default:
+            return false; // Unknown type
+        }
+
+        if (i + valueLength > size)
+            return false;
+        uint32_t value = readLE(raw + i, valueLength);
+        i += valueLength;
+
+        if (type == FrameValueType::FLOAT32)
+        {
+            float real;
+            memcpy(&real, &value, sizeof(real));
+            snprintf(formatted, sizeof(formatted), "%.7g", static_cast<double>(real));
+        }
+        else
+        {
+            // Sign extend
+            int32_t number = valueLength == 1 ? static_cast<int8_t>(value)
+                             : valueLength == 2 ? static_cast<int16_t>(value)
+                                                : static_cast<int32_t>(value);
+            snprintf(formatted, sizeof(formatted), "%ld", static_cast<long>(number));
+        }
+        message.append(formatted);
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file framing.hpp
+ * @brief Declaration of the compact binary framing of protocol messages.
+ *
+ * Binary framing is negotiated during INIT (see Protocol::init) and replaces the text lines
+ * on the link. Both sides keep working with text messages, the messenger converts them:
+ *
+ * frame   = COBS( flags | record... | crc16 ) 0x00
+ * flags   = u8, bit 0 set for pushed frames (text prefix PUSH_FRAME_PREFIX)
+ * record  = pair... (records of a batched response are separated by a SEPARATOR pair)
+ * pair    = tag u8 | key | value
+ * tag     = value type (bits 0-6) | FRAME_TAG_KEY_INDEX (bit 7)
+ * key     = key index u8 (protocol keys like "id", "status", "seq" below SCHEMA_KEY_BASE,
+ *           negotiated schema keys "#ID" from SCHEMA_KEY_BASE) or key length u8 + characters
+ * value   = STRING: u8 length + bytes, STRING16: u16 length + bytes,
+ *           INT8/INT16/INT32: little-endian integer, FLOAT32: little-endian IEEE 754
+ * crc16   = CRC-16/CCITT-FALSE of flags and records, little-endian
+ *
+ * Numbers are sent typed only if they convert back to exactly the same text, so the
+ * conversion is lossless. COBS guarantees there is no 0x00 inside a frame, so after
+ * line noise the receiver resynchronizes on the next delimiter and the CRC drops the
+ * damaged frame.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef FRAMING_HPP
+#define FRAMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../config.hpp"
+
+/**
+ * @enum FramingMode
+ * @brief Framing of messages on the link.
+ */
+enum class FramingMode : uint8_t
+{
+    TEXT = 0, ///< Text lines terminated by '\n' (default, always used for the first INIT).
+    COBS = 1, ///< COBS encoded binary frames terminated by 0x00.
+};
+
+/**
+ * @enum FrameValueType
+ * @brief Type tag of one key/value pair of a binary frame.
+ */
+enum class FrameValueType : uint8_t
+{
+    SEPARATOR = 0x00, ///< Record separator of batched responses (no key, no value).
+    STRING = 0x01,    ///< Up to 255 characters.
+    INT8 = 0x02,      ///< Signed 8-bit integer.
+    INT16 = 0x03,     ///< Signed 16-bit integer.
+    INT32 = 0x04,     ///< Signed 32-bit integer.
+    FLOAT32 = 0x05,   ///< IEEE 754 single precision.
+    STRING16 = 0x06,  ///< Up to 65535 characters.
+};
+
+#define FRAME_DELIMITER 0x00  ///< Delimiter of COBS frames on the link
+#define FRAME_FLAG_PUSH 0x01  ///< Frame flag - pushed frame
+#define FRAME_TAG_KEY_INDEX 0x80 ///< Pair tag flag - key is sent as index of a well-known key
+
+/**
+ * @brief Computes CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF).
+ *
+ * @param data Data to compute the checksum of.
+ * @param length Length of the data.
+ * @return The checksum.
+ */
+uint16_t crc16(const uint8_t *data, size_t length);
+
+/**
+ * @brief Appends COBS encoded data to the output (without delimiter).
+ *
+ * @param data Data to encode.
+ * @param length Length of the data.
+ * @param out Output buffer (appended).
+ */
+void cobsEncode(const uint8_t *data, size_t length, std::string &out);
+
+/**
+ * @brief Decodes COBS encoded data (without delimiter).
+ *
+ * @param data Encoded data.
+ * @param length Length of the encoded data.
+ * @param out Output buffer (replaced).
+ * @return false if the data are not valid COBS.
+ */
+bool cobsDecode(const char *data, size_t length, std::string &out);
+
+/**
+ * @brief Converts a text message into a binary frame (without delimiter).
+ *
+ * @param message Text message ("?key=value&...", batched records separated by '|', pushed
+ *                frames prefixed by PUSH_FRAME_PREFIX).
+ * @param frame Output - encoded frame (replaced).
+ * @return false if the message can not be framed (key longer than 255 characters, value
+ *         longer than 65535 characters or a record with more than MAX_MESSAGE_PARAMS pairs).
+ */
+bool encodeFrame(const std::string &message, std::string &frame);
+
+/**
+ * @brief Converts a binary frame (without delimiter) back into a text message.
+ *
+ * @param data Received frame.
+ * @param length Length of the frame.
+ * @param message Output - text message (replaced).
+ * @return false if the frame is damaged (COBS, CRC or layout error).
+ */
+bool decodeFrame(const char *data, size_t length, std::string &message);
+
+#endif // FRAMING_HPP
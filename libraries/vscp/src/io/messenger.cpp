@@ -1,100 +1,108 @@
 /**
  * @file messenger.cpp
  * @brief Definition of the messenger interface and related global functions.
- * 
+ *
  * This header defines the global functions for message operations. It includes configuration
  * and exception handling support..
- * 
+ *
+ * Receiving is split into two halves. The platform part only moves received bytes into
+ * a ring buffer (UART event callback on Arduino, pty pump on console applications), the
+ * common part assembles lines from the ring without blocking, so the application loop
+ * never waits on the serial port.
+ *
  * @copyright 2024 MTA
- * @author 
+ * @author
  * Ing. Jiri Konecny
  */
 #include "messenger.hpp"
 
+static RingBuffer<UART_RX_RING_SIZE> rxRing; ///< Received bytes, producer is the platform part
+static LineAssembler<MAX_RECEIVE_LINE_SIZE> rxAssembler; ///< Partially received line, persists between calls
+static std::string rxDecoded; ///< Reused buffer of the decoded COBS frame
+static std::string txFrame; ///< Reused buffer of the line/frame being sent
+static PushFrameHandler pushFrameHandler = nullptr; ///< Handler of pushed frames
+static FramingMode framingMode = FramingMode::TEXT; ///< Framing of messages on the link
+static uint32_t framingErrors = 0; ///< Number of dropped damaged frames
+static unsigned long lineRate = UART1_BAUDRATE; ///< Current line rate of the link
+
+/*Platform part*/
+
 #ifdef ARDUINO_H
-    #include <Arduino.h>  ///< Include Arduino 
+    #include <Arduino.h>  ///< Include Arduino
     #include <HardwareSerial.h> ///< Include Arduino Serial functions
 
     HardwareSerial UART1_VIRTUAL(UART1_PORT);
     static bool uart1_initialized = false;
 
-    String stripMessage(const String &input, bool trim = true) {
-        String out = "";
-        out.reserve(input.length());
-
-        for (size_t i = 0; i < input.length(); i++) {
-            char c = input[i];
-
-            // tisknutelné ASCII = 32 až 126
-            if (c >= 32 && c <= 126) {
-                out += c;
+    /**
+     * @brief UART event callback (runs in the UART event task), moves received bytes to the ring.
+     */
+    static void onUartReceive() {
+        char chunk[64];
+        int available;
+        while ((available = UART1_VIRTUAL.available()) > 0) {
+            size_t count = UART1_VIRTUAL.readBytes(chunk, available < static_cast<int>(sizeof(chunk)) ? available : sizeof(chunk));
+            if (count == 0) {
+                break;
             }
+            rxRing.push(chunk, count);
         }
-
-        if (trim) {
-            out.trim(); // Remove leading/trailing whitespace
-        }
-        
-        return out;
     }
 
-    void sendMessage(const char* message, int verbose, bool strip) {
-        sendMessageAsString(String(message), verbose, strip);
+    static bool ensureInitialized() {
+        return uart1_initialized || initMessenger();
     }
 
-    void sendMessage(const std::string &message, int verbose, bool strip) {
-        sendMessageAsString(String(message.c_str()), verbose, strip);
+    static void pumpReceived() {
+        // Nothing to do, the ring is filled from the UART event
     }
-    
-    void sendMessageAsString(const String &message, int verbose, bool strip) {
-        if(!uart1_initialized){
-            initMessenger();
-        }
-
-        //strip message before sending
-        String prepMessage = message;
-        if (strip) 
-            prepMessage = stripMessage(message, true);
-
-        if (verbose >= 2) {
-            Serial.print("[SEND] ");
-            Serial.println(prepMessage);
-        }
 
-        UART1_VIRTUAL.println(prepMessage);
+    static void writeBytes(const char *data, size_t length) {
+        UART1_VIRTUAL.write(reinterpret_cast<const uint8_t *>(data), length);
     }
 
-    String receiveMessageAsString(int verbose, int timeout, bool strip) {
-        String msg = ""; // static so it persists between calls
-
-        if(!uart1_initialized){
-            initMessenger();
-        }
+    static void logMessage(const char *prefix, const MessageView &text) {
+        Serial.print(prefix);
+        Serial.write(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+        Serial.println();
+    }
 
-        msg = UART1_VIRTUAL.readStringUntil('\n');
-        if (strip)
-            msg = stripMessage(msg, true);
+    void waitMs(unsigned long ms) {
+        delay(ms);
+    }
 
-        if (msg.length()==0 && verbose>0) {
-            Serial.println("[RECV] No message received (timeout?)");
+    static bool applyBaudRate(unsigned long baudrate) {
+        if (!ensureInitialized()) {
+            return false;
         }
+        UART1_VIRTUAL.flush(); // Send the rest at the old rate
+        UART1_VIRTUAL.updateBaudRate(baudrate);
+        return true;
+    }
 
-        if (verbose >= 2) {
-            Serial.print("[RECV] ");
-            Serial.println(msg);
-        }
+    unsigned long getTimeMs() {
+        return millis();
+    }
 
-        return msg;
+    unsigned long getTimeUs() {
+        return micros();
     }
 
-    const char* receiveMessageAsChars(int verbose, int timeout, bool strip) {
-        String msg = receiveMessageAsString(verbose, timeout, strip);
-        return msg.c_str();
+    void sendMessageAsString(const String &message, int verbose, bool strip) {
+        sendMessage(std::string(message.c_str()), verbose, strip);
     }
-    
-    std::string receiveMessage(int verbose, int timeout, bool strip) {
-        String msg = receiveMessageAsString(verbose, timeout, strip);
-        return std::string(msg.c_str());
+
+    String receiveMessageAsString(int verbose, int timeout, bool strip) {
+        MessageView line;
+        if (!receiveLine(line, verbose, timeout, strip)) {
+            return String();
+        }
+        String out;
+        out.reserve(line.size());
+        for (size_t i = 0; i < line.size(); i++) {
+            out += line[i];
+        }
+        return out;
     }
 
     bool initMessenger(unsigned long baudrate, unsigned int mode, int rx, int tx, unsigned int port) {
@@ -102,6 +110,8 @@
         UART1_VIRTUAL = HardwareSerial(port);
         UART1_VIRTUAL.begin(baudrate, mode, rx, tx);
         UART1_VIRTUAL.setTimeout(UART1_TIMEOUT);
+        UART1_VIRTUAL.onReceive(onUartReceive);
+        lineRate = baudrate;
         return uart1_initialized = true;
     }
 
@@ -111,23 +121,333 @@
 
 #elif defined(STDIO_H)
     #include <stdio.h>    ///< Include standard I/O functions
+    #include <stdlib.h>   ///< Include getenv, posix_openpt
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <termios.h>
+    #include <time.h>
+    #include <unistd.h>
+
+    static int portFd = -1; ///< Serial device or pty master
+    static int ptySlaveFd = -1; ///< Own pty slave, kept open so the link survives reconnecting peers
 
-    void sendMessage(const std::string &message) {
-        printf("%s\n", message.c_str());
+    static speed_t toSpeed(unsigned long baudrate) {
+        switch (baudrate) {
+            case 9600: return B9600;
+            case 19200: return B19200;
+            case 38400: return B38400;
+            case 57600: return B57600;
+            case 230400: return B230400;
+    #ifdef B460800
+            case 460800: return B460800;
+    #endif
+    #ifdef B921600
+            case 921600: return B921600;
+    #endif
+    #ifdef B2000000
+            case 2000000: return B2000000;
+    #endif
+            default: return B115200;
+        }
     }
 
-    std::string receiveMessage(int timeout, int verbose) {
-        char buffer[256];
-        scanf("%s", buffer);
-        return std::string(buffer);
+    static bool configureRaw(int fd, unsigned long baudrate) {
+        struct termios tio;
+        if (tcgetattr(fd, &tio) != 0) {
+            return false;
+        }
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, toSpeed(baudrate));
+        cfsetospeed(&tio, toSpeed(baudrate));
+        return tcsetattr(fd, TCSANOW, &tio) == 0;
     }
 
-    bool initMessenger() {
-        // No initialization needed for standard I/O
+    static void closePort() {
+        if (ptySlaveFd >= 0) {
+            close(ptySlaveFd);
+            ptySlaveFd = -1;
+        }
+        if (portFd >= 0) {
+            close(portFd);
+            portFd = -1;
+        }
+    }
+
+    static bool ensureInitialized() {
+        return portFd >= 0 || initMessenger();
+    }
+
+    static void pumpReceived() {
+        char chunk[256];
+        ssize_t count;
+        while ((count = read(portFd, chunk, sizeof(chunk))) > 0) {
+            rxRing.push(chunk, static_cast<size_t>(count));
+        }
+    }
+
+    static void writeBytes(const char *data, size_t length) {
+        while (length > 0) {
+            ssize_t written = write(portFd, data, length);
+            if (written < 0) {
+                if (errno != EAGAIN && errno != EINTR) {
+                    return;
+                }
+                usleep(100); // Output queue full, the peer is slower
+                continue;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    static void logMessage(const char *prefix, const MessageView &text) {
+        fprintf(stderr, "%s%.*s\n", prefix, static_cast<int>(text.size()), text.data());
+    }
+
+    void waitMs(unsigned long ms) {
+        usleep(static_cast<useconds_t>(ms * 1000));
+    }
+
+    static bool applyBaudRate(unsigned long baudrate) {
+        if (!ensureInitialized()) {
+            return false;
+        }
+        tcdrain(portFd); // Send the rest at the old rate
+        // A pty has no line rate, the setting is only visible to the peer (tcgetattr on the slave)
+        return configureRaw(ptySlaveFd >= 0 ? ptySlaveFd : portFd, baudrate);
+    }
+
+    unsigned long getTimeMs() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<unsigned long>(now.tv_sec) * 1000UL + static_cast<unsigned long>(now.tv_nsec / 1000000L);
+    }
+
+    unsigned long getTimeUs() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<unsigned long>(now.tv_sec) * 1000000UL + static_cast<unsigned long>(now.tv_nsec / 1000L);
+    }
+
+    bool initMessenger(unsigned long baudrate, unsigned int mode, int rx, int tx, unsigned int port) {
+        (void)mode; (void)rx; (void)tx; (void)port; // Given by the device
+        closePort();
+
+        // Existing serial device (or pty of another program) selected by the environment
+        const char *device = getenv(STDIO_PORT_ENV);
+        if (device != nullptr && device[0] != '\0') {
+            portFd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+            if (portFd < 0 || !configureRaw(portFd, baudrate)) {
+                fprintf(stderr, "[INIT] Can not open serial device %s\n", device);
+                closePort();
+                return false;
+            }
+            lineRate = baudrate;
+            return true;
+        }
+
+        // Otherwise create a pty, the peer (emulator) connects to the printed slave device
+        portFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        const char *slave = portFd >= 0 && grantpt(portFd) == 0 && unlockpt(portFd) == 0 ? ptsname(portFd) : nullptr;
+        if (slave != nullptr) {
+            ptySlaveFd = open(slave, O_RDWR | O_NOCTTY);
+        }
+        if (ptySlaveFd < 0 || !configureRaw(ptySlaveFd, baudrate)) {
+            fprintf(stderr, "[INIT] Can not create pty\n");
+            closePort();
+            return false;
+        }
+        fprintf(stderr, "[INIT] Serial link on %s\n", slave);
+        lineRate = baudrate;
         return true;
     }
 
+    bool initMessenger() {
+        return initMessenger(UART1_BAUDRATE, 0, UART1_RX, UART1_TX, UART1_PORT);
+    }
+
 #else
     #error "No valid platform defined. Please define ARDUINO_H or STDIO_H in config.hpp"
-    
-#endif
\ No newline at end of file
+
+#endif
+
+/*Common part*/
+
+/**
+ * @brief Copies the message keeping only printable ASCII and without leading/trailing whitespace.
+ */
+static void stripInto(const std::string &message, std::string &out) {
+    out.clear();
+    for (size_t i = 0; i < message.size(); i++) {
+        char c = message[i];
+
+        // tisknutelné ASCII = 32 až 126
+        if (c >= 32 && c <= 126) {
+            out.push_back(c);
+        }
+    }
+
+    // Remove leading/trailing whitespace
+    size_t start = out.find_first_not_of(' ');
+    if (start == std::string::npos) {
+        out.clear();
+        return;
+    }
+    out.erase(out.find_last_not_of(' ') + 1);
+    out.erase(0, start);
+}
+
+void sendMessage(const char* message, int verbose, bool strip) {
+    sendMessage(std::string(message), verbose, strip);
+}
+
+void sendMessage(const std::string &message, int verbose, bool strip) {
+    if (!ensureInitialized()) {
+        return;
+    }
+
+    if (framingMode == FramingMode::TEXT) {
+        //strip message before sending
+        if (strip)
+            stripInto(message, txFrame);
+        else
+            txFrame.assign(message);
+
+        if (verbose >= 2) {
+            logMessage("[SEND] ", MessageView(txFrame));
+        }
+
+        txFrame.append("\r\n");
+        writeBytes(txFrame.data(), txFrame.size());
+        return;
+    }
+
+    if (verbose >= 2) {
+        logMessage("[SEND] ", MessageView(message));
+    }
+
+    if (!encodeFrame(message, txFrame)) {
+        if (verbose > 0) {
+            logMessage("[SEND] ", "Message can not be framed, dropped");
+        }
+        return;
+    }
+    txFrame.push_back(static_cast<char>(FRAME_DELIMITER));
+    writeBytes(txFrame.data(), txFrame.size());
+}
+
+void setPushFrameHandler(PushFrameHandler handler) {
+    pushFrameHandler = handler;
+}
+
+void setFramingMode(FramingMode mode) {
+    framingMode = mode;
+    rxAssembler.reset();
+}
+
+bool setBaudRate(unsigned long baudrate) {
+    if (!applyBaudRate(baudrate)) {
+        return false;
+    }
+    lineRate = baudrate;
+    rxRing.clear();
+    rxAssembler.reset();
+    return true;
+}
+
+unsigned long getBaudRate() {
+    return lineRate;
+}
+
+FramingMode getFramingMode() {
+    return framingMode;
+}
+
+uint32_t getFramingErrorCount() {
+    return framingErrors;
+}
+
+uint32_t getRxOverflowCount() {
+    return rxRing.getOverflowCount() + rxAssembler.getOverflowCount();
+}
+
+bool tryReceiveLine(MessageView &line, int verbose, bool strip) {
+    if (!ensureInitialized()) {
+        return false;
+    }
+    pumpReceived();
+
+    const bool binary = framingMode == FramingMode::COBS;
+    const char delimiter = binary ? static_cast<char>(FRAME_DELIMITER) : '\n';
+    MessageView raw;
+    while (rxAssembler.assemble(rxRing, delimiter, strip && !binary, raw)) {
+        if (binary) {
+            // Complete frame received, damaged frames are dropped and the next delimiter resynchronizes
+            if (raw.empty()) {
+                continue; // Delimiter only
+            }
+            if (!decodeFrame(raw.data(), raw.size(), rxDecoded)) {
+                framingErrors++;
+                if (verbose > 0) {
+                    logMessage("[RECV] ", "Damaged frame dropped");
+                }
+                continue;
+            }
+            line = MessageView(rxDecoded);
+        } else {
+            line = strip ? raw.trimmed() : raw;
+        }
+
+        // Pushed frames are not responses, demultiplex them here
+        if (!line.empty() && line[0] == PUSH_FRAME_PREFIX) {
+            if (pushFrameHandler) {
+                pushFrameHandler(line.data() + 1, line.size() - 1);
+            }
+            continue;
+        }
+
+        if (verbose >= 2) {
+            logMessage("[RECV] ", line);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool receiveLine(MessageView &line, int verbose, int timeout, bool strip) {
+    unsigned long start = getTimeMs();
+
+    while (!tryReceiveLine(line, verbose, strip)) {
+        if (static_cast<long>(getTimeMs() - start) >= timeout) {
+            if (verbose > 0) {
+                logMessage("[RECV] ", "No message received (timeout?)");
+            }
+            return false;
+        }
+        waitMs(1);
+    }
+    return true;
+}
+
+bool tryReceiveMessage(std::string &message, int verbose, bool strip) {
+    MessageView line;
+    if (!tryReceiveLine(line, verbose, strip)) {
+        return false;
+    }
+    message.assign(line.data(), line.size());
+    return true;
+}
+
+std::string receiveMessage(int verbose, int timeout, bool strip) {
+    MessageView line;
+    if (!receiveLine(line, verbose, timeout, strip)) {
+        return std::string();
+    }
+    return line.str();
+}
+
+const char* receiveMessageAsChars(int verbose, int timeout, bool strip) {
+    static std::string message; // Valid until the next call
+    message = receiveMessage(verbose, timeout, strip);
+    return message.c_str();
+}
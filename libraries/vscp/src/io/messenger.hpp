@@ -15,6 +15,9 @@
 
 #include <string>
 #include "../config.hpp"     ///< Configuration.
+#include "framing.hpp"       ///< Binary framing.
+#include "rx_buffer.hpp"     ///< Receive ring buffer and line assembler.
+#include "../message.hpp"    ///< Message views.
 
 #ifdef ARDUINO_H
     #include <Arduino.h>  ///< Include Arduino Serial functions
@@ -95,6 +98,132 @@ const char* receiveMessageAsChars(int verbose = 0, int timeout = UART1_TIMEOUT,
  */
 std::string receiveMessage(int verbose = 0, int timeout = UART1_TIMEOUT, bool strip = true);
 
+/**
+ * @brief Sets framing of messages on the link.
+ * 
+ * Messages are always passed as text, in COBS mode they are converted to/from binary frames.
+ * Partially received data are dropped.
+ * 
+ * @param mode The framing mode.
+ */
+void setFramingMode(FramingMode mode);
+
+/**
+ * @brief Gets framing of messages on the link.
+ * 
+ * @return The framing mode.
+ */
+FramingMode getFramingMode();
+
+/**
+ * @brief Changes the line rate of the link.
+ * 
+ * Waits until the pending output is sent, then switches the rate. Partially received
+ * data are dropped (bytes received during the switch are not valid at either rate).
+ * 
+ * @param baudrate The new line rate.
+ * @return true if the rate was applied.
+ */
+bool setBaudRate(unsigned long baudrate);
+
+/**
+ * @brief Gets the line rate of the link.
+ * 
+ * @return The line rate set by initMessenger() or setBaudRate().
+ */
+unsigned long getBaudRate();
+
+/**
+ * @brief Gets number of dropped damaged frames (COBS or CRC error).
+ * 
+ * @return Number of damaged frames since start.
+ */
+uint32_t getFramingErrorCount();
+
+/**
+ * @brief Handler of frames pushed by the peer without request.
+ * 
+ * @param frame Frame content without the PUSH_FRAME_PREFIX (not null terminated).
+ * @param length Length of the frame.
+ */
+typedef void (*PushFrameHandler)(const char *frame, size_t length);
+
+/**
+ * @brief Sets the handler of pushed frames.
+ * 
+ * Received lines starting with PUSH_FRAME_PREFIX are passed to the handler and are never
+ * returned by the receive functions, so they can not be mistaken for command responses.
+ * 
+ * @param handler The handler (nullptr - pushed frames are dropped).
+ */
+void setPushFrameHandler(PushFrameHandler handler);
+
+/**
+ * @brief Receives a message without blocking.
+ * 
+ * Consumes whatever is available on the link. Partially received lines are kept
+ * between calls, so it can be polled from the main loop.
+ * 
+ * @param message Output - the received message (valid only if true is returned).
+ * @param verbose Verbosity level for logging (0 = silent, 1 = errors, 2 = all).
+ * @param strip Whether to strip the message after receiving (default is true).
+ * @return true if a complete message was received.
+ */
+bool tryReceiveMessage(std::string &message, int verbose = 0, bool strip = true);
+
+/**
+ * @brief Receives a line without blocking and without copying.
+ * 
+ * Received bytes are queued in a ring buffer by the UART event (pty pump on host),
+ * this only assembles complete lines from it. In COBS mode the frame is decoded
+ * into an internal buffer.
+ * 
+ * @param line Output - view of the received message, valid until the next receive call.
+ * @param verbose Verbosity level for logging (0 = silent, 1 = errors, 2 = all).
+ * @param strip Whether to strip the message after receiving (default is true).
+ * @return true if a complete message was received.
+ */
+bool tryReceiveLine(MessageView &line, int verbose = 0, bool strip = true);
+
+/**
+ * @brief Receives a line, waits at most timeout milliseconds.
+ * 
+ * @param line Output - view of the received message, valid until the next receive call.
+ * @param verbose Verbosity level for logging (0 = silent, 1 = errors, 2 = all).
+ * @param timeout The timeout in milliseconds to wait for a message.
+ * @param strip Whether to strip the message after receiving (default is true).
+ * @return false on timeout.
+ */
+bool receiveLine(MessageView &line, int verbose = 0, int timeout = UART1_TIMEOUT, bool strip = true);
+
+/**
+ * @brief Gets number of received bytes/lines dropped because the buffers were full.
+ * 
+ * @return Number of ring buffer overflows (bytes) plus too long lines since start.
+ */
+uint32_t getRxOverflowCount();
+
+/**
+ * @brief Get monotonic time used by the messenger.
+ * 
+ * @return Time in milliseconds since start.
+ */
+unsigned long getTimeMs();
+
+/**
+ * @brief Wait using the messenger time base.
+ * 
+ * @param ms Time to wait in milliseconds.
+ */
+void waitMs(unsigned long ms);
+
+/**
+ * @brief Get monotonic time used by the messenger in microseconds.
+ * 
+ * @return Time in microseconds since start (wraps around).
+ */
+unsigned long getTimeUs();
+
 #ifdef ARDUINO_H
 /**
  * @brief Receives a message using the global messenger.
@@ -0,0 +1,170 @@
+/**
+ * @file rx_buffer.hpp
+ * @brief Declaration of the receive ring buffer and the non-blocking line assembler.
+ *
+ * RingBuffer is a fixed-size single-producer/single-consumer byte queue. The producer
+ * (UART event callback on target, pty pump on host) pushes received bytes, the consumer
+ * (application loop) pops them without locks.
+ *
+ * LineAssembler pops bytes from the ring into a fixed line buffer and hands out complete
+ * lines as views, so receiving never blocks and never allocates.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef RX_BUFFER_HPP
+#define RX_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../message.hpp"
+
+/**
+ * @class RingBuffer
+ * @brief Lock-free single-producer/single-consumer byte ring buffer.
+ *
+ * @tparam Capacity Size of the buffer in bytes, must be a power of two.
+ */
+template <size_t Capacity>
+class RingBuffer
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+private:
+    char data[Capacity];                  ///< Stored bytes.
+    std::atomic<size_t> head{0};          ///< Write position (producer only).
+    std::atomic<size_t> tail{0};          ///< Read position (consumer only).
+    std::atomic<uint32_t> overflows{0};   ///< Number of bytes dropped because the buffer was full.
+
+public:
+    /**
+     * @brief Push one byte (producer side).
+     *
+     * @return false if the buffer is full and the byte was dropped.
+     */
+    bool push(char c)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= Capacity)
+        {
+            overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        data[h & (Capacity - 1)] = c;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Push several bytes (producer side).
+     *
+     * @return Number of stored bytes, the rest was dropped.
+     */
+    size_t push(const char *src, size_t length)
+    {
+        size_t stored = 0;
+        while (stored < length && push(src[stored]))
+            stored++;
+        return stored;
+    }
+
+    /**
+     * @brief Pop one byte (consumer side).
+     *
+     * @return false if the buffer is empty.
+     */
+    bool pop(char &c)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        c = data[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Drop all stored bytes (consumer side).
+     */
+    void clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return Capacity; }
+    uint32_t getOverflowCount() const { return overflows.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @class LineAssembler
+ * @brief Assembles delimited lines (or frames) from a RingBuffer without blocking.
+ *
+ * Lines longer than the capacity are dropped as a whole and counted.
+ *
+ * @tparam Capacity Maximum line length in bytes.
+ */
+template <size_t Capacity>
+class LineAssembler
+{
+private:
+    char line[Capacity];      ///< Line being assembled / last returned line.
+    size_t length = 0;        ///< Number of bytes of the line being assembled.
+    bool discarding = false;  ///< Set while skipping the rest of a too long line.
+    uint32_t overflows = 0;   ///< Number of dropped too long lines.
+
+public:
+    /**
+     * @brief Consume available bytes until a complete line is found.
+     *
+     * @param ring Source of received bytes.
+     * @param delimiter Line delimiter (not part of the line).
+     * @param printableOnly Whether to drop characters outside printable ASCII (text lines).
+     * @param out Output - the line, valid until the next call.
+     * @return true if a complete line was assembled.
+     */
+    template <size_t RingCapacity>
+    bool assemble(RingBuffer<RingCapacity> &ring, char delimiter, bool printableOnly, MessageView &out)
+    {
+        char c;
+        while (ring.pop(c))
+        {
+            if (c != delimiter)
+            {
+                if (printableOnly && (c < 32 || c > 126))
+                    continue;
+                if (length < Capacity)
+                    line[length++] = c;
+                else
+                    discarding = true;
+                continue;
+            }
+
+            size_t complete = length;
+            length = 0;
+            if (discarding)
+            {
+                discarding = false;
+                overflows++;
+                continue;
+            }
+            out = MessageView(line, complete);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drop the partially assembled line.
+     */
+    void reset()
+    {
+        length = 0;
+        discarding = false;
+    }
+
+    uint32_t getOverflowCount() const { return overflows; }
+};
+
+#endif // RX_BUFFER_HPP
@@ -0,0 +1,96 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Declaration of the lock-free single-producer/single-consumer queue.
+ *
+ * SpscQueue hands objects (e.g. jobs or sensor updates) from one task to another,
+ * like RingBuffer does with received bytes. Neither side locks or waits, a full
+ * queue is reported to the producer and an empty one to the consumer.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @class SpscQueue
+ * @brief Lock-free single-producer/single-consumer queue of fixed capacity.
+ *
+ * Slots are allocated once, items are moved in and out of them.
+ *
+ * @tparam T Item type, must be default constructible and movable.
+ * @tparam Capacity Number of slots, must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+    T slots[Capacity];                  ///< Stored items.
+    std::atomic<size_t> head{0};        ///< Write position (producer only).
+    std::atomic<size_t> tail{0};        ///< Read position (consumer only).
+    std::atomic<uint32_t> overflows{0}; ///< Number of items dropped because the queue was full.
+
+public:
+    /**
+     * @brief Push one item (producer side).
+     *
+     * @param item Item moved into the queue, left untouched if the queue is full.
+     * @return false if the queue is full and the item was dropped.
+     */
+    bool push(T &&item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= Capacity)
+        {
+            overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[h & (Capacity - 1)] = std::move(item);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop one item (consumer side).
+     *
+     * @param item Output - the item moved out of the queue.
+     * @return false if the queue is empty.
+     */
+    bool pop(T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        T &slot = slots[t & (Capacity - 1)];
+        item = std::move(slot);
+        slot = T(); // Release resources held by the moved-from item
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Drop all stored items (consumer side).
+     */
+    void clear()
+    {
+        T item;
+        while (pop(item))
+        {
+        }
+    }
+
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return Capacity; }
+    uint32_t getOverflowCount() const { return overflows.load(std::memory_order_relaxed); }
+};
+
+#endif // SPSC_QUEUE_HPP
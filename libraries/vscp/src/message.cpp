@@ -0,0 +1,206 @@
+/**
+ * @file message.cpp
+ * @brief Implementation of the zero-allocation protocol message tokenizer.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include "message.hpp"
+
+#include <cctype> // For std::isspace, std::tolower
+#include <cstring> // For std::strlen, std::memcmp
+
+static inline bool isTrimmable(char c)
+{
+    return std::isspace(static_cast<unsigned char>(c)) || static_cast<unsigned char>(c) < 32;
+}
+
+static inline char lowerAscii(char c)
+{
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+const size_t MessageView::npos;
+
+MessageView::MessageView(const char *cstr) : ptr(cstr), len(cstr ? std::strlen(cstr) : 0)
+{
+}
+
+bool MessageView::equals(const MessageView &other, bool caseSensitive) const
+{
+    if (len != other.len)
+        return false;
+
+    if (caseSensitive)
+        return len == 0 || std::memcmp(ptr, other.ptr, len) == 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (lowerAscii(ptr[i]) != lowerAscii(other.ptr[i]))
+            return false;
+    }
+    return true;
+}
+
+size_t MessageView::find(char c, size_t from) const
+{
+    for (size_t i = from; i < len; i++)
+    {
+        if (ptr[i] == c)
+            return i;
+    }
+    return npos;
+}
+
+MessageView MessageView::substr(size_t pos, size_t count) const
+{
+    if (pos > len)
+        pos = len;
+    size_t remaining = len - pos;
+    if (count > remaining)
+        count = remaining;
+    return MessageView(ptr + pos, count);
+}
+
+MessageView MessageView::trimmed() const
+{
+    size_t start = 0;
+    size_t stop = len;
+    while (start < stop && isTrimmable(ptr[start]))
+        start++;
+    while (stop > start && isTrimmable(ptr[stop - 1]))
+        stop--;
+    return MessageView(ptr + start, stop - start);
+}
+
+void MessageParams::clear(bool isCaseSensitive)
+{
+    count = 0;
+    truncated = false;
+    caseSensitive = isCaseSensitive;
+}
+
+bool MessageParams::set(const MessageView &key, const MessageView &value)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (entries[i].key.equals(key, caseSensitive))
+        {
+            entries[i].value = value;
+            return true;
+        }
+    }
+
+    if (count >= entries.size())
+    {
+        truncated = true;
+        return false;
+    }
+
+    entries[count].key = key;
+    entries[count].value = value;
+    entries[count].keyId = parseSchemaKeyId(key);
+    count++;
+    return true;
+}
+
+const MessageView *MessageParams::find(const MessageView &key) const
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (entries[i].key.equals(key, caseSensitive))
+            return &entries[i].value;
+    }
+    return nullptr;
+}
+
+MessageView MessageParams::get(const MessageView &key, const MessageView &fallback) const
+{
+    const MessageView *value = find(key);
+    return value ? *value : fallback;
+}
+
+std::unordered_map<std::string, std::string> MessageParams::toMap() const
+{
+    std::unordered_map<std::string, std::string> map;
+    for (size_t i = 0; i < count; i++)
+    {
+        std::string key = entries[i].key.str();
+        std::string value = entries[i].value.str();
+        if (!caseSensitive)
+        {
+            // Keep behaviour of the former parser, which lowercased the whole message
+            for (auto &c : key) c = lowerAscii(c);
+            for (auto &c : value) c = lowerAscii(c);
+        }
+        map[key] = value;
+    }
+    return map;
+}
+
+uint8_t parseSchemaKeyId(const MessageView &key)
+{
+    if (key.size() < 2 || key.size() > 4 || key[0] != SCHEMA_KEY_PREFIX)
+        return 0;
+
+    unsigned id = 0;
+    for (size_t i = 1; i < key.size(); i++)
+    {
+        if (key[i] < '0' || key[i] > '9')
+            return 0;
+        id = id * 10 + static_cast<unsigned>(key[i] - '0');
+    }
+    return (id >= SCHEMA_KEY_BASE && id <= 0xFF) ? static_cast<uint8_t>(id) : 0;
+}
+
+size_t parseMessageParams(const MessageView &message, MessageParams &params, bool caseSensitive)
+{
+    params.clear(caseSensitive);
+
+    MessageView rest = message.trimmed();
+    if (!rest.empty() && rest[0] == '?')
+    {
+        rest = rest.substr(1);
+    }
+
+    // Split by '&' to get key-value pairs
+    size_t pos = 0;
+    while (pos <= rest.size())
+    {
+        size_t amp = rest.find('&', pos);
+        if (amp == MessageView::npos)
+            amp = rest.size();
+
+        MessageView pair = rest.substr(pos, amp - pos);
+        size_t equalPos = pair.find('=');
+        if (equalPos != MessageView::npos)
+        {
+            MessageView key = pair.substr(0, equalPos).trimmed();
+            MessageView value = pair.substr(equalPos + 1).trimmed();
+
+            // Only add non-empty keys
+            if (!key.empty())
+            {
+                params.set(key, value);
+            }
+        }
+
+        pos = amp + 1;
+    }
+
+    return params.size();
+}
+
+bool nextListItem(const MessageView &list, size_t &pos, MessageView &item)
+{
+    if (pos >= list.size())
+        return false;
+
+    size_t comma = list.find(',', pos);
+    if (comma == MessageView::npos)
+        comma = list.size();
+    item = list.substr(pos, comma - pos).trimmed();
+    pos = comma + 1;
+    return true;
+}
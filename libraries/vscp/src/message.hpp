@@ -0,0 +1,204 @@
+/**
+ * @file message.hpp
+ * @brief Declaration of the zero-allocation protocol message tokenizer.
+ *
+ * This header declares MessageView (a non-owning view into a received message) and
+ * MessageParams (a fixed-capacity flat key/value table of views). Parsing a message with
+ * parseMessageParams() tokenizes it in place and never touches the heap, so it is safe
+ * to run on every UPDATE.
+ *
+ * Views stay valid only as long as the buffer they point into is alive and unchanged.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef MESSAGE_HPP
+#define MESSAGE_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @class MessageView
+ * @brief Non-owning, read-only view of a character sequence.
+ *
+ * Minimal C++11 replacement of std::string_view used by the protocol parser.
+ */
+class MessageView
+{
+private:
+    const char *ptr; ///< Start of the viewed characters (not null terminated).
+    size_t len;      ///< Number of viewed characters.
+
+public:
+    static const size_t npos = static_cast<size_t>(-1); ///< "Not found" position.
+
+    MessageView() : ptr(nullptr), len(0) {}
+    MessageView(const char *data, size_t length) : ptr(data), len(length) {}
+    MessageView(const char *cstr);
+    MessageView(const std::string &str) : ptr(str.data()), len(str.size()) {}
+
+    const char *data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    char operator[](size_t i) const { return ptr[i]; }
+    const char *begin() const { return ptr; }
+    const char *end() const { return ptr + len; }
+
+    /**
+     * @brief Compare with another view.
+     *
+     * @param other View to compare with.
+     * @param caseSensitive Whether ASCII letters must match exactly.
+     * @return true if both views hold the same characters.
+     */
+    bool equals(const MessageView &other, bool caseSensitive = true) const;
+
+    bool operator==(const MessageView &other) const { return equals(other); }
+    bool operator!=(const MessageView &other) const { return !equals(other); }
+
+    /**
+     * @brief Find the first occurrence of a character.
+     *
+     * @param c Character to look for.
+     * @param from Position to start searching at.
+     * @return Position of the character or npos.
+     */
+    size_t find(char c, size_t from = 0) const;
+
+    /**
+     * @brief Get a sub-view.
+     *
+     * @param pos First character of the sub-view (clamped to size()).
+     * @param count Maximum number of characters (clamped to the remaining size).
+     * @return The sub-view.
+     */
+    MessageView substr(size_t pos, size_t count = npos) const;
+
+    /**
+     * @brief Get the view without leading/trailing whitespace and control characters.
+     */
+    MessageView trimmed() const;
+
+    /**
+     * @brief Copy the viewed characters into a new std::string (allocates).
+     */
+    std::string str() const { return ptr ? std::string(ptr, len) : std::string(); }
+};
+
+/**
+ * @struct MessageParam
+ * @brief One key/value pair of a parsed message.
+ */
+struct MessageParam
+{
+    MessageView key;   ///< Parameter key.
+    MessageView value; ///< Parameter value.
+    uint8_t keyId = 0; ///< Negotiated schema key ID of "#ID" keys, 0 if the key is sent by name.
+};
+
+/**
+ * @class MessageParams
+ * @brief Fixed-capacity flat key/value table filled by parseMessageParams().
+ *
+ * Lookups are linear scans over at most MAX_MESSAGE_PARAMS entries, which for protocol
+ * sized messages is faster than hashing and never allocates.
+ */
+class MessageParams
+{
+private:
+    std::array<MessageParam, MAX_MESSAGE_PARAMS> entries; ///< Parsed pairs.
+    size_t count = 0;                                     ///< Number of valid pairs.
+    bool caseSensitive = CASE_SENSITIVE;                  ///< Key comparison mode.
+    bool truncated = false;                               ///< Set if pairs were dropped (table full).
+
+public:
+    /**
+     * @brief Remove all pairs.
+     *
+     * @param isCaseSensitive Key comparison mode used by later lookups.
+     */
+    void clear(bool isCaseSensitive = CASE_SENSITIVE);
+
+    /**
+     * @brief Add or overwrite a pair (later keys win, like the previous map-based parser).
+     *
+     * @return false if the table is full and the pair was dropped (see isTruncated()).
+     */
+    bool set(const MessageView &key, const MessageView &value);
+
+    /**
+     * @brief Find value by key.
+     *
+     * @return Pointer to the value view or nullptr if the key is missing.
+     */
+    const MessageView *find(const MessageView &key) const;
+
+    /**
+     * @brief Check if the key is present.
+     */
+    bool has(const MessageView &key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief Get value by key.
+     *
+     * @param key Key to look up.
+     * @param fallback Value returned if the key is missing.
+     * @return The value view.
+     */
+    MessageView get(const MessageView &key, const MessageView &fallback = MessageView()) const;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    /**
+     * @brief Check if pairs were dropped because the table was full (the message is incomplete).
+     */
+    bool isTruncated() const { return truncated; }
+    const MessageParam *begin() const { return entries.data(); }
+    const MessageParam *end() const { return entries.data() + count; }
+
+    /**
+     * @brief Copy all pairs into an owning map (allocates, compatibility path only).
+     */
+    std::unordered_map<std::string, std::string> toMap() const;
+};
+
+/**
+ * @brief Tokenize a protocol message in place.
+ *
+ * Accepts the URL-like format "?key1=value1&key2=value2". The leading '?' is optional,
+ * keys and values are trimmed, pairs without '=' or with an empty key are skipped.
+ * The resulting views point into @p message.
+ *
+ * @param message The message to parse.
+ * @param params Output table (cleared first).
+ * @param caseSensitive Whether later key lookups are case sensitive.
+ * @return Number of parsed pairs.
+ */
+size_t parseMessageParams(const MessageView &message, MessageParams &params, bool caseSensitive = CASE_SENSITIVE);
+
+/**
+ * @brief Get negotiated schema key ID of a key sent as "#ID".
+ *
+ * @param key The key.
+ * @return The ID (SCHEMA_KEY_BASE..255), 0 if the key is not a schema key ID.
+ */
+uint8_t parseSchemaKeyId(const MessageView &key);
+
+/**
+ * @brief Get the next item of a comma separated list (e.g. samples of a BURST response).
+ *
+ * @param list The list.
+ * @param pos Position of the next item, advanced past it (start with 0).
+ * @param item Output - the trimmed item, a view into @p list.
+ * @return false if there are no more items.
+ */
+bool nextListItem(const MessageView &list, size_t &pos, MessageView &item);
+
+#endif // MESSAGE_HPP
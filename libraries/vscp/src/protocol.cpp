@@ -11,72 +11,525 @@
  */
 
 #include "protocol.hpp"
-//#include <expt.hpp> // For std::exception and logs
 
-#include <sstream> // For std::stringstream
-#include <algorithm> // For std::transform
-#include <cctype> // For std::isspace
+#include <cstdio> // For snprintf
+//#include <expt.hpp> // For std::exception and logs
 
 // Static member definitions
 const std::string Protocol::API_VERSION = "1.2";
 bool Protocol::initialized = false;
 
-// Helper function to trim whitespace and invisible characters from strings
-static std::string trim(const std::string& str) {
-    // Find first non-whitespace character
-    size_t start = 0;
-    while (start < str.length() && (std::isspace(static_cast<unsigned char>(str[start])) || str[start] < 32)) {
-        start++;
+std::string Protocol::txBuffer;
+std::string Protocol::rxBuffer;
+std::string Protocol::errorBuffer;
+std::string Protocol::asyncBuffer;
+
+std::array<Protocol::PendingRequest, MAX_PIPELINE_DEPTH> Protocol::pipeline;
+RequestId Protocol::lastSeq = 0;
+uint32_t Protocol::lastTicket = 0;
+
+std::array<Protocol::Subscription, MAX_SUBSCRIPTIONS> Protocol::subscriptions;
+std::string Protocol::pushBuffer;
+uint32_t Protocol::coalescedFrames = 0;
+
+LinkStats Protocol::linkStats;
+ProtocolStats Protocol::stats;
+uint32_t Protocol::jitterSeed = 0;
+
+uint32_t Protocol::baudCeiling = 0xFFFFFFFFu;
+
+std::vector<std::string> Protocol::schemaKeys;
+size_t Protocol::schemaSize = 0;
+
+#ifdef PROTOCOL_BAUD_NEGOTIATION
+static const uint32_t BAUD_RATES[] = {PROTOCOL_BAUDRATES}; ///< Line rates offered during INIT
+#endif
+
+/// PROBE data - alternating bits and a spread of characters, damaged by a wrong line rate
+static const char PROBE_PATTERN[] = "U*U*U*U*0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz~";
+
+/**
+ * @brief Finds the sequence ID ("seq=N") in a response.
+ *
+ * The whole message is scanned, so it works for batched responses as well.
+ *
+ * @return RequestId Sequence ID or 0 if missing
+ */
+static RequestId findSequence(const MessageView& message) {
+    for (size_t i = 0; i + 4 < message.size(); i++) {
+        if ((i > 0 && message[i - 1] != '?' && message[i - 1] != '&') || 
+            message[i] != 's' || message[i + 1] != 'e' || message[i + 2] != 'q' || message[i + 3] != '=') {
+            continue;
+        }
+
+        uint32_t seq = 0;
+        for (size_t j = i + 4; j < message.size() && message[j] >= '0' && message[j] <= '9'; j++) {
+            seq = seq * 10 + static_cast<uint32_t>(message[j] - '0');
+            if (seq > 0xFFFF) return 0;
+        }
+        return static_cast<RequestId>(seq);
     }
-    
-    // If string is all whitespace
-    if (start == str.length()) {
-        return "";
+    return 0;
+}
+
+/**
+ * @brief Checks if the comma separated UID list contains the UID.
+ */
+static bool containsId(const MessageView& ids, const MessageView& id) {
+    size_t pos = 0;
+    while (pos <= ids.size()) {
+        size_t comma = ids.find(',', pos);
+        if (comma == MessageView::npos) comma = ids.size();
+        if (ids.substr(pos, comma - pos) == id) return true;
+        pos = comma + 1;
     }
-    
-    // Find last non-whitespace character
-    size_t end = str.length() - 1;
-    while (end > start && (std::isspace(static_cast<unsigned char>(str[end])) || str[end] < 32)) {
-        end--;
+    return false;
+}
+
+void Protocol::beginRequest(const char* type) {
+    if (txBuffer.capacity() < MAX_PROTOCOL_REQUEST_SIZE) {
+        txBuffer.reserve(MAX_PROTOCOL_REQUEST_SIZE);
     }
-    
-    return str.substr(start, end - start + 1);
+    txBuffer.assign("?type=");
+    txBuffer.append(type);
+}
+
+void Protocol::appendParam(const char* key, const std::string& value) {
+    txBuffer.push_back('&');
+    txBuffer.append(key);
+    txBuffer.push_back('=');
+    txBuffer.append(value);
 }
 
-std::unordered_map<std::string, std::string> Protocol::parseMessage(const std::string& message, bool caseSensitive) {
-    static std::unordered_map<std::string, std::string> params;
-    params.clear();
+MessageView Protocol::transact(int timeout, size_t expected) {
+    if (timeout <= 0) {
+        timeout = static_cast<int>(requestTimeout(expected));
+    }
+
+    // Send request and receive response, round trip is measured only if nothing else is in flight
+    RequestId seq = appendSequence();
+    bool measured = pendingCount() == 0;
+    size_t sentBytes = txBuffer.size();
+    sendMessage(txBuffer);
+    unsigned long sent = getTimeUs();
+    stats.onRequest(txBuffer.size());
+
+    unsigned long start = getTimeMs();
+    long remaining = timeout;
+    MessageView line;
+    while (remaining > 0) {
+        if (!receiveLine(line, PROTOCOL_VERBOSE, static_cast<int>(remaining))) { // Use defined verbosity for receive
+            break; // Timeout
+        }
+        remaining = timeout - static_cast<long>(getTimeMs() - start);
+        if (line.empty()) {
+            continue;
+        }
+        stats.onReceive(line.size());
+        rxBuffer.assign(line.data(), line.size()); // Keeps capacity, the line view is reused by the next receive
+
+        // Responses of asynchronous requests may arrive first, pass them on
+        RequestId received = findSequence(rxBuffer);
+        if (received == seq || (received == 0 && pendingCount() == 0)) {
+            linkStats.timeoutsInRow = 0;
+            unsigned long latency = getTimeUs() - sent;
+            stats.onResponse(latency);
+            if (measured) sampleRtt(latency, sentBytes + rxBuffer.size());
+            return MessageView(rxBuffer);
+        }
+        dispatch(MessageView(rxBuffer), received);
+    }
+
+    onRequestTimeout();
+    rxBuffer.clear();
+    return MessageView(rxBuffer);
+}
+
+unsigned long Protocol::transferUs(size_t bytes) {
+    unsigned long baudrate = getBaudRate();
+    if (baudrate == 0) baudrate = UART1_BAUDRATE;
+    return static_cast<unsigned long>(static_cast<uint64_t>(bytes) * 10 * 1000000UL / baudrate); // Start, 8 data and stop bit
+}
+
+unsigned long Protocol::requestTimeout(size_t expected) {
+    return linkStats.timeout + (transferUs(txBuffer.size() + expected) + 999) / 1000;
+}
+
+unsigned long Protocol::maxRequestTimeout(size_t expected) {
+    // The base rate is the slowest one, the time is rounded up
+    uint64_t transfer = static_cast<uint64_t>(MAX_PROTOCOL_REQUEST_SIZE + expected) * 10 * 1000 / UART1_BAUDRATE + 1;
+    return (PROTOCOL_MAX_TIMEOUT + static_cast<unsigned long>(transfer)) * MAX_PIPELINE_DEPTH;
+}
+
+void Protocol::sampleRtt(unsigned long rtt, size_t bytes) {
+    // Transfer time depends on the size, the rest is the latency of the link and the peer
+    unsigned long transfer = transferUs(bytes);
+    uint32_t sample = static_cast<uint32_t>(rtt > transfer ? rtt - transfer : 0);
+    linkStats.lastRtt = sample;
+    if (linkStats.samples++ == 0) {
+        linkStats.srtt = sample;
+        linkStats.rttvar = sample / 2;
+    } else {
+        uint32_t error = sample > linkStats.srtt ? sample - linkStats.srtt : linkStats.srtt - sample;
+        linkStats.rttvar = (3 * linkStats.rttvar + error) / 4;
+        linkStats.srtt = (7 * linkStats.srtt + sample) / 8;
+    }
+
+    uint32_t timeout = (linkStats.srtt + 4 * linkStats.rttvar + 999) / 1000; // us -> ms, rounded up
+    linkStats.timeout = timeout < PROTOCOL_MIN_TIMEOUT ? PROTOCOL_MIN_TIMEOUT
+                      : timeout > PROTOCOL_MAX_TIMEOUT ? PROTOCOL_MAX_TIMEOUT : timeout;
+}
+
+void Protocol::onRequestTimeout() {
+    stats.onTimeout();
+    linkStats.timeouts++;
+    linkStats.timeout = linkStats.timeout * 2 > PROTOCOL_MAX_TIMEOUT ? PROTOCOL_MAX_TIMEOUT : linkStats.timeout * 2;
+
+    // The negotiated rate stopped working, the peer falls back on the damaged data it receives
+    if (++linkStats.timeoutsInRow >= PROTOCOL_BAUD_FALLBACK_TIMEOUTS && linkStats.rateState == LinkRateState::NEGOTIATED) {
+        fallbackBaudRate();
+    }
+}
+
+void Protocol::appendBaudRates() {
+#ifdef PROTOCOL_BAUD_NEGOTIATION
+    bool first = true;
+    char rate[12];
+    for (uint32_t baudrate : BAUD_RATES) {
+        if (baudrate <= UART1_BAUDRATE || baudrate > baudCeiling) continue;
+        txBuffer.append(first ? "&baud=" : ",");
+        snprintf(rate, sizeof(rate), "%lu", static_cast<unsigned long>(baudrate));
+        txBuffer.append(rate);
+        first = false;
+    }
+#endif
+}
+
+bool Protocol::switchBaudRate(uint32_t baudrate) {
+    linkStats.rateState = LinkRateState::PROBING;
+    if (!setBaudRate(baudrate)) {
+        linkStats.rateState = LinkRateState::BASE;
+        return false;
+    }
+    linkStats.baudrate = baudrate;
+    linkStats.samples = 0; // Round trips at the new rate differ, measure again
+
+    for (uint8_t i = 0; i < PROTOCOL_PROBE_COUNT; i++) {
+        if (!probe()) {
+            fallbackBaudRate();
+            waitMs(PROTOCOL_BAUD_FALLBACK_DELAY); // Until the peer falls back too
+            return false;
+        }
+    }
+    linkStats.rateState = LinkRateState::NEGOTIATED;
+    return true;
+}
+
+bool Protocol::probe() {
+    beginRequest("PROBE");
+    appendParam("data", PROBE_PATTERN);
+
+    ResponseStatusView response;
+    parseResponse(transact(PROTOCOL_INIT_TIMEOUT), nullptr, "Probe failed", response);
+    return response.status == ResponseStatusEnum::OK && response.params.get("data") == MessageView(PROBE_PATTERN);
+}
+
+void Protocol::fallbackBaudRate() {
+    baudCeiling = linkStats.baudrate - 1;
+    setBaudRate(UART1_BAUDRATE);
+    linkStats.baudrate = UART1_BAUDRATE;
+    linkStats.rateState = LinkRateState::FALLBACK;
+    linkStats.rateFallbacks++;
+    linkStats.samples = 0;
+}
+
+LinkStats Protocol::getLinkStats() {
+    return linkStats;
+}
+
+ProtocolStatsSnapshot Protocol::getStats() {
+    return stats.snapshot();
+}
+
+void Protocol::resetStats() {
+    stats.reset();
+}
+
+ResponseStatus Protocol::exchangeStats() {
+    ResponseStatusView response;
+    if (!initialized) {
+        response.error = "Protocol not initialized";
+        return response.toResponseStatus();
+    }
+
+    // Local counters go with the request, the peer may log them
+    ProtocolStatsSnapshot local = stats.snapshot();
+    char number[12];
+    beginRequest("STATS");
+    const struct { const char* key; uint32_t value; } counters[] = {
+        {"req", local.requests}, {"rsp", local.responses}, {"err", local.errors},
+        {"tmo", local.timeouts}, {"p50", local.percentile(50)}, {"p99", local.percentile(99)}
+    };
+    for (const auto& counter : counters) {
+        snprintf(number, sizeof(number), "%lu", static_cast<unsigned long>(counter.value));
+        appendParam(counter.key, number);
+    }
+
+    parseResponse(transact(), nullptr, "Stats failed - bad or missing status", response);
+    return response.toResponseStatus(true);
+}
+
+unsigned long Protocol::getRetryDelay(uint8_t attempt) {
+    unsigned long delay = PROTOCOL_RETRY_DELAY;
+    for (uint8_t i = 0; i < attempt && delay < PROTOCOL_RETRY_DELAY_MAX; i++) {
+        delay *= 2;
+    }
+    if (delay > PROTOCOL_RETRY_DELAY_MAX) delay = PROTOCOL_RETRY_DELAY_MAX;
+
+    // xorshift32, seeded by the boot time
+    if (jitterSeed == 0) jitterSeed = static_cast<uint32_t>(getTimeUs()) | 1;
+    jitterSeed ^= jitterSeed << 13;
+    jitterSeed ^= jitterSeed >> 17;
+    jitterSeed ^= jitterSeed << 5;
+    return delay / 2 + jitterSeed % (delay / 2 + 1);
+}
+
+RequestId Protocol::appendSequence() {
+    if (++lastSeq == 0) lastSeq = 1; // 0 is reserved for "no request"
+
+    char seq[8];
+    snprintf(seq, sizeof(seq), "%u", static_cast<unsigned>(lastSeq));
+    txBuffer.append("&seq=");
+    txBuffer.append(seq);
+    return lastSeq;
+}
+
+RequestId Protocol::submit(const MessageView& ids, bool batched, const ResponseRecordHandler& handler) {
+    PendingRequest* request = nullptr;
+    for (auto& slot : pipeline) {
+        if (slot.seq == 0) {
+            request = &slot;
+            break;
+        }
+    }
+    if (!request) {
+        return 0; // Pipeline full
+    }
+
+    // Requests ahead in the pipeline are answered first
+    size_t ahead = pendingCount();
+    request->seq = appendSequence();
+    request->ticket = ++lastTicket;
+    request->deadline = getTimeMs() + requestTimeout(batched ? MAX_RECEIVE_LINE_SIZE : PROTOCOL_RESPONSE_SIZE) * (ahead + 1);
+    request->measured = ahead == 0;
+    request->sentBytes = txBuffer.size();
+    request->batched = batched;
+    request->completed = false;
+    request->ids.assign(ids.data(), ids.size());
+    request->handler = handler;
+
+    sendMessage(txBuffer);
+    request->sent = getTimeUs();
+    stats.onRequest(txBuffer.size());
+    return request->seq;
+}
+
+bool Protocol::dispatch(const MessageView& message, RequestId seq) {
+    PendingRequest* request = nullptr;
+    for (auto& slot : pipeline) {
+        if (slot.seq == 0 || slot.completed) continue;
+
+        if (seq != 0 && slot.seq == seq) {
+            request = &slot;
+            break;
+        }
+        // Response without sequence ID belongs to the oldest request (FIFO)
+        if (seq == 0 && (!request || slot.ticket - request->ticket > 0x7FFFFFFFu)) {
+            request = &slot;
+        }
+    }
+
+    if (!request) {
+        stats.onLateResponse();
+        return false; // Late response of expired or cancelled request
+    }
+
+    linkStats.timeoutsInRow = 0;
+    unsigned long latency = getTimeUs() - request->sent;
+    stats.onResponse(latency);
+    if (request->measured) sampleRtt(latency, request->sentBytes + message.size());
+    complete(*request, &message, nullptr);
+    return true;
+}
+
+void Protocol::complete(PendingRequest& request, const MessageView* message, const char* error) {
+    request.completed = true;
+    // Take the handler out of the slot, it may submit new requests or cancel this one
+    ResponseRecordHandler handler = std::move(request.handler);
+    request.handler = ResponseRecordHandler();
+
+    if (!message) {
+        request.result.status = ResponseStatusEnum::ERROR;
+        request.result.error = error;
+        request.result.params.clear();
+        if (handler) {
+            ResponseStatusView response;
+            response.error = request.result.error;
+            handler(response);
+        }
+    } else if (request.batched) {
+        request.result = walkBatch(*message, request.ids, handler);
+        if (handler) {
+            // Overall result without "id"
+            ResponseStatusView response;
+            response.status = request.result.status;
+            response.error = request.result.error;
+            handler(response);
+        }
+    } else {
+        ResponseStatusView response;
+        parseResponse(*message, &request.ids, "Connection failed - bad or missing status", response);
+        if (handler) {
+            handler(response);
+        } else {
+            request.result = response.toResponseStatus(true);
+        }
+    }
+
+    if (handler) {
+        request.seq = 0; // Delivered, release the slot
+    }
+}
+
+bool Protocol::checkReady(const std::string& uid, ResponseStatusView& response) {
+    response.status = ResponseStatusEnum::ERROR;
+    response.params.clear();
+
+    if (!initialized) {
+        response.error = "Protocol not initialized";
+        return false;
+    }
     
-    // Remove leading '?' if present
-    std::string cleanMessage = message;
-    if(!caseSensitive)
-    {
-        // Convert to lowercase
-        std::transform(cleanMessage.begin(), cleanMessage.end(), cleanMessage.begin(), ::tolower);
+    if (uid.empty()) {
+        response.error = "UID cannot be empty";
+        return false;
     }
+    return true;
+}
 
-    if (!cleanMessage.empty() && cleanMessage[0] == '?') {
-        cleanMessage = cleanMessage.substr(1);
+void Protocol::parseResponse(const MessageView& message, const std::string* uid, const char* failMessage, ResponseStatusView& response) {
+    response.status = ResponseStatusEnum::ERROR;
+    parseMessageParams(message, response.params);
+
+    // Pairs over MAX_MESSAGE_PARAMS were dropped, the response can not be trusted
+    if (response.params.isTruncated()) {
+        stats.onError();
+        response.error = "Response has too many parameters";
+        return;
+    }
+
+    // Check if UID from response matches request
+    if (uid) {
+        const MessageView* id = response.params.find("id");
+        if (!id || *id != MessageView(*uid)) {
+            if (!message.empty()) stats.onUidMismatch();
+            errorBuffer = "Response UID mismatch - expected: " + *uid + ", received: " + 
+                            (id ? id->str() : std::string("none"));
+            response.error = errorBuffer;
+            return;
+        }
     }
     
-    // Split by '&' to get key-value pairs
-    std::stringstream ss(cleanMessage);
-    std::string pair;
+    // Check if request was successful
+    const MessageView* status = response.params.find("status");
+    if (!status || *status != MessageView("1")) {
+        if (!message.empty()) stats.onError(); // Empty message is a timeout, counted already
+        response.error = response.params.get("error", failMessage);
+        return;
+    }
+
+    response.status = ResponseStatusEnum::OK;
+    response.error = MessageView();
+}
+
+ResponseStatus Protocol::handshake(const std::string* app_name, const std::string* db_version) {
+    // First init messenger and drop requests and streams of the previous session
+    initMessenger();
+    setPushFrameHandler(&Protocol::onPushFrame);
+    cancelAll();
+    stats.start(); // Counters run across sessions until resetStats()
+    linkStats = LinkStats(); // The peer may have changed, measure again
+    for (auto& subscription : subscriptions) {
+        subscription.active = false;
+        subscription.fresh = false;
+        subscription.handler = ResponseRecordHandler();
+    }
+    coalescedFrames = 0;
+    baudCeiling = 0xFFFFFFFFu; // Rates failed in the previous session may work with this peer or cable
     
-    while (std::getline(ss, pair, '&')) {
-        size_t equalPos = pair.find('=');
-        if (equalPos != std::string::npos) {
-            std::string key = trim(pair.substr(0, equalPos));
-            std::string value = trim(pair.substr(equalPos + 1));
-            
-            // Only add non-empty keys
-            if (!key.empty()) {
-                params[key] = value;
+    ResponseStatusView response;
+    for (;;) {
+        // Build initialization request
+        beginRequest("INIT");
+        if (app_name) appendParam("app", *app_name);
+        if (db_version) appendParam("db", *db_version);
+        appendParam("api", API_VERSION);
+#ifdef PROTOCOL_BINARY_FRAMING
+        appendParam("framing", "cobs"); // Offer binary framing, peer confirms it in response
+#endif
+        schemaSize = 0; // Keys are sent by name until the peer confirms the schema
+        if (!schemaKeys.empty()) {
+            txBuffer.append("&keys=");
+            for (size_t i = 0; i < schemaKeys.size(); i++) {
+                if (i > 0) txBuffer.push_back(',');
+                txBuffer.append(schemaKeys[i]);
+            }
+        }
+        appendBaudRates();
+        
+        MessageView message = transact(PROTOCOL_INIT_TIMEOUT);
+        parseResponse(message, nullptr, "Initialization failed - bad or missing status", response);
+        
+        // Check if initialization was successful
+        if (response.status != ResponseStatusEnum::OK) {
+            if (message.empty()) {
+                // No response - peer may have restarted in text mode, next attempt starts in text mode
+                setFramingMode(FramingMode::TEXT);
             }
+            break;
         }
+
+        initialized = true;
+        // Switch framing after the response, legacy peers do not confirm and stay in text mode
+        setFramingMode(response.params.get("framing") == MessageView("cobs") ? FramingMode::COBS : FramingMode::TEXT);
+
+        // Legacy peers do not confirm the schema, keys stay sent by name
+        size_t accepted = 0;
+        for (char c : response.params.get("keys")) {
+            if (c < '0' || c > '9') {
+                accepted = 0;
+                break;
+            }
+            accepted = accepted * 10 + static_cast<size_t>(c - '0');
+            if (accepted > schemaKeys.size()) accepted = schemaKeys.size();
+        }
+        schemaSize = accepted;
+
+        // Switch to the accepted line rate, legacy peers stay at the base rate
+        uint32_t baudrate = 0;
+        for (char c : response.params.get("baud")) {
+            if (c < '0' || c > '9') {
+                baudrate = 0;
+                break;
+            }
+            baudrate = baudrate * 10 + static_cast<uint32_t>(c - '0');
+        }
+        if (baudrate <= UART1_BAUDRATE || baudrate > baudCeiling || switchBaudRate(baudrate)) {
+            break;
+        }
+        // Probes failed, both sides are back at the base rate - negotiate again without the failed rate
     }
-    
-    return params;
+    return response.toResponseStatus();
 }
 
 ResponseStatus Protocol::init_dummy() {
@@ -84,12 +537,14 @@ ResponseStatus Protocol::init_dummy() {
     
     // First init messenger
     initMessenger();
+    setFramingMode(FramingMode::TEXT);
+    schemaSize = 0;
 
     // Build initialization request
-    std::string request = "?type=INIT";
+    beginRequest("INIT");
  
     // Send request and receive response
-    sendMessage(request); 
+    sendMessage(txBuffer); 
 
     //dummy response for test mode - always successful
     response.status = ResponseStatusEnum::OK;
@@ -100,71 +555,46 @@ ResponseStatus Protocol::init_dummy() {
     return response;
 }
 
-ResponseStatus Protocol::init() {
-    ResponseStatus response;
-    response.status = ResponseStatusEnum::ERROR;
-    
-    // First init messenger
-    initMessenger();
-    
-    // Build initialization request
-    std::string request = "?type=INIT";
-    request += "&api=" + API_VERSION;
-
-    // Send request and receive response
-    sendMessage(request); 
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE, PROTOCOL_INIT_TIMEOUT); 
-    
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
-    
-    // Check if initialization was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Initialization failed - bad or missing status";
+void Protocol::setKeySchema(const std::vector<std::string>& keys) {
+    schemaKeys.clear();
+    schemaSize = 0; // New schema has to be negotiated first
+    for (const auto& key : keys) {
+        if (schemaKeys.size() >= MAX_SCHEMA_KEYS) break;
+        if (key.empty() || key[0] == SCHEMA_KEY_PREFIX || key.find_first_of(",&=|") != std::string::npos) continue;
+        schemaKeys.push_back(key);
+    }
+}
 
-        return response;
-    } 
+uint8_t Protocol::getKeyId(const std::string& key) {
+    for (size_t i = 0; i < schemaSize; i++) {
+        if (schemaKeys[i] == key) return static_cast<uint8_t>(SCHEMA_KEY_BASE + i);
+    }
+    return 0;
+}
 
-    response.status = ResponseStatusEnum::OK;
-    response.error = "";
-    initialized = true; 
-    return response;
+const std::string* Protocol::getKeyName(uint8_t id) {
+    if (id < SCHEMA_KEY_BASE || static_cast<size_t>(id - SCHEMA_KEY_BASE) >= schemaSize) return nullptr;
+    return &schemaKeys[id - SCHEMA_KEY_BASE];
 }
 
-ResponseStatus Protocol::init(const std::string& db_version) {
-    ResponseStatus response;
-    response.status = ResponseStatusEnum::ERROR;
-    
-    // First init messenger
-    initMessenger();
-    
-    // Build initialization request
-    std::string request = "?type=INIT";
-    request += "&db=" + db_version;
-    request += "&api=" + API_VERSION;
-    
-    // Send request and receive response
-    sendMessage(request); 
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE, PROTOCOL_INIT_TIMEOUT); 
-    
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
-    
-    // Check if initialization was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Initialization failed - bad or missing status";
+void Protocol::appendSchemaParam(const std::string& key, const std::string& value) {
+    uint8_t id = getKeyId(key);
+    if (id == 0) {
+        appendParam(key.c_str(), value);
+        return;
+    }
 
-        return response;
-    } 
+    char name[8];
+    snprintf(name, sizeof(name), "%c%u", SCHEMA_KEY_PREFIX, static_cast<unsigned>(id));
+    appendParam(name, value);
+}
 
-    response.status = ResponseStatusEnum::OK;
-    response.error = "";
-    initialized = true; 
-    return response;
+ResponseStatus Protocol::init() {
+    return handshake(nullptr, nullptr);
+}
+
+ResponseStatus Protocol::init(const std::string& db_version) {
+    return handshake(nullptr, &db_version);
 }
 
 ResponseStatus Protocol::init(const std::string& app_name, const std::string& db_version) {
@@ -176,141 +606,146 @@ ResponseStatus Protocol::init(const std::string& app_name, const std::string& db
         return init(db_version);
     }
 
-    ResponseStatus response;
-    response.status = ResponseStatusEnum::ERROR;
-    
-    // First init messenger
-    initMessenger();
-    
-    // Build initialization request
-    std::string request = "?type=INIT";
-    request += "&app=" + app_name;
-    request += "&db=" + db_version;
-    request += "&api=" + API_VERSION;
-    
-    // Send request and receive response
-    sendMessage(request); 
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE, PROTOCOL_INIT_TIMEOUT); 
-    
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
-    
-    // Check if initialization was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Initialization failed - bad or missing status";
-        
-        return response;
-    } 
+    return handshake(&app_name, &db_version);
+}
 
-    response.status = ResponseStatusEnum::OK;
-    response.error = "";
-    initialized = true; 
-    return response;
+/**
+ * @brief Appends known revision of the sensor values (nothing for 0 - full update).
+ */
+static void appendSince(std::string& buffer, uint32_t since) {
+    if (since == 0) return;
+
+    char revision[12];
+    snprintf(revision, sizeof(revision), "%lu", static_cast<unsigned long>(since));
+    buffer.append("&since=");
+    buffer.append(revision);
 }
 
-ResponseStatus Protocol::update(const std::string& uid) {
-    ResponseStatus response;
-    response.status = ResponseStatusEnum::ERROR;
+/**
+ * @brief Appends known revisions of batched sensors (nothing if all of them are unknown).
+ */
+static void appendSinceList(std::string& buffer, const std::vector<uint32_t>& since) {
+    bool known = false;
+    for (uint32_t revision : since) {
+        known |= revision != 0;
+    }
+    if (!known) return;
 
-    if (!initialized) {
-        response.error = "Protocol not initialized";
-        return response;
+    char revision[12];
+    buffer.append("&since=");
+    for (size_t i = 0; i < since.size(); i++) {
+        if (i > 0) buffer.push_back(',');
+        snprintf(revision, sizeof(revision), "%lu", static_cast<unsigned long>(since[i]));
+        buffer.append(revision);
     }
-    
-    if (uid.empty()) {
-        response.error = "UID cannot be empty";
+}
+
+ResponseStatusView Protocol::updateView(const std::string& uid, uint32_t since) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
         return response;
     }
 
     // Build update request
-    std::string request = "?type=UPDATE";
-    request += "&id=" + uid;
-    
-    // Send request and receive response
-    sendMessage(request);
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE); // Use defined verbosity for receive
+    beginRequest("UPDATE");
+    appendParam("id", uid);
+    appendSince(txBuffer, since);
     
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
-    
-    // Check if UID from response matches request
-    if (responseParams.find("id") == responseParams.end() || responseParams["id"] != uid) {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = "Response UID mismatch - expected: " + uid + ", received: " + 
-                                (responseParams.find("id") != responseParams.end() ? responseParams["id"] : "none");
+    parseResponse(transact(), &uid, "Connection failed - bad or missing status", response);
+    return response;
+}
+
+ResponseStatusView Protocol::burstView(const std::string& uid, unsigned int samples) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
         return response;
     }
-    
-    // Check if connection was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
 
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Connection failed - bad or missing status";
-        return response;
+    if (samples == 0 || samples > MAX_BURST_SAMPLES) {
+        samples = MAX_BURST_SAMPLES;
     }
 
-    response.params = responseParams; // Store all response parameters
-    response.status = ResponseStatusEnum::OK;
-    response.error = "";
+    // Build burst request
+    char count[12];
+    snprintf(count, sizeof(count), "%u", samples);
+    beginRequest("BURST");
+    appendParam("id", uid);
+    appendParam("n", count);
+
+    // Samples of all values, the response is up to a full line
+    parseResponse(transact(0, MAX_RECEIVE_LINE_SIZE), &uid, "Connection failed - bad or missing status", response);
     return response;
 }
 
-ResponseStatus Protocol::config(const std::string& uid, const std::unordered_map<std::string, std::string>& config) {
+ResponseStatus Protocol::walkBatch(const MessageView& message, const MessageView& ids, const ResponseRecordHandler& onRecord) {
     ResponseStatus response;
     response.status = ResponseStatusEnum::ERROR;
 
-    if (!initialized) {
-        response.error = "Protocol not initialized";
-        return response;
-    }
-    
-    if (uid.empty()) {
-        response.error = "UID cannot be empty";
-        return response;
+    size_t expected = 1;
+    for (char c : ids) {
+        if (c == ',') expected++;
     }
 
-    // Build configuration request
-    std::string request = "?type=CONFIG";
-    request += "&id=" + uid;
-    
-    // Add configuration parameters
-    for (const auto& configParam : config) {
-        request += "&" + configParam.first + "=" + configParam.second;
-    }
-    
-    // Send request and receive response
-    sendMessage(request);
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE); // Use defined verbosity for receive
-    
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
-    
-     // Check if UID from response matches request
-    if (responseParams.find("id") == responseParams.end() || responseParams["id"] != uid) {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = "Response UID mismatch - expected: " + uid + ", received: " + 
-                                (responseParams.find("id") != responseParams.end() ? responseParams["id"] : "none");
-        return response;
+    // Walk records separated by '|', every record is a regular UPDATE response
+    ResponseStatusView record;
+    size_t received = 0;
+    size_t pos = 0;
+    while (pos < message.size()) {
+        size_t sep = message.find('|', pos);
+        if (sep == MessageView::npos) sep = message.size();
+        MessageView recordMessage = message.substr(pos, sep - pos);
+        pos = sep + 1;
+
+        parseResponse(recordMessage, nullptr, "Connection failed - bad or missing status", record);
+        const MessageView* id = record.params.find("id");
+        if (!id) {
+            // Record without UID is an error of the whole request
+            response.error = record.error.empty() ? "Response UID missing" : record.error.str();
+            return response;
+        }
+
+        if (!containsId(ids, *id)) {
+            stats.onUidMismatch();
+            response.error = "Response UID mismatch - unexpected: " + id->str();
+            continue;
+        }
+
+        if (record.status == ResponseStatusEnum::OK) {
+            received++;
+        }
+        if (onRecord) {
+            onRecord(record);
+        }
     }
-    
-    // Check if connection was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
 
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Connection failed - bad or missing status";
+    if (received != expected) {
+        if (response.error.empty()) {
+            response.error = "Batched update incomplete - " + std::to_string(received) + "/" + std::to_string(expected) + " records";
+        }
         return response;
     }
 
     response.status = ResponseStatusEnum::OK;
-    response.error = "";
     return response;
 }
 
-ResponseStatus Protocol::reset(const std::string& uid) {
+/**
+ * @brief Appends the comma separated UID list of a batched request to the buffer.
+ *
+ * @return size_t Position of the list in the buffer
+ */
+static size_t appendIdList(std::string& buffer, const std::vector<std::string>& uids) {
+    buffer.append("&id=");
+    size_t begin = buffer.size();
+    for (size_t i = 0; i < uids.size(); i++) {
+        if (i > 0) buffer.push_back(',');
+        buffer.append(uids[i]);
+    }
+    return begin;
+}
+
+ResponseStatus Protocol::updateBatch(const std::vector<std::string>& uids, const ResponseRecordHandler& onRecord,
+                                     const std::vector<uint32_t>& since) {
     ResponseStatus response;
     response.status = ResponseStatusEnum::ERROR;
 
@@ -318,137 +753,335 @@ ResponseStatus Protocol::reset(const std::string& uid) {
         response.error = "Protocol not initialized";
         return response;
     }
-    
-    if (uid.empty()) {
-        response.error = "UID cannot be empty";
+
+    if (uids.empty()) {
+        response.error = "UID list cannot be empty";
         return response;
     }
 
-    // Build reset request
-    std::string request = "?type=RESET";
-    request += "&id=" + uid;
-    
-    // Send request and receive response
-    sendMessage(request);
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE); // Use defined verbosity for receive
-    
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
-    
-    // Check if UID from response matches request
-    if (responseParams.find("id") == responseParams.end() || responseParams["id"] != uid) {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = "Response UID mismatch - expected: " + uid + ", received: " + 
-                                (responseParams.find("id") != responseParams.end() ? responseParams["id"] : "none");
-        return response;
+    // Build batched update request
+    beginRequest("UPDATE");
+    size_t begin = appendIdList(txBuffer, uids);
+    size_t length = txBuffer.size() - begin;
+    appendSinceList(txBuffer, since);
+
+    MessageView message = transact(0, MAX_RECEIVE_LINE_SIZE); // Records of all sensors
+    return walkBatch(message, MessageView(txBuffer).substr(begin, length), onRecord);
+}
+
+RequestId Protocol::updateAsync(const std::string& uid, const ResponseRecordHandler& onResponse, uint32_t since) {
+    if (!initialized || uid.empty()) {
+        return 0;
     }
-    
-    // Check if connection was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
 
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Connection failed - bad or missing status";
-        return response;
+    // Build update request
+    beginRequest("UPDATE");
+    appendParam("id", uid);
+    appendSince(txBuffer, since);
+    return submit(MessageView(uid), false, onResponse);
+}
+
+RequestId Protocol::updateBatchAsync(const std::vector<std::string>& uids, const ResponseRecordHandler& onRecord,
+                                     const std::vector<uint32_t>& since) {
+    if (!initialized || uids.empty()) {
+        return 0;
     }
 
-    response.status = ResponseStatusEnum::OK;
-    response.error = "";
-    return response;
+    // Build batched update request
+    beginRequest("UPDATE");
+    size_t begin = appendIdList(txBuffer, uids);
+    size_t length = txBuffer.size() - begin;
+    appendSinceList(txBuffer, since);
+    return submit(MessageView(txBuffer).substr(begin, length), true, onRecord);
 }
 
-ResponseStatus Protocol::connect(const std::string& uid, const std::string& pins) {
-    ResponseStatus response;
-    response.status = ResponseStatusEnum::ERROR;
+ResponseStatus Protocol::subscribe(const std::string& uid, unsigned int period, const ResponseRecordHandler& onUpdate) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
+        return response.toResponseStatus();
+    }
 
-    if (!initialized) {
-        response.error = "Protocol not initialized";
-        return response;
+    // Reserve the mailbox first, frames may be pushed before the response arrives
+    Subscription* subscription = nullptr;
+    for (auto& slot : subscriptions) {
+        if (slot.active && slot.uid == uid) {
+            subscription = &slot;
+            break;
+        }
+        if (!slot.active && !subscription) {
+            subscription = &slot;
+        }
     }
-    
-    if (uid.empty()) {
-        response.error = "UID cannot be empty";
-        return response;
+    if (!subscription) {
+        response.error = "Subscription table full";
+        return response.toResponseStatus();
     }
+    subscription->active = true;
+    subscription->fresh = false;
+    subscription->uid = uid;
+    subscription->handler = onUpdate;
 
-    // Build connect request
-    std::string request = "?type=CONNECT";
-    request += "&id=" + uid;
-    request += "&pins=" + pins;
-    
-    // Send request and receive response
-    sendMessage(request);
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE); // Use defined verbosity for receive
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
-    
-    // Check if UID from response matches request
-    if (responseParams.find("id") == responseParams.end() || responseParams["id"] != uid) {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = "Response UID mismatch - expected: " + uid + ", received: " + 
-                                (responseParams.find("id") != responseParams.end() ? responseParams["id"] : "none");
-        return response;
+    // Build subscribe request
+    beginRequest("SUBSCRIBE");
+    appendParam("id", uid);
+    appendParam("period", std::to_string(period));
+
+    parseResponse(transact(), &uid, "Subscribe failed - bad or missing status", response);
+    if (response.status == ResponseStatusEnum::ERROR) {
+        subscription->active = false;
+        subscription->handler = ResponseRecordHandler();
     }
-    
-    // Check if connection was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
+    return response.toResponseStatus(response.status == ResponseStatusEnum::ERROR); // Refusal tells what was refused
+}
 
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Connection failed - bad or missing status";
-        return response;
+ResponseStatus Protocol::unsubscribe(const std::string& uid) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
+        return response.toResponseStatus();
     }
 
-    response.status = ResponseStatusEnum::OK;
-    response.error = "";
+    for (auto& slot : subscriptions) {
+        if (slot.active && slot.uid == uid) {
+            slot.active = false;
+            slot.fresh = false;
+            slot.handler = ResponseRecordHandler();
+        }
+    }
+
+    // Build unsubscribe request
+    beginRequest("SUBSCRIBE");
+    appendParam("id", uid);
+    appendParam("period", "0");
+
+    parseResponse(transact(), &uid, "Unsubscribe failed - bad or missing status", response);
+    return response.toResponseStatus();
+}
+
+bool Protocol::isSubscribed(const std::string& uid) {
+    for (const auto& slot : subscriptions) {
+        if (slot.active && slot.uid == uid) return true;
+    }
+    return false;
+}
+
+uint32_t Protocol::getCoalescedCount() {
+    return coalescedFrames;
+}
+
+void Protocol::onPushFrame(const char* frame, size_t length) {
+    stats.onPushFrame();
+    stats.onReceive(length);
+    MessageView message(frame, length);
+    MessageParams params;
+    parseMessageParams(message, params);
+    MessageView id = params.get("id");
+
+    for (auto& slot : subscriptions) {
+        if (!slot.active || id != MessageView(slot.uid)) continue;
+
+        // Keep only the latest frame, older undelivered one is coalesced
+        if (slot.fresh) coalescedFrames++;
+        slot.frame.assign(frame, length);
+        slot.fresh = true;
+        return;
+    }
+}
+
+size_t Protocol::deliverPushed() {
+    size_t delivered = 0;
+    ResponseStatusView response;
+
+    for (auto& slot : subscriptions) {
+        if (!slot.active || !slot.fresh) continue;
+
+        // Move the frame out of the mailbox, the handler may receive and refill it
+        slot.fresh = false;
+        pushBuffer.swap(slot.frame);
+        parseResponse(MessageView(pushBuffer), &slot.uid, "Pushed update failed - bad or missing status", response);
+        // Take the handler out of the slot, it may unsubscribe
+        ResponseRecordHandler handler = std::move(slot.handler);
+        slot.handler = ResponseRecordHandler();
+        if (handler) {
+            handler(response);
+        }
+        if (slot.active && !slot.handler) {
+            slot.handler = std::move(handler);
+        }
+        delivered++;
+    }
+    return delivered;
+}
+
+size_t Protocol::poll() {
+    size_t completed = 0;
+
+    MessageView line;
+    while (tryReceiveLine(line, PROTOCOL_VERBOSE)) {
+        if (line.empty()) continue;
+        stats.onReceive(line.size());
+        asyncBuffer.assign(line.data(), line.size()); // Handlers may send requests that reuse the line
+        if (dispatch(MessageView(asyncBuffer), findSequence(asyncBuffer))) {
+            completed++;
+        }
+    }
+
+    // Expire requests without response
+    unsigned long now = getTimeMs();
+    for (auto& request : pipeline) {
+        if (request.seq != 0 && !request.completed && static_cast<long>(now - request.deadline) >= 0) {
+            onRequestTimeout();
+            complete(request, nullptr, "Request timeout");
+            completed++;
+        }
+    }
+
+    completed += deliverPushed();
+    return completed;
+}
+
+bool Protocol::isPending(RequestId seq) {
+    if (seq == 0) return false;
+    for (const auto& request : pipeline) {
+        if (request.seq == seq) return !request.completed;
+    }
+    return false;
+}
+
+bool Protocol::takeResult(RequestId seq, ResponseStatus& result) {
+    if (seq == 0) return false;
+    for (auto& request : pipeline) {
+        if (request.seq == seq && request.completed) {
+            result = std::move(request.result);
+            request.seq = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Protocol::cancel(RequestId seq) {
+    if (seq == 0) return;
+    for (auto& request : pipeline) {
+        if (request.seq == seq) {
+            request.seq = 0;
+            request.handler = ResponseRecordHandler();
+        }
+    }
+}
+
+void Protocol::cancelAll() {
+    for (auto& request : pipeline) {
+        request.seq = 0;
+        request.handler = ResponseRecordHandler();
+    }
+}
+
+size_t Protocol::pendingCount() {
+    size_t count = 0;
+    for (const auto& request : pipeline) {
+        if (request.seq != 0 && !request.completed) count++;
+    }
+    return count;
+}
+
+ResponseStatus Protocol::update(const std::string& uid, uint32_t since) {
+    ResponseStatusView view = updateView(uid, since);
+    ResponseStatus response = view.toResponseStatus(true); // Store all response parameters
+
+    // Owning copy is keyed by names
+    for (const auto& param : view.params) {
+        const std::string* name = getKeyName(param.keyId);
+        if (name) {
+            response.params.erase(param.key.str());
+            response.params[*name] = param.value.str();
+        }
+    }
     return response;
 }
 
-ResponseStatus Protocol::disconnect(const std::string& uid) {
-    ResponseStatus response;
-    response.status = ResponseStatusEnum::ERROR;
+ResponseStatus Protocol::config(const std::string& uid, const std::unordered_map<std::string, std::string>& config) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
+        return response.toResponseStatus();
+    }
 
-    if (!initialized) {
-        response.error = "Protocol not initialized";
-        return response;
+    // Build configuration request
+    beginRequest("CONFIG");
+    appendParam("id", uid);
+    
+    // Add configuration parameters
+    for (const auto& configParam : config) {
+        appendSchemaParam(configParam.first, configParam.second);
     }
     
-    if (uid.empty()) {
-        response.error = "UID cannot be empty";
-        return response;
+    parseResponse(transact(), &uid, "Connection failed - bad or missing status", response);
+    return response.toResponseStatus();
+}
+
+ResponseStatus Protocol::reset(const std::string& uid) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
+        return response.toResponseStatus();
     }
 
-    // Build disconnect request
-    std::string request = "?type=DISCONNECT";
-    request += "&id=" + uid;
-    
-    // Send request and receive response
-    sendMessage(request);
-    std::string responseMsg = receiveMessage(PROTOCOL_VERBOSE); // Use defined verbosity for receive
+    // Build reset request
+    beginRequest("RESET");
+    appendParam("id", uid);
     
-    // Parse response
-    auto responseParams = parseMessage(responseMsg);
+    parseResponse(transact(), &uid, "Connection failed - bad or missing status", response);
+    return response.toResponseStatus();
+}
+
+ResponseStatus Protocol::connect(const std::string& uid, const std::string& pins) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
+        return response.toResponseStatus();
+    }
+
+    // Build connect request
+    beginRequest("CONNECT");
+    appendParam("id", uid);
+    appendParam("pins", pins);
     
-    // Check if UID from response matches request
-    if (responseParams.find("id") == responseParams.end() || responseParams["id"] != uid) {
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = "Response UID mismatch - expected: " + uid + ", received: " + 
-                                (responseParams.find("id") != responseParams.end() ? responseParams["id"] : "none");
-        return response;
+    parseResponse(transact(), &uid, "Connection failed - bad or missing status", response);
+    return response.toResponseStatus();
+}
+
+ResponseStatus Protocol::disconnect(const std::string& uid) {
+    ResponseStatusView response;
+    if (!checkReady(uid, response)) {
+        return response.toResponseStatus();
     }
+
+    // Build disconnect request
+    beginRequest("DISCONNECT");
+    appendParam("id", uid);
     
-    // Check if connection was successful
-    if (responseParams.find("status") == responseParams.end() || responseParams["status"] != "1") {
+    parseResponse(transact(), &uid, "Connection failed - bad or missing status", response);
+    return response.toResponseStatus();
+}
 
-        response.status = ResponseStatusEnum::ERROR;
-        response.error = responseParams.find("error") != responseParams.end() 
-                            ? responseParams["error"] : "Connection failed - bad or missing status";
-        return response;
+ResponseStatus Protocol::pinMap(const std::vector<std::pair<std::string, std::string>>& changes) {
+    ResponseStatusView response;
+    if (!checkReady(changes.empty() ? std::string() : changes.front().first, response)) {
+        return response.toResponseStatus();
     }
 
-    response.status = ResponseStatusEnum::OK;
-    response.error = "";
-    return response;
+    // Build pin map request, pins of the sensors are separated by ';' (pins itself use ',')
+    beginRequest("PINMAP");
+    txBuffer.append("&id=");
+    for (size_t i = 0; i < changes.size(); i++) {
+        if (i > 0) txBuffer.push_back(',');
+        txBuffer.append(changes[i].first);
+    }
+    txBuffer.append("&pins=");
+    for (size_t i = 0; i < changes.size(); i++) {
+        if (i > 0) txBuffer.push_back(';');
+        txBuffer.append(changes[i].second);
+    }
+
+    parseResponse(transact(), nullptr, "Pin map failed - bad or missing status", response);
+    return response.toResponseStatus(true); // 'id' names the refused change
 }
 
 bool Protocol::isInitialized() {
@@ -457,4 +1090,4 @@ bool Protocol::isInitialized() {
 
 std::string Protocol::getApiVersion() {
     return API_VERSION;
-}
\ No newline at end of file
+}
@@ -6,11 +6,35 @@
 //API methods:
 /*
 - init: handshake and ensure purpose of application, matches device db versions and api versions
-req: ?type=INIT&app=APP_NAME&db=DB_VERSION&api=API_VERSION
-res: ?status=1/0&error=Error Message
+req: ?type=INIT&app=APP_NAME&db=DB_VERSION&api=API_VERSION&framing=cobs&keys=KEY1,KEY2,...&baud=RATE1,RATE2,...
+res: ?status=1/0&error=Error Message&framing=cobs&keys=COUNT&baud=RATE
+'framing=cobs' offers binary framing (see io/framing.hpp). If the peer confirms it, both sides switch
+to binary frames right after the INIT response, otherwise text lines are kept.
+'keys' offers a schema of value/config keys (see setKeySchema). Key N of the list gets ID SCHEMA_KEY_BASE+N,
+the peer confirms how many of them it accepts. Accepted keys may then be sent as '#ID=value' instead
+of 'KEY=value' in both directions (binary frames carry the ID as a single byte).
+The INIT request is always sent at the base line rate (UART1_BAUDRATE). 'baud' offers higher rates
+(highest first), the peer answers the one it chose. Both sides switch right after the INIT response
+(after the framing), then the display verifies the rate by PROBE exchanges. The peer returns to the
+base rate if no valid request arrives within PROTOCOL_BAUD_FALLBACK_DELAY after the switch, or when
+it receives damaged data at the new rate. The display returns to the base rate after a failed probe
+(and repeats INIT offering lower rates only) or after PROTOCOL_BAUD_FALLBACK_TIMEOUTS requests
+without response in a row.
+- probe: verify the line rate, the data is echoed back
+req: ?type=PROBE&data=PATTERN
+res: ?status=1/0&data=PATTERN
 - update: request data update
 req: ?type=UPDATE&id=UID
 res: ?id=UID&status=1/0&param1=value1&param2=value2...
+- update (batched): request data update of several sensors in one round trip
+req: ?type=UPDATE&id=UID1,UID2,UID3
+res: ?id=UID1&status=1/0&param1=value1...|?id=UID2&status=1/0&param1=value1...|...
+- update (delta): request only values changed since the known revision of the sensor
+req: ?type=UPDATE&id=UID&since=REV (batched: &id=UID1,UID2&since=REV1,REV2, 0 = full update)
+res: ?id=UID&status=1/0&rev=REV&changed1=value1... (keys changed after 'since' only)
+Every update response (and pushed frame) may carry the revision of the sensor values 'rev=REV'.
+The peer increments it whenever a value changes, so a response with 'rev' equal to 'since'
+and no values means nothing changed. Peers without revisions ignore 'since' and send full updates.
 - config: send new configuration for sensor from HMI side to HW side
 req: ?type=CONFIG&id=UID&param1=value1&param2=value2
 res: ?id=UID&status=1/0&error=Error Message
@@ -23,6 +47,33 @@ res: ?id=UID&status=1/0&error=Error Message
 - disconnect: disconnect sensor from pin
 req: ?type=DISCONNECT&id=UID
 res: ?id=UID&status=1/0&error=Error Message
+- pin map: apply several connection changes as one transaction
+req: ?type=PINMAP&id=UID1,UID2,UID3&pins=PINS1;PINS2;PINS3
+res: ?status=1 or ?status=0&id=UID&error=Error Message
+Every sensor gets one ';' separated entry of 'pins' (PINS as in connect), the entry replaces its
+previous pins and an empty entry disconnects it. The peer applies all changes or none of them,
+a rejection names the sensor of the refused change. Peers without PINMAP reject it without 'id'.
+- subscribe: ask the peer to push sensor data every PERIOD ms (period=0 stops the stream)
+req: ?type=SUBSCRIBE&id=UID&period=PERIOD
+res: ?id=UID&status=1/0&error=Error Message
+push: !?id=UID&status=1/0&param1=value1&param2=value2... (unsolicited, same content as update response)
+- burst: request samples buffered by the peer since the previous burst (high-rate sampling)
+req: ?type=BURST&id=UID&n=N
+res: ?id=UID&status=1/0&n=K&t=T1,T2,...&now=T&param1=v1,v2,...&param2=v1,v2,...
+K <= N samples oldest first, 't' are their timestamps (ms, peer clock) and every value key carries
+K comma separated samples. Returned samples are dropped from the peer buffer. 'now' is the peer
+clock when answering, it maps the timestamps to the local clock (optional, older peers omit it).
+- stats: exchange link statistics, the request reports counters of this side (see ProtocolStats)
+req: ?type=STATS&req=N&rsp=N&err=N&tmo=N&p50=US&p99=US
+res: ?status=1&rx=N&err=N&bad=N&proc=US&up=MS
+rx = received requests, err = rejected requests, bad = damaged frames, proc = mean time (us) to
+process a request, up = peer uptime (ms). Comparing 'proc' with the local latency tells a slow
+peer from a slow link.
+
+Every request carries a sequence ID '&seq=N' (1..65535), the response echoes it back as '&seq=N'.
+Responses are matched to requests by the sequence ID, so several asynchronous requests can be
+in flight at once (see updateAsync/updateBatchAsync and poll). Responses without a sequence ID
+are matched in FIFO order (legacy peers).
 */
 // Create class method for every API method
 // For sending/receiving messages, use abstracted messenger interface - Messenger, user can connect to own implementation in .cpp file
@@ -51,9 +102,16 @@ res: ?id=UID&status=1/0&error=Error Message
 #define PROTOCOL_HPP
 
 #include "config.hpp"
+#include "message.hpp"
+#include "stats.hpp"
 #include "io/messenger.hpp"
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <vector>
+#include <utility>
+#include <functional>
 #include <unordered_map>
 
 /**
@@ -82,7 +140,145 @@ struct ResponseStatus
     std::unordered_map<std::string, std::string> params; ///< Additional parameters from response.
 };
 
-    
+
+/**
+ * @struct ResponseStatusView
+ * @brief View-based variant of ResponseStatus used on the hot path.
+ *
+ * Error message and parameters are views into the Protocol receive buffer, so filling
+ * this structure does not allocate. The views are valid only until the next Protocol call.
+ */
+struct ResponseStatusView
+{
+    ResponseStatusEnum status = ResponseStatusEnum::ERROR;
+    MessageView error;    ///< Last error message.
+    MessageParams params; ///< Additional parameters from response.
+
+    /**
+     * @brief Convert into an owning ResponseStatus (allocates).
+     *
+     * @param withParams Whether the response parameters should be copied as well.
+     * @return ResponseStatus Owning copy of the response.
+     */
+    ResponseStatus toResponseStatus(bool withParams = false) const
+    {
+        ResponseStatus response;
+        response.status = status;
+        response.error = error.str();
+        if (withParams)
+        {
+            response.params = params.toMap();
+        }
+        return response;
+    }
+
+    /**
+     * @brief Get revision of the sensor values carried by the response.
+     *
+     * @return uint32_t Revision ("rev" parameter), 0 if the peer does not use revisions
+     */
+    uint32_t getRevision() const
+    {
+        uint32_t revision = 0;
+        for (char c : params.get("rev"))
+        {
+            if (c < '0' || c > '9')
+                return 0;
+            revision = revision * 10 + static_cast<uint32_t>(c - '0');
+        }
+        return revision;
+    }
+};
+
+/**
+ * @struct ResponseRecordCopy
+ * @brief Owning copy of a record, so it can outlive the Protocol call (e.g. be handed to another task).
+ */
+struct ResponseRecordCopy
+{
+    ResponseStatusEnum status = ResponseStatusEnum::ERROR;
+    std::string error;  ///< Error message.
+    std::string params; ///< Parameters serialized back as "key=value&...".
+
+    ResponseRecordCopy() {}
+
+    explicit ResponseRecordCopy(const ResponseStatusView& record) : status(record.status), error(record.error.str())
+    {
+        for (const auto& param : record.params)
+        {
+            if (!params.empty()) params += '&';
+            params.append(param.key.data(), param.key.size());
+            params += '=';
+            params.append(param.value.data(), param.value.size());
+        }
+    }
+
+    /**
+     * @brief Fill a view of the copy.
+     *
+     * @param record Output - views into this copy, valid while the copy is alive and unchanged.
+     */
+    void view(ResponseStatusView& record) const
+    {
+        record.status = status;
+        record.error = MessageView(error);
+        parseMessageParams(MessageView(params), record.params);
+    }
+};
+
+/**
+ * @brief Handler called for every record of a batched response.
+ *
+ * The record (status, error and parameters) is valid only during the call.
+ */
+typedef std::function<void(const ResponseStatusView& record)> ResponseRecordHandler;
+
+/**
+ * @enum LinkRateState
+ * @brief State of the line rate negotiation.
+ *
+ * BASE -> PROBING (peer accepted a rate during INIT) -> NEGOTIATED (all probes passed)
+ * or FALLBACK (a probe failed, or too many requests without response at the negotiated rate).
+ * FALLBACK runs at the base rate, the next INIT offers only rates below the failed one.
+ */
+enum class LinkRateState
+{
+    BASE = 0,       ///< Base rate, nothing negotiated (or legacy peer).
+    PROBING = 1,    ///< Switched to the negotiated rate, probe exchange in progress.
+    NEGOTIATED = 2, ///< Negotiated rate verified by probes.
+    FALLBACK = 3,   ///< Negotiated rate failed, back at the base rate.
+};
+
+/**
+ * @struct LinkStats
+ * @brief Round trip time statistics of the link and the adaptive request timeout.
+ *
+ * The estimator follows RFC 6298: SRTT and RTTVAR are smoothed from measured round
+ * trips, the timeout is SRTT + 4 * RTTVAR and doubles after every timed out request
+ * until a new round trip is measured. Round trips are measured without the transfer
+ * time of the request and response at the line rate, every request adds the transfer
+ * time of itself and of its expected response to the timeout instead. So small responses
+ * do not shorten the timeout of large ones (BURST, batched updates).
+ */
+struct LinkStats
+{
+    uint32_t srtt = 0;                ///< Smoothed round trip time (us), 0 until measured
+    uint32_t rttvar = 0;              ///< Round trip time variation (us)
+    uint32_t lastRtt = 0;             ///< Last measured round trip time (us)
+    uint32_t timeout = UART1_TIMEOUT; ///< Current request timeout (ms) without transfer time
+    uint32_t samples = 0;             ///< Number of measured round trips
+    uint32_t timeouts = 0;            ///< Number of requests without response
+    uint32_t timeoutsInRow = 0;       ///< Requests without response since the last response
+    uint32_t baudrate = UART1_BAUDRATE;          ///< Current line rate
+    LinkRateState rateState = LinkRateState::BASE; ///< Line rate negotiation state
+    uint32_t rateFallbacks = 0;       ///< Number of negotiated line rates given up
+};
+
+/**
+ * @brief Sequence ID of a request, 0 means no (or failed) request.
+ */
+typedef uint16_t RequestId;
+
 /**
  * @class Protocol
  * @brief Handles API communication protocol for sensor operations.
@@ -103,22 +299,243 @@ class Protocol {
 private:
     static const std::string API_VERSION; ///< API version constant
     static bool initialized;              ///< Protocol initialization status
-    
+
+    static std::string txBuffer;    ///< Reused request buffer
+    static std::string rxBuffer;    ///< Reused response buffer, response views point here
+    static std::string errorBuffer; ///< Storage for composed error messages
+    static std::string asyncBuffer; ///< Response buffer of asynchronous requests, views point here
+
     /**
-     * @brief Parses a protocol message into key-value pairs.
-     * 
-     * @param message The protocol message to parse
-     * @return std::unordered_map<std::string, std::string> Parsed key-value pairs
+     * @struct PendingRequest
+     * @brief Slot of the pipeline holding one asynchronous request in flight.
      */
-    static std::unordered_map<std::string, std::string> parseMessage(const std::string& message, bool caseSensitive = CASE_SENSITIVE);
-    
+    struct PendingRequest
+    {
+        RequestId seq = 0;             ///< Sequence ID, 0 if the slot is free
+        uint32_t ticket = 0;           ///< Submission order, used to match responses without sequence ID
+        unsigned long deadline = 0;    ///< Time (ms) when the request times out
+        unsigned long sent = 0;        ///< Time (us) when the request was sent
+        bool measured = false;         ///< Whether the round trip is measured (nothing else was in flight)
+        size_t sentBytes = 0;          ///< Size of the request (transfer time is not part of the round trip)
+        bool batched = false;          ///< Whether the request is a batched update
+        bool completed = false;        ///< Whether the result is ready to be taken
+        std::string ids;               ///< Requested UID (comma separated UIDs if batched)
+        ResponseRecordHandler handler; ///< Completion handler (empty - result is kept for takeResult)
+        ResponseStatus result;         ///< Result kept for takeResult
+    };
+
     /**
-     * @brief Builds a protocol message from key-value pairs.
-     * 
-     * @param params Key-value pairs to build message from
-     * @return std::string Formatted protocol message
+     * @struct Subscription
+     * @brief Active SUBSCRIBE stream with its single-frame mailbox.
+     *
+     * Only the latest pushed frame is kept. If the application polls slower than the peer
+     * pushes, older frames are overwritten (coalesced), so the link is always drained and
+     * the application always gets the freshest data.
+     */
+    struct Subscription
+    {
+        bool active = false;           ///< Whether the slot is used
+        bool fresh = false;            ///< Whether the mailbox holds an undelivered frame
+        std::string uid;               ///< Subscribed sensor UID
+        std::string frame;             ///< Latest pushed frame (mailbox)
+        ResponseRecordHandler handler; ///< Handler of pushed updates
+    };
+
+    static std::array<PendingRequest, MAX_PIPELINE_DEPTH> pipeline; ///< Asynchronous requests in flight
+    static std::array<Subscription, MAX_SUBSCRIPTIONS> subscriptions; ///< Active SUBSCRIBE streams
+    static std::string pushBuffer;                                   ///< Pushed frame being delivered, views point here
+    static uint32_t coalescedFrames;                                 ///< Number of overwritten (never delivered) frames
+    static RequestId lastSeq;                                        ///< Last used sequence ID
+    static uint32_t lastTicket;                                      ///< Last used submission ticket
+
+    static LinkStats linkStats; ///< Round trip time estimator
+    static ProtocolStats stats; ///< Request counters and latency histogram
+    static uint32_t jitterSeed; ///< State of the retry delay jitter generator
+
+    /**
+     * @brief Updates the round trip time estimator with a measured round trip.
+     *
+     * @param rtt Round trip time in microseconds
+     * @param bytes Size of the request and the response, their transfer time is subtracted
+     */
+    static void sampleRtt(unsigned long rtt, size_t bytes);
+
+    /**
+     * @brief Gets transfer time of data at the current line rate.
+     *
+     * @param bytes Number of bytes (10 bits each on the line)
+     * @return unsigned long Transfer time in microseconds
+     */
+    static unsigned long transferUs(size_t bytes);
+
+    /**
+     * @brief Gets timeout of the request in the transmit buffer.
+     *
+     * @param expected Expected size of the response (bytes)
+     * @return unsigned long Adaptive timeout plus transfer time of the request and response (ms)
+     */
+    static unsigned long requestTimeout(size_t expected);
+
+    /**
+     * @brief Backs off the request timeout after a request without response.
+     */
+    static void onRequestTimeout();
+
+    static uint32_t baudCeiling; ///< Highest line rate still offered, lowered by failed rates until the next handshake
+
+    /**
+     * @brief Appends line rates offered during INIT (those between the base rate and the ceiling).
+     */
+    static void appendBaudRates();
+
+    /**
+     * @brief Switches to the line rate accepted by the peer and verifies it by probes.
+     *
+     * On failure the link falls back to the base rate (see fallbackBaudRate()) and waits
+     * until the peer does the same.
+     *
+     * @param baudrate The accepted line rate.
+     * @return true if all probes passed.
+     */
+    static bool switchBaudRate(uint32_t baudrate);
+
+    /**
+     * @brief Exchanges one PROBE request, the echoed data has to match.
+     *
+     * @return true if the probe passed.
+     */
+    static bool probe();
+
+    /**
+     * @brief Returns to the base line rate, rates from the current one up are not offered until the next handshake.
+     */
+    static void fallbackBaudRate();
+
+    static std::vector<std::string> schemaKeys; ///< Offered key schema, index + SCHEMA_KEY_BASE is the key ID
+    static size_t schemaSize;                   ///< Number of keys of the schema accepted by the peer
+
+    /**
+     * @brief Appends a parameter with the key replaced by its schema key ID if negotiated.
+     *
+     * @param key Parameter key
+     * @param value Parameter value
+     */
+    static void appendSchemaParam(const std::string& key, const std::string& value);
+
+    /**
+     * @brief Starts a new request in the transmit buffer.
+     *
+     * @param type Request type (INIT, UPDATE, ...)
+     */
+    static void beginRequest(const char* type);
+
+    /**
+     * @brief Appends a key-value pair to the request in the transmit buffer.
+     *
+     * @param key Parameter key
+     * @param value Parameter value
+     */
+    static void appendParam(const char* key, const std::string& value);
+
+    /**
+     * @brief Sends the request from the transmit buffer and waits for the response.
+     *
+     * @param timeout Receive timeout in milliseconds, 0 = adaptive timeout (see LinkStats)
+     * @param expected Expected size of the response (bytes), its transfer time extends the adaptive timeout
+     * @return MessageView View of the received response (valid until next transaction)
+     */
+    static MessageView transact(int timeout = 0, size_t expected = PROTOCOL_RESPONSE_SIZE);
+
+    /**
+     * @brief Appends a new sequence ID to the request in the transmit buffer.
+     *
+     * @return RequestId The sequence ID
+     */
+    static RequestId appendSequence();
+
+    /**
+     * @brief Sends the request from the transmit buffer without waiting for the response.
+     *
+     * @param ids Requested UID (comma separated UIDs if batched)
+     * @param batched Whether the request is a batched update
+     * @param handler Completion handler
+     * @return RequestId Sequence ID of the request, 0 if the pipeline is full
+     */
+    static RequestId submit(const MessageView& ids, bool batched, const ResponseRecordHandler& handler);
+
+    /**
+     * @brief Passes a received response to the asynchronous request it belongs to.
+     *
+     * @param message Received response
+     * @param seq Sequence ID carried by the response (0 - oldest request in flight)
+     * @return bool True if a request was completed
+     */
+    static bool dispatch(const MessageView& message, RequestId seq);
+
+    /**
+     * @brief Completes the asynchronous request with a received response.
+     *
+     * @param request Request to complete
+     * @param message Received response (nullptr on timeout)
+     * @param error Error message used if no response was received
+     */
+    static void complete(PendingRequest& request, const MessageView* message, const char* error);
+
+    /**
+     * @brief Walks records of a batched update response.
+     *
+     * @param message Received response
+     * @param ids Comma separated requested UIDs
+     * @param onRecord Handler called for every record of a requested sensor
+     * @return ResponseStatus OK if a valid record was received for every requested sensor
+     */
+    static ResponseStatus walkBatch(const MessageView& message, const MessageView& ids, const ResponseRecordHandler& onRecord);
+
+    /**
+     * @brief Stores a pushed frame into the mailbox of its subscription (messenger push handler).
+     *
+     * @param frame Pushed frame without prefix
+     * @param length Length of the frame
+     */
+    static void onPushFrame(const char* frame, size_t length);
+
+    /**
+     * @brief Delivers fresh frames from subscription mailboxes to their handlers.
+     *
+     * @return size_t Number of delivered frames
+     */
+    static size_t deliverPushed();
+
+    /**
+     * @brief Checks that the protocol is initialized and the UID is valid.
+     *
+     * @param uid Unique identifier of the sensor
+     * @param response Response to fill with error if not ready
+     * @return bool True if the request can be sent
+     */
+    static bool checkReady(const std::string& uid, ResponseStatusView& response);
+
+    /**
+     * @brief Parses the received response and validates UID and status.
+     *
+     * Responses with more parameters than MAX_MESSAGE_PARAMS are errors, the dropped
+     * parameters could carry the status or values.
+     *
+     * @param message Received response
+     * @param uid Expected UID (nullptr if the response carries no UID)
+     * @param failMessage Error message used if the response has no error of its own
+     * @param response Response to fill
+     */
+    static void parseResponse(const MessageView& message, const std::string* uid, const char* failMessage, ResponseStatusView& response);
+
+    /**
+     * @brief Performs the INIT handshake with optional application name and database version.
+     *
+     * @param app_name Application name (nullptr to omit)
+     * @param db_version Database version (nullptr to omit)
+     * @return ResponseStatus Initialization response
      */
-    static std::string buildMessage(const std::unordered_map<std::string, std::string>& params);
+    static ResponseStatus handshake(const std::string* app_name, const std::string* db_version);
 
 public:
 
@@ -133,6 +550,33 @@ public:
      */
     static ResponseStatus init_dummy();
 
+    /**
+     * @brief Sets the key schema offered with the next initialization.
+     *
+     * Keys which can not be listed (empty, containing ',', '&', '=', '|' or starting with
+     * SCHEMA_KEY_PREFIX) and keys over MAX_SCHEMA_KEYS are left out, they are always sent by name.
+     * The schema is active after a successful init which the peer confirmed.
+     *
+     * @param keys Value/config keys of all sensors, keys of one sensor should be adjacent
+     */
+    static void setKeySchema(const std::vector<std::string>& keys);
+
+    /**
+     * @brief Gets negotiated schema key ID.
+     *
+     * @param key Value/config key
+     * @return uint8_t The ID (SCHEMA_KEY_BASE..255), 0 if the key is not part of the negotiated schema
+     */
+    static uint8_t getKeyId(const std::string& key);
+
+    /**
+     * @brief Gets key of a negotiated schema key ID.
+     *
+     * @param id Schema key ID
+     * @return const std::string* The key, nullptr if the ID is not part of the negotiated schema
+     */
+    static const std::string* getKeyName(uint8_t id);
+
     /**
      * @brief Initializes the protocol connection with default API version.
      *
@@ -162,7 +606,7 @@ public:
      * Performs complete handshake to ensure application purpose, matches device database versions
      * and API versions with the remote device. Application info is sent once during initialization.
      *
-     * Request format: ?type=INIT&app=APP_NAME&db=DB_VERSION&api=API_VERSION
+     * Request format: ?type=INIT&app=APP_NAME&db=DB_VERSION&api=API_VERSION&framing=cobs
      * Response format: ?status=1/0&error=Error Message
      *
      * @param app_name Application name identifier
@@ -177,13 +621,238 @@ public:
      * Sends an update request to retrieve current sensor data and parameters from the remote device.
      * The response contains all current sensor parameters and values.
      *
-     * Request format: ?type=UPDATE&id=UID
-     * Response format: ?id=UID&status=1/0&param1=value1&param2=value2...
+     * Request format: ?type=UPDATE&id=UID&since=REV
+     * Response format: ?id=UID&status=1/0&rev=REV&param1=value1&param2=value2...
      *
      * @param uid Unique identifier of the sensor
+     * @param since Last known revision of the sensor values, only newer values are returned (0 = all)
      * @return ResponseStatus Update response containing status (OK/ERROR), error message if any, and updated sensor parameters
      */
-    static ResponseStatus update(const std::string& uid);
+    static ResponseStatus update(const std::string& uid, uint32_t since = 0);
+
+    /**
+     * @brief Requests data update for a specific sensor without allocating.
+     *
+     * Same request as update(), but the response is returned as ResponseStatusView whose
+     * parameters are views into the protocol receive buffer. Use this on the sync hot path.
+     *
+     * @param uid Unique identifier of the sensor
+     * @param since Last known revision of the sensor values, only newer values are returned (0 = all)
+     * @return ResponseStatusView Update response, valid until the next Protocol call
+     */
+    static ResponseStatusView updateView(const std::string& uid, uint32_t since = 0);
+
+    /**
+     * @brief Requests data update for several sensors in a single round trip.
+     *
+     * The response carries one record per sensor, records are separated by '|' and each
+     * of them has the same format as a single UPDATE response. Every record is validated
+     * (UID must be one of the requested, status must be 1) and passed to @p onRecord,
+     * failed records are passed too with status ERROR and their error message.
+     *
+     * Request format: ?type=UPDATE&id=UID1,UID2,UID3
+     * Response format: ?id=UID1&status=1/0&param1=value1...|?id=UID2&status=1/0&param1=value1...
+     *
+     * @param uids Unique identifiers of the sensors
+     * @param onRecord Handler called for every received record
+     * @param since Last known revisions of the sensors in the order of @p uids (empty = full update)
+     * @return ResponseStatus OK if a valid record was received for every requested sensor, ERROR otherwise
+     */
+    static ResponseStatus updateBatch(const std::vector<std::string>& uids, const ResponseRecordHandler& onRecord,
+                                      const std::vector<uint32_t>& since = std::vector<uint32_t>());
+
+    /**
+     * @brief Requests data update from the specified sensor without waiting for the response.
+     *
+     * The request is sent immediately, the response is delivered by poll(). The handler is called
+     * exactly once - with the response, or with an ERROR status if the request times out.
+     * Without handler the result is kept until it is taken by takeResult().
+     *
+     * @param uid Unique identifier of the sensor
+     * @param onResponse Completion handler (optional)
+     * @param since Last known revision of the sensor values (0 = all)
+     * @return RequestId Sequence ID of the request, 0 if not sent (not initialized, pipeline full)
+     */
+    static RequestId updateAsync(const std::string& uid, const ResponseRecordHandler& onResponse = ResponseRecordHandler(), uint32_t since = 0);
+
+    /**
+     * @brief Requests data update of several sensors without waiting for the response.
+     *
+     * Same as updateBatch(), but the records are delivered by poll(). After the records the
+     * handler is called once more with the overall result, which carries no "id" parameter.
+     * On timeout only the overall result is passed.
+     *
+     * @param uids Unique identifiers of the sensors
+     * @param onRecord Handler called for every record and for the overall result (optional)
+     * @param since Last known revisions of the sensors in the order of @p uids (empty = full update)
+     * @return RequestId Sequence ID of the request, 0 if not sent (not initialized, pipeline full)
+     */
+    static RequestId updateBatchAsync(const std::vector<std::string>& uids, const ResponseRecordHandler& onRecord = ResponseRecordHandler(),
+                                      const std::vector<uint32_t>& since = std::vector<uint32_t>());
+
+    /**
+     * @brief Requests samples buffered by the peer in a single message.
+     *
+     * Used for sensors sampled faster than the update rate. The response carries the timestamps
+     * ("t") and for every value key the samples as comma separated lists (see nextListItem()).
+     *
+     * Request format: ?type=BURST&id=UID&n=N
+     * Response format: ?id=UID&status=1/0&n=K&t=T1,T2,...&now=T&param1=v1,v2,...
+     *
+     * @param uid Unique identifier of the sensor
+     * @param samples Maximum number of returned samples (limited to MAX_BURST_SAMPLES)
+     * @return ResponseStatusView Burst response, valid until the next Protocol call
+     */
+    static ResponseStatusView burstView(const std::string& uid, unsigned int samples);
+
+    /**
+     * @brief Delivers received responses of asynchronous requests and expires timed out ones.
+     *
+     * Never blocks. Should be called periodically from the main loop. Handlers are called from here
+     * and must not call poll() themselves.
+     *
+     * @return size_t Number of completed requests
+     */
+    static size_t poll();
+
+    /**
+     * @brief Subscribes to data pushed by the peer every period milliseconds.
+     *
+     * Pushed updates are delivered by poll() to the handler, which receives the same content as
+     * an update response. If updates arrive faster than poll() is called, only the latest one
+     * is delivered (see getCoalescedCount()).
+     *
+     * Request format: ?type=SUBSCRIBE&id=UID&period=PERIOD
+     * Response format: ?id=UID&status=1/0&error=Error Message
+     * Pushed frame format: !?id=UID&status=1/0&param1=value1&param2=value2...
+     *
+     * @param uid Unique identifier of the sensor
+     * @param period Push period in milliseconds
+     * @param onUpdate Handler of pushed updates
+     * @return ResponseStatus Subscribe response containing status (OK/ERROR) and error message if any,
+     *         parameters of a refusal: 'id' of the refused sensor, no 'id' if the peer does not support SUBSCRIBE,
+     *         no parameters if there was no response
+     */
+    static ResponseStatus subscribe(const std::string& uid, unsigned int period, const ResponseRecordHandler& onUpdate);
+
+    /**
+     * @brief Stops the stream of pushed data.
+     *
+     * The subscription is dropped locally even if the peer does not respond.
+     *
+     * Request format: ?type=SUBSCRIBE&id=UID&period=0
+     * Response format: ?id=UID&status=1/0&error=Error Message
+     *
+     * @param uid Unique identifier of the sensor
+     * @return ResponseStatus Unsubscribe response containing status (OK/ERROR) and error message if any
+     */
+    static ResponseStatus unsubscribe(const std::string& uid);
+
+    /**
+     * @brief Checks if the sensor is subscribed.
+     *
+     * @param uid Unique identifier of the sensor
+     * @return bool True if pushed data of the sensor are delivered
+     */
+    static bool isSubscribed(const std::string& uid);
+
+    /**
+     * @brief Gets number of pushed frames overwritten before they were delivered.
+     *
+     * @return uint32_t Number of coalesced frames since initialization
+     */
+    static uint32_t getCoalescedCount();
+
+    /**
+     * @brief Gets round trip time statistics of the link.
+     *
+     * @return LinkStats Current estimate, the timeout is used by all following requests
+     */
+    static LinkStats getLinkStats();
+
+    /**
+     * @brief Gets the longest timeout a request can get, from any task.
+     *
+     * The largest adaptive timeout plus the transfer at the base line rate, for each request
+     * of a full pipeline answered first.
+     *
+     * @param expected Expected size of the response (bytes)
+     * @return unsigned long Upper bound of the request deadline (ms)
+     */
+    static unsigned long maxRequestTimeout(size_t expected);
+
+    /**
+     * @brief Gets request counters and the response latency histogram.
+     *
+     * Lock-free, may be called from another task while requests are running.
+     *
+     * @return ProtocolStatsSnapshot Counters since start or the last resetStats()
+     */
+    static ProtocolStatsSnapshot getStats();
+
+    /**
+     * @brief Zero the request counters and the latency histogram.
+     */
+    static void resetStats();
+
+    /**
+     * @brief Exchange link statistics with the peer.
+     *
+     * Sends the local counters and latency percentiles, the peer answers with its own counters.
+     *
+     * Request format: ?type=STATS&req=N&rsp=N&err=N&tmo=N&p50=US&p99=US
+     * Response format: ?status=1&rx=N&err=N&bad=N&proc=US&up=MS
+     *
+     * @return ResponseStatus Peer counters in params, ERROR if the peer does not support STATS
+     */
+    static ResponseStatus exchangeStats();
+
+    /**
+     * @brief Gets delay before the next retry of a failed request.
+     *
+     * Exponential backoff from PROTOCOL_RETRY_DELAY up to PROTOCOL_RETRY_DELAY_MAX, the delay is
+     * randomized between half and full value, so retrying peers do not synchronize.
+     *
+     * @param attempt Number of failed attempts before (0 = first retry)
+     * @return unsigned long Delay in milliseconds
+     */
+    static unsigned long getRetryDelay(uint8_t attempt);
+
+    /**
+     * @brief Checks if the asynchronous request is still waiting for its response.
+     *
+     * @param seq Sequence ID of the request
+     * @return bool True if the request is in flight
+     */
+    static bool isPending(RequestId seq);
+
+    /**
+     * @brief Takes the result of a completed asynchronous request submitted without handler.
+     *
+     * @param seq Sequence ID of the request
+     * @param result Output - the result
+     * @return bool True if the result was ready (the pipeline slot is released)
+     */
+    static bool takeResult(RequestId seq, ResponseStatus& result);
+
+    /**
+     * @brief Drops the asynchronous request, its handler will not be called.
+     *
+     * @param seq Sequence ID of the request
+     */
+    static void cancel(RequestId seq);
+
+    /**
+     * @brief Drops all asynchronous requests, their handlers will not be called.
+     */
+    static void cancelAll();
+
+    /**
+     * @brief Gets number of asynchronous requests waiting for their response.
+     *
+     * @return size_t Number of requests in flight
+     */
+    static size_t pendingCount();
     
     /**
      * @brief Sends new configuration parameters for sensor from HMI side to HW side.
@@ -243,6 +912,21 @@ public:
      * @return ResponseStatus Disconnection response containing status (OK/ERROR), error message if any, and response parameters
      */
     static ResponseStatus disconnect(const std::string& uid);
+
+    /**
+     * @brief Applies several pin connection changes as one transaction.
+     *
+     * Every change replaces pins of one sensor, empty pins disconnect the sensor.
+     * The peer acknowledges or rejects all changes at once, so one round trip
+     * replaces a DISCONNECT/CONNECT pair per sensor.
+     *
+     * Request format: ?type=PINMAP&id=UID1,UID2&pins=PINS1;PINS2
+     * Response format: ?status=1/0&id=UID&error=Error Message ('id' of the refused change)
+     *
+     * @param changes Sensor UIDs with their new pins ("5" or "5,6,7", empty to disconnect)
+     * @return ResponseStatus Transaction response, ERROR without 'id' if the peer does not support PINMAP
+     */
+    static ResponseStatus pinMap(const std::vector<std::pair<std::string, std::string>>& changes);
     
     /**
      * @brief Checks if protocol is initialized.
@@ -0,0 +1,91 @@
+/**
+ * @file stats.cpp
+ * @brief Implementation of the protocol statistics.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include "stats.hpp"
+#include "io/messenger.hpp"
+
+#include <initializer_list>
+
+uint32_t ProtocolStatsSnapshot::percentile(uint8_t percent) const {
+    uint32_t total = 0;
+    for (uint32_t count : histogram) total += count;
+    if (total == 0) return 0;
+
+    // Rank of the percentile, rounded up so p100 is the last response
+    uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(total) * (percent > 100 ? 100 : percent) + 99) / 100);
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS - 1; i++) {
+        seen += histogram[i];
+        if (seen >= rank) return LATENCY_BUCKET_BOUNDS[i] < latencyMax ? LATENCY_BUCKET_BOUNDS[i] : latencyMax;
+    }
+    return latencyMax;
+}
+
+uint32_t ProtocolStatsSnapshot::meanLatency() const {
+    return responses ? static_cast<uint32_t>(latencySum / responses) : 0;
+}
+
+uint32_t ProtocolStatsSnapshot::bytesPerSecond() const {
+    return elapsed ? static_cast<uint32_t>((static_cast<uint64_t>(bytesSent) + bytesReceived) * 1000 / elapsed) : 0;
+}
+
+ProtocolStats::ProtocolStats() {
+    for (auto &bucket : histogram) bucket.store(0, std::memory_order_relaxed);
+}
+
+void ProtocolStats::onResponse(unsigned long latency) {
+    uint32_t sample = static_cast<uint32_t>(latency);
+    add(responses);
+    latencySum.fetch_add(sample, std::memory_order_relaxed);
+
+    size_t bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && sample > LATENCY_BUCKET_BOUNDS[bucket]) bucket++;
+    add(histogram[bucket]);
+
+    // Single writer, load and store do not race with another update
+    if (sample > latencyMax.load(std::memory_order_relaxed)) {
+        latencyMax.store(sample, std::memory_order_relaxed);
+    }
+}
+
+ProtocolStatsSnapshot ProtocolStats::snapshot() const {
+    ProtocolStatsSnapshot copy;
+    copy.requests = requests.load(std::memory_order_relaxed);
+    copy.responses = responses.load(std::memory_order_relaxed);
+    copy.errors = errors.load(std::memory_order_relaxed);
+    copy.timeouts = timeouts.load(std::memory_order_relaxed);
+    copy.uidMismatches = uidMismatches.load(std::memory_order_relaxed);
+    copy.lateResponses = lateResponses.load(std::memory_order_relaxed);
+    copy.pushFrames = pushFrames.load(std::memory_order_relaxed);
+    copy.framingErrors = getFramingErrorCount() - framingErrorsBase.load(std::memory_order_relaxed);
+    copy.rxOverflows = getRxOverflowCount() - rxOverflowsBase.load(std::memory_order_relaxed);
+    copy.bytesSent = bytesSent.load(std::memory_order_relaxed);
+    copy.bytesReceived = bytesReceived.load(std::memory_order_relaxed);
+    copy.latencyMax = latencyMax.load(std::memory_order_relaxed);
+    copy.latencySum = latencySum.load(std::memory_order_relaxed);
+    copy.elapsed = static_cast<uint32_t>(getTimeMs()) - since.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        copy.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+    }
+    return copy;
+}
+
+void ProtocolStats::reset() {
+    for (auto *counter : {&requests, &responses, &errors, &timeouts, &uidMismatches, &lateResponses,
+                          &pushFrames, &bytesSent, &bytesReceived, &latencyMax}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    latencySum.store(0, std::memory_order_relaxed);
+    for (auto &bucket : histogram) bucket.store(0, std::memory_order_relaxed);
+    framingErrorsBase.store(getFramingErrorCount(), std::memory_order_relaxed);
+    rxOverflowsBase.store(getRxOverflowCount(), std::memory_order_relaxed);
+    since.store(static_cast<uint32_t>(getTimeMs()), std::memory_order_relaxed);
+    started.store(true, std::memory_order_relaxed);
+}
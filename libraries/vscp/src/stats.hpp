@@ -0,0 +1,135 @@
+/**
+ * @file stats.hpp
+ * @brief Declaration of the protocol statistics (counters and latency histogram).
+ *
+ * ProtocolStats counts requests, responses, errors and transferred bytes of the Protocol
+ * and sorts response latencies into fixed buckets. The Protocol is the only writer,
+ * readers (diagnostics screen, another task) take a snapshot at any time. All counters
+ * are relaxed atomics, so neither side locks and the snapshot is consistent per counter.
+ * The latency sum is 64-bit, on 32-bit cores its update is a short critical section.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// Number of latency histogram buckets, the last one collects everything above the bounds
+#define LATENCY_BUCKETS 12
+
+/**
+ * @brief Upper bounds (us) of the latency buckets, except the last (open) one.
+ */
+static const uint32_t LATENCY_BUCKET_BOUNDS[LATENCY_BUCKETS - 1] = {
+    500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000
+};
+
+/**
+ * @struct ProtocolStatsSnapshot
+ * @brief Plain copy of the protocol statistics with derived values.
+ */
+struct ProtocolStatsSnapshot
+{
+    uint32_t requests = 0;        ///< Sent requests
+    uint32_t responses = 0;       ///< Responses matched to a request
+    uint32_t errors = 0;          ///< Responses/records with failed or missing status
+    uint32_t timeouts = 0;        ///< Requests without response
+    uint32_t uidMismatches = 0;   ///< Responses/records of an unexpected sensor
+    uint32_t lateResponses = 0;   ///< Responses of expired or cancelled requests
+    uint32_t pushFrames = 0;      ///< Frames pushed by the peer
+    uint32_t framingErrors = 0;   ///< Dropped damaged frames
+    uint32_t rxOverflows = 0;     ///< Received bytes/lines dropped because the buffers were full
+    uint32_t bytesSent = 0;       ///< Sent message bytes
+    uint32_t bytesReceived = 0;   ///< Received message bytes
+    uint32_t latencyMax = 0;      ///< Longest response latency (us)
+    uint64_t latencySum = 0;      ///< Sum of response latencies (us)
+    uint32_t elapsed = 0;         ///< Time since the statistics were reset (ms)
+    uint32_t histogram[LATENCY_BUCKETS] = {}; ///< Responses per latency bucket
+
+    /**
+     * @brief Approximate latency percentile from the histogram.
+     *
+     * @param percent Percentile (0-100).
+     * @return Upper bound (us) of the bucket containing the percentile (at most latencyMax), 0 without responses.
+     */
+    uint32_t percentile(uint8_t percent) const;
+
+    /**
+     * @brief Mean response latency.
+     *
+     * @return Mean latency (us), 0 without responses.
+     */
+    uint32_t meanLatency() const;
+
+    /**
+     * @brief Sent and received bytes per second since the reset.
+     */
+    uint32_t bytesPerSecond() const;
+};
+
+/**
+ * @class ProtocolStats
+ * @brief Lock-free counters and latency histogram of the Protocol.
+ */
+class ProtocolStats
+{
+private:
+    std::atomic<uint32_t> requests{0};
+    std::atomic<uint32_t> responses{0};
+    std::atomic<uint32_t> errors{0};
+    std::atomic<uint32_t> timeouts{0};
+    std::atomic<uint32_t> uidMismatches{0};
+    std::atomic<uint32_t> lateResponses{0};
+    std::atomic<uint32_t> pushFrames{0};
+    std::atomic<uint32_t> bytesSent{0};
+    std::atomic<uint32_t> bytesReceived{0};
+    std::atomic<uint32_t> latencyMax{0};
+    std::atomic<uint64_t> latencySum{0}; ///< In us, a mean of short latencies is not rounded away
+    std::atomic<uint32_t> histogram[LATENCY_BUCKETS];
+    std::atomic<uint32_t> since{0};       ///< Time of the reset (ms)
+    std::atomic<uint32_t> framingErrorsBase{0}; ///< Messenger counters at the reset
+    std::atomic<uint32_t> rxOverflowsBase{0};
+    std::atomic<bool> started{false};     ///< Set by the first start() or reset()
+
+    static void add(std::atomic<uint32_t> &counter, uint32_t value = 1) { counter.fetch_add(value, std::memory_order_relaxed); }
+
+public:
+    ProtocolStats();
+
+    void onRequest(size_t bytes) { add(requests); add(bytesSent, static_cast<uint32_t>(bytes)); }
+    void onReceive(size_t bytes) { add(bytesReceived, static_cast<uint32_t>(bytes)); }
+    void onError() { add(errors); }
+    void onTimeout() { add(timeouts); }
+    void onUidMismatch() { add(uidMismatches); }
+    void onLateResponse() { add(lateResponses); }
+    void onPushFrame() { add(pushFrames); }
+
+    /**
+     * @brief Count a response matched to its request.
+     *
+     * @param latency Time from sending the request (us), including time queued behind other requests.
+     */
+    void onResponse(unsigned long latency);
+
+    /**
+     * @brief Copy all counters.
+     */
+    ProtocolStatsSnapshot snapshot() const;
+
+    /**
+     * @brief Zero all counters and restart the byte rate measurement.
+     */
+    void reset();
+
+    /**
+     * @brief Start the measurement (reset) unless it is running already.
+     */
+    void start() { if (!started.load(std::memory_order_relaxed)) reset(); }
+};
+
+#endif // STATS_HPP
@@ -21,9 +21,12 @@
  *********************/
 
 #include "config.hpp"
+#include "message.hpp"
 #include "protocol.hpp"
+#include "stats.hpp"
 
 #include "io/messenger.hpp"
+#include "io/spsc_queue.hpp"
 
 #endif // VSCP_HPP
 
@@ -0,0 +1,129 @@
+/**
+ * @file bench_message.cpp
+ * @brief Host microbenchmark of UPDATE response parsing: former map parser vs in-place tokenizer.
+ *
+ * Prints messages per second and heap allocations per message of both parsers. Fails if
+ * the tokenizer allocates or loses a value, so it runs with the tests as well.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "message.hpp"
+#include "test.hpp"
+
+static unsigned long allocations = 0; ///< Number of operator new calls.
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *memory = malloc(size ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+/**
+ * @brief Trim as the former parser did (copies).
+ */
+static std::string trimCopy(const std::string &str)
+{
+    size_t start = 0;
+    while (start < str.length() && (std::isspace(static_cast<unsigned char>(str[start])) || str[start] < 32))
+    {
+        start++;
+    }
+    if (start == str.length())
+    {
+        return "";
+    }
+    size_t end = str.length() - 1;
+    while (end > start && (std::isspace(static_cast<unsigned char>(str[end])) || str[end] < 32))
+    {
+        end--;
+    }
+    return str.substr(start, end - start + 1);
+}
+
+/**
+ * @brief The former Protocol::parseMessage(), kept as the baseline.
+ */
+static std::unordered_map<std::string, std::string> &parseMap(const std::string &message)
+{
+    static std::unordered_map<std::string, std::string> params;
+    params.clear();
+
+    std::string cleanMessage = message;
+    if (!cleanMessage.empty() && cleanMessage[0] == '?')
+    {
+        cleanMessage = cleanMessage.substr(1);
+    }
+
+    std::stringstream ss(cleanMessage);
+    std::string pair;
+    while (std::getline(ss, pair, '&'))
+    {
+        size_t equalPos = pair.find('=');
+        if (equalPos != std::string::npos)
+        {
+            std::string key = trimCopy(pair.substr(0, equalPos));
+            std::string value = trimCopy(pair.substr(equalPos + 1));
+            if (!key.empty())
+            {
+                params[key] = value;
+            }
+        }
+    }
+    return params;
+}
+
+int main(int argc, char **argv)
+{
+    const long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    const std::string message = "?id=GAT-0001&status=1&seq=412&rev=9917&Temperature=23.51&acm_x=0.012"
+                                "&acm_y=-0.998&acm_z=0.034&gyr_x=1.25&gyr_y=-0.5&gyr_z=0.0";
+    size_t checksum = 0;
+
+    unsigned long before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++)
+    {
+        checksum += parseMap(message)["acm_y"].size();
+    }
+    double mapSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double mapAllocations = static_cast<double>(allocations - before) / iterations;
+
+    MessageParams params;
+    MessageView view(message);
+    before = allocations;
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++)
+    {
+        parseMessageParams(view, params);
+        checksum += params.get("acm_y").size();
+    }
+    double viewSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double viewAllocations = static_cast<double>(allocations - before) / iterations;
+
+    printf("map parser:   %10.0f msg/s  %5.1f allocations/msg\n", iterations / mapSeconds, mapAllocations);
+    printf("view parser:  %10.0f msg/s  %5.1f allocations/msg\n", iterations / viewSeconds, viewAllocations);
+
+    CHECK_EQ(viewAllocations * iterations, 0);
+    CHECK_EQ(checksum, static_cast<size_t>(2 * 6 * iterations));
+    return TEST_RESULT();
+}
@@ -0,0 +1,231 @@
+/**
+ * @file pty_peer.hpp
+ * @brief Stand-in of the upstream device for host tests, on the master side of a pty.
+ *
+ * The messenger opens the slave side (VSCP_PORT), the peer runs in its own thread and
+ * answers every received request line by a handler. Responses are sent after the delay
+ * returned with them, so link latency can be injected and responses reordered. Line rate
+ * switches are seen by the peer as the termios speed of the slave.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef PTY_PEER_HPP
+#define PTY_PEER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "message.hpp"
+
+/**
+ * @struct PeerReply
+ * @brief Response of the peer to one request.
+ */
+struct PeerReply
+{
+    std::string line;   ///< Response without the line end, empty = no response.
+    unsigned delay = 0; ///< Delay (ms) of the response after the request was received.
+};
+
+/**
+ * @brief Handler of the peer, called with the request line and its parsed parameters.
+ */
+typedef std::function<PeerReply(const std::string &request, const MessageParams &params)> PeerHandler;
+
+/**
+ * @class PtyPeer
+ * @brief Peer answering requests on the master side of a pty.
+ */
+class PtyPeer
+{
+private:
+    struct Scheduled
+    {
+        std::chrono::steady_clock::time_point due; ///< Time to send the response.
+        std::string line;                          ///< The response with the line end.
+    };
+
+    int master = -1;                 ///< Master side of the pty.
+    std::string slave;               ///< Path of the slave side.
+    PeerHandler handler;             ///< Answers the requests.
+    std::thread worker;              ///< Runs the peer.
+    std::atomic<bool> running{false}; ///< Cleared to stop the worker.
+    std::mutex lock;                 ///< Guards the handler.
+    std::atomic<unsigned> requests{0}; ///< Received requests.
+
+    void run()
+    {
+        std::string line;
+        std::vector<Scheduled> scheduled;
+        char chunk[256];
+        while (running.load())
+        {
+            ssize_t count = read(master, chunk, sizeof(chunk));
+            for (ssize_t i = 0; i < count; i++)
+            {
+                if (chunk[i] == '\r')
+                {
+                    continue;
+                }
+                if (chunk[i] != '\n')
+                {
+                    line.push_back(chunk[i]);
+                    continue;
+                }
+
+                requests++;
+                MessageParams params;
+                parseMessageParams(MessageView(line), params);
+                PeerReply reply;
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (handler)
+                    {
+                        reply = handler(line, params);
+                    }
+                }
+                if (!reply.line.empty())
+                {
+                    Scheduled response = {std::chrono::steady_clock::now() + std::chrono::milliseconds(reply.delay), reply.line + "\r\n"};
+                    scheduled.push_back(response);
+                }
+                line.clear();
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < scheduled.size();)
+            {
+                if (scheduled[i].due > now)
+                {
+                    i++;
+                    continue;
+                }
+                const std::string &out = scheduled[i].line;
+                if (write(master, out.data(), out.size()) < 0)
+                {
+                    break;
+                }
+                scheduled.erase(scheduled.begin() + i);
+            }
+            if (count <= 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+public:
+    PtyPeer()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0)
+        {
+            slave = ptsname(master);
+            setenv(STDIO_PORT_ENV, slave.c_str(), 1); // Opened by initMessenger()
+        }
+    }
+
+    ~PtyPeer()
+    {
+        stop();
+        if (master >= 0)
+        {
+            close(master);
+        }
+    }
+
+    /**
+     * @brief Whether the pty was created.
+     */
+    bool ok() const { return !slave.empty(); }
+
+    /**
+     * @brief Replace the handler (may be called while running).
+     */
+    void setHandler(const PeerHandler &answer)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        handler = answer;
+    }
+
+    void start()
+    {
+        running = true;
+        worker = std::thread(&PtyPeer::run, this);
+    }
+
+    void stop()
+    {
+        running = false;
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Number of received requests.
+     */
+    unsigned getRequestCount() const { return requests.load(); }
+
+    /**
+     * @brief Line rate set on the slave side (as the peer sees it after a switch).
+     */
+    unsigned long getBaudRate() const
+    {
+        struct termios tio;
+        int fd = open(slave.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0)
+        {
+            return 0;
+        }
+        unsigned long baudrate = 0;
+        if (tcgetattr(fd, &tio) == 0)
+        {
+            switch (cfgetospeed(&tio))
+            {
+            case B115200: baudrate = 115200; break;
+            case B460800: baudrate = 460800; break;
+            case B921600: baudrate = 921600; break;
+            case B2000000: baudrate = 2000000; break;
+            default: break;
+            }
+        }
+        close(fd);
+        return baudrate;
+    }
+};
+
+/**
+ * @brief Response of a request with its sequence ID echoed.
+ *
+ * @param params The request parameters.
+ * @param rest Response parameters after the sequence ID ("status=1&...").
+ */
+inline std::string echoSeq(const MessageParams &params, const std::string &rest)
+{
+    std::string line = "?";
+    if (params.has("id"))
+    {
+        line += "id=" + params.get("id").str() + "&";
+    }
+    if (params.has("seq"))
+    {
+        line += "seq=" + params.get("seq").str() + "&";
+    }
+    return line + rest;
+}
+
+#endif // PTY_PEER_HPP
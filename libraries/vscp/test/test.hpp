@@ -0,0 +1,44 @@
+/**
+ * @file test.hpp
+ * @brief Minimal checks of the host tests (no test framework is needed to build them).
+ *
+ * A failed CHECK prints the location and marks the test failed, the test keeps running.
+ * main() returns TEST_RESULT(), so CTest sees the failure.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef VSCP_TEST_HPP
+#define VSCP_TEST_HPP
+
+#include <cstdio>
+
+static int testFailures = 0; ///< Number of failed checks.
+
+#define CHECK(condition)                                                          \
+    do                                                                            \
+    {                                                                             \
+        if (!(condition))                                                         \
+        {                                                                         \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                       \
+        }                                                                         \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                \
+    do                                                                            \
+    {                                                                             \
+        long long a_ = static_cast<long long>(actual);                            \
+        long long e_ = static_cast<long long>(expected);                          \
+        if (a_ != e_)                                                             \
+        {                                                                         \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n",     \
+                    __FILE__, __LINE__, #actual, #expected, a_, e_);              \
+            testFailures++;                                                       \
+        }                                                                         \
+    } while (0)
+
+#define TEST_RESULT() (testFailures == 0 ? 0 : 1)
+
+#endif // VSCP_TEST_HPP
@@ -0,0 +1,126 @@
+/**
+ * @file test_baud_fallback.cpp
+ * @brief Host test of the line rate negotiation and the fallback to the base rate.
+ *
+ * The peer accepts a higher line rate in INIT and echoes the probes. When it stops answering,
+ * PROTOCOL_BAUD_FALLBACK_TIMEOUTS requests in a row time out and the link falls back to the
+ * base rate. Failed probes fall back at once and INIT is retried without the failed rate,
+ * the next handshake offers all rates again.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <atomic>
+#include <string>
+
+#include "protocol.hpp"
+#include "pty_peer.hpp"
+#include "test.hpp"
+
+static std::atomic<bool> silent{false};       ///< The peer ignores UPDATE requests.
+static std::atomic<bool> damagedProbe{false}; ///< The peer answers probes with wrong data.
+static std::atomic<unsigned> inits{0};        ///< Received INIT requests.
+static std::atomic<bool> accepted{false};     ///< A line rate was accepted in the last INIT.
+
+static PeerReply answer(const std::string &, const MessageParams &params)
+{
+    PeerReply reply;
+    MessageView type = params.get("type");
+    if (type == MessageView("INIT"))
+    {
+        // Accept the highest (first) offered rate
+        inits++;
+        MessageView offered = params.get("baud");
+        accepted = !offered.empty();
+        reply.line = "?status=1";
+        if (accepted)
+        {
+            reply.line += "&baud=" + offered.substr(0, offered.find(',')).str();
+        }
+    }
+    else if (type == MessageView("PROBE"))
+    {
+        reply.line = echoSeq(params, "status=1&data=" + (damagedProbe ? std::string("U*U*") : params.get("data").str()));
+    }
+    else if (type == MessageView("UPDATE") && !silent)
+    {
+        reply.line = echoSeq(params, "status=1&value=1");
+    }
+    return reply;
+}
+
+static void testFallbackAfterTimeouts(const PtyPeer &peer)
+{
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+    LinkStats link = Protocol::getLinkStats();
+    CHECK(link.rateState == LinkRateState::NEGOTIATED);
+    CHECK_EQ(link.baudrate, 2000000);
+    CHECK_EQ(peer.getBaudRate(), 2000000);
+    CHECK(Protocol::update("S").status == ResponseStatusEnum::OK);
+
+    // Fewer timeouts keep the negotiated rate
+    silent = true;
+    for (int i = 0; i < PROTOCOL_BAUD_FALLBACK_TIMEOUTS - 1; i++)
+    {
+        CHECK(Protocol::update("S").status != ResponseStatusEnum::OK);
+    }
+    CHECK(Protocol::getLinkStats().rateState == LinkRateState::NEGOTIATED);
+
+    CHECK(Protocol::update("S").status != ResponseStatusEnum::OK);
+    link = Protocol::getLinkStats();
+    CHECK(link.rateState == LinkRateState::FALLBACK);
+    CHECK_EQ(link.baudrate, UART1_BAUDRATE);
+    CHECK_EQ(link.rateFallbacks, 1);
+    CHECK_EQ(peer.getBaudRate(), UART1_BAUDRATE);
+
+    // The link works at the base rate
+    silent = false;
+    CHECK(Protocol::update("S").status == ResponseStatusEnum::OK);
+    CHECK_EQ(Protocol::getLinkStats().timeoutsInRow, 0);
+}
+
+static void testFallbackOnDamagedProbe(const PtyPeer &peer)
+{
+    // The rate failed in the previous session is offered again, failed rates are not offered
+    // again in this one: 2000000, 921600 and 460800 are tried before the base rate
+    inits = 0;
+    damagedProbe = true;
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+    LinkStats link = Protocol::getLinkStats();
+    CHECK(link.rateState == LinkRateState::FALLBACK);
+    CHECK_EQ(link.baudrate, UART1_BAUDRATE);
+    CHECK_EQ(link.rateFallbacks, 3);
+    CHECK_EQ(peer.getBaudRate(), UART1_BAUDRATE);
+    CHECK_EQ(inits.load(), 4);
+    CHECK(!accepted);
+    damagedProbe = false;
+}
+
+static void testCeilingReset(const PtyPeer &peer)
+{
+    // Rates failed in the previous session do not stay lowered for good
+    inits = 0;
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+    LinkStats link = Protocol::getLinkStats();
+    CHECK(link.rateState == LinkRateState::NEGOTIATED);
+    CHECK_EQ(link.baudrate, 2000000);
+    CHECK_EQ(peer.getBaudRate(), 2000000);
+    CHECK_EQ(inits.load(), 1);
+    CHECK(Protocol::update("S").status == ResponseStatusEnum::OK);
+}
+
+int main()
+{
+    PtyPeer peer;
+    CHECK(peer.ok());
+    peer.setHandler(answer);
+    peer.start();
+
+    testFallbackAfterTimeouts(peer);
+    testFallbackOnDamagedProbe(peer);
+    testCeilingReset(peer);
+
+    peer.stop();
+    return TEST_RESULT();
+}
@@ -0,0 +1,51 @@
+/**
+ * @file test_framing.cpp
+ * @brief Host test of the binary framing.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+
+#include "io/framing.hpp"
+#include "message.hpp"
+#include "test.hpp"
+
+static void testRoundTrip()
+{
+    const std::string message = "?id=ADC1&status=1&seq=7&value=-12&temp=23.5&#40=abc|?id=ADC2&status=0&error=Busy";
+    std::string frame;
+    std::string decoded;
+    CHECK(encodeFrame(message, frame));
+    CHECK(frame.find('\0') == std::string::npos);
+    CHECK(decodeFrame(frame.data(), frame.size(), decoded));
+    CHECK(decoded == message);
+
+    // Damaged frame is dropped
+    frame[frame.size() / 2] ^= 0x10;
+    CHECK(!decodeFrame(frame.data(), frame.size(), decoded));
+}
+
+static void testTooManyPairs()
+{
+    std::string message = "?status=1";
+    for (int i = 0; i < MAX_MESSAGE_PARAMS; i++)
+    {
+        message += "&k" + std::to_string(i) + "=" + std::to_string(i);
+    }
+
+    std::string frame;
+    CHECK(!encodeFrame(message, frame)); // Would drop the last pair
+
+    // Limit applies per record
+    std::string batched = message.substr(0, message.rfind('&')) + "|?id=B&status=1";
+    CHECK(encodeFrame(batched, frame));
+}
+
+int main()
+{
+    testRoundTrip();
+    testTooManyPairs();
+    return TEST_RESULT();
+}
@@ -0,0 +1,75 @@
+/**
+ * @file test_message.cpp
+ * @brief Host test of the in-place message tokenizer.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+
+#include "message.hpp"
+#include "test.hpp"
+
+static void testParse()
+{
+    MessageParams params;
+    CHECK_EQ(parseMessageParams(MessageView("?id=ADC1&status=1& value = 12 &flag&=x&#40=7"), params), 4);
+    CHECK(params.get("id") == MessageView("ADC1"));
+    CHECK(params.get("value") == MessageView("12"));
+    CHECK(!params.has("flag")); // No '='
+    CHECK_EQ(params.find("#40") ? 1 : 0, 1);
+    CHECK_EQ(params.begin()[3].keyId, 40);
+    CHECK(!params.isTruncated());
+
+    // Later keys win
+    parseMessageParams(MessageView("a=1&a=2"), params);
+    CHECK_EQ(params.size(), 1);
+    CHECK(params.get("a") == MessageView("2"));
+
+    // Case insensitive lookups
+    parseMessageParams(MessageView("Status=1"), params, false);
+    CHECK(params.has("status"));
+}
+
+static void testTruncated()
+{
+    std::string message = "?status=1";
+    for (int i = 0; i < MAX_MESSAGE_PARAMS; i++)
+    {
+        message += "&k" + std::to_string(i) + "=" + std::to_string(i);
+    }
+
+    MessageParams params;
+    CHECK_EQ(parseMessageParams(MessageView(message), params), MAX_MESSAGE_PARAMS);
+    CHECK(params.isTruncated());
+    CHECK(!params.has("k" + std::to_string(MAX_MESSAGE_PARAMS - 1)));
+
+    // Overwriting a kept key does not need a new entry
+    CHECK(params.set(MessageView("status"), MessageView("0")));
+
+    // Cleared by the next parse
+    parseMessageParams(MessageView("status=1"), params);
+    CHECK(!params.isTruncated());
+}
+
+static void testList()
+{
+    MessageView list(" 1, 2 ,,3 ");
+    MessageView item;
+    size_t pos = 0;
+    std::string joined;
+    while (nextListItem(list, pos, item))
+    {
+        joined += item.str() + ";";
+    }
+    CHECK(joined == "1;2;;3;");
+}
+
+int main()
+{
+    testParse();
+    testTruncated();
+    testList();
+    return TEST_RESULT();
+}
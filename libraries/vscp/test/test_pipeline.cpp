@@ -0,0 +1,124 @@
+/**
+ * @file test_pipeline.cpp
+ * @brief Host test of pipelined asynchronous requests over the pty link.
+ *
+ * The peer answers after an injected latency. With one request in flight the rate is
+ * bound by the latency, with MAX_PIPELINE_DEPTH requests in flight the latency overlaps.
+ * Responses sent in reverse order have to reach their own requests by sequence ID.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "protocol.hpp"
+#include "pty_peer.hpp"
+#include "test.hpp"
+
+static const unsigned LATENCY_MS = 20; ///< Injected latency of every response.
+
+static PeerReply answer(const std::string &, const MessageParams &params)
+{
+    PeerReply reply;
+    MessageView type = params.get("type");
+    if (type == MessageView("INIT"))
+    {
+        reply.line = "?status=1";
+        reply.delay = LATENCY_MS; // The first round trip sets the timeout
+    }
+    else if (type == MessageView("UPDATE"))
+    {
+        reply.line = echoSeq(params, "status=1&value=1");
+        reply.delay = LATENCY_MS;
+    }
+    return reply;
+}
+
+/**
+ * @brief Run requests with at most @p depth of them in flight.
+ *
+ * @return Completed requests per second.
+ */
+static double run(size_t depth, unsigned total)
+{
+    unsigned sent = 0;
+    unsigned completed = 0;
+    unsigned mismatched = 0;
+    unsigned timedOut = 0;
+    unsigned long start = getTimeMs();
+    while (completed < total && getTimeMs() - start < 10000)
+    {
+        while (sent < total && Protocol::pendingCount() < depth)
+        {
+            std::string uid = "S" + std::to_string(sent);
+            RequestId seq = Protocol::updateAsync(uid, [uid, &completed, &mismatched, &timedOut](const ResponseStatusView &response) {
+                completed++;
+                if (response.status != ResponseStatusEnum::OK)
+                {
+                    timedOut++;
+                }
+                else if (response.params.get("id") != MessageView(uid))
+                {
+                    mismatched++;
+                }
+            });
+            CHECK(seq != 0);
+            sent++;
+        }
+        Protocol::poll();
+        waitMs(1);
+    }
+    CHECK_EQ(completed, total);
+    CHECK_EQ(mismatched, 0);
+    // The adaptive timeout is close to the latency, scheduling jitter of the host may expire a few
+    CHECK(timedOut * 10 <= total);
+    return completed * 1000.0 / (getTimeMs() - start);
+}
+
+static void testReordered()
+{
+    // Second request is answered first
+    unsigned answered = 0;
+    std::string order;
+    RequestId first = Protocol::updateAsync("A", [&](const ResponseStatusView &response) { order += response.params.get("id").str(); answered++; });
+    RequestId second = Protocol::updateAsync("B", [&](const ResponseStatusView &response) { order += response.params.get("id").str(); answered++; });
+    CHECK(first != 0 && second != 0);
+
+    unsigned long start = getTimeMs();
+    while (answered < 2 && getTimeMs() - start < 2000)
+    {
+        Protocol::poll();
+        waitMs(1);
+    }
+    CHECK(order == "BA");
+}
+
+int main()
+{
+    PtyPeer peer;
+    CHECK(peer.ok());
+    peer.setHandler(answer);
+    peer.start();
+
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+
+    // Reordered first, the timeout is still well above the latency
+    peer.setHandler([](const std::string &request, const MessageParams &params) {
+        PeerReply reply = answer(request, params);
+        reply.delay = params.get("id") == MessageView("A") ? 2 * LATENCY_MS : LATENCY_MS;
+        return reply;
+    });
+    testReordered();
+    peer.setHandler(answer);
+
+    const unsigned total = 60;
+    double serial = run(1, total);
+    double pipelined = run(MAX_PIPELINE_DEPTH, total);
+    printf("depth 1: %.0f req/s, depth %d: %.0f req/s (latency %u ms)\n", serial, MAX_PIPELINE_DEPTH, pipelined, LATENCY_MS);
+    CHECK(pipelined > serial * 2);
+
+    peer.stop();
+    return TEST_RESULT();
+}
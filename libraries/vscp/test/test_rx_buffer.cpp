@@ -0,0 +1,147 @@
+/**
+ * @file test_rx_buffer.cpp
+ * @brief Host test of the receive ring buffer, the line assembler and the pty backend.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "io/messenger.hpp"
+#include "pty_peer.hpp"
+#include "test.hpp"
+
+static void testRingWrapAndOverflow()
+{
+    RingBuffer<8> ring;
+    char c;
+
+    // Positions run past the capacity several times
+    for (int round = 0; round < 5; round++)
+    {
+        CHECK_EQ(ring.push("abcde", 5), 5);
+        for (const char *expected = "abcde"; *expected; expected++)
+        {
+            CHECK(ring.pop(c) && c == *expected);
+        }
+        CHECK(ring.empty());
+    }
+
+    // Full ring drops and counts the rest
+    CHECK_EQ(ring.push("0123456789", 10), 8);
+    CHECK_EQ(ring.size(), 8);
+    CHECK_EQ(ring.getOverflowCount(), 1); // push() stops at the first dropped byte
+    CHECK(!ring.push('x'));
+    CHECK_EQ(ring.getOverflowCount(), 2);
+    CHECK(ring.pop(c) && c == '0');
+    CHECK(ring.push('x'));
+
+    ring.clear();
+    CHECK(ring.empty());
+    CHECK(!ring.pop(c));
+}
+
+static void testRingConcurrent()
+{
+    // One producer and one consumer thread, no byte may be lost, duplicated or reordered
+    static RingBuffer<64> ring;
+    const unsigned total = 200000;
+    std::thread producer([]() {
+        for (unsigned i = 0; i < total;)
+        {
+            if (ring.push(static_cast<char>(i & 0x7F)))
+            {
+                i++;
+            }
+            else
+            {
+                std::this_thread::yield(); // Full, let the consumer run (single core hosts)
+            }
+        }
+    });
+
+    unsigned received = 0;
+    unsigned wrong = 0;
+    char c;
+    while (received < total)
+    {
+        if (ring.pop(c))
+        {
+            wrong += c != static_cast<char>(received & 0x7F);
+            received++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK_EQ(wrong, 0);
+    CHECK(ring.empty());
+}
+
+static void testLineAcrossChunks()
+{
+    RingBuffer<64> ring;
+    LineAssembler<16> assembler;
+    MessageView line;
+
+    // A line split over several chunks is returned once complete
+    ring.push("?id=A", 5);
+    CHECK(!assembler.assemble(ring, '\n', true, line));
+    ring.push("&st", 3);
+    CHECK(!assembler.assemble(ring, '\n', true, line));
+    ring.push("atus=1\r\n?id", 11);
+    CHECK(assembler.assemble(ring, '\n', true, line));
+    CHECK(line == MessageView("?id=A&status=1")); // '\r' dropped as non-printable
+    CHECK(!assembler.assemble(ring, '\n', true, line));
+    ring.push("=B\n", 3);
+    CHECK(assembler.assemble(ring, '\n', true, line));
+    CHECK(line == MessageView("?id=B"));
+
+    // Too long line is dropped as a whole, the next one is kept
+    ring.push("0123456789abcdefXYZ\nok\n", 23);
+    CHECK(assembler.assemble(ring, '\n', true, line));
+    CHECK(line == MessageView("ok"));
+    CHECK_EQ(assembler.getOverflowCount(), 1);
+}
+
+static void testPtyRoundTrip()
+{
+    PtyPeer peer;
+    CHECK(peer.ok());
+    std::string received;
+    peer.setHandler([&received](const std::string &request, const MessageParams &) {
+        received = request;
+        PeerReply reply;
+        reply.line = "?status=1&echo=" + request.substr(request.find('=') + 1);
+        return reply;
+    });
+    peer.start();
+
+    CHECK(initMessenger());
+    setFramingMode(FramingMode::TEXT);
+    sendMessage(std::string("?type=PING&n=42"));
+
+    MessageView line;
+    CHECK(receiveLine(line, 0, 1000));
+    CHECK(line == MessageView("?status=1&echo=PING&n=42"));
+    CHECK(received == "?type=PING&n=42");
+
+    // Nothing else is pending, the non-blocking receive returns at once
+    CHECK(!tryReceiveLine(line));
+    peer.stop();
+}
+
+int main()
+{
+    testRingWrapAndOverflow();
+    testRingConcurrent();
+    testLineAcrossChunks();
+    testPtyRoundTrip();
+    return TEST_RESULT();
+}
@@ -0,0 +1,69 @@
+/**
+ * @file test_stats.cpp
+ * @brief Host test of the protocol statistics.
+ *
+ * Latencies are summed in microseconds, so the mean of fast responses (below 1 ms on a
+ * fast link) is not rounded to zero, and the sum does not wrap after long uptime.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include "stats.hpp"
+#include "test.hpp"
+
+static void testMean()
+{
+    ProtocolStats stats;
+    stats.reset();
+    CHECK_EQ(stats.snapshot().meanLatency(), 0);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        stats.onResponse(i % 2 ? 200 : 400);
+    }
+    ProtocolStatsSnapshot snapshot = stats.snapshot();
+    CHECK_EQ(snapshot.responses, 1000);
+    CHECK_EQ(snapshot.meanLatency(), 300);
+    CHECK_EQ(snapshot.latencyMax, 400);
+    CHECK_EQ(snapshot.histogram[0], 1000);
+    CHECK_EQ(snapshot.percentile(50), 400); // Bound of the bucket, at most the maximum
+
+    // Past 2^32 us in total (over an hour of latency)
+    for (int i = 0; i < 5000; i++)
+    {
+        stats.onResponse(1000000);
+    }
+    snapshot = stats.snapshot();
+    CHECK(snapshot.latencySum > 0xFFFFFFFFull);
+    CHECK_EQ(snapshot.meanLatency(), (1000 * 300ull + 5000 * 1000000ull) / 6000);
+    CHECK_EQ(snapshot.histogram[LATENCY_BUCKETS - 2], 5000);
+    CHECK_EQ(snapshot.percentile(100), 1000000);
+
+    stats.reset();
+    snapshot = stats.snapshot();
+    CHECK(snapshot.latencySum == 0 && snapshot.responses == 0 && snapshot.latencyMax == 0);
+}
+
+static void testHistogram()
+{
+    ProtocolStats stats;
+    stats.reset();
+    stats.onResponse(500);     // Bounds belong to their bucket
+    stats.onResponse(501);
+    stats.onResponse(2000000); // Open bucket
+    ProtocolStatsSnapshot snapshot = stats.snapshot();
+    CHECK_EQ(snapshot.histogram[0], 1);
+    CHECK_EQ(snapshot.histogram[1], 1);
+    CHECK_EQ(snapshot.histogram[LATENCY_BUCKETS - 1], 1);
+    CHECK_EQ(snapshot.percentile(30), 500);
+    CHECK_EQ(snapshot.percentile(60), 1000);
+    CHECK_EQ(snapshot.percentile(100), 2000000);
+}
+
+int main()
+{
+    testMean();
+    testHistogram();
+    return TEST_RESULT();
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_timeout.cpp
+ * @brief Host test of the adaptive request timeout with responses of different sizes.
+ *
+ * Small fast responses drive the timeout down to its minimum, a large response still has
+ * to arrive within the timeout as its transfer time at the line rate is added. Requests of a
+ * full pipeline to a silent peer complete within Protocol::maxRequestTimeout().
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "protocol.hpp"
+#include "pty_peer.hpp"
+#include "test.hpp"
+
+static const size_t BURST_SIZE = 1800; ///< Size of the BURST response (bytes).
+
+static std::atomic<bool> silent{false}; ///< The peer ignores UPDATE requests.
+
+static PeerReply answer(const std::string &, const MessageParams &params)
+{
+    PeerReply reply;
+    MessageView type = params.get("type");
+    if (type == MessageView("INIT"))
+    {
+        reply.line = "?status=1";
+    }
+    else if (type == MessageView("UPDATE") && !silent)
+    {
+        reply.line = echoSeq(params, "status=1&value=1");
+    }
+    else if (type == MessageView("BURST"))
+    {
+        // The pty has no line rate, the transfer time at 115200 Bd is injected as latency
+        reply.line = echoSeq(params, "status=1&value=");
+        reply.line.append(BURST_SIZE - reply.line.size(), '1');
+        reply.delay = static_cast<unsigned>(BURST_SIZE * 10 * 1000 / UART1_BAUDRATE);
+    }
+    return reply;
+}
+
+static void testDeadlineBound()
+{
+    // Back off to the largest timeout
+    silent = true;
+    while (Protocol::getLinkStats().timeout < PROTOCOL_MAX_TIMEOUT)
+    {
+        CHECK(Protocol::update("S").status != ResponseStatusEnum::OK);
+    }
+
+    // The last request of a full pipeline waits for all before it
+    unsigned completed = 0;
+    std::vector<std::string> uids(1, "S");
+    unsigned long start = getTimeMs();
+    for (int i = 0; i < MAX_PIPELINE_DEPTH; i++)
+    {
+        CHECK(Protocol::updateBatchAsync(uids, [&completed](const ResponseStatusView &record) {
+            CHECK(record.status != ResponseStatusEnum::OK);
+            completed++;
+        }) != 0);
+    }
+    unsigned long bound = Protocol::maxRequestTimeout(MAX_RECEIVE_LINE_SIZE);
+    while (completed < MAX_PIPELINE_DEPTH && getTimeMs() - start < 2 * bound)
+    {
+        Protocol::poll();
+        waitMs(1);
+    }
+    unsigned long elapsed = getTimeMs() - start;
+    CHECK_EQ(completed, MAX_PIPELINE_DEPTH);
+    CHECK(elapsed > 2 * PROTOCOL_MAX_TIMEOUT); // Deadlines grow with the requests ahead
+    CHECK(elapsed <= bound);
+    silent = false;
+}
+
+int main()
+{
+    PtyPeer peer;
+    CHECK(peer.ok());
+    peer.setHandler(answer);
+    peer.start();
+
+    CHECK(Protocol::init().status == ResponseStatusEnum::OK);
+    for (int i = 0; i < 50; i++)
+    {
+        CHECK(Protocol::update("S").status == ResponseStatusEnum::OK);
+    }
+    CHECK_EQ(Protocol::getLinkStats().timeout, PROTOCOL_MIN_TIMEOUT);
+
+    for (int i = 0; i < PROTOCOL_BAUD_FALLBACK_TIMEOUTS; i++)
+    {
+        ResponseStatusView response = Protocol::burstView("S", 8);
+        CHECK(response.status == ResponseStatusEnum::OK);
+        CHECK(response.params.get("value").size() > BURST_SIZE / 2);
+    }
+    CHECK_EQ(Protocol::getLinkStats().timeouts, 0);
+    CHECK_EQ(Protocol::getLinkStats().rateFallbacks, 0);
+
+    testDeadlineBound();
+
+    peer.stop();
+    return TEST_RESULT();
+}
@@ -185,6 +185,10 @@ void switchToCommunicationSelectionScreen() {
     guiManager.switchContent(GuiState::COMMUNICATION_SELECTION);
 }
 
+void switchToDiagnosticsScreen() {
+    guiManager.switchContent(GuiState::DIAGNOSTICS);
+}
+
 void setup ()
 {
     //Serial.begin( 115200 ); /* prepare for possible serial debug */